@@ -17,6 +17,7 @@
 #include "hermes/BCGen/HBC/BytecodeDataProvider.h"
 #include "hermes/BCGen/HBC/BytecodeFileFormat.h"
 #include "hermes/BCGen/HBC/BytecodeProviderFromSrc.h"
+#include "hermes/BCGen/HBC/CompileCache.h"
 #include "hermes/DebuggerAPI.h"
 #include "hermes/Platform/Logging.h"
 #include "hermes/Public/RuntimeConfig.h"
@@ -38,6 +39,7 @@
 #include "hermes/VM/Profiler/CodeCoverageProfiler.h"
 #include "hermes/VM/Profiler/SamplingProfiler.h"
 #include "hermes/VM/Runtime.h"
+#include "hermes/VM/SegmentPool.h"
 #include "hermes/VM/StringPrimitive.h"
 #include "hermes/VM/StringView.h"
 #include "hermes/VM/SymbolID.h"
@@ -331,6 +333,14 @@ class HermesRuntimeImpl final : public HermesRuntime,
     }
 
     compileFlags_.enableGenerator = runtimeConfig.getEnableGenerator();
+    compileFlags_.preParseThreads = runtimeConfig.getPreParseThreads();
+#ifndef HERMESVM_LEAN
+    if (!runtimeConfig.getCompileCacheDirectory().empty()) {
+      compileCache_ = std::make_unique<hbc::CompileCache>(
+          runtimeConfig.getCompileCacheDirectory(),
+          runtimeConfig.getCompileCacheMaxSize());
+    }
+#endif
     compileFlags_.emitAsyncBreakCheck = defaultEmitAsyncBreakCheck_ =
         runtimeConfig.getAsyncBreakCheckInEval();
 
@@ -615,13 +625,17 @@ class HermesRuntimeImpl final : public HermesRuntime,
     if (code) {
       throw std::system_error(code);
     }
-    runtime_.getHeap().createSnapshot(os);
+    if (auto code = runtime_.getHeap().createSnapshot(os)) {
+      throw std::system_error(code);
+    }
   }
 
   // Overridden from jsi::Instrumentation
   void createSnapshotToStream(std::ostream &os) override {
     llvh::raw_os_ostream ros(os);
-    runtime_.getHeap().createSnapshot(ros);
+    if (auto code = runtime_.getHeap().createSnapshot(ros)) {
+      throw std::system_error(code);
+    }
   }
 
   // Overridden from jsi::Instrumentation
@@ -1110,6 +1124,10 @@ class HermesRuntimeImpl final : public HermesRuntime,
 
   /// Compilation flags used by prepareJavaScript().
   ::hermes::hbc::CompileFlags compileFlags_{};
+#ifndef HERMESVM_LEAN
+  /// If set, the cache of the bytecode compiled by prepareJavaScript().
+  std::unique_ptr<::hermes::hbc::CompileCache> compileCache_;
+#endif
   /// The default setting of "emit async break check" in this runtime.
   bool defaultEmitAsyncBreakCheck_{false};
 };
@@ -1228,6 +1246,14 @@ void HermesRuntime::setFatalHandler(void (*handler)(const std::string &)) {
   detail::sApiFatalHandler = handler;
 }
 
+void HermesRuntime::setSegmentPoolLimits(
+    size_t maxPooled,
+    size_t maxResident,
+    uint32_t idleTimeoutMs) {
+  ::hermes::vm::SegmentPool::getInstance().setLimits(
+      maxPooled, maxResident, std::chrono::milliseconds(idleTimeoutMs));
+}
+
 namespace {
 // A class which adapts a jsi buffer to a Hermes buffer.
 class BufferAdapter final : public ::hermes::Buffer {
@@ -1317,6 +1343,25 @@ const ::hermes::vm::GCExecTrace &HermesRuntime::getGCExecTrace() const {
       ->runtime_.getGCExecTrace();
 }
 
+void HermesRuntime::enableHeapSamplingProfiler(
+    size_t samplingInterval,
+    size_t maxStackDepth,
+    size_t maxLiveSamples) {
+  static_cast<HermesRuntimeImpl *>(this)
+      ->runtime_.enableHeapSamplingProfiler(
+          samplingInterval, maxStackDepth, maxLiveSamples);
+}
+
+bool HermesRuntime::dumpHeapSamplingProfile(llvh::raw_ostream &os) {
+  return static_cast<HermesRuntimeImpl *>(this)
+      ->runtime_.writeHeapSamplingProfile(os);
+}
+
+void HermesRuntime::disableHeapSamplingProfiler() {
+  static_cast<HermesRuntimeImpl *>(this)
+      ->runtime_.disableHeapSamplingProfiler();
+}
+
 std::string HermesRuntime::getIOTrackingInfoJSON() {
   std::string buf;
   llvh::raw_string_ostream strstrm(buf);
@@ -1381,6 +1426,74 @@ void HermesRuntime::unwatchTimeLimit() {
       &(impl(this)->runtime_));
 }
 
+jsi::Value HermesRuntime::createValueFromJsonUtf8Stream(
+    const std::function<size_t(uint8_t *buffer, size_t size)> &read) {
+  return maybeRethrow([&] {
+    vm::Runtime &runtime = impl(this)->runtime_;
+    vm::GCScope gcScope(&runtime);
+    // The parser is not exception safe, so an exception from read() is held
+    // until it returns. Ending the text makes the parse fail right away.
+    std::exception_ptr readError;
+    vm::CallResult<vm::HermesValue> res = runtimeJSONParseRef(
+        &runtime,
+        ::hermes::UTF16Stream(
+            [&read, &readError](uint8_t *buffer, size_t size) -> size_t {
+              if (readError) {
+                return 0;
+              }
+              try {
+                return read(buffer, size);
+              } catch (...) {
+                readError = std::current_exception();
+                return 0;
+              }
+            }));
+    if (readError) {
+      if (res == vm::ExecutionStatus::EXCEPTION) {
+        runtime.clearThrownValue();
+      }
+      std::rethrow_exception(readError);
+    }
+    impl(this)->checkStatus(res.getStatus());
+    return impl(this)->valueFromHermesValue(*res);
+  });
+}
+
+bool HermesRuntime::writeValueAsJsonUtf8(
+    const jsi::Value &value,
+    const std::function<void(const char *data, size_t size)> &write) {
+  return maybeRethrow([&] {
+    vm::Runtime &runtime = impl(this)->runtime_;
+    vm::GCScope gcScope(&runtime);
+    std::exception_ptr writeError;
+    vm::CallResult<bool> res = runtimeJSONStringifyToSink(
+        &runtime,
+        impl(this)->vmHandleFromValue(value),
+        vm::Runtime::getUndefinedValue(),
+        vm::Runtime::getUndefinedValue(),
+        // The stringifier is not exception safe, so an exception from write()
+        // is held until it returns, and the rest of the text is dropped.
+        [&write, &writeError](llvh::StringRef text) {
+          if (writeError) {
+            return;
+          }
+          try {
+            write(text.data(), text.size());
+          } catch (...) {
+            writeError = std::current_exception();
+          }
+        });
+    if (writeError) {
+      if (res == vm::ExecutionStatus::EXCEPTION) {
+        runtime.clearThrownValue();
+      }
+      std::rethrow_exception(writeError);
+    }
+    impl(this)->checkStatus(res.getStatus());
+    return *res;
+  });
+}
+
 jsi::Value HermesRuntime::evaluateJavaScriptWithSourceMap(
     const std::shared_ptr<const jsi::Buffer> &buffer,
     const std::shared_ptr<const jsi::Buffer> &sourceMapBuf,
@@ -1475,8 +1588,13 @@ HermesRuntimeImpl::prepareJavaScriptWithSourceMap(
         throw std::runtime_error("Error parsing source map:" + errorStr);
       }
     }
-    bcErr = hbc::BCProviderFromSrc::createBCProviderFromSrc(
-        std::move(buffer), sourceURL, std::move(sourceMap), compileFlags_);
+    if (compileCache_) {
+      bcErr = compileCache_->getOrCompile(
+          std::move(buffer), sourceURL, std::move(sourceMap), compileFlags_);
+    } else {
+      bcErr = hbc::BCProviderFromSrc::createBCProviderFromSrc(
+          std::move(buffer), sourceURL, std::move(sourceMap), compileFlags_);
+    }
 #endif
   }
   if (!bcErr.first) {
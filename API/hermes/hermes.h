@@ -9,6 +9,7 @@
 #define HERMES_HERMES_H
 
 #include <exception>
+#include <functional>
 #include <list>
 #include <map>
 #include <memory>
@@ -92,6 +93,17 @@ class HERMES_EXPORT HermesRuntime : public jsi::Runtime {
       std::string *errorMessage = nullptr);
   static void setFatalHandler(void (*handler)(const std::string &));
 
+  /// Bound the segment pool shared by all runtimes created with
+  /// GCConfig::UseSegmentPool: it caches at most \p maxPooled segments, of
+  /// which at most \p maxResident keep their physical pages, for at most
+  /// \p idleTimeoutMs milliseconds after they were last used. The limits
+  /// apply to the whole process, so the host should set them once, before
+  /// creating those runtimes.
+  static void setSegmentPoolLimits(
+      size_t maxPooled,
+      size_t maxResident,
+      uint32_t idleTimeoutMs);
+
   // Assuming that \p data is valid HBC bytecode data, returns a pointer to the
   // first element of the epilogue, data append to the end of the bytecode
   // stream. Return pair contain ptr to data and header.
@@ -215,6 +227,47 @@ class HERMES_EXPORT HermesRuntime : public jsi::Runtime {
   /// Unregister this runtime for sampling profiler.
   void unregisterForProfiling();
 
+  /// Enable the heap sampling profiler for this runtime. It is cheap enough to
+  /// leave on in production: about once every \p samplingInterval allocated
+  /// bytes, the allocation is attributed to the current JS stack, truncated to
+  /// \p maxStackDepth frames. At most \p maxLiveSamples sampled objects are
+  /// tracked at a time. Restarts the profiler if it is already enabled.
+  void enableHeapSamplingProfiler(
+      size_t samplingInterval,
+      size_t maxStackDepth = 64,
+      size_t maxLiveSamples = 1 << 16);
+  /// Write the sampled allocations that are still alive to \p os, in the
+  /// Chrome .heapprofile format. Can be called repeatedly while the profiler
+  /// is running. \return false if the profiler is not enabled.
+  bool dumpHeapSamplingProfile(llvh::raw_ostream &os);
+  /// Disable the heap sampling profiler, discarding its samples.
+  void disableHeapSamplingProfiler();
+
+  /// Parse JSON text like createValueFromJsonUtf8, reading it with \p read
+  /// instead of from one buffer. \p read is called repeatedly to write the
+  /// next at most \p size bytes of the UTF-8 text to \p buffer, and returns
+  /// how many it wrote, or 0 at the end of the text. Only a few kilobytes of
+  /// the text are held in memory at a time, so large payloads can be parsed
+  /// as they arrive from a file or socket. \p read is called while the text
+  /// is being parsed, and must not call back into the runtime. If \p read
+  /// throws, parsing stops and the exception is rethrown from this method.
+  jsi::Value createValueFromJsonUtf8Stream(
+      const std::function<size_t(uint8_t *buffer, size_t size)> &read);
+
+  /// Serialize \p value like JSON.stringify(value), passing the UTF-8 text
+  /// to \p write in pieces as it is produced instead of creating one string.
+  /// \p write must not call back into the runtime. If \p write throws, it is
+  /// not called again, and the exception is rethrown from this method once
+  /// serialization has finished. If serialization fails,
+  /// for example because a toJSON method throws or the value is cyclic, the
+  /// error is thrown after \p write may have received the start of the text,
+  /// and the caller should discard what it was given.
+  /// \return false, without calling \p write, if the value has no JSON
+  /// representation, like undefined or a function.
+  bool writeValueAsJsonUtf8(
+      const jsi::Value &value,
+      const std::function<void(const char *data, size_t size)> &write);
+
   /// Register this runtime for execution time limit monitoring, with a time
   /// limit of \p timeoutInMs milliseconds.
   /// All JS compiled to bytecode via prepareJS, or evaluateJS, will support the
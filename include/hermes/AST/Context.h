@@ -176,6 +176,10 @@ class Context {
   /// bytes.
   unsigned preemptiveFileCompilationThreshold_{0};
 
+  /// The maximum number of threads used to pre-parse a large file for lazy
+  /// compilation. 1 pre-parses it on the calling thread only.
+  unsigned preParseThreads_{1};
+
   /// If true, do not error on return statements that are not within functions.
   bool allowReturnOutsideFunction_{false};
 
@@ -380,6 +384,14 @@ class Context {
     preemptiveFileCompilationThreshold_ = byteCount;
   };
 
+  unsigned getPreParseThreads() const {
+    return preParseThreads_;
+  }
+
+  void setPreParseThreads(unsigned threads) {
+    preParseThreads_ = threads;
+  }
+
   bool allowReturnOutsideFunction() const {
     return allowReturnOutsideFunction_;
   }
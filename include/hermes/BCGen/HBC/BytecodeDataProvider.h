@@ -20,7 +20,9 @@
 #include "llvh/ADT/ArrayRef.h"
 
 #include <atomic>
+#include <mutex>
 #include <thread>
+#include <vector>
 
 namespace hermes {
 namespace hbc {
@@ -337,6 +339,15 @@ class BCProviderFromBuffer final : public BCProviderBase {
   /// End of the bytecode file.
   const uint8_t *end_;
 
+  /// Chunks of compressed function bodies, if the bytecode is compressed.
+  llvh::ArrayRef<hbc::CompressedChunkEntry> compressedChunks_{};
+
+  /// Each chunk of compressedChunks_ once it has been decompressed, or null.
+  mutable std::vector<std::unique_ptr<uint8_t[]>> decompressedChunks_;
+
+  /// Protects decompressedChunks_.
+  mutable std::mutex decompressMutex_;
+
   /// Tells any running warmup thread to abort and then joins that thread.
   void stopWarmup();
 
@@ -354,6 +365,10 @@ class BCProviderFromBuffer final : public BCProviderBase {
       const hbc::DebugOffsets *>
   getExceptionTableAndDebugOffsets(uint32_t functionID) const;
 
+  /// \return a pointer to \p offset of the uncompressed function bodies,
+  /// decompressing the chunk that contains it on first use.
+  const uint8_t *getDecompressedBytecode(uint32_t offset) const;
+
  public:
   static std::pair<std::unique_ptr<BCProviderFromBuffer>, std::string>
   createBCProviderFromBuffer(
@@ -451,6 +466,9 @@ class BCProviderFromBuffer final : public BCProviderBase {
   }
 
   const uint8_t *getBytecode(uint32_t functionID) const override {
+    if (LLVM_UNLIKELY(!compressedChunks_.empty())) {
+      return getDecompressedBytecode(getFunctionHeader(functionID).offset());
+    }
     return bufferPtr_ + getFunctionHeader(functionID).offset();
   }
 
@@ -51,6 +51,9 @@ union BytecodeOptions {
     bool staticBuiltins : 1;
     bool cjsModulesStaticallyResolved : 1;
     bool hasAsync : 1;
+    /// Function bodies are stored in compressed chunks, described by a
+    /// CompressedChunkTableHeader after the function source table.
+    bool compressedBytecode : 1;
   };
   uint8_t _flags;
 
@@ -388,6 +391,27 @@ struct DebugFileRegion {
   uint32_t sourceMappingUrlId;
 };
 
+/// When BytecodeOptions::compressedBytecode is set, the function bodies are
+/// concatenated into an uncompressed stream, split into chunks at function
+/// boundaries, and each chunk is compressed separately with LZ4. Function
+/// header offsets are then offsets into the uncompressed stream. The table
+/// follows the function source table, and the compressed chunks follow it.
+struct CompressedChunkTableHeader {
+  uint32_t count;
+};
+
+struct CompressedChunkEntry {
+  /// Offset of the compressed chunk in the file.
+  uint32_t offset;
+  /// Size of the compressed chunk in bytes.
+  uint32_t size;
+  /// Offset of the chunk in the uncompressed stream. Chunks are contiguous
+  /// and in order, and each starts at a multiple of 4.
+  uint32_t uncompressedOffset;
+  /// Size of the chunk in bytes after decompression.
+  uint32_t uncompressedSize;
+};
+
 LLVM_PACKED_END
 
 /// Visit each segment in a bytecode file in order.
@@ -470,6 +494,9 @@ struct BytecodeFileFields {
   /// List of function source table entries.
   Array<std::pair<uint32_t, uint32_t>> functionSourceTable;
 
+  /// List of compressed function body chunks, if the bytecode is compressed.
+  Array<hbc::CompressedChunkEntry> compressedChunks;
+
   /// Populate bytecode file fields from a buffer. The fields will point
   /// directly into the buffer and it is the caller's responsibility to ensure
   /// the result does not outlive the buffer.
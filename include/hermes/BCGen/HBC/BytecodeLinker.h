@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_BCGEN_HBC_BYTECODELINKER_H
+#define HERMES_BCGEN_HBC_BYTECODELINKER_H
+
+#include "hermes/BCGen/HBC/Bytecode.h"
+#include "hermes/BCGen/HBC/BytecodeDataProvider.h"
+
+#include "llvh/ADT/ArrayRef.h"
+
+#include <memory>
+#include <string>
+
+namespace hermes {
+namespace hbc {
+
+/// Link the bytecode object units \p units into a single BytecodeModule, which
+/// can then be serialized with BytecodeSerializer.
+///
+/// Each unit holds the CommonJS modules of one or more source files, compiled
+/// with `hermesc -commonjs -object-unit`. The string tables are merged and the
+/// functions, literal buffers and regexps of each unit are renumbered after
+/// those of the units before it; the instructions are rewritten in place,
+/// which is why the units must use the widest form of every instruction that
+/// refers to them. The CommonJS module tables are concatenated, so the first
+/// module of the first unit is the entry point, and require() calls between
+/// units are resolved at run time by filename, like calls within a unit.
+///
+/// Source locations are kept, and so are variable names when the units were
+/// compiled with -g3. \p options controls the string table packing
+/// (optimizationEnabled) and whether debug info is kept at all
+/// (stripDebugInfoSection).
+///
+/// \return the linked module, or nullptr with a description of the problem in
+///     \p outError.
+std::unique_ptr<BytecodeModule> linkBytecodeUnits(
+    llvh::ArrayRef<const BCProviderBase *> units,
+    const BytecodeGenerationOptions &options,
+    std::string *outError);
+
+} // namespace hbc
+} // namespace hermes
+
+#endif // HERMES_BCGEN_HBC_BYTECODELINKER_H
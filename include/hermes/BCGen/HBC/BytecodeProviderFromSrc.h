@@ -30,6 +30,8 @@ struct CompileFlags {
   unsigned preemptiveFileCompilationThreshold{1 << 16};
   /// Eagerly compile functions under this number of bytes, even when lazy.
   unsigned preemptiveFunctionCompilationThreshold{160};
+  /// Pre-parse files for lazy compilation on up to this many threads.
+  unsigned preParseThreads{1};
 
   bool strict{false};
   /// The value is optional; when it is set, the optimization setting is based
@@ -55,10 +55,26 @@ class BytecodeSerializer {
   uint32_t overflowStringEntryCount_{0};
   /// Hash of everything written in non-layout mode so far.
   llvh::SHA1 outputHasher_;
+  /// IDs of all functions in the order their bytecode and info are written,
+  /// computed during the layout phase.
+  std::vector<uint32_t> functionLayout_;
+
+  /// A chunk of function bodies compressed during the layout phase.
+  struct CompressedChunk {
+    uint32_t uncompressedOffset;
+    uint32_t uncompressedSize;
+    std::vector<uint8_t> data;
+  };
+  /// The function bodies, if options_.compressBytecode is set.
+  std::vector<CompressedChunk> compressedChunks_;
 
   /// Each subsection of a function's `info' section is aligned thusly.
   static constexpr uint32_t INFO_ALIGNMENT = 4;
 
+  /// Compressed function bodies are split into chunks of at least this many
+  /// bytes before compression, which is how much is decompressed at once.
+  static constexpr uint32_t COMPRESSED_CHUNK_SIZE = 32 * 1024;
+
   template <typename T>
   void writeBinaryArray(const ArrayRef<T> array) {
     size_t size = sizeof(T) * array.size();
@@ -105,7 +121,19 @@ class BytecodeSerializer {
 
   void serializeDebugOffsets(BytecodeFunction &BF);
 
+  /// Destinations for serializeFunctionBodies(), which provide offset(),
+  /// write(), pad() and finishFunction().
+  class StreamBodySink;
+  class ChunkBodySink;
+
+  /// Write the body of each function to \p sink in layout order, reusing the
+  /// body of an identical earlier function when optimizing. During layout,
+  /// set the offset of each function to where its body is in \p sink.
+  template <typename Sink>
+  void serializeFunctionBodies(BytecodeModule &BM, Sink &sink);
+
   void serializeFunctionsBytecode(BytecodeModule &BM);
+  void serializeCompressedFunctionsBytecode(BytecodeModule &BM);
   void serializeFunctionInfo(BytecodeFunction &BF);
 
   void finishLayout(BytecodeModule &BM);
@@ -131,6 +159,12 @@ class BytecodeSerializer {
       : os_(OS), options_(options) {}
 
   void serialize(BytecodeModule &BM, const SHA1 &sourceHash);
+
+  /// \return the IDs 0 to \p numFunctions - 1 in layout order: the valid IDs
+  /// in \p preferredOrder first, followed by the rest in ID order.
+  static std::vector<uint32_t> computeFunctionLayout(
+      llvh::ArrayRef<uint32_t> preferredOrder,
+      uint32_t numFunctions);
 };
 
 } // namespace hbc
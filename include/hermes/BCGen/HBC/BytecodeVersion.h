@@ -19,8 +19,8 @@ namespace hermes {
 namespace hbc {
 
 // Bytecode version generated by this version of the compiler.
-// Updated: Jul 06, 2021
-const static uint32_t BYTECODE_VERSION = 84;
+// Updated: Oct 18, 2026
+const static uint32_t BYTECODE_VERSION = 85;
 
 } // namespace hbc
 } // namespace hermes
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_BCGEN_HBC_COMPILECACHE_H
+#define HERMES_BCGEN_HBC_COMPILECACHE_H
+
+#include "hermes/BCGen/HBC/BytecodeProviderFromSrc.h"
+#include "hermes/Support/SHA1.h"
+
+#include <memory>
+#include <string>
+
+namespace hermes {
+namespace hbc {
+
+#ifndef HERMESVM_LEAN
+/// A persistent cache of the bytecode compiled from JavaScript source.
+///
+/// Entries live in a directory, one file per entry, named after a SHA1 of the
+/// source, its URL, the compile flags that affect the generated bytecode, and
+/// the bytecode version. A hit is loaded with BCProviderFromBuffer instead of
+/// being compiled again.
+///
+/// Entries are always compiled eagerly, even when \c CompileFlags::lazy is
+/// set, so that they contain every function in the source. Lazy compilation
+/// would otherwise leave functions that can only be compiled from source.
+///
+/// Several processes may share a directory: entries are written to a
+/// temporary file which is then renamed into place, and entries that are
+/// unreadable or fail validation are treated as misses and replaced.
+///
+/// The entries are kept under a total size: whenever an entry is stored, the
+/// least recently written entries are removed until the directory fits.
+/// Loading an entry does not change its modification time, so entries that
+/// are hit often are still evicted once enough newer ones have been written.
+class CompileCache {
+ public:
+  /// The default bound on the total size of the entries, in bytes.
+  static constexpr uint64_t kDefaultMaxSize = 64 << 20;
+
+  /// Create a cache that stores its entries in \p directory, which is created
+  /// if it does not exist, and keeps their total size under \p maxSize bytes.
+  explicit CompileCache(
+      std::string directory,
+      uint64_t maxSize = kDefaultMaxSize)
+      : directory_(std::move(directory)), maxSize_(maxSize) {}
+
+  /// \return the key of the entry for compiling \p source, named \p sourceURL,
+  /// with \p flags.
+  static SHA1 computeKey(
+      llvh::ArrayRef<uint8_t> source,
+      llvh::StringRef sourceURL,
+      const CompileFlags &flags);
+
+  /// \return the path of the entry for \p key.
+  std::string getEntryPath(const SHA1 &key) const;
+
+  /// \return the bytecode stored for \p key, or nullptr if there is no valid
+  /// entry for it.
+  std::unique_ptr<BCProviderFromBuffer> load(const SHA1 &key) const;
+
+  /// Store \p bytecode as the entry for \p key, and evict old entries if the
+  /// cache is over its size. \return true on success.
+  bool store(const SHA1 &key, llvh::ArrayRef<uint8_t> bytecode) const;
+
+  /// Load the bytecode for \p buffer from the cache, or compile it and add it
+  /// to the cache. The arguments are those of
+  /// BCProviderFromSrc::createBCProviderFromSrc, which this falls back to for
+  /// sources that can't be cached.
+  ///
+  /// \return a BCProvider and an empty error, or a null BCProvider and an
+  ///     error message.
+  std::pair<std::unique_ptr<BCProvider>, std::string> getOrCompile(
+      std::unique_ptr<Buffer> buffer,
+      llvh::StringRef sourceURL,
+      std::unique_ptr<SourceMap> sourceMap,
+      const CompileFlags &flags);
+
+ private:
+  /// Remove the least recently written entries, other than the one at
+  /// \p keepPath, until the total size of the entries is at most maxSize_.
+  void evict(llvh::StringRef keepPath) const;
+
+  /// The directory containing the entries.
+  const std::string directory_;
+
+  /// The bound on the total size of the entries, in bytes.
+  const uint64_t maxSize_;
+};
+#endif // HERMESVM_LEAN
+
+} // namespace hbc
+} // namespace hermes
+
+#endif // HERMES_BCGEN_HBC_COMPILECACHE_H
@@ -17,8 +17,12 @@
 #include "hermes/Support/OptValue.h"
 #include "hermes/Support/StringTable.h"
 #include "hermes/Support/UTF8.h"
+#include "llvh/ADT/DenseMap.h"
 #include "llvh/Support/Format.h"
 
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -134,9 +138,71 @@ class DebugInfo {
   uint32_t lexicalDataOffset_ = 0;
   StreamVector<uint8_t> data_{};
 
+  /// A point in a function's source location stream from which decoding can
+  /// resume.
+  struct LocationCheckpoint {
+    /// Offset in data_ of the entry that produced location.
+    uint32_t locationOffset;
+    /// Offset in data_ of the entry after it.
+    uint32_t nextOffset;
+    /// The decoded location at this point.
+    DebugSourceLocation location;
+  };
+
+  /// Sparse checkpoints into long source location streams, keyed by the
+  /// stream's debug offset. They are built lazily by getLocationForAddress(),
+  /// which may be called from several threads. A stream whose addresses are
+  /// not sorted has no checkpoints.
+  struct LocationIndex {
+    std::mutex mutex;
+    llvh::DenseMap<uint32_t, std::vector<LocationCheckpoint>> checkpoints;
+  };
+
+  /// Owns the LocationIndex, which is only allocated when the first stream
+  /// is indexed. Unlike the atomic pointer it wraps, it can be moved.
+  class LocationIndexPtr {
+   public:
+    LocationIndexPtr() = default;
+    LocationIndexPtr(LocationIndexPtr &&that)
+        : ptr_(that.ptr_.exchange(nullptr)) {}
+    LocationIndexPtr &operator=(LocationIndexPtr &&that) {
+      delete ptr_.exchange(that.ptr_.exchange(nullptr));
+      return *this;
+    }
+    ~LocationIndexPtr() {
+      delete ptr_.load();
+    }
+
+    /// \return the index, or nullptr if nothing has been indexed yet.
+    LocationIndex *get() const {
+      return ptr_.load(std::memory_order_acquire);
+    }
+
+    /// \return the index, allocating it if needed.
+    LocationIndex &getOrCreate();
+
+   private:
+    std::atomic<LocationIndex *> ptr_{nullptr};
+  };
+  mutable LocationIndexPtr locationIndex_;
+
   /// Get source filename as string id.
   OptValue<uint32_t> getFilenameForAddress(uint32_t debugOffset) const;
 
+  /// Find the last checkpoint at or before \p offsetInFunction in the source
+  /// location stream at \p debugOffset, and store it in \p checkpoint.
+  /// \return false if the stream hasn't been indexed yet. Takes the index's
+  /// lock, so it is only used once a lookup has decoded enough of a stream
+  /// for the stream to be worth indexing.
+  bool findLocationCheckpoint(
+      uint32_t debugOffset,
+      uint32_t offsetInFunction,
+      OptValue<LocationCheckpoint> &checkpoint) const;
+
+  /// Decode the whole source location stream at \p debugOffset and add its
+  /// checkpoints to locationIndex_.
+  void buildLocationIndex(uint32_t debugOffset) const;
+
  public:
   explicit DebugInfo() = default;
   /*implicit*/ DebugInfo(DebugInfo &&that) = default;
@@ -192,11 +258,20 @@ class DebugInfo {
   }
 
   /// Get the location of \p offsetInFunction, given the function's debug
-  /// offset.
+  /// offset. Long functions are indexed on first use, so that later lookups
+  /// only decode a few entries.
   OptValue<DebugSourceLocation> getLocationForAddress(
       uint32_t debugOffset,
       uint32_t offsetInFunction) const;
 
+  /// Decode the whole source location stream at \p debugOffset into the
+  /// location of the function's start, \p start, and the locations of its
+  /// instructions, \p locations. Filename IDs refer to this DebugInfo.
+  void getSourceLocations(
+      uint32_t debugOffset,
+      DebugSourceLocation &start,
+      std::vector<DebugSourceLocation> &locations) const;
+
   /// Given a \p targetLine and optional \p targetColumn,
   /// find a bytecode address at which that location is listed in debug info.
   /// If \p targetColumn is None, then it tries to match at the first location
@@ -322,6 +397,9 @@ class DebugInfoGenerator {
   uint32_t appendLexicalData(
       OptValue<uint32_t> parentFunctionIndex,
       llvh::ArrayRef<Identifier> names);
+  uint32_t appendLexicalData(
+      OptValue<uint32_t> parentFunctionIndex,
+      llvh::ArrayRef<llvh::StringRef> names);
 
   // Destructively move memory to a DebugInfo.
   DebugInfo serializeWithMove();
@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_BCGEN_HBC_FUNCTIONTRACE_H
+#define HERMES_BCGEN_HBC_FUNCTIONTRACE_H
+
+#include "llvh/ADT/StringRef.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace hermes {
+namespace hbc {
+
+/// Parse a function trace, as written by `hvm -function-trace`: the IDs of
+/// the functions that ran, one per line. Empty lines and lines starting with
+/// '#' are ignored. The IDs in \p contents are appended to \p ids.
+/// \param fileName the name of the trace, used in error messages.
+/// \return false and print an error to stderr if a line isn't a function ID.
+bool parseFunctionTrace(
+    llvh::StringRef contents,
+    llvh::StringRef fileName,
+    std::vector<uint32_t> &ids);
+
+} // namespace hbc
+} // namespace hermes
+
+#endif // HERMES_BCGEN_HBC_FUNCTIONTRACE_H
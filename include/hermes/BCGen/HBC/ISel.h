@@ -117,6 +117,13 @@ class HBCISel {
   /// Encode a value into a param_t type.
   unsigned encodeValue(Value *);
 
+  /// \return true if the string, function or literal buffer ID \p id may be
+  /// encoded in an operand no larger than \p max. Object units always use
+  /// the widest operand, so that linking can renumber the IDs in place.
+  bool fitsOperand(uint32_t id, uint32_t max) const {
+    return id <= max && !bytecodeGenerationOptions_.objectUnit;
+  }
+
   /// Resolve the offset of every relocation.
   void resolveRelocations();
 
@@ -147,6 +147,10 @@ struct ExecuteOptions {
 
   /// Start tracking heap objects before executing bytecode.
   bool heapTimeline{false};
+
+  /// If not empty, write the IDs of the functions that ran to this file, in
+  /// the order they first ran. hermesc -function-order reads it.
+  std::string functionTraceFile;
 };
 
 /// Executes the HBC bytecode provided in HermesVM.
@@ -155,6 +155,21 @@ static opt<bool> TrackBytecodeIO(
         "Track bytecode I/O when executing bytecode. Only works with bytecode mode"),
     cat(RuntimeCategory));
 
+static opt<bool> PerfMap(
+    "perf-map",
+    init(false),
+    desc("Call JS functions through native trampolines listed in "
+         "/tmp/perf-<pid>.map, so that Linux perf can symbolize JS frames "
+         "(requires a build with HERMESVM_JS_PERF_MAP)"),
+    cat(RuntimeCategory));
+
+static opt<bool> BackgroundLazyCompilation(
+    "Xbackground-lazy-compile",
+    init(RuntimeConfig::getDefaultBackgroundLazyCompilation()),
+    desc("Compile lazy functions on a background thread before their first "
+         "call"),
+    cat(RuntimeCategory));
+
 static opt<bool> StableInstructionCount(
     "Xstable-instruction-count",
     init(false),
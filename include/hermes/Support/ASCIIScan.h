@@ -0,0 +1,293 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_SUPPORT_ASCIISCAN_H
+#define HERMES_SUPPORT_ASCIISCAN_H
+
+#include "hermes/Support/ByteScan.h"
+
+#include "llvh/Support/MathExtras.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace hermes {
+
+/// Helpers for the ASCII fast paths of string operations, over arrays of
+/// char or char16_t. Like the ones in ByteScan.h, they examine 16 bytes at a
+/// time where the target supports it, and only read inside the given range.
+namespace asciiscan {
+
+namespace detail {
+
+/// \return true if \p c is in [lo, hi].
+template <typename T>
+inline bool inRange(T c, char lo, char hi) {
+  using U = typename std::make_unsigned<T>::type;
+  return static_cast<U>(static_cast<U>(c) - lo) <= static_cast<U>(hi - lo);
+}
+
+/// \return true if \p c is an ASCII white space or line terminator.
+template <typename T>
+inline bool isASCIISpace(T c) {
+  return inRange(c, '\t', '\r') || c == ' ';
+}
+
+#ifdef HERMES_BYTESCAN_VECTOR
+using bytescan::detail::Block;
+
+/// Number of characters of type T in a Block.
+template <typename T>
+constexpr ptrdiff_t kLanes = bytescan::kBlockSize / sizeof(T);
+
+template <typename T>
+inline Block load(const T *p) {
+  return bytescan::detail::load(reinterpret_cast<const char *>(p));
+}
+
+#if defined(HERMES_BYTESCAN_SSE2)
+template <typename T>
+inline void store(T *p, Block v) {
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(p), v);
+}
+inline Block splat(char c) {
+  return _mm_set1_epi8(c);
+}
+inline Block splat(char16_t c) {
+  return _mm_set1_epi16(static_cast<short>(c));
+}
+inline Block sub(Block a, Block b, char) {
+  return _mm_sub_epi8(a, b);
+}
+inline Block sub(Block a, Block b, char16_t) {
+  return _mm_sub_epi16(a, b);
+}
+/// \return a mask of the lanes of \p v that are at most \p max, unsigned.
+inline Block atMost(Block v, char max) {
+  return _mm_cmpeq_epi8(_mm_subs_epu8(v, splat(max)), _mm_setzero_si128());
+}
+inline Block atMost(Block v, char16_t max) {
+  return _mm_cmpeq_epi16(_mm_subs_epu16(v, splat(max)), _mm_setzero_si128());
+}
+inline Block eq(Block v, char c) {
+  return _mm_cmpeq_epi8(v, splat(c));
+}
+inline Block eq(Block v, char16_t c) {
+  return _mm_cmpeq_epi16(v, splat(c));
+}
+inline Block andMask(Block a, Block b) {
+  return _mm_and_si128(a, b);
+}
+inline Block orMask(Block a, Block b) {
+  return _mm_or_si128(a, b);
+}
+inline Block xorMask(Block a, Block b) {
+  return _mm_xor_si128(a, b);
+}
+/// \return one bit for every byte of \p mask, set if the byte is set.
+inline unsigned byteBits(Block mask) {
+  return _mm_movemask_epi8(mask);
+}
+#elif defined(HERMES_BYTESCAN_NEON)
+template <typename T>
+inline void store(T *p, Block v) {
+  vst1q_u8(reinterpret_cast<uint8_t *>(p), v);
+}
+inline Block splat(char c) {
+  return vdupq_n_u8(static_cast<uint8_t>(c));
+}
+inline Block splat(char16_t c) {
+  return vreinterpretq_u8_u16(vdupq_n_u16(c));
+}
+inline Block sub(Block a, Block b, char) {
+  return vsubq_u8(a, b);
+}
+inline Block sub(Block a, Block b, char16_t) {
+  return vreinterpretq_u8_u16(
+      vsubq_u16(vreinterpretq_u16_u8(a), vreinterpretq_u16_u8(b)));
+}
+inline Block atMost(Block v, char max) {
+  return vcleq_u8(v, splat(max));
+}
+inline Block atMost(Block v, char16_t max) {
+  return vreinterpretq_u8_u16(
+      vcleq_u16(vreinterpretq_u16_u8(v), vdupq_n_u16(max)));
+}
+inline Block eq(Block v, char c) {
+  return vceqq_u8(v, splat(c));
+}
+inline Block eq(Block v, char16_t c) {
+  return vreinterpretq_u8_u16(
+      vceqq_u16(vreinterpretq_u16_u8(v), vdupq_n_u16(c)));
+}
+inline Block andMask(Block a, Block b) {
+  return vandq_u8(a, b);
+}
+inline Block orMask(Block a, Block b) {
+  return vorrq_u8(a, b);
+}
+inline Block xorMask(Block a, Block b) {
+  return veorq_u8(a, b);
+}
+/// \return one bit for every byte of \p mask, set if the byte is set.
+inline unsigned byteBits(Block mask) {
+  static const uint8_t kBits[16] = {
+      1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+  uint8x16_t bits = vandq_u8(mask, vld1q_u8(kBits));
+  return vaddv_u8(vget_low_u8(bits)) | (vaddv_u8(vget_high_u8(bits)) << 8);
+}
+#endif
+
+/// \return a mask of the lanes of \p v that are in [lo, hi].
+template <typename T>
+inline Block inRange(Block v, char lo, char hi) {
+  return atMost(sub(v, splat(T(lo)), T()), T(hi - lo));
+}
+
+/// \return a mask of the lanes of \p v that are ASCII white space or line
+/// terminators.
+template <typename T>
+inline Block asciiSpace(Block v) {
+  return orMask(inRange<T>(v, '\t', '\r'), eq(v, T(' ')));
+}
+
+/// \return the index of the first lane set in \p mask, or kLanes<T>.
+template <typename T>
+inline ptrdiff_t firstSet(Block mask) {
+  unsigned bits = byteBits(mask);
+  return bits ? llvh::countTrailingZeros(bits) / sizeof(T) : kLanes<T>;
+}
+
+/// \return the index of the last lane clear in \p mask, or -1.
+template <typename T>
+inline ptrdiff_t lastClear(Block mask) {
+  unsigned bits = ~byteBits(mask) & 0xffff;
+  return bits ? (31 - llvh::countLeadingZeros(bits)) / sizeof(T) : -1;
+}
+#endif
+
+} // namespace detail
+
+/// \return the first character in [p, end) that is not ASCII.
+template <typename T>
+inline const T *findNonASCII(const T *p, const T *end) {
+  using U = typename std::make_unsigned<T>::type;
+#ifdef HERMES_BYTESCAN_VECTOR
+  constexpr ptrdiff_t kLanes = detail::kLanes<T>;
+  for (; end - p >= kLanes; p += kLanes) {
+    detail::Block v = detail::load(p);
+    ptrdiff_t i = detail::firstSet<T>(
+        detail::xorMask(detail::atMost(v, T(0x7f)), detail::splat(T(-1))));
+    if (i != kLanes)
+      return p + i;
+  }
+#endif
+  while (p != end && static_cast<U>(*p) <= 0x7f)
+    ++p;
+  return p;
+}
+
+/// \return the first character in [p, end) that is in [lo, hi].
+template <typename T>
+inline const T *findInRange(const T *p, const T *end, char lo, char hi) {
+#ifdef HERMES_BYTESCAN_VECTOR
+  constexpr ptrdiff_t kLanes = detail::kLanes<T>;
+  for (; end - p >= kLanes; p += kLanes) {
+    ptrdiff_t i =
+        detail::firstSet<T>(detail::inRange<T>(detail::load(p), lo, hi));
+    if (i != kLanes)
+      return p + i;
+  }
+#endif
+  while (p != end && !detail::inRange(*p, lo, hi))
+    ++p;
+  return p;
+}
+
+/// Copy [p, end) to \p out, flipping the ASCII case bit (0x20) of the
+/// characters in [lo, hi]. \p out may be \p p.
+template <typename T>
+inline void
+flipCaseInRange(const T *p, const T *end, T *out, char lo, char hi) {
+#ifdef HERMES_BYTESCAN_VECTOR
+  constexpr ptrdiff_t kLanes = detail::kLanes<T>;
+  const detail::Block caseBit = detail::splat(T(0x20));
+  for (; end - p >= kLanes; p += kLanes, out += kLanes) {
+    detail::Block v = detail::load(p);
+    detail::store(
+        out,
+        detail::xorMask(
+            v, detail::andMask(detail::inRange<T>(v, lo, hi), caseBit)));
+  }
+#endif
+  for (; p != end; ++p, ++out)
+    *out = detail::inRange(*p, lo, hi) ? T(*p ^ 0x20) : *p;
+}
+
+/// \return the first character in [p, end) that is a double quote, a
+/// backslash or a control character (below 0x20): the characters that end a
+/// run of literal characters in a JSON string.
+template <typename T>
+inline const T *findQuoteBackslashOrControl(const T *p, const T *end) {
+  using U = typename std::make_unsigned<T>::type;
+#ifdef HERMES_BYTESCAN_VECTOR
+  constexpr ptrdiff_t kLanes = detail::kLanes<T>;
+  for (; end - p >= kLanes; p += kLanes) {
+    detail::Block v = detail::load(p);
+    ptrdiff_t i = detail::firstSet<T>(detail::orMask(
+        detail::atMost(v, T(0x1f)),
+        detail::orMask(detail::eq(v, T('"')), detail::eq(v, T('\\')))));
+    if (i != kLanes)
+      return p + i;
+  }
+#endif
+  while (p != end && static_cast<U>(*p) > 0x1f && *p != '"' && *p != '\\')
+    ++p;
+  return p;
+}
+
+/// \return the first character in [p, end) that is not an ASCII white space
+/// or line terminator.
+template <typename T>
+inline const T *skipASCIISpace(const T *p, const T *end) {
+#ifdef HERMES_BYTESCAN_VECTOR
+  constexpr ptrdiff_t kLanes = detail::kLanes<T>;
+  for (; end - p >= kLanes; p += kLanes) {
+    ptrdiff_t i = detail::firstSet<T>(detail::xorMask(
+        detail::asciiSpace<T>(detail::load(p)), detail::splat(T(-1))));
+    if (i != kLanes)
+      return p + i;
+  }
+#endif
+  while (p != end && detail::isASCIISpace(*p))
+    ++p;
+  return p;
+}
+
+/// \return one past the last character in [begin, end) that is not an ASCII
+/// white space or line terminator, or \p begin if there is none.
+template <typename T>
+inline const T *skipASCIISpaceBackward(const T *begin, const T *end) {
+#ifdef HERMES_BYTESCAN_VECTOR
+  constexpr ptrdiff_t kLanes = detail::kLanes<T>;
+  for (; end - begin >= kLanes; end -= kLanes) {
+    ptrdiff_t i = detail::lastClear<T>(
+        detail::asciiSpace<T>(detail::load(end - kLanes)));
+    if (i != -1)
+      return end - kLanes + i + 1;
+  }
+#endif
+  while (end != begin && detail::isASCIISpace(end[-1]))
+    --end;
+  return end;
+}
+
+} // namespace asciiscan
+} // namespace hermes
+
+#endif // HERMES_SUPPORT_ASCIISCAN_H
@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_SUPPORT_BYTESCAN_H
+#define HERMES_SUPPORT_BYTESCAN_H
+
+#include "llvh/Support/MathExtras.h"
+
+#include <cstddef>
+#include <cstdint>
+
+/// Select a 16-byte vector implementation. SSE2 is part of the x86-64
+/// baseline and NEON of the AArch64 one, so neither needs runtime dispatch.
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HERMES_BYTESCAN_SSE2
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define HERMES_BYTESCAN_NEON
+#include <arm_neon.h>
+#endif
+
+namespace hermes {
+
+/// Helpers for skipping over runs of "uninteresting" bytes in a buffer, 16
+/// bytes at a time where the target supports it. Every function takes a range
+/// [p, end) and returns a pointer to the first byte in it that stops the scan,
+/// or \p end if there is none. Only bytes inside the range are ever read.
+namespace bytescan {
+
+/// Number of bytes examined at once by the vector implementations.
+constexpr ptrdiff_t kBlockSize = 16;
+
+namespace detail {
+
+/// \return true if \p ch is one of \p Cs.
+template <char C>
+inline bool isOneOf(char ch) {
+  return ch == C;
+}
+template <char C, char D, char... Rest>
+inline bool isOneOf(char ch) {
+  return ch == C || isOneOf<D, Rest...>(ch);
+}
+
+/// \return true if \p ch is [A-Za-z0-9_$].
+inline bool isASCIIIdentifierPart(char ch) {
+  return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') ||
+      (ch >= '0' && ch <= '9') || ch == '_' || ch == '$';
+}
+
+#if defined(HERMES_BYTESCAN_SSE2)
+#define HERMES_BYTESCAN_VECTOR
+using Block = __m128i;
+
+inline Block load(const char *p) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+}
+inline Block splat(char c) {
+  return _mm_set1_epi8(c);
+}
+inline Block eq(Block v, char c) {
+  return _mm_cmpeq_epi8(v, splat(c));
+}
+inline Block orMask(Block a, Block b) {
+  return _mm_or_si128(a, b);
+}
+/// \return a mask of the bytes in \p v that are in the ASCII range [lo, hi].
+/// Non-ASCII bytes are negative as signed chars, so they never match.
+inline Block inRange(Block v, char lo, char hi) {
+  return _mm_and_si128(
+      _mm_cmpgt_epi8(v, splat(lo - 1)), _mm_cmplt_epi8(v, splat(hi + 1)));
+}
+/// \return a mask of the bytes in \p v that have the high bit set.
+inline Block nonASCII(Block v) {
+  return _mm_cmplt_epi8(v, _mm_setzero_si128());
+}
+/// \return the index of the first byte set in \p mask, or kBlockSize.
+inline ptrdiff_t firstSet(Block mask) {
+  unsigned bits = _mm_movemask_epi8(mask);
+  return bits ? llvh::countTrailingZeros(bits) : kBlockSize;
+}
+/// \return the index of the first byte clear in \p mask, or kBlockSize.
+inline ptrdiff_t firstClear(Block mask) {
+  unsigned bits = ~_mm_movemask_epi8(mask) & 0xffff;
+  return bits ? llvh::countTrailingZeros(bits) : kBlockSize;
+}
+#elif defined(HERMES_BYTESCAN_NEON)
+#define HERMES_BYTESCAN_VECTOR
+using Block = uint8x16_t;
+
+inline Block load(const char *p) {
+  return vld1q_u8(reinterpret_cast<const uint8_t *>(p));
+}
+inline Block splat(char c) {
+  return vdupq_n_u8(static_cast<uint8_t>(c));
+}
+inline Block eq(Block v, char c) {
+  return vceqq_u8(v, splat(c));
+}
+inline Block orMask(Block a, Block b) {
+  return vorrq_u8(a, b);
+}
+/// \return a mask of the bytes in \p v that are in the ASCII range [lo, hi].
+/// Non-ASCII bytes are above any ASCII \p hi, so they never match.
+inline Block inRange(Block v, char lo, char hi) {
+  return vandq_u8(vcgeq_u8(v, splat(lo)), vcleq_u8(v, splat(hi)));
+}
+/// \return a mask of the bytes in \p v that have the high bit set.
+inline Block nonASCII(Block v) {
+  return vcgeq_u8(v, vdupq_n_u8(0x80));
+}
+/// \return the index of the first byte set in \p mask, or kBlockSize.
+/// NEON has no movemask, so narrow each byte of the mask to a nibble.
+inline ptrdiff_t firstSet(Block mask) {
+  uint64_t bits = vget_lane_u64(
+      vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(mask), 4)), 0);
+  return bits ? llvh::countTrailingZeros(bits) / 4 : kBlockSize;
+}
+/// \return the index of the first byte clear in \p mask, or kBlockSize.
+inline ptrdiff_t firstClear(Block mask) {
+  return firstSet(vmvnq_u8(mask));
+}
+#endif
+
+#ifdef HERMES_BYTESCAN_VECTOR
+/// \return a mask of the bytes in \p v that are one of \p Cs.
+template <char C>
+inline Block anyOf(Block v) {
+  return eq(v, C);
+}
+template <char C, char D, char... Rest>
+inline Block anyOf(Block v) {
+  return orMask(eq(v, C), anyOf<D, Rest...>(v));
+}
+#endif
+
+} // namespace detail
+
+/// \return the first byte in [p, end) that is not a space or a tab.
+inline const char *skipSpacesAndTabs(const char *p, const char *end) {
+#ifdef HERMES_BYTESCAN_VECTOR
+  for (; end - p >= kBlockSize; p += kBlockSize) {
+    detail::Block v = detail::load(p);
+    ptrdiff_t i = detail::firstClear(
+        detail::orMask(detail::eq(v, ' '), detail::eq(v, '\t')));
+    if (i != kBlockSize)
+      return p + i;
+  }
+#endif
+  while (p != end && (*p == ' ' || *p == '\t'))
+    ++p;
+  return p;
+}
+
+/// \return the first byte in [p, end) that is not [A-Za-z0-9_$], or \p extra
+/// when it is not zero.
+inline const char *
+skipASCIIIdentifierParts(const char *p, const char *end, char extra = 0) {
+#ifdef HERMES_BYTESCAN_VECTOR
+  // '_' is already accepted, so it stands in for a missing extra character.
+  const char extraOrUnderscore = extra ? extra : '_';
+  for (; end - p >= kBlockSize; p += kBlockSize) {
+    detail::Block v = detail::load(p);
+    detail::Block letters = detail::orMask(
+        detail::inRange(v, 'a', 'z'), detail::inRange(v, 'A', 'Z'));
+    detail::Block others = detail::orMask(
+        detail::inRange(v, '0', '9'),
+        detail::orMask(
+            detail::anyOf<'_', '$'>(v), detail::eq(v, extraOrUnderscore)));
+    ptrdiff_t i = detail::firstClear(detail::orMask(letters, others));
+    if (i != kBlockSize)
+      return p + i;
+  }
+#endif
+  while (p != end &&
+         (detail::isASCIIIdentifierPart(*p) || (extra && *p == extra)))
+    ++p;
+  return p;
+}
+
+/// \return the first byte in [p, end) that is one of \p Cs or is not ASCII.
+template <char... Cs>
+inline const char *findFirstOfOrNonASCII(const char *p, const char *end) {
+#ifdef HERMES_BYTESCAN_VECTOR
+  for (; end - p >= kBlockSize; p += kBlockSize) {
+    detail::Block v = detail::load(p);
+    ptrdiff_t i = detail::firstSet(
+        detail::orMask(detail::anyOf<Cs...>(v), detail::nonASCII(v)));
+    if (i != kBlockSize)
+      return p + i;
+  }
+#endif
+  while (p != end && !(*p & 0x80) && !detail::isOneOf<Cs...>(*p))
+    ++p;
+  return p;
+}
+
+} // namespace bytescan
+} // namespace hermes
+
+#endif // HERMES_SUPPORT_BYTESCAN_H
@@ -8,8 +8,49 @@
 #ifndef HERMES_SUPPORT_JSON_H
 #define HERMES_SUPPORT_JSON_H
 
+#include "hermes/Support/ASCIIScan.h"
+
 namespace hermes {
 
+/// Append the JSON string form of \p ch to \p output: the character itself,
+/// or its escape sequence if it is a quote, a backslash or a control
+/// character.
+template <typename Output>
+void appendCharForJSON(Output &output, char16_t ch) {
+#define ESCAPE(ch, replace)    \
+  case ch:                     \
+    output.push_back(u'\\');   \
+    output.push_back(replace); \
+    break
+
+  switch (ch) {
+    // Quote.2.a.
+    ESCAPE(u'\\', u'\\');
+    ESCAPE(u'"', u'"');
+    // Quote.2.b.
+    ESCAPE(u'\b', u'b');
+    ESCAPE(u'\f', u'f');
+    ESCAPE(u'\n', u'n');
+    ESCAPE(u'\r', u'r');
+    ESCAPE(u'\t', u't');
+    default:
+      if (ch < u' ') {
+        // Quote.2.c.
+        output.append({u'\\', u'u', u'0', u'0'});
+        output.push_back(u'0' + (ch / 16));
+        if (ch % 16 < 10) {
+          output.push_back(u'0' + (ch % 16));
+        } else {
+          output.push_back(u'a' + (ch % 16 - 10));
+        }
+      } else {
+        // Quote.2.d.
+        output.push_back(ch);
+      }
+  }
+#undef ESCAPE
+}
+
 /// Quotes a string given by \p view and puts the quoted version into \p output.
 /// \p view should be utf16-encoded, and \p output will be as well.
 /// \post output is a container that has a sequential list of utf16 characters
@@ -20,39 +61,27 @@ void quoteStringForJSON(Output &output, StringView view) {
   output.push_back(u'"');
   // Quote.2.
   for (char16_t ch : view) {
-#define ESCAPE(ch, replace)    \
-  case ch:                     \
-    output.push_back(u'\\');   \
-    output.push_back(replace); \
-    break
+    appendCharForJSON(output, ch);
+  }
+  // Quote.3.
+  output.push_back(u'"');
+}
 
-    switch (ch) {
-      // Quote.2.a.
-      ESCAPE(u'\\', u'\\');
-      ESCAPE(u'"', u'"');
-      // Quote.2.b.
-      ESCAPE(u'\b', u'b');
-      ESCAPE(u'\f', u'f');
-      ESCAPE(u'\n', u'n');
-      ESCAPE(u'\r', u'r');
-      ESCAPE(u'\t', u't');
-      default:
-        if (ch < u' ') {
-          // Quote.2.c.
-          output.append({u'\\', u'u', u'0', u'0'});
-          output.push_back(u'0' + (ch / 16));
-          if (ch % 16 < 10) {
-            output.push_back(u'0' + (ch % 16));
-          } else {
-            output.push_back(u'a' + (ch % 16 - 10));
-          }
-        } else {
-          // Quote.2.d.
-          output.push_back(ch);
-        }
+/// Quotes the string [p, end) of char or char16_t into \p output, like the
+/// version above. Runs of characters that need no escaping are found with a
+/// vector scan and appended with a single call to output.append(begin, end).
+template <typename Output, typename T>
+void quoteStringForJSON(Output &output, const T *p, const T *end) {
+  output.push_back(u'"');
+  for (;;) {
+    const T *run = asciiscan::findQuoteBackslashOrControl(p, end);
+    output.append(p, run);
+    if (run == end) {
+      break;
     }
+    appendCharForJSON(output, *run);
+    p = run + 1;
   }
-  // Quote.3.
   output.push_back(u'"');
 }
 
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_SUPPORT_LZ4_H
+#define HERMES_SUPPORT_LZ4_H
+
+#include "llvh/ADT/ArrayRef.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace hermes {
+namespace lz4 {
+
+/// Compress \p src in the LZ4 block format, and append the result to \p dst.
+/// The encoder favours speed over ratio, and the output can be decoded by any
+/// LZ4 block decoder.
+void compress(llvh::ArrayRef<uint8_t> src, std::vector<uint8_t> &dst);
+
+/// An LZ4 block never decodes to more than this many times its size: every
+/// byte of a match length beyond the first few adds at most 255 bytes.
+constexpr uint64_t kMaxExpansionRatio = 255;
+
+/// Decode the LZ4 block \p src into \p dst, which must be exactly as large as
+/// the data that was compressed.
+/// \return false if \p src is malformed or doesn't decode to exactly
+///   dst.size() bytes, in which case the contents of \p dst are unspecified.
+bool decompress(
+    llvh::ArrayRef<uint8_t> src,
+    llvh::MutableArrayRef<uint8_t> dst);
+
+} // namespace lz4
+} // namespace hermes
+
+#endif // HERMES_SUPPORT_LZ4_H
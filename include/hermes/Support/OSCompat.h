@@ -79,11 +79,40 @@ void vm_free(void *p, size_t sz);
 /// \p vm_allocate_aligned.
 void vm_free_aligned(void *p, size_t sz);
 
+/// Reserve a \p sz byte region of virtual address space aligned to
+/// \p alignment, without committing memory to it. No part of the region can
+/// be accessed until it is committed with \p vm_commit.
+/// \pre sz and alignment must be multiples of oscompat::page_size().
+llvh::ErrorOr<void *> vm_reserve_aligned(size_t sz, size_t alignment);
+
+/// Release a region returned by \p vm_reserve_aligned, including any parts
+/// of it that are committed. \p sz must match the reserved size.
+void vm_release_aligned(void *p, size_t sz);
+
+/// Commit the \p sz byte region starting at \p p, which must lie in a region
+/// returned by \p vm_reserve_aligned, so that it can be read and written.
+/// \pre p and sz must be multiples of oscompat::page_size().
+/// \return false if the memory could not be committed.
+bool vm_commit(void *p, size_t sz);
+
+/// Return the \p sz byte region starting at \p p, committed by
+/// \p vm_commit, to the reserved state. Both its pages and its charge against
+/// the system's commit limit are given back, and any advice applied to it
+/// (like \p vm_hugepage) is lost. It reads as zero once committed again.
+void vm_uncommit(void *p, size_t sz);
+
 /// Mark the \p sz byte region of memory starting at \p p as being a good
 /// candidate for huge pages.
 /// \pre sz must be a multiple of oscompat::page_size().
 void vm_hugepage(void *p, size_t sz);
 
+/// Prefer that pages in the \p sz byte region starting at \p p are backed by
+/// memory from the NUMA node of the CPU the calling thread is running on.
+/// Only supported on Linux.
+/// \pre p and sz must be multiples of oscompat::page_size().
+/// \return true if the policy was applied, false on error or if unsupported.
+bool vm_bind_local_numa(void *p, size_t sz);
+
 /// Mark the \p sz byte region of memory starting at \p p as not currently in
 /// use, so that the OS may free it. \p p must be page-aligned.
 void vm_unused(void *p, size_t sz);
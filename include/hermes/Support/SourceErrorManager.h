@@ -686,6 +686,11 @@ class CollectMessagesRAII {
   void setDiscardMessages(bool discardMessages) {
     discardMessages_ = discardMessages;
   }
+
+  /// \return whether any messages have been collected so far.
+  bool hasMessages() const {
+    return !storage_.empty();
+  }
 };
 
 } // namespace hermes
@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_SUPPORT_STRINGSEARCH_H
+#define HERMES_SUPPORT_STRINGSEARCH_H
+
+#include "hermes/Support/ByteScan.h"
+
+#include "llvh/Support/MathExtras.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace hermes {
+
+/// Substring search over arrays of char or char16_t. Every function takes a
+/// haystack [hay, hayEnd) and a needle [needle, needle + needleLen) of the
+/// same character type, and returns a pointer to the start of the match in
+/// the haystack, or nullptr if there is none. An empty needle matches at both
+/// ends of the haystack.
+///
+/// Single characters and short needles are found by scanning for their first
+/// and last characters, 16 bytes at a time where the target supports it (see
+/// ByteScan.h), and comparing the rest only at the candidate positions. Long
+/// needles use Boyer-Moore-Horspool, which skips ahead by up to the length of
+/// the needle after a mismatch.
+namespace stringsearch {
+
+/// Needles at least this long are searched for with Boyer-Moore-Horspool.
+constexpr size_t kHorspoolMinLength = 32;
+
+namespace detail {
+
+/// \return true if the \p n characters at \p a and \p b are equal.
+template <typename T>
+inline bool equalChars(const T *a, const T *b, size_t n) {
+  return std::memcmp(a, b, n * sizeof(T)) == 0;
+}
+
+#ifdef HERMES_BYTESCAN_VECTOR
+using bytescan::detail::Block;
+using bytescan::detail::load;
+
+/// Number of characters of type T in a Block.
+template <typename T>
+constexpr ptrdiff_t kLanes = bytescan::kBlockSize / sizeof(T);
+
+#if defined(HERMES_BYTESCAN_SSE2)
+/// Number of bits produced by laneBits() for every byte of a Block.
+constexpr unsigned kBitsPerByte = 1;
+
+inline Block eqChar(Block v, char c) {
+  return _mm_cmpeq_epi8(v, _mm_set1_epi8(c));
+}
+inline Block eqChar(Block v, char16_t c) {
+  return _mm_cmpeq_epi16(v, _mm_set1_epi16(static_cast<short>(c)));
+}
+inline Block andMask(Block a, Block b) {
+  return _mm_and_si128(a, b);
+}
+/// \return kBitsPerByte bits for every byte of \p mask, all set if the byte
+/// is set.
+inline uint64_t laneBits(Block mask) {
+  return static_cast<unsigned>(_mm_movemask_epi8(mask));
+}
+#elif defined(HERMES_BYTESCAN_NEON)
+constexpr unsigned kBitsPerByte = 4;
+
+inline Block eqChar(Block v, char c) {
+  return vceqq_u8(v, vdupq_n_u8(static_cast<uint8_t>(c)));
+}
+inline Block eqChar(Block v, char16_t c) {
+  return vreinterpretq_u8_u16(
+      vceqq_u16(vreinterpretq_u16_u8(v), vdupq_n_u16(c)));
+}
+inline Block andMask(Block a, Block b) {
+  return vandq_u8(a, b);
+}
+inline uint64_t laneBits(Block mask) {
+  return vget_lane_u64(
+      vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(mask), 4)), 0);
+}
+#endif
+
+/// Number of bits produced by laneBits() for every character of type T.
+template <typename T>
+constexpr unsigned kBitsPerLane = kBitsPerByte * sizeof(T);
+
+/// \return the bits of lane \p lane in the result of laneBits().
+template <typename T>
+inline uint64_t laneMask(ptrdiff_t lane) {
+  return ((uint64_t(1) << kBitsPerLane<T>) - 1) << (lane * kBitsPerLane<T>);
+}
+
+/// \return the bits of the lanes in which the character at \p p is \p first
+/// and the character at \p p + \p lastOffset is \p last.
+template <typename T>
+inline uint64_t candidates(const T *p, size_t lastOffset, T first, T last) {
+  return laneBits(andMask(
+      eqChar(load(reinterpret_cast<const char *>(p)), first),
+      eqChar(load(reinterpret_cast<const char *>(p + lastOffset)), last)));
+}
+#endif
+
+/// Boyer-Moore-Horspool search for a needle of at least two characters.
+/// Characters are hashed to their low byte, which only makes some shifts
+/// shorter than they could be.
+template <typename T>
+const T *
+findFirstHorspool(const T *hay, const T *hayEnd, const T *needle, size_t n) {
+  // How far the window can move when its last character is a given one.
+  uint32_t shift[256];
+  for (uint32_t &s : shift)
+    s = n;
+  for (size_t i = 0; i + 1 < n; ++i)
+    shift[static_cast<uint8_t>(needle[i])] = n - 1 - i;
+
+  const T last = needle[n - 1];
+  const size_t hayLen = hayEnd - hay;
+  for (size_t i = 0; i + n <= hayLen;) {
+    T c = hay[i + n - 1];
+    if (c == last && equalChars(hay + i, needle, n - 1))
+      return hay + i;
+    i += shift[static_cast<uint8_t>(c)];
+  }
+  return nullptr;
+}
+
+} // namespace detail
+
+/// \return the first occurrence of the needle in the haystack, or nullptr.
+template <typename T>
+const T *
+findFirst(const T *hay, const T *hayEnd, const T *needle, size_t needleLen) {
+  static_assert(
+      std::is_same<T, char>::value || std::is_same<T, char16_t>::value,
+      "only char and char16_t strings are supported");
+  const size_t n = needleLen;
+  if (n == 0)
+    return hay;
+  if (static_cast<size_t>(hayEnd - hay) < n)
+    return nullptr;
+  if (n >= kHorspoolMinLength)
+    return detail::findFirstHorspool(hay, hayEnd, needle, n);
+
+  const T first = needle[0];
+  const T last = needle[n - 1];
+  // The last position at which a match can start.
+  const T *lastStart = hayEnd - n;
+  const T *p = hay;
+#ifdef HERMES_BYTESCAN_VECTOR
+  constexpr ptrdiff_t kLanes = detail::kLanes<T>;
+  for (; lastStart - p >= kLanes - 1; p += kLanes) {
+    uint64_t bits = detail::candidates(p, n - 1, first, last);
+    while (bits) {
+      ptrdiff_t lane =
+          llvh::countTrailingZeros(bits) / detail::kBitsPerLane<T>;
+      if (detail::equalChars(p + lane + 1, needle + 1, n - 1))
+        return p + lane;
+      bits &= ~detail::laneMask<T>(lane);
+    }
+  }
+#endif
+  for (; p <= lastStart; ++p) {
+    if (p[0] == first && p[n - 1] == last &&
+        detail::equalChars(p + 1, needle + 1, n - 1))
+      return p;
+  }
+  return nullptr;
+}
+
+/// \return the last occurrence of the needle in the haystack, or nullptr.
+template <typename T>
+const T *
+findLast(const T *hay, const T *hayEnd, const T *needle, size_t needleLen) {
+  static_assert(
+      std::is_same<T, char>::value || std::is_same<T, char16_t>::value,
+      "only char and char16_t strings are supported");
+  const size_t n = needleLen;
+  if (n == 0)
+    return hayEnd;
+  if (static_cast<size_t>(hayEnd - hay) < n)
+    return nullptr;
+
+  const T first = needle[0];
+  const T last = needle[n - 1];
+  // One past the last position at which a match can start.
+  const T *p = hayEnd - n + 1;
+#ifdef HERMES_BYTESCAN_VECTOR
+  constexpr ptrdiff_t kLanes = detail::kLanes<T>;
+  for (; p - hay >= kLanes;) {
+    p -= kLanes;
+    uint64_t bits = detail::candidates(p, n - 1, first, last);
+    while (bits) {
+      ptrdiff_t lane = (63 - llvh::countLeadingZeros(bits)) /
+          detail::kBitsPerLane<T>;
+      if (detail::equalChars(p + lane + 1, needle + 1, n - 1))
+        return p + lane;
+      bits &= ~detail::laneMask<T>(lane);
+    }
+  }
+#endif
+  while (p != hay) {
+    --p;
+    if (p[0] == first && p[n - 1] == last &&
+        detail::equalChars(p + 1, needle + 1, n - 1))
+      return p;
+  }
+  return nullptr;
+}
+
+} // namespace stringsearch
+} // namespace hermes
+
+#endif // HERMES_SUPPORT_STRINGSEARCH_H
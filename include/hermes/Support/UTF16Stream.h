@@ -9,6 +9,7 @@
 #define HERMES_SUPPORT_UTF16STREAM_H
 
 #include <cstdint>
+#include <functional>
 
 #include "hermes/ADT/OwningArray.h"
 #include "llvh/ADT/ArrayRef.h"
@@ -17,6 +18,8 @@ namespace hermes {
 
 /// A stream of char16_t that can be constructed from either UTF16 or UTF8 data.
 /// If the input is UTF8, it's converted in chunks, to reduce peak memory usage.
+/// UTF8 input can also be read in chunks, as the stream needs it, so that it
+/// never has to be held in memory all at once.
 ///
 /// NOTE: This class is NOT GC-aware. Don't pass in data from GC-managed objects
 /// unless you can somehow guarantee the data will not move.
@@ -33,6 +36,16 @@ class UTF16Stream {
   /// then the stream will end at the first malformed character.
   explicit UTF16Stream(llvh::ArrayRef<uint8_t> utf8);
 
+  /// Reads up to \p size bytes of input into \p buffer, and returns how many
+  /// bytes it read. Returning 0 signals the end of the input.
+  using Reader = std::function<size_t(uint8_t *buffer, size_t size)>;
+
+  /// A stream that converts the UTF8 produced by \p reader to UTF16, calling
+  /// it whenever it needs more input. Characters may be split across reads.
+  /// If the input is not valid UTF8, then the stream will end at the first
+  /// malformed character.
+  explicit UTF16Stream(Reader reader);
+
   /// Movable but not copyable.
   UTF16Stream(UTF16Stream &&rhs) = default;
   UTF16Stream(UTF16Stream &rhs) = delete;
@@ -59,10 +72,31 @@ class UTF16Stream {
     return *this;
   }
 
+  /// Returns the UTF16 units from the current stream position that can be
+  /// consumed without converting more data. Callers can scan them in bulk,
+  /// and then consume them with skip().
+  /// \pre hasChar returns true.
+  llvh::ArrayRef<char16_t> available() const {
+    assert(cur_ != end_ && "must check hasChar");
+    return {cur_, end_};
+  }
+
+  /// Advances the stream by \p count UTF16 units, which must be available.
+  UTF16Stream &skip(size_t count) {
+    assert(count <= size_t(end_ - cur_) && "skipping unavailable data");
+    cur_ += count;
+    return *this;
+  }
+
  private:
   /// Tries to convert more data. Returns true if more data was converted.
   bool refill();
 
+  /// Moves the input left to convert to the front of input_, and calls
+  /// reader_ to fill the rest, until there is enough for any character or the
+  /// input has ended. Clears reader_ at the end of the input.
+  void readInput();
+
   /// The range of the input (if UTF16 input) or conversion buffer (if UTF8
   /// input) that is available to be consumed.
   const char16_t *cur_;
@@ -74,6 +108,11 @@ class UTF16Stream {
 
   /// The conversion buffer (if UTF8 input).
   OwningArray<char16_t> storage_;
+
+  /// The source of the input and the buffer it is read into, if the input is
+  /// read in chunks. reader_ is cleared once it has no more input.
+  Reader reader_;
+  OwningArray<uint8_t> input_;
 };
 
 } // namespace hermes
@@ -58,6 +58,16 @@ inline bool isAllASCII(const char *start, const char *end) {
   return isAllASCII((const uint8_t *)start, (const uint8_t *)end);
 }
 
+/// Overload for UTF-16, used to decide whether a string can be stored as
+/// ASCII.
+bool isAllASCII(const char16_t *start, const char16_t *end);
+
+/// Non-const UTF-16 pointers would otherwise match the generic template
+/// better than the overload above.
+inline bool isAllASCII(char16_t *start, char16_t *end) {
+  return isAllASCII((const char16_t *)start, (const char16_t *)end);
+}
+
 /// Decode a sequence of UTF8 encoded bytes when it is known that the first byte
 /// is a start of an UTF8 sequence.
 /// \tparam allowSurrogates when false, values in the surrogate range are
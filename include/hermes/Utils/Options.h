@@ -8,6 +8,9 @@
 #ifndef HERMES_UTILS_OPTIONS_H
 #define HERMES_UTILS_OPTIONS_H
 
+#include <cstdint>
+#include <vector>
+
 namespace hermes {
 
 enum OutputFormatKind {
@@ -59,6 +62,20 @@ struct BytecodeGenerationOptions {
   /// Strip the source map URL.
   bool stripSourceMappingURL = false;
 
+  /// Store function bodies compressed, to be decompressed as they are first
+  /// run.
+  bool compressBytecode = false;
+
+  /// Generate an object unit that hbc-link can combine with other units:
+  /// every instruction that refers to a string, function or literal buffer
+  /// uses its widest form, whatever the ID.
+  bool objectUnit = false;
+
+  /// IDs of functions whose bytecode and info are laid out first, in this
+  /// order, so that functions that run together share pages. The remaining
+  /// functions follow in ID order. IDs that don't exist are ignored.
+  std::vector<uint32_t> functionLayoutOrder;
+
   /* implicit */ BytecodeGenerationOptions(OutputFormatKind format)
       : format(format) {}
 
@@ -65,6 +65,9 @@ T *GCBase::makeA(uint32_t size, Args &&...args) {
 #ifdef HERMES_ENABLE_ALLOCATION_LOCATION_TRACES
   newAlloc(ptr, size);
 #endif
+  if (LLVM_UNLIKELY(allocationSampler_)) {
+    allocationSampler_->newAlloc(ptr, size);
+  }
   return ptr;
 }
 
@@ -669,6 +669,34 @@ class GCBase {
     size_t nextSample();
   };
 
+  /// An observer of a sampled subset of allocations. Unlike the trackers
+  /// above, it is available in all builds, and costs one counter decrement
+  /// per allocation while installed. It does not assign IDs to objects, so
+  /// the GC is never notified of moves and frees; a sampler that needs to
+  /// follow its sampled objects keeps them as weak roots.
+  class AllocationSampler {
+   public:
+    virtual ~AllocationSampler() = default;
+
+    /// Account for a new allocation of \p sz bytes at \p ptr, and sample it
+    /// if enough bytes have been allocated since the last sample.
+    void newAlloc(const GCCell *ptr, uint32_t sz) {
+      if (LLVM_LIKELY(sz < bytesUntilSample_)) {
+        bytesUntilSample_ -= sz;
+        return;
+      }
+      bytesUntilSample_ = sample(ptr, sz);
+    }
+
+   protected:
+    /// Record a sample for the new allocation of \p sz bytes at \p ptr.
+    /// \return the number of bytes to allocate before the next sample.
+    virtual size_t sample(const GCCell *ptr, uint32_t sz) = 0;
+
+    /// Bytes left to allocate before the next sample is taken.
+    size_t bytesUntilSample_{0};
+  };
+
   class IDTracker final {
    public:
     /// These are IDs that are reserved for special objects.
@@ -1083,8 +1111,11 @@ class GCBase {
 
   /// Creates a snapshot of the heap, which includes information about what
   /// objects exist, their sizes, and what they point to.
-  virtual void createSnapshot(llvh::raw_ostream &os) = 0;
-  void createSnapshot(GC *gc, llvh::raw_ostream &os);
+  /// \return An error code if the snapshot could not be completed, in which
+  ///   case the output is incomplete and must be discarded, else an empty
+  ///   error code.
+  virtual std::error_code createSnapshot(llvh::raw_ostream &os) = 0;
+  std::error_code createSnapshot(GC *gc, llvh::raw_ostream &os);
 
   /// Subclasses can override and add more specific native memory usage.
   virtual void snapshotAddGCNativeNodes(HeapSnapshot &snap);
@@ -1122,6 +1153,13 @@ class GCBase {
   /// will be gone.
   virtual void disableSamplingHeapProfiler(llvh::raw_ostream &os);
 
+  /// Install \p sampler to observe allocations, or remove the current one if
+  /// \p sampler is null. The caller retains ownership, and must remove the
+  /// sampler before destroying it.
+  void setAllocationSampler(AllocationSampler *sampler) {
+    allocationSampler_ = sampler;
+  }
+
   /// Default implementations for the external memory credit/debit APIs: do
   /// nothing.
   virtual void creditExternalMemory(GCCell *alloc, uint32_t size) {}
@@ -1582,6 +1620,9 @@ class GCBase {
   /// Whether to output GC statistics at the end of execution.
   bool recordGcStats_{false};
 
+  /// Whether heap snapshots should be taken in streaming mode.
+  const bool streamHeapSnapshots_;
+
   /// Whether or not a GC cycle is currently occurring.
   bool inGC_{false};
 
@@ -1627,6 +1668,9 @@ class GCBase {
   /// Attaches stack-traces to objects when enabled.
   SamplingAllocationLocationTracker samplingAllocationTracker_;
 
+  /// Observes a sampled subset of allocations, if non-null.
+  AllocationSampler *allocationSampler_{nullptr};
+
 #ifndef NDEBUG
   /// The number of reasons why no allocation is allowed in this heap right
   /// now.
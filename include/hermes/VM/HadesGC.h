@@ -94,7 +94,7 @@ class HadesGC final : public GCBase {
   void getHeapInfo(HeapInfo &info) override;
   void getHeapInfoWithMallocSize(HeapInfo &info) override;
   void getCrashManagerHeapInfo(CrashManager::HeapInformation &info) override;
-  void createSnapshot(llvh::raw_ostream &os) override;
+  std::error_code createSnapshot(llvh::raw_ostream &os) override;
   void snapshotAddGCNativeNodes(HeapSnapshot &snap) override;
   void snapshotAddGCNativeEdges(HeapSnapshot &snap) override;
   void enableHeapProfiler(
@@ -24,7 +24,9 @@
 
 #include <bitset>
 #include <chrono>
+#include <memory>
 #include <string>
+#include <system_error>
 
 namespace hermes {
 namespace vm {
@@ -98,11 +100,31 @@ class HeapSnapshot {
   using NodeIndex = uint32_t;
   using EdgeIndex = uint32_t;
 
-  HeapSnapshot(JSONEmitter &json, StackTracesTree *stackTracesTree);
+  /// Create a snapshot that is written to \p json.
+  /// \param streaming If true, bound the memory used by the snapshot:
+  ///   strings are written to a temporary file as they are seen and
+  ///   deduplicated only through a fixed-size cache, instead of being kept in
+  ///   memory until the end; and the index that maps node IDs to their
+  ///   position, which edges need, is spooled to a temporary file too. If a
+  ///   temporary file can't be created, that table is kept in memory as
+  ///   usual. If a temporary file can't be written or read back, the snapshot
+  ///   is abandoned; see checkSpools().
+  HeapSnapshot(
+      JSONEmitter &json,
+      StackTracesTree *stackTracesTree,
+      bool streaming = false);
 
   /// NOTE: this destructor writes to \p json.
   ~HeapSnapshot();
 
+  /// \return an error if a temporary file of a streaming snapshot could not
+  ///   be written or read back, else an empty error code. Once that happens
+  ///   the snapshot is abandoned: the destructor leaves the output
+  ///   unterminated, and the caller must stop adding to the snapshot and
+  ///   discard the output. Checked after the "nodes" section and once all
+  ///   other sections have been added.
+  std::error_code checkSpools();
+
   /// Opens \p section.  All sections between the next section to be closed
   ///(inclusive) and this one (exclusive) will be skipped by implicitly opening
   /// and closing them.
@@ -156,9 +178,23 @@ class HeapSnapshot {
   void emitAllocationTraceInfo();
 
  private:
+  class SpooledStringTable;
+  class SpooledNodeIndex;
+
   void emitMeta();
   size_t countFunctionTraceInfos();
-  void emitStrings();
+  /// Emit the "strings" section.
+  /// \return false if the snapshot was abandoned instead.
+  bool emitStrings();
+
+  /// \return the index of \p str in the "strings" section.
+  uint32_t internString(llvh::StringRef str);
+
+  /// Record that the node \p id is the next node in the "nodes" section.
+  void addNodeIndex(NodeID id);
+
+  /// \return the index of the node \p id in the "nodes" section.
+  NodeIndex getNodeIndex(NodeID id) const;
 
   /// The next section to be closed.  This class guarantees that all
   /// previous sections will have been written to the JSON emitter.
@@ -171,7 +207,16 @@ class HeapSnapshot {
   StackTracesTree *stackTracesTree_;
   llvh::DenseMap<NodeID, NodeIndex> nodeToIndex_;
   std::shared_ptr<StringSetVector> stringTable_;
+
+  /// In streaming mode, holds the strings that are not in stringTable_.
+  std::unique_ptr<SpooledStringTable> spooledStrings_;
+
+  /// In streaming mode, used instead of nodeToIndex_.
+  std::unique_ptr<SpooledNodeIndex> spooledNodes_;
   NodeIndex nodeCount_{0};
+
+  /// Set if a temporary file of a streaming snapshot failed.
+  std::error_code error_;
   HeapSizeType currEdgeCount_{0};
   struct TraceNodeStats {
     HeapSizeType count{0};
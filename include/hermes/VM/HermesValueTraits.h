@@ -111,6 +111,10 @@ template <typename T>
 class BufferedStringPrimitive;
 template <typename T>
 struct IsGCObject<BufferedStringPrimitive<T>> : public std::true_type {};
+template <typename T>
+class SlicedStringPrimitive;
+template <typename T>
+struct IsGCObject<SlicedStringPrimitive<T>> : public std::true_type {};
 
 template <size_t Size>
 struct EmptyCell;
@@ -213,6 +217,12 @@ struct HermesValueTraits<BufferedStringPrimitive<char>, true>
 template <>
 struct HermesValueTraits<BufferedStringPrimitive<char16_t>, true>
     : public StringTraitsImpl<BufferedStringPrimitive<char16_t>> {};
+template <>
+struct HermesValueTraits<SlicedStringPrimitive<char>, true>
+    : public StringTraitsImpl<SlicedStringPrimitive<char>> {};
+template <>
+struct HermesValueTraits<SlicedStringPrimitive<char16_t>, true>
+    : public StringTraitsImpl<SlicedStringPrimitive<char16_t>> {};
 
 template <class T>
 struct HermesValueTraits<T, true> {
@@ -104,6 +104,26 @@ class Interpreter {
   static PseudoHandle<>
   getByValTransientFast(Runtime *runtime, Handle<> base, Handle<> nameHandle);
 
+  /// Fast path for OpCode::GetByVal when \p base is a JSArray or a typed array
+  /// and \p name is an array index within its elements. The element is read
+  /// directly, without going through JSObject::getComputed_RJS().
+  /// \return the element, or Empty if the fast path doesn't apply: holes,
+  ///   out of bounds indexes, detached buffers and other kinds of objects.
+  static HermesValue
+  getByValObjectFast(Runtime *runtime, JSObject *base, HermesValue name);
+
+  /// Fast path for OpCode::PutByVal when \p base is a JSArray or a typed array
+  /// and \p name is an array index within its elements. Only writes that
+  /// cannot run user code or fail are handled: the array element must already
+  /// exist and the array must not be frozen, and the value written to a typed
+  /// array must be a number and its buffer must be attached.
+  /// \return true if \p value was written, false to take the slow path.
+  static bool putByValObjectFast(
+      Runtime *runtime,
+      JSObject *base,
+      HermesValue name,
+      HermesValue value);
+
   /// Implement OpCode::GetByVal when the base is not an object.
   static CallResult<PseudoHandle<>>
   getByValTransient_RJS(Runtime *runtime, Handle<> base, Handle<> name);
@@ -8,10 +8,13 @@
 #ifndef HERMES_VM_JSARRAY_H
 #define HERMES_VM_JSARRAY_H
 
+#include "hermes/Support/Conversions.h"
 #include "hermes/VM/IterationKind.h"
 #include "hermes/VM/JSObject.h"
 #include "hermes/VM/SegmentedArray.h"
 
+#include <cmath>
+
 namespace hermes {
 namespace vm {
 
@@ -75,10 +78,36 @@ class ArrayImpl : public JSObject {
     assert(
         index >= self->beginIndex_ && index < self->endIndex_ &&
         "array index out of range");
+    self->updateElementsKind(value);
     self->getIndexedStorage(runtime)->set(
         index - self->beginIndex_, value, &runtime->getHeap());
   }
 
+  /// Overwrite the element at index \p index, but only if that can be done
+  /// without any of the checks of a full property write: the array has fast
+  /// index properties, is not frozen, and already has a non-empty element at
+  /// \p index. Writing to a hole has to look at the prototype chain, so it is
+  /// left to the caller's slow path.
+  /// \return true if the element was written.
+  static bool trySetExistingElementAt(
+      ArrayImpl *self,
+      Runtime *runtime,
+      size_type index,
+      HermesValue value) {
+    if (LLVM_UNLIKELY(
+            !self->flags_.fastIndexProperties || self->flags_.frozen ||
+            index < self->beginIndex_ || index >= self->endIndex_)) {
+      return false;
+    }
+    auto *storage = self->getIndexedStorage(runtime);
+    if (LLVM_UNLIKELY(storage->at(index - self->beginIndex_).isEmpty())) {
+      return false;
+    }
+    self->updateElementsKind(value);
+    storage->set(index - self->beginIndex_, value, &runtime->getHeap());
+    return true;
+  }
+
   /// Set the element at index \p index to empty. This does not affect the
   /// storage size or array length.
   /// \return true if the operation succeeded (which is always in this class).
@@ -99,6 +128,12 @@ class ArrayImpl : public JSObject {
     return endIndex_;
   }
 
+  /// \return what the elements in the storage are known to be. Holes aren't
+  /// accounted for, any element can still be empty.
+  ElementsKind getElementsKind() const {
+    return static_cast<ElementsKind>(flags_.elementsKind);
+  }
+
   /// Return the value at index \p index, or \c empty if the index is not
   /// contained in the storage.
   const HermesValue at(Runtime *runtime, size_type index) const {
@@ -219,6 +254,24 @@ class ArrayImpl : public JSObject {
   }
 
  private:
+  /// Make the elements kind general enough to include \p value, which is
+  /// about to be stored.
+  void updateElementsKind(HermesValue value) {
+    if (LLVM_LIKELY(getElementsKind() == ElementsKind::Generic))
+      return;
+    if (LLVM_UNLIKELY(!value.isNumber())) {
+      flags_.elementsKind = static_cast<uint32_t>(ElementsKind::Generic);
+      return;
+    }
+    if (getElementsKind() == ElementsKind::Int32) {
+      double d = value.getNumber();
+      if (LLVM_UNLIKELY(
+              truncateToInt32(d) != d || (d == 0 && std::signbit(d)))) {
+        flags_.elementsKind = static_cast<uint32_t>(ElementsKind::Double);
+      }
+    }
+  }
+
   /// The first index contained in the storage.
   uint32_t beginIndex_{0};
   /// One past the last index contained in the storage.
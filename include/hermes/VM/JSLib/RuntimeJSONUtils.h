@@ -11,6 +11,10 @@
 #include "hermes/Support/UTF16Stream.h"
 #include "hermes/VM/Runtime.h"
 
+#include "llvh/ADT/StringRef.h"
+
+#include <functional>
+
 namespace hermes {
 namespace vm {
 
@@ -31,6 +35,21 @@ CallResult<HermesValue> runtimeJSONStringify(
     Handle<> replacer,
     Handle<> space);
 
+/// Receives the output of runtimeJSONStringifyToSink, as UTF-8.
+using JSONStringifySink = std::function<void(llvh::StringRef)>;
+
+/// Like runtimeJSONStringify, but passes the result to \p sink in pieces as
+/// it is produced instead of creating a string, so that only a bounded part
+/// of it is held in memory at a time. \p sink must not run JavaScript.
+/// On an exception, \p sink may already have received part of the result.
+/// \return false, without calling \p sink, if the result would be undefined.
+CallResult<bool> runtimeJSONStringifyToSink(
+    Runtime *runtime,
+    Handle<> value,
+    Handle<> replacer,
+    Handle<> space,
+    const JSONStringifySink &sink);
+
 } // namespace vm
 } // namespace hermes
 
@@ -92,6 +92,19 @@ union DefinePropertyFlags {
   }
 };
 
+/// What the values stored in the indexed storage of an array are known to be.
+/// The kind only ever becomes more general, in the order below, except that it
+/// starts over when the storage is emptied. Holes are not part of the kind:
+/// readers of the storage still have to check for empty values.
+enum class ElementsKind : uint8_t {
+  /// Every element is an integral number in the int32 range, other than -0.
+  Int32,
+  /// Every element is a number.
+  Double,
+  /// Elements can be any value.
+  Generic,
+};
+
 /// Flags associated with an object.
 struct ObjectFlags {
   /// New properties cannot be added.
@@ -127,7 +140,11 @@ struct ObjectFlags {
   /// This flag indicates this is a proxy exotic Object
   uint32_t proxyObject : 1;
 
-  static constexpr unsigned kHashWidth = 24;
+  /// The \c ElementsKind of the values in the indexed storage, if the object
+  /// is an array. It is maintained by \c ArrayImpl.
+  uint32_t elementsKind : 2;
+
+  static constexpr unsigned kHashWidth = 22;
   /// A non-zero object id value, assigned lazily. It is 0 before it is
   /// assigned. If an object started out as lazy, the objectID is the lazy
   /// object index used to identify when it gets initialized.
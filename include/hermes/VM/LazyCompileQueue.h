@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_VM_LAZYCOMPILEQUEUE_H
+#define HERMES_VM_LAZYCOMPILEQUEUE_H
+
+#ifndef HERMESVM_LEAN
+
+#include "hermes/BCGen/HBC/Bytecode.h"
+#include "hermes/IRGen/IRGen.h"
+
+#include "llvh/ADT/DenseMap.h"
+#include "llvh/ADT/Optional.h"
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace hermes {
+namespace vm {
+
+/// Compile the lazy function described by \p lazyData into a new
+/// BytecodeModule. The caller must have exclusive use of lazyData->context.
+std::unique_ptr<hbc::BytecodeModule> compileLazyFunction(
+    hbc::LazyCompilationData *lazyData);
+
+/// Compiles lazy functions on a background thread before they are first
+/// called, so that the JS thread doesn't stall to compile them.
+///
+/// A function is predicted to run soon when a closure is first created for
+/// it: this is when function declarations are hoisted into a scope that is
+/// being entered, and when function expressions (such as module factories)
+/// are evaluated. Predictions are compiled in the order they were made. The
+/// JS thread claims the result with getOrCompile() on the first call, waiting
+/// if the function is being compiled at that moment, and compiling it itself
+/// if it hasn't been reached yet.
+///
+/// All lazy functions compiled from one source share a Context, which is not
+/// thread safe. The queue therefore compiles one function at a time, and any
+/// other use of the Context of a lazy function must hold lockContexts().
+class LazyCompileQueue {
+ public:
+  /// Maximum number of functions waiting to be compiled. Later predictions
+  /// are dropped while the queue is full.
+  static constexpr size_t kMaxPending = 64;
+
+  /// Maximum number of compiled functions waiting to be claimed. The oldest
+  /// one is discarded to make room for a new one.
+  static constexpr size_t kMaxReady = 64;
+
+  /// \return a new queue with its worker thread started, or nullptr if this
+  /// platform doesn't support threads.
+  static std::unique_ptr<LazyCompileQueue> create();
+
+  /// Stops the worker thread, abandoning any functions still pending.
+  ~LazyCompileQueue();
+
+  /// Predict that the function described by \p lazyData will be called soon.
+  /// This only takes the queue lock briefly, and never waits for a
+  /// compilation.
+  void enqueue(const hbc::LazyCompilationData &lazyData);
+
+  /// \return the compiled module for \p lazyData, either precompiled by the
+  /// worker, or compiled on the calling thread now.
+  std::unique_ptr<hbc::BytecodeModule> getOrCompile(
+      hbc::LazyCompilationData *lazyData);
+
+  /// Wait until the worker has compiled every pending function.
+  void waitUntilIdle() {
+    std::unique_lock<std::mutex> lk{mutex_};
+    cond_.wait(lk, [this] { return pending_.empty() && !compiling_; });
+  }
+
+  /// \return a lock that gives the caller exclusive use of the Contexts of
+  /// lazy functions.
+  std::unique_lock<std::mutex> lockContexts() {
+    return std::unique_lock<std::mutex>{compileMutex_};
+  }
+
+  /// \return the number of functions that were precompiled and then claimed.
+  size_t getNumHits() const {
+    std::lock_guard<std::mutex> lk{mutex_};
+    return numHits_;
+  }
+
+ private:
+  /// Identifies a lazy function by its Context and the start of its source.
+  /// Queued and compiled functions keep their Context alive, so the key
+  /// can't be reused by a different function while it is in the queue.
+  using Key = std::pair<const Context *, const char *>;
+
+  static Key getKey(const hbc::LazyCompilationData &lazyData) {
+    return {lazyData.context.get(), lazyData.span.Start.getPointer()};
+  }
+
+  LazyCompileQueue() = default;
+
+  /// Compile pending functions until the queue is destroyed.
+  void workerLoop();
+
+  /// Protects all the fields below, except the worker thread itself.
+  mutable std::mutex mutex_;
+
+  /// Signalled when a job is added, when a compilation finishes, and when the
+  /// worker should exit.
+  std::condition_variable cond_;
+
+  /// Functions waiting to be compiled, oldest first.
+  std::deque<hbc::LazyCompilationData> pending_;
+
+  /// The function being compiled by the worker, if any.
+  llvh::Optional<Key> compiling_;
+
+  /// Compiled functions waiting to be claimed, along with their Context, and
+  /// the order they finished.
+  llvh::DenseMap<
+      Key,
+      std::pair<std::shared_ptr<Context>, std::unique_ptr<hbc::BytecodeModule>>>
+      ready_;
+  std::deque<Key> readyOrder_;
+
+  /// Number of getOrCompile() calls that found the function already compiled
+  /// or being compiled.
+  size_t numHits_{0};
+
+  /// Whether the worker thread should exit.
+  bool shouldExit_{false};
+
+  /// Held for the duration of every compilation, on either thread.
+  std::mutex compileMutex_;
+
+  std::thread worker_;
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMESVM_LEAN
+
+#endif // HERMES_VM_LAZYCOMPILEQUEUE_H
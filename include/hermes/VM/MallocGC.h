@@ -218,7 +218,7 @@ class MallocGC final : public GCBase {
 #endif
 
   /// Same as in superclass GCBase.
-  virtual void createSnapshot(llvh::raw_ostream &os) override;
+  virtual std::error_code createSnapshot(llvh::raw_ostream &os) override;
 
   void writeBarrier(const GCHermesValue *, HermesValue) {}
   void writeBarrier(const GCSmallHermesValue *, SmallHermesValue) {}
@@ -102,6 +102,10 @@ class CodeCoverageProfiler {
   /// \return executed function information for this profiler.
   std::vector<CodeCoverageProfiler::FuncInfo> getExecutedFunctionsLocal();
 
+  /// \return the IDs of the functions in \p module that were executed, in
+  /// the order they were first executed.
+  std::vector<uint32_t> getExecutedFunctionIDsInOrder(RuntimeModule *module);
+
  private:
   static std::unordered_set<CodeCoverageProfiler *> &allProfilers();
   static std::mutex &globalMutex();
@@ -120,7 +124,7 @@ class CodeCoverageProfiler {
 
   /// Protect any local state of this code coverage profiler that can be
   /// accessed by the static members. For now, this is only used to protect
-  /// executedFuncBitsArrayMap_.
+  /// executedFuncBitsArrayMap_ and executedFuncOrderMap_.
   std::mutex localMutex_;
 
   /// RuntimeModule => executed function bits array map.
@@ -129,6 +133,10 @@ class CodeCoverageProfiler {
   /// RuntimeModule.
   llvh::DenseMap<RuntimeModule *, std::vector<bool>> executedFuncBitsArrayMap_;
 
+  /// RuntimeModule => IDs of its executed functions, in the order they were
+  /// first executed.
+  llvh::DenseMap<RuntimeModule *, std::vector<uint32_t>> executedFuncOrderMap_;
+
   /// Domains to keep its RuntimeModules alive. Will be marked by markRoots().
   /// Does not require localMutex_ to be held since it is only modified and read
   /// by the runtime.
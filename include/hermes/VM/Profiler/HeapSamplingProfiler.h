@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_VM_PROFILER_HEAPSAMPLINGPROFILER_H
+#define HERMES_VM_PROFILER_HEAPSAMPLINGPROFILER_H
+
+#include "hermes/Public/DebuggerTypes.h"
+#include "hermes/Support/StringSetVector.h"
+#include "hermes/VM/GCBase.h"
+#include "hermes/VM/WeakRef.h"
+
+#include "llvh/ADT/DenseMap.h"
+#include "llvh/Support/raw_ostream.h"
+
+#include <random>
+#include <vector>
+
+namespace hermes {
+namespace vm {
+
+class CodeBlock;
+class Runtime;
+
+/// A sampling heap profiler that is cheap enough to leave running in
+/// production builds.
+///
+/// Unlike GCBase::SamplingAllocationLocationTracker, it does not depend on
+/// the StackTracesTree (which must be updated on every call and return while
+/// enabled), nor on HERMES_ENABLE_ALLOCATION_LOCATION_TRACES. Between samples
+/// the only cost is one counter decrement per allocation, and nothing is done
+/// when unsampled objects move or die. Sampled objects are kept as weak
+/// roots, so each collection visits every live sample once. Allocations are
+/// sampled as a Poisson process over allocated bytes, and on each sample the
+/// JS stack is walked up to a maximum depth. Stacks are interned in a prefix
+/// tree, and every distinct (CodeBlock, bytecode offset) pair is symbolized
+/// only once.
+///
+/// Memory use is bounded: at most maxLiveSamples sampled objects are tracked
+/// at a time, and the prefix tree holds at most maxStackNodes nodes. Samples
+/// beyond the first bound are dropped; stacks beyond the second are truncated
+/// to their longest known prefix.
+///
+/// Sampled objects are forgotten by the collection that frees them, so the
+/// profile written by writeChromeProfile() describes the sampled allocations
+/// that survived the last collection, and it can be written repeatedly while
+/// the profiler runs.
+///
+/// All methods must be called on the mutator thread, or while the world is
+/// stopped.
+class HeapSamplingProfiler final : public GCBase::AllocationSampler {
+ public:
+  static constexpr size_t kDefaultMaxStackDepth = 64;
+  static constexpr size_t kDefaultMaxLiveSamples = 1 << 16;
+  static constexpr size_t kDefaultMaxStackNodes = 1 << 16;
+
+  /// Create a profiler for \p runtime that takes a sample about once every
+  /// \p samplingInterval allocated bytes. If \p seed is non-negative, it is
+  /// used to seed the random sampling, giving deterministic output.
+  /// The profiler does not install itself; see
+  /// Runtime::enableHeapSamplingProfiler.
+  HeapSamplingProfiler(
+      Runtime *runtime,
+      size_t samplingInterval,
+      size_t maxStackDepth = kDefaultMaxStackDepth,
+      size_t maxLiveSamples = kDefaultMaxLiveSamples,
+      size_t maxStackNodes = kDefaultMaxStackNodes,
+      int64_t seed = -1);
+
+  /// Update the sampled objects that moved, and forget those that died.
+  void markWeakRoots(WeakRootAcceptor &acceptor);
+
+  /// Write the sampled allocations that are still alive to \p os, in the
+  /// format of Chrome's .heapprofile files.
+  void writeChromeProfile(llvh::raw_ostream &os);
+
+  /// \return the number of sampled allocations that are still alive.
+  size_t numLiveSamples() const;
+
+  /// \return the number of samples that were dropped because maxLiveSamples
+  /// was reached.
+  size_t numDroppedSamples() const;
+
+ protected:
+  size_t sample(const GCCell *ptr, uint32_t sz) override;
+
+ private:
+  /// A symbolized stack frame.
+  struct Frame {
+    StringSetVector::size_type functionName;
+    StringSetVector::size_type scriptName;
+    ::facebook::hermes::debugger::ScriptID scriptID;
+    /// 1-based line and column.
+    int32_t lineNo;
+    int32_t columnNo;
+  };
+
+  /// A node of the stack prefix tree. Node 0 is the root.
+  struct StackNode {
+    uint32_t parent;
+    uint32_t frame;
+  };
+
+  struct Sample {
+    /// The sampled object, or null once it is freed.
+    WeakRoot<GCCell> cell;
+    /// The size of the object when it was allocated.
+    uint32_t size;
+    /// The StackNode of the innermost captured frame.
+    uint32_t stack;
+    /// Order in which the sample was taken.
+    uint64_t ordinal;
+  };
+
+  /// \return the number of bytes to allocate before taking the next sample.
+  size_t nextSampleDistance();
+
+  /// Walk the JS stack and \return the StackNode for it.
+  uint32_t captureStack();
+
+  /// \return the index of the Frame for \p offset in \p codeBlock, or None if
+  /// the frame is not known yet and the frame table is full.
+  OptValue<uint32_t> internFrame(const CodeBlock *codeBlock, uint32_t offset);
+
+  Runtime *const runtime_;
+  const size_t maxStackDepth_;
+  const size_t maxLiveSamples_;
+  const size_t maxStackNodes_;
+
+  std::minstd_rand randomEngine_;
+  std::exponential_distribution<double> dist_;
+
+  /// Strings referenced by frames_.
+  StringSetVector strings_;
+  StringSetVector::size_type rootFunctionID_;
+  StringSetVector::size_type anonymousFunctionID_;
+
+  std::vector<Frame> frames_;
+  llvh::DenseMap<std::pair<const CodeBlock *, uint32_t>, uint32_t> frameIDs_;
+
+  std::vector<StackNode> stackNodes_;
+  /// Map from (parent StackNode, Frame) to the child StackNode.
+  llvh::DenseMap<std::pair<uint32_t, uint32_t>, uint32_t> stackChildren_;
+
+  /// Live samples, in the order they were taken.
+  std::vector<Sample> samples_;
+  size_t numDroppedSamples_{0};
+  uint64_t nextOrdinal_{1};
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_PROFILER_HEAPSAMPLINGPROFILER_H
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_VM_PROFILER_JSPERFMAP_H
+#define HERMES_VM_PROFILER_JSPERFMAP_H
+
+#include "hermes/VM/CallResult.h"
+#include "hermes/VM/GCBase.h"
+
+#include "llvh/ADT/DenseMap.h"
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#if defined(HERMESVM_JS_PERF_MAP) && defined(__linux__) && \
+    (defined(__x86_64__) || defined(__aarch64__))
+#define HERMESVM_JSPERFMAP_SUPPORTED
+#endif
+
+namespace hermes {
+namespace vm {
+
+class CodeBlock;
+class Runtime;
+
+/// Makes interpreted JS functions visible to Linux perf and other native
+/// profilers that understand perf map files.
+///
+/// Normally the interpreter handles a JS to JS call without leaving its
+/// dispatch loop, so a native profiler sees a single interpretFunction frame
+/// for a whole stack of JS functions. When a Runtime has a JSPerfMap, every JS
+/// call instead re-enters the interpreter through a small trampoline that is
+/// generated for the callee's CodeBlock. Each trampoline is described by a line
+/// in /tmp/perf-<pid>.map, which perf consults to symbolize code that does not
+/// belong to any mapped binary. This is only available in builds with
+/// HERMESVM_JS_PERF_MAP, so that other builds don't check for it on every call.
+///
+/// Symbols are named "JS:name(file:line:column)" after the start of the
+/// function when debug info is available, and "JS:name(segment:offset)" after
+/// its bytecode virtual offset otherwise. These are the funcLine/funcColumn
+/// and funcVirtAddr fields of SamplingProfiler's trace events, so native
+/// samples can be joined with (or symbolicated like) JS samples.
+///
+/// Trampolines outlive their CodeBlock, since they may still be on the stack
+/// when it is freed, and their memory is released when the JSPerfMap is
+/// destroyed with its Runtime. Their lines stay in the map, so perf can still
+/// symbolize samples taken in them, and their addresses stay reserved, so
+/// that no later trampoline or other code is mapped where a stale line would
+/// misname it.
+class JSPerfMap {
+ public:
+  /// \return true if trampolines can be generated in this build and on this
+  /// platform.
+  static bool isSupported();
+
+  /// \return the default path of the perf map for the current process.
+  static std::string getPerfMapPath();
+
+  /// Create a perf map for \p runtime, appending to \p path, or to
+  /// getPerfMapPath() if it is empty.
+  /// \return nullptr if this platform is not supported, or the map could not
+  /// be opened.
+  static std::unique_ptr<JSPerfMap> create(
+      Runtime *runtime,
+      const std::string &path = std::string());
+
+  ~JSPerfMap();
+
+  /// Interpret \p codeBlock from within its trampoline.
+  CallResult<HermesValue> interpretFunction(CodeBlock *codeBlock);
+
+  /// Forget the trampoline for \p codeBlock, which is being freed. A later
+  /// CodeBlock at the same address gets a new trampoline and symbol.
+  void forgetCodeBlock(const CodeBlock *codeBlock) {
+    trampolines_.erase(codeBlock);
+  }
+
+  /// \return the perf symbol name for \p codeBlock.
+  static std::string getSymbolName(
+      const CodeBlock *codeBlock,
+      GCBase::GCCallbacks *callbacks);
+
+ private:
+  /// A trampoline calls \c fn(ctx) from a native frame of its own.
+  using Trampoline = void (*)(void *ctx, void (*fn)(void *));
+
+  JSPerfMap(Runtime *runtime, FILE *file) : runtime_(runtime), file_(file) {}
+
+  /// \return the trampoline for \p codeBlock, generating it and adding it to
+  /// the perf map if necessary. \return nullptr if executable memory could
+  /// not be allocated.
+  Trampoline getTrampoline(CodeBlock *codeBlock);
+
+  Runtime *const runtime_;
+
+  /// The perf map being appended to.
+  FILE *const file_;
+
+  llvh::DenseMap<const CodeBlock *, Trampoline> trampolines_;
+
+  /// Every executable chunk of trampolines, to be released on destruction.
+  /// New trampolines are written to the last one.
+  std::vector<char *> chunks_;
+
+  /// The number of bytes used in the last chunk.
+  size_t chunkUsed_{0};
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMES_VM_PROFILER_JSPERFMAP_H
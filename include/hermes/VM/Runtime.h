@@ -82,6 +82,9 @@ class ScopedNativeDepthReducer;
 class ScopedNativeDepthTracker;
 class ScopedNativeCallFrame;
 class SamplingProfiler;
+class HeapSamplingProfiler;
+class JSPerfMap;
+class LazyCompileQueue;
 class CodeCoverageProfiler;
 struct MockedEnvironment;
 struct StackTracesTree;
@@ -114,7 +117,8 @@ enum class PropCacheID {
 class CrashTraceImpl {
   /// Record of the last executed instruction.
   struct Record {
-    /// Offset from start of bytecode file.
+    /// Offset from start of bytecode file, or for compressed bytecode, from
+    /// the start of its decompressed function bodies.
     uint32_t ipOffset;
     /// Opcode of last executed instruction.
     inst::OpCode opCode;
@@ -721,6 +725,34 @@ class Runtime : public HandleRootOwner,
   /// CallResult<HermesValue> or the thrown object in 'thrownObject'.
   CallResult<HermesValue> interpretFunction(CodeBlock *newCodeBlock);
 
+  /// \return true if every JS to JS call recursively enters the interpreter
+  /// through interpretFunction(), so that each JS frame has a native frame of
+  /// its own. This is the case with HERMESVM_PROFILER_EXTERN and JSPerfMap.
+  /// It is a constant false unless one of them is enabled in the build, and
+  /// never changes once JS has started running.
+  bool hasNativeFramePerJSCall() const {
+#if defined(HERMESVM_PROFILER_EXTERN)
+    return true;
+#elif defined(HERMESVM_JS_PERF_MAP)
+    return jsPerfMap_ != nullptr;
+#else
+    return false;
+#endif
+  }
+
+  /// \return the perf map for JS functions, or nullptr if it isn't enabled.
+  JSPerfMap *getJSPerfMap() {
+    return jsPerfMap_.get();
+  }
+
+#ifndef HERMESVM_LEAN
+  /// \return the queue that compiles lazy functions in the background, or
+  /// nullptr if it isn't enabled.
+  LazyCompileQueue *getLazyCompileQueue() {
+    return lazyCompileQueue_.get();
+  }
+#endif
+
 #ifdef HERMES_ENABLE_DEBUGGER
   /// Single-step the provided function, update the interpreter state.
   ExecutionStatus stepFunction(InterpreterState &state);
@@ -852,6 +884,17 @@ class Runtime : public HandleRootOwner,
     return hasIntl_;
   }
 
+  /// \return the maximum number of frames recorded in an Error's stack trace.
+  uint32_t getErrorStackCaptureDepth() const {
+    return errorStackCaptureDepth_;
+  }
+
+  /// \return true if function names for an Error's stack trace are only
+  /// looked up when the stack is read.
+  bool hasLazyErrorStackNames() const {
+    return lazyErrorStackNames_;
+  }
+
   bool useJobQueue() const {
     return getVMExperimentFlags() & experiments::JobQueue;
   }
@@ -1115,6 +1158,13 @@ class Runtime : public HandleRootOwner,
   // Signal-based I/O tracking. Slows down execution.
   const bool trackIO_;
 
+  /// Maximum number of frames recorded in an Error's stack trace.
+  const uint32_t errorStackCaptureDepth_;
+
+  /// Set to true if names in Error stack traces come from the bytecode when
+  /// the stack is read, rather than from the callees when it is recorded.
+  const bool lazyErrorStackNames_;
+
   /// This value can be passed to the runtime as flags to test experimental
   /// features. Each experimental feature decides how to interpret these
   /// values. Generally each experiment is associated with one or more bits of
@@ -1126,6 +1176,7 @@ class Runtime : public HandleRootOwner,
   friend class GCScope;
   friend class HandleBase;
   friend class Interpreter;
+  friend class JSPerfMap;
   friend class RuntimeModule;
   friend class MarkRootsPhaseTimer;
   friend struct RuntimeOffsets;
@@ -1475,10 +1526,42 @@ class Runtime : public HandleRootOwner,
   /// Disable the heap sampling profiler and flush the results out to \p os.
   void disableSamplingHeapProfiler(llvh::raw_ostream &os);
 
+  /// Enable the production heap sampling profiler, which works in all builds
+  /// and, unlike enableSamplingHeapProfiler, does not track every call and
+  /// return. See HeapSamplingProfiler for the meaning of the parameters.
+  /// If it is already enabled, its samples are discarded and it is restarted.
+  void enableHeapSamplingProfiler(
+      size_t samplingInterval,
+      size_t maxStackDepth,
+      size_t maxLiveSamples,
+      int64_t seed = -1);
+
+  /// Write the live samples of the production heap sampling profiler to \p os
+  /// as a Chrome .heapprofile. The profiler keeps running.
+  /// \return false if the profiler is not enabled.
+  bool writeHeapSamplingProfile(llvh::raw_ostream &os);
+
+  /// Disable the production heap sampling profiler, discarding its samples.
+  void disableHeapSamplingProfiler();
+
  private:
   void popCallStackImpl();
   void pushCallStackImpl(const CodeBlock *codeBlock, const inst::Inst *ip);
   std::unique_ptr<StackTracesTree> stackTracesTree_;
+
+  /// The production heap sampling profiler, if enabled.
+  std::unique_ptr<HeapSamplingProfiler> heapSamplingProfiler_;
+
+  /// Native trampolines and perf map for JS functions, if enabled by
+  /// RuntimeConfig::withEnableJSPerfMap(). Set before any JS runs, and never
+  /// changed afterwards.
+  std::unique_ptr<JSPerfMap> jsPerfMap_;
+
+#ifndef HERMESVM_LEAN
+  /// Background compiler for lazy functions, if enabled by
+  /// RuntimeConfig::withBackgroundLazyCompilation().
+  std::unique_ptr<LazyCompileQueue> lazyCompileQueue_;
+#endif
 };
 
 /// StackRuntime is meant to be used whenever a Runtime should be allocated on
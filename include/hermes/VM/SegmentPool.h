@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_VM_SEGMENTPOOL_H
+#define HERMES_VM_SEGMENTPOOL_H
+
+#include "hermes/VM/StorageProvider.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace hermes {
+namespace vm {
+
+/// A bounded cache of segment storage that outlives the Runtimes using it, so
+/// that a process creating and destroying many Runtimes does not have to map,
+/// fault in and unmap fresh segments every time.
+///
+/// Returned storage is kept mapped. Up to maxResident() of the most recently
+/// returned storages keep their physical pages, so the next Runtime can reuse
+/// them without page faults; storages that exceed that bound, or that have
+/// been idle in the pool for longer than idleTimeout(), are released to the OS
+/// with oscompat::vm_unused. At most maxPooled() storages are cached; beyond
+/// that, returned storage is unmapped.
+///
+/// Idle storages are released by a background thread, which is started the
+/// first time a storage is returned while the idle timeout is finite, so that
+/// an idle process gives its memory back without any further allocation. The
+/// destructor stops the thread, but the process-wide pool is never destroyed,
+/// so its thread runs until the process exits.
+///
+/// All methods are thread-safe.
+class SegmentPool {
+ public:
+  static constexpr size_t kDefaultMaxPooled = 64;
+  static constexpr size_t kDefaultMaxResident = 8;
+  static constexpr std::chrono::milliseconds kDefaultIdleTimeout{5000};
+
+  SegmentPool() = default;
+  ~SegmentPool();
+
+  SegmentPool(const SegmentPool &) = delete;
+  SegmentPool &operator=(const SegmentPool &) = delete;
+
+  /// \return the process-wide pool. It is never destroyed, so storage may be
+  /// returned to it at any point during process teardown. Its limits are
+  /// process-wide too, so only the host should change them.
+  static SegmentPool &getInstance();
+
+  /// Take a storage of AlignedStorage::size() bytes from the pool, or map a
+  /// new one if the pool is empty. The storage is named \p name on platforms
+  /// that support it.
+  llvh::ErrorOr<void *> acquire(const char *name);
+
+  /// Return \p storage, previously obtained from acquire(), to the pool.
+  void release(void *storage);
+
+  /// Release the physical pages of all pooled storages to the OS, keeping the
+  /// address space for reuse.
+  void releaseIdle();
+
+  /// Unmap all pooled storages.
+  void clear();
+
+  /// Change the bounds of the pool. Storages that no longer fit are released
+  /// or unmapped immediately. An \p idleTimeout of
+  /// std::chrono::milliseconds::max() means storages are never released for
+  /// being idle.
+  void setLimits(
+      size_t maxPooled,
+      size_t maxResident,
+      std::chrono::milliseconds idleTimeout);
+
+  size_t maxPooled() const;
+  size_t maxResident() const;
+  std::chrono::milliseconds idleTimeout() const;
+
+  /// \return the number of storages currently cached by the pool.
+  size_t numPooled() const;
+
+  /// \return the number of pooled storages that may still be backed by
+  /// physical pages.
+  size_t numResident() const;
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  /// A pooled storage that still has its physical pages.
+  struct ResidentEntry {
+    void *storage;
+    /// When the storage was returned to the pool.
+    Clock::time_point since;
+  };
+
+  /// Move resident storages that exceed maxResident_ or have been idle for
+  /// longer than idleTimeout_ as of \p now to released_, and unmap storages
+  /// that exceed maxPooled_.
+  /// \pre mtx_ is held.
+  void trimLocked(Clock::time_point now);
+
+  /// Start idleThread_ if there are resident storages to time out, or wake it
+  /// to recompute its deadline.
+  /// \pre mtx_ is held.
+  void scheduleIdleReleaseLocked();
+
+  /// Body of idleThread_: sleep until the oldest resident storage times out,
+  /// and release it.
+  void idleLoop();
+
+  mutable std::mutex mtx_;
+
+  /// Signalled when idleThread_ has to recompute its deadline or exit.
+  std::condition_variable idleCond_;
+
+  /// Releases resident storages once they time out. Not started until needed.
+  std::thread idleThread_;
+
+  /// Set by the destructor to stop idleThread_.
+  bool shouldExit_{false};
+
+  size_t maxPooled_{kDefaultMaxPooled};
+  size_t maxResident_{kDefaultMaxResident};
+  std::chrono::milliseconds idleTimeout_{kDefaultIdleTimeout};
+
+  /// Resident storages, ordered by the time they were returned, oldest first.
+  std::vector<ResidentEntry> resident_;
+
+  /// Storages whose pages have been released with vm_unused.
+  std::vector<void *> released_;
+};
+
+/// A PooledStorageProvider takes storage from a SegmentPool and returns
+/// deleted storage to it, instead of mapping and unmapping storage itself.
+class PooledStorageProvider final : public StorageProvider {
+  SegmentPool &pool_;
+
+ public:
+  explicit PooledStorageProvider(
+      SegmentPool &pool = SegmentPool::getInstance())
+      : pool_(pool) {}
+
+ protected:
+  llvh::ErrorOr<void *> newStorageImpl(const char *name) override;
+
+  void deleteStorageImpl(void *storage) override;
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif
@@ -32,6 +32,17 @@ class StorageProvider {
   /// Provide storage via malloc.
   static std::unique_ptr<StorageProvider> mallocProvider();
 
+  /// Provide storage from a single virtual address range of \p size bytes
+  /// (rounded up to a multiple of AlignedStorage::size()) that is reserved up
+  /// front and advised to be backed by huge pages. Deleted storage is kept
+  /// mapped and handed out again by later allocations. If \p bindLocalNUMA is
+  /// true, the range prefers memory from the NUMA node of the creating thread.
+  /// If the range cannot be reserved or is exhausted, segments are mmap'ed
+  /// individually as with mmapProvider().
+  static std::unique_ptr<StorageProvider> contiguousVAProvider(
+      size_t size,
+      bool bindLocalNUMA = false);
+
   /// @}
 
   /// Create a new segment memory space.
@@ -35,6 +35,8 @@ class StringPrimitive : public VariableSizeRuntimeCell {
   friend class StringView;
   template <typename T>
   friend class BufferedStringPrimitive;
+  template <typename T>
+  friend class SlicedStringPrimitive;
 
   friend llvh::raw_ostream &operator<<(
       llvh::raw_ostream &OS,
@@ -136,6 +138,15 @@ class StringPrimitive : public VariableSizeRuntimeCell {
   static constexpr uint32_t CONCAT_STRING_MIN_SIZE =
       std::max(256u, EXTERNAL_STRING_MIN_SIZE);
 
+  /// Slices of this size or larger will use SlicedStringPrimitive, which
+  /// references the characters of the sliced string instead of copying them.
+  static constexpr uint32_t SLICED_STRING_MIN_SIZE = 256;
+
+  /// A SlicedStringPrimitive is only created if its parent is at most this
+  /// many times longer than the slice, to bound the amount of memory a small
+  /// slice can keep alive.
+  static constexpr uint32_t SLICED_STRING_MAX_PARENT_RATIO = 4;
+
   static bool classof(const GCCell *cell) {
     return kindInRange(
         cell->getKind(),
@@ -767,6 +778,111 @@ inline bool isBufferedStringPrimitive(const GCCell *cell) {
       cell->getKind() == CellKind::BufferedASCIIStringPrimitiveKind;
 }
 
+/// An immutable JavaScript primitive consisting of a reference to another
+/// string, its parent, together with an offset and a length. This is the
+/// result of StringPrimitive::slice() for long slices, which would otherwise
+/// copy their characters.
+///
+/// The parent is never itself a SlicedStringPrimitive: slicing a slice
+/// references the parent of the original slice, so the characters are always
+/// one indirection away. The raw pointer is recomputed from the parent on
+/// every access, since the GC may move the parent.
+///
+/// A slice keeps its whole parent alive. StringPrimitive::slice() only
+/// creates one when the parent is at most SLICED_STRING_MAX_PARENT_RATIO
+/// times longer than the slice, and copies the characters otherwise.
+template <typename T>
+class SlicedStringPrimitive final : public StringPrimitive {
+  friend class IdentifierTable;
+  friend class StringBuilder;
+  friend class StringPrimitive;
+  friend void SlicedASCIIStringPrimitiveBuildMeta(
+      const GCCell *cell,
+      Metadata::Builder &mb);
+  friend void SlicedUTF16StringPrimitiveBuildMeta(
+      const GCCell *cell,
+      Metadata::Builder &mb);
+
+  /// \return the cell kind for this string.
+  static constexpr CellKind getCellKind() {
+    return std::is_same<T, char16_t>::value
+        ? CellKind::SlicedUTF16StringPrimitiveKind
+        : CellKind::SlicedASCIIStringPrimitiveKind;
+  }
+
+ public:
+  static bool classof(const GCCell *cell) {
+    return cell->getKind() == SlicedStringPrimitive::getCellKind();
+  }
+
+#ifdef UNIT_TEST
+  /// Expose the parent string for unit tests.
+  StringPrimitive *testGetParent() const {
+    return getParent();
+  }
+#endif
+
+ private:
+  static const VTable vt;
+
+ public:
+  /// Construct a SlicedStringPrimitive referring to the \p length characters
+  /// of \p parent starting at \p offset.
+  SlicedStringPrimitive(
+      Runtime *runtime,
+      Handle<StringPrimitive> parent,
+      uint32_t offset,
+      uint32_t length)
+      : StringPrimitive(
+            runtime,
+            &vt,
+            sizeof(SlicedStringPrimitive<T>),
+            length),
+        offset_(offset) {
+    parentHV_.set(
+        HermesValue::encodeStringValue(*parent), &runtime->getHeap());
+    assert(
+        !vmisa<SlicedStringPrimitive<T>>(*parent) &&
+        "the parent of a slice cannot be a slice");
+    assert(
+        offset + length <= parent->getStringLength() &&
+        "slice exceeds its parent");
+  }
+
+ private:
+  /// Allocate a SlicedStringPrimitive referring to the \p length characters
+  /// of \p parent starting at \p offset.
+  /// \pre \p parent is not a SlicedStringPrimitive.
+  static PseudoHandle<StringPrimitive> create(
+      Runtime *runtime,
+      Handle<StringPrimitive> parent,
+      uint32_t offset,
+      uint32_t length);
+
+  /// \return a const pointer to the first character of the string.
+  const T *getRawPointer() const {
+    return getParent()->template castToPointer<T>() + offset_;
+  }
+
+  /// \return the string whose characters this string refers to.
+  StringPrimitive *getParent() const {
+    return vmcast<StringPrimitive>(parentHV_);
+  }
+
+  /// Reference to the parent string. Like in BufferedStringPrimitive, this is
+  /// a GCHermesValue instead of a GCPointer.
+  GCHermesValue parentHV_;
+
+  /// Index of the first character of this string in the parent.
+  uint32_t offset_;
+};
+
+/// \return true if this is one of the SlicedStringPrimitive classes.
+inline bool isSlicedStringPrimitive(const GCCell *cell) {
+  return cell->getKind() == CellKind::SlicedUTF16StringPrimitiveKind ||
+      cell->getKind() == CellKind::SlicedASCIIStringPrimitiveKind;
+}
+
 /// This function is not part of the API and is not supposed to be called
 /// directly. It is used internally by StringPrimitive::concat. It is used
 /// to handle the case when the result string exceeds the minimal length for
@@ -847,6 +963,25 @@ const VTable BufferedStringPrimitive<T>::vt = VTable(
 using BufferedUTF16StringPrimitive = BufferedStringPrimitive<char16_t>;
 using BufferedASCIIStringPrimitive = BufferedStringPrimitive<char>;
 
+template <typename T>
+const VTable SlicedStringPrimitive<T>::vt = VTable(
+    SlicedStringPrimitive<T>::getCellKind(),
+    0,
+    nullptr, // finalize.
+    nullptr, // markWeak.
+    nullptr, // mallocSize
+    nullptr,
+    nullptr, // externalMemorySize
+    VTable::HeapSnapshotMetadata{
+        HeapSnapshot::NodeType::String,
+        SlicedStringPrimitive<T>::_snapshotNameImpl,
+        nullptr,
+        nullptr,
+        nullptr});
+
+using SlicedUTF16StringPrimitive = SlicedStringPrimitive<char16_t>;
+using SlicedASCIIStringPrimitive = SlicedStringPrimitive<char>;
+
 //===----------------------------------------------------------------------===//
 // StringPrimitive inline methods.
 
@@ -984,6 +1119,8 @@ inline const char *StringPrimitive::castToASCIIPointer() const {
     return vmcast<DynamicUniquedASCIIStringPrimitive>(this)->getRawPointer();
   } else if (vmisa<DynamicASCIIStringPrimitive>(this)) {
     return vmcast<DynamicASCIIStringPrimitive>(this)->getRawPointer();
+  } else if (vmisa<SlicedASCIIStringPrimitive>(this)) {
+    return vmcast<SlicedASCIIStringPrimitive>(this)->getRawPointer();
   } else {
     return vmcast<BufferedASCIIStringPrimitive>(this)->getRawPointer();
   }
@@ -996,6 +1133,8 @@ inline const char16_t *StringPrimitive::castToUTF16Pointer() const {
     return vmcast<DynamicUniquedUTF16StringPrimitive>(this)->getRawPointer();
   } else if (vmisa<DynamicUTF16StringPrimitive>(this)) {
     return vmcast<DynamicUTF16StringPrimitive>(this)->getRawPointer();
+  } else if (vmisa<SlicedUTF16StringPrimitive>(this)) {
+    return vmcast<SlicedUTF16StringPrimitive>(this)->getRawPointer();
   } else {
     return vmcast<BufferedUTF16StringPrimitive>(this)->getRawPointer();
   }
@@ -1051,6 +1190,8 @@ inline bool StringPrimitive::isASCII() const {
           CellKind::DynamicASCIIStringPrimitiveKind,
           CellKind::BufferedUTF16StringPrimitiveKind,
           CellKind::BufferedASCIIStringPrimitiveKind,
+          CellKind::SlicedUTF16StringPrimitiveKind,
+          CellKind::SlicedASCIIStringPrimitiveKind,
           CellKind::DynamicUniquedUTF16StringPrimitiveKind,
           CellKind::DynamicUniquedASCIIStringPrimitiveKind,
           CellKind::ExternalUTF16StringPrimitiveKind,
@@ -1070,6 +1211,8 @@ inline bool StringPrimitive::isExternal() const {
           CellKind::DynamicASCIIStringPrimitiveKind,
           CellKind::BufferedUTF16StringPrimitiveKind,
           CellKind::BufferedASCIIStringPrimitiveKind,
+          CellKind::SlicedUTF16StringPrimitiveKind,
+          CellKind::SlicedASCIIStringPrimitiveKind,
           CellKind::DynamicUniquedUTF16StringPrimitiveKind,
           CellKind::DynamicUniquedASCIIStringPrimitiveKind,
           CellKind::ExternalUTF16StringPrimitiveKind,
@@ -8,11 +8,14 @@
 #include "hermes/BCGen/HBC/BytecodeDataProvider.h"
 #include "hermes/BCGen/HBC/BytecodeFileFormat.h"
 #include "hermes/Support/ErrorHandling.h"
+#include "hermes/Support/LZ4.h"
 #include "hermes/Support/OSCompat.h"
 
 #include "llvh/Support/MathExtras.h"
 #include "llvh/Support/SHA1.h"
 
+#include <algorithm>
+
 namespace hermes {
 namespace hbc {
 
@@ -195,6 +198,25 @@ void align(uint8_t *&buf, uint32_t alignment = BYTECODE_ALIGNMENT) {
   buf = (uint8_t *)llvh::alignAddr(buf, alignment);
 }
 
+/// \return the chunk in \p chunks that holds \p offset of the uncompressed
+/// function bodies, or nullptr if there is none.
+const CompressedChunkEntry *findCompressedChunk(
+    llvh::ArrayRef<CompressedChunkEntry> chunks,
+    uint32_t offset) {
+  auto it = std::upper_bound(
+      chunks.begin(),
+      chunks.end(),
+      offset,
+      [](uint32_t offset, const CompressedChunkEntry &chunk) {
+        return offset < chunk.uncompressedOffset;
+      });
+  if (it == chunks.begin() ||
+      offset - (it - 1)->uncompressedOffset >= (it - 1)->uncompressedSize) {
+    return nullptr;
+  }
+  return it - 1;
+}
+
 } // namespace
 
 template <bool Mutable>
@@ -304,10 +326,35 @@ bool BytecodeFileFields<Mutable>::populateFromBuffer(
       f.functionSourceTable = castArrayRef<std::pair<uint32_t, uint32_t>>(
           buf, h->functionSourceCount, end);
     }
+    void visitCompressedChunkTable() {
+      align(buf);
+      const auto *tableHeader = castData<CompressedChunkTableHeader>(buf);
+      f.compressedChunks =
+          castArrayRef<CompressedChunkEntry>(buf, tableHeader->count, end);
+    }
   };
 
   BytecodeFileFieldsPopulator populator{*this, buffer.data(), buffer.end()};
   visitBytecodeSegmentsInOrder(populator);
+
+  if (header->options.compressedBytecode) {
+    populator.visitCompressedChunkTable();
+    uint64_t uncompressedOffset = 0;
+    for (const CompressedChunkEntry &chunk : compressedChunks) {
+      if (chunk.uncompressedOffset != uncompressedOffset ||
+          chunk.uncompressedOffset % sizeof(uint32_t) != 0 ||
+          chunk.offset > header->fileLength ||
+          chunk.size > header->fileLength - chunk.offset ||
+          // Bound the buffer allocated for the chunk before it is decoded.
+          chunk.uncompressedSize > chunk.size * lz4::kMaxExpansionRatio) {
+        if (outError) {
+          *outError = "Malformed compressed bytecode chunk table";
+        }
+        return false;
+      }
+      uncompressedOffset += chunk.uncompressedSize;
+    }
+  }
   return true;
 }
 
@@ -571,6 +618,33 @@ BCProviderFromBuffer::BCProviderFromBuffer(
   cjsModuleTable_ = fields.cjsModuleTable;
   cjsModuleTableStatic_ = fields.cjsModuleTableStatic;
   functionSourceTable_ = fields.functionSourceTable;
+  compressedChunks_ = fields.compressedChunks;
+  if (!compressedChunks_.empty()) {
+    decompressedChunks_.resize(compressedChunks_.size());
+  }
+}
+
+const uint8_t *BCProviderFromBuffer::getDecompressedBytecode(
+    uint32_t offset) const {
+  const hbc::CompressedChunkEntry *chunk =
+      findCompressedChunk(compressedChunks_, offset);
+  if (LLVM_UNLIKELY(!chunk))
+    hermes_fatal("function offset past end of compressed bytecode");
+
+  // Decompressed chunks are kept until the provider is destroyed, since code
+  // blocks point directly into them.
+  std::lock_guard<std::mutex> lk{decompressMutex_};
+  std::unique_ptr<uint8_t[]> &data =
+      decompressedChunks_[chunk - compressedChunks_.begin()];
+  if (!data) {
+    std::unique_ptr<uint8_t[]> out{new uint8_t[chunk->uncompressedSize]};
+    if (!lz4::decompress(
+            {bufferPtr_ + chunk->offset, chunk->size},
+            {out.get(), chunk->uncompressedSize}))
+      hermes_fatal("corrupt compressed bytecode");
+    data = std::move(out);
+  }
+  return data.get() + (offset - chunk->uncompressedOffset);
 }
 
 llvh::ArrayRef<uint8_t> BCProviderFromBuffer::getEpilogue() const {
@@ -707,6 +781,14 @@ void BCProviderFromBuffer::prefetch(llvh::ArrayRef<uint8_t> aref) {
       ? RuntimeFunctionHeader(reinterpret_cast<const hbc::FunctionHeader *>(
             aref.data() + globalSmall.getLargeHeaderOffset()))
       : RuntimeFunctionHeader(&globalSmall);
+  if (!fields.compressedChunks.empty()) {
+    // Prefetch the compressed chunk with the global function in it instead.
+    if (const CompressedChunkEntry *chunk =
+            findCompressedChunk(fields.compressedChunks, global.offset())) {
+      prefetchRegion(aref.data() + chunk->offset, chunk->size);
+    }
+    return;
+  }
   prefetchRegion(aref.data() + global.offset(), global.bytecodeSizeInBytes());
 }
 
@@ -212,6 +212,13 @@ bool hermes::hbc::convertBytecodeToForm(
   if (!fields.populateFromBuffer(buffer, outError, sourceForm)) {
     return false;
   }
+  if (!fields.compressedChunks.empty()) {
+    // The instructions to adjust are not accessible in place.
+    if (outError) {
+      *outError = "Cannot convert compressed bytecode";
+    }
+    return false;
+  }
 
   if (targetForm == BytecodeForm::Delta) {
     BytecodeFormConverter<BytecodeForm::Delta> conv(buffer, fields, sourceForm);
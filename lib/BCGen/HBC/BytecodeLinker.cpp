@@ -0,0 +1,675 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/BCGen/HBC/BytecodeLinker.h"
+
+#include "hermes/BCGen/HBC/ConsecutiveStringStorage.h"
+#include "hermes/BCGen/HBC/DebugInfo.h"
+#include "hermes/BCGen/HBC/SerializedLiteralGenerator.h"
+#include "hermes/BCGen/HBC/UniquingFilenameTable.h"
+#include "hermes/BCGen/HBC/UniquingStringLiteralTable.h"
+#include "hermes/Inst/Inst.h"
+#include "hermes/Inst/InstDecode.h"
+#include "hermes/Support/OptValue.h"
+
+#include "llvh/ADT/DenseSet.h"
+#include "llvh/ADT/StringMap.h"
+#include "llvh/ADT/Twine.h"
+#include "llvh/Support/Endian.h"
+#include "llvh/Support/MathExtras.h"
+
+#include <limits>
+
+using namespace hermes;
+using namespace hermes::hbc;
+using namespace hermes::inst;
+using SLG = hermes::hbc::SerializedLiteralGenerator;
+
+namespace {
+
+/// Append the tag of a sequence of \p seqLength literals of kind \p tag to
+/// \p buff, in the format read by SerializedLiteralParserBase.
+void appendTag(
+    std::vector<unsigned char> &buff,
+    SLG::TagType tag,
+    unsigned seqLength) {
+  if (seqLength > 15) {
+    buff.push_back((tag | 0x80) | (seqLength >> 8));
+    buff.push_back(seqLength & 0xff);
+  } else {
+    buff.push_back(tag + seqLength);
+  }
+}
+
+/// Append \p value to \p buff in little-endian format.
+template <typename T>
+void appendValue(std::vector<unsigned char> &buff, T value) {
+  buff.resize(buff.size() + sizeof(T));
+  llvh::support::endian::write<T, 1>(
+      buff.data() + buff.size() - sizeof(T),
+      value,
+      llvh::support::endianness::little);
+}
+
+/// Links object units into one module. See linkBytecodeUnits().
+class BytecodeLinker {
+  /// Where the IDs of one unit land in the linked module.
+  struct UnitMapping {
+    /// The linked ID of each string in the unit.
+    std::vector<uint32_t> strings;
+    /// The linked ID of each filename in the unit's debug info.
+    std::vector<uint32_t> filenames;
+    /// The linked ID of the unit's first function.
+    uint32_t firstFunction{0};
+    /// The linked ID of the unit's first regexp.
+    uint32_t firstRegExp{0};
+  };
+
+  llvh::ArrayRef<const BCProviderBase *> units_;
+  const BytecodeGenerationOptions &options_;
+  std::string *outError_;
+
+  std::vector<UnitMapping> mappings_;
+
+  /// The merged string table.
+  StringLiteralTable strings_;
+
+  /// The merged literal buffers, and the offset of each encoded literal
+  /// sequence in them, so that identical sequences are stored once.
+  std::vector<unsigned char> arrayBuffer_;
+  std::vector<unsigned char> objKeyBuffer_;
+  std::vector<unsigned char> objValBuffer_;
+  llvh::StringMap<uint32_t> arrayBufferOffsets_;
+  llvh::StringMap<uint32_t> objKeyBufferOffsets_;
+  llvh::StringMap<uint32_t> objValBufferOffsets_;
+
+  /// Report \p msg about unit \p unit. \return false, for convenience.
+  bool error(unsigned unit, const llvh::Twine &msg) {
+    *outError_ = ("unit " + llvh::Twine(unit) + ": " + msg).str();
+    return false;
+  }
+
+  /// Call \p callback with each string of \p bc, and whether it is an
+  /// identifier, in ID order.
+  template <typename F>
+  static void forEachString(const BCProviderBase &bc, F callback) {
+    std::string utf8Storage;
+    uint32_t id = 0;
+    for (StringKind::Entry kindEntry : bc.getStringKinds()) {
+      bool isIdentifier = kindEntry.kind() != StringKind::String;
+      for (uint32_t i = 0; i < kindEntry.count(); ++i, ++id) {
+        callback(
+            getStringFromEntry(
+                bc.getStringTableEntry(id),
+                bc.getStringStorage(),
+                utf8Storage),
+            isIdentifier);
+      }
+    }
+  }
+
+  /// \return the linked ID of string \p id of unit \p unit, or None if the
+  /// unit has no such string.
+  OptValue<uint32_t> mapString(unsigned unit, uint32_t id) const {
+    const auto &strings = mappings_[unit].strings;
+    if (id >= strings.size())
+      return llvh::None;
+    return strings[id];
+  }
+
+  /// \return the linked ID of function \p id of unit \p unit, or None if the
+  /// unit has no such function.
+  OptValue<uint32_t> mapFunction(unsigned unit, uint32_t id) const {
+    if (id >= units_[unit]->getFunctionCount())
+      return llvh::None;
+    return mappings_[unit].firstFunction + id;
+  }
+
+  /// \return the linked ID of regexp \p id of unit \p unit, or None if the
+  /// unit has no such regexp.
+  OptValue<uint32_t> mapRegExp(unsigned unit, uint32_t id) const {
+    if (id >= units_[unit]->getRegExpTable().size())
+      return llvh::None;
+    return mappings_[unit].firstRegExp + id;
+  }
+
+  /// Check that every unit can be linked.
+  bool checkUnits();
+
+  /// Build the merged string table, and the string mapping of every unit.
+  void mergeStrings();
+
+  /// Re-encode the \p count literals at \p offset in \p src, a literal buffer
+  /// of unit \p unit, with linked string IDs, and add them to \p dst.
+  /// \return their offset in \p dst, or None if the literals are malformed.
+  OptValue<uint32_t> linkLiterals(
+      unsigned unit,
+      llvh::ArrayRef<unsigned char> src,
+      uint32_t offset,
+      uint32_t count,
+      std::vector<unsigned char> &dst,
+      llvh::StringMap<uint32_t> &dstOffsets);
+
+  /// Rewrite the operands of the instructions in \p opcodes, the bytecode of
+  /// a function of unit \p unit, with linked IDs. Set \p jumpTableBytes to
+  /// the size of the function's jump tables.
+  bool linkInstructions(
+      unsigned unit,
+      llvh::MutableArrayRef<opcode_atom_t> opcodes,
+      uint32_t &jumpTableBytes);
+
+  /// Link function \p id of unit \p unit into \p functions, adding its
+  /// debug info to \p debugGen if it is not null.
+  bool linkFunction(
+      unsigned unit,
+      uint32_t id,
+      std::vector<std::unique_ptr<BytecodeFunction>> &functions,
+      DebugInfoGenerator *debugGen);
+
+ public:
+  BytecodeLinker(
+      llvh::ArrayRef<const BCProviderBase *> units,
+      const BytecodeGenerationOptions &options,
+      std::string *outError)
+      : units_(units), options_(options), outError_(outError) {}
+
+  std::unique_ptr<BytecodeModule> link();
+};
+
+bool BytecodeLinker::checkUnits() {
+  if (units_.empty()) {
+    *outError_ = "no units to link";
+    return false;
+  }
+  for (unsigned unit = 0; unit < units_.size(); ++unit) {
+    const BCProviderBase &bc = *units_[unit];
+    BytecodeOptions bcOptions = bc.getBytecodeOptions();
+    if (bcOptions.cjsModulesStaticallyResolved)
+      return error(unit, "statically resolved requires can't be linked");
+    if (bc.getCJSModuleTable().empty())
+      return error(unit, "no CommonJS modules, compile it with -commonjs");
+    if (bcOptions.staticBuiltins !=
+        units_[0]->getBytecodeOptions().staticBuiltins)
+      return error(unit, "static builtins differ from unit 0");
+  }
+  return true;
+}
+
+void BytecodeLinker::mergeStrings() {
+  UniquingStringLiteralAccumulator accumulator;
+  for (const BCProviderBase *bc : units_) {
+    forEachString(*bc, [&accumulator](llvh::StringRef str, bool isIdentifier) {
+      accumulator.addString(str, isIdentifier);
+    });
+  }
+  strings_ = UniquingStringLiteralAccumulator::toTable(
+      std::move(accumulator), options_.optimizationEnabled);
+
+  for (unsigned unit = 0; unit < units_.size(); ++unit) {
+    auto &ids = mappings_[unit].strings;
+    ids.reserve(units_[unit]->getStringCount());
+    forEachString(*units_[unit], [this, &ids](llvh::StringRef str, bool) {
+      ids.push_back(strings_.getStringID(str));
+    });
+  }
+}
+
+OptValue<uint32_t> BytecodeLinker::linkLiterals(
+    unsigned unit,
+    llvh::ArrayRef<unsigned char> src,
+    uint32_t offset,
+    uint32_t count,
+    std::vector<unsigned char> &dst,
+    llvh::StringMap<uint32_t> &dstOffsets) {
+  std::vector<unsigned char> encoded;
+  std::vector<unsigned char> seq;
+  SLG::TagType lastTag = SLG::NullTag;
+  unsigned seqLength = 0;
+  auto flush = [&]() {
+    if (seqLength) {
+      appendTag(encoded, lastTag, seqLength);
+      encoded.insert(encoded.end(), seq.begin(), seq.end());
+      seq.clear();
+      seqLength = 0;
+    }
+  };
+
+  uint32_t pos = offset;
+  while (count) {
+    if (pos >= src.size())
+      return llvh::None;
+    unsigned char tagByte = src[pos++];
+    SLG::TagType tag = tagByte & SLG::TagMask;
+    uint32_t length = tagByte & 0x0f;
+    if (tagByte & 0x80) {
+      if (pos >= src.size())
+        return llvh::None;
+      length = (length << 8) | src[pos++];
+    }
+    if (length == 0)
+      return llvh::None;
+    length = std::min(length, count);
+    count -= length;
+
+    unsigned payloadSize = 0;
+    switch (tag) {
+      case SLG::NullTag:
+      case SLG::TrueTag:
+      case SLG::FalseTag:
+        break;
+      case SLG::NumberTag:
+        payloadSize = sizeof(double);
+        break;
+      case SLG::IntegerTag:
+      case SLG::LongStringTag:
+        payloadSize = sizeof(uint32_t);
+        break;
+      case SLG::ShortStringTag:
+        payloadSize = sizeof(uint16_t);
+        break;
+      case SLG::ByteStringTag:
+        payloadSize = sizeof(uint8_t);
+        break;
+      default:
+        return llvh::None;
+    }
+    if ((uint64_t)pos + (uint64_t)length * payloadSize > src.size())
+      return llvh::None;
+
+    for (uint32_t i = 0; i < length; ++i, pos += payloadSize) {
+      const unsigned char *payload = src.data() + pos;
+      SLG::TagType newTag = tag;
+      OptValue<uint32_t> stringID = llvh::None;
+      using llvh::support::endianness;
+      using llvh::support::endian::read;
+      if (tag == SLG::LongStringTag) {
+        stringID = read<uint32_t, 1>(payload, endianness::little);
+      } else if (tag == SLG::ShortStringTag) {
+        stringID = read<uint16_t, 1>(payload, endianness::little);
+      } else if (tag == SLG::ByteStringTag) {
+        stringID = read<uint8_t, 1>(payload, endianness::little);
+      }
+      if (stringID) {
+        stringID = mapString(unit, *stringID);
+        if (!stringID)
+          return llvh::None;
+        newTag = *stringID > UINT16_MAX ? SLG::LongStringTag
+            : *stringID > UINT8_MAX     ? SLG::ShortStringTag
+                                        : SLG::ByteStringTag;
+      }
+
+      if (newTag != lastTag || seqLength == SLG::SequenceMax) {
+        flush();
+        lastTag = newTag;
+      }
+      ++seqLength;
+
+      if (!stringID) {
+        seq.insert(seq.end(), payload, payload + payloadSize);
+      } else if (newTag == SLG::LongStringTag) {
+        appendValue<uint32_t>(seq, *stringID);
+      } else if (newTag == SLG::ShortStringTag) {
+        appendValue<uint16_t>(seq, *stringID);
+      } else {
+        appendValue<uint8_t>(seq, *stringID);
+      }
+    }
+  }
+  flush();
+
+  auto result = dstOffsets.try_emplace(
+      llvh::StringRef((const char *)encoded.data(), encoded.size()),
+      dst.size());
+  if (result.second)
+    dst.insert(dst.end(), encoded.begin(), encoded.end());
+  return result.first->second;
+}
+
+bool BytecodeLinker::linkInstructions(
+    unsigned unit,
+    llvh::MutableArrayRef<opcode_atom_t> opcodes,
+    uint32_t &jumpTableBytes) {
+  const BCProviderBase &bc = *units_[unit];
+  jumpTableBytes = 0;
+
+  // Replace the operand \p field with \p value, a linked ID. The operands are
+  // unaligned, so we can't take references to them.
+#define LINK_OPERAND(field, value)                                       \
+  do {                                                                   \
+    OptValue<uint32_t> linked = (value);                                 \
+    if (!linked)                                                         \
+      return error(unit, "invalid operand in " + getOpCodeString(op));   \
+    if (*linked > std::numeric_limits<decltype(field)>::max())           \
+      return error(                                                      \
+          unit,                                                          \
+          getOpCodeString(op) +                                          \
+              " has a narrow operand, compile it with -object-unit");    \
+    field = *linked;                                                     \
+  } while (0)
+
+  for (uint32_t offset = 0; offset < opcodes.size();) {
+    auto *ip = reinterpret_cast<Inst *>(&opcodes[offset]);
+    OpCode op = ip->opCode;
+    if (op >= OpCode::_last ||
+        offset + getInstSize(op) > (uint64_t)opcodes.size()) {
+      return error(unit, "malformed bytecode");
+    }
+
+#define OPERAND_STRING_ID(name, operandNumber)                          \
+  if (op == OpCode::name) {                                             \
+    LINK_OPERAND(                                                       \
+        ip->i##name.op##operandNumber,                                  \
+        mapString(unit, ip->i##name.op##operandNumber));                \
+  }
+#include "hermes/BCGen/HBC/BytecodeList.def"
+
+    switch (op) {
+#define CASE_FUNCTION_ID(name)                                           \
+  case OpCode::name:                                                     \
+    LINK_OPERAND(ip->i##name.op3, mapFunction(unit, ip->i##name.op3));   \
+    break;
+      CASE_FUNCTION_ID(CreateClosure)
+      CASE_FUNCTION_ID(CreateClosureLongIndex)
+      CASE_FUNCTION_ID(CreateGeneratorClosure)
+      CASE_FUNCTION_ID(CreateGeneratorClosureLongIndex)
+      CASE_FUNCTION_ID(CreateAsyncClosure)
+      CASE_FUNCTION_ID(CreateAsyncClosureLongIndex)
+      CASE_FUNCTION_ID(CreateGenerator)
+      CASE_FUNCTION_ID(CreateGeneratorLongIndex)
+      CASE_FUNCTION_ID(CallDirect)
+      CASE_FUNCTION_ID(CallDirectLongIndex)
+#undef CASE_FUNCTION_ID
+
+#define CASE_ARRAY_BUFFER(name)                                     \
+  case OpCode::name:                                                \
+    LINK_OPERAND(                                                   \
+        ip->i##name.op4,                                            \
+        linkLiterals(                                               \
+            unit,                                                   \
+            bc.getArrayBuffer(),                                    \
+            ip->i##name.op4,                                        \
+            ip->i##name.op3,                                        \
+            arrayBuffer_,                                           \
+            arrayBufferOffsets_));                                  \
+    break;
+      CASE_ARRAY_BUFFER(NewArrayWithBuffer)
+      CASE_ARRAY_BUFFER(NewArrayWithBufferLong)
+#undef CASE_ARRAY_BUFFER
+
+#define CASE_OBJECT_BUFFER(name)                                    \
+  case OpCode::name:                                                \
+    LINK_OPERAND(                                                   \
+        ip->i##name.op4,                                            \
+        linkLiterals(                                               \
+            unit,                                                   \
+            bc.getObjectKeyBuffer(),                                \
+            ip->i##name.op4,                                        \
+            ip->i##name.op3,                                        \
+            objKeyBuffer_,                                          \
+            objKeyBufferOffsets_));                                 \
+    LINK_OPERAND(                                                   \
+        ip->i##name.op5,                                            \
+        linkLiterals(                                               \
+            unit,                                                   \
+            bc.getObjectValueBuffer(),                              \
+            ip->i##name.op5,                                        \
+            ip->i##name.op3,                                        \
+            objValBuffer_,                                          \
+            objValBufferOffsets_));                                 \
+    break;
+      CASE_OBJECT_BUFFER(NewObjectWithBuffer)
+      CASE_OBJECT_BUFFER(NewObjectWithBufferLong)
+#undef CASE_OBJECT_BUFFER
+
+      case OpCode::CreateRegExp:
+        LINK_OPERAND(
+            ip->iCreateRegExp.op4, mapRegExp(unit, ip->iCreateRegExp.op4));
+        break;
+
+      case OpCode::SwitchImm:
+        // The jump tables of a function follow its instructions, in the
+        // order of their SwitchImm instructions.
+        jumpTableBytes += sizeof(uint32_t) *
+            (ip->iSwitchImm.op5 - ip->iSwitchImm.op4 + 1);
+        break;
+
+      default:
+        break;
+    }
+
+    offset += getInstSize(op);
+  }
+#undef LINK_OPERAND
+  return true;
+}
+
+bool BytecodeLinker::linkFunction(
+    unsigned unit,
+    uint32_t id,
+    std::vector<std::unique_ptr<BytecodeFunction>> &functions,
+    DebugInfoGenerator *debugGen) {
+  const BCProviderBase &bc = *units_[unit];
+  const UnitMapping &mapping = mappings_[unit];
+  uint32_t linkedID = mapping.firstFunction + id;
+
+  RuntimeFunctionHeader header = bc.getFunctionHeader(id);
+  const uint8_t *bytecode = bc.getBytecode(id);
+  uint32_t size = header.bytecodeSizeInBytes();
+  std::vector<opcode_atom_t> opcodes(bytecode, bytecode + size);
+  uint32_t jumpTableBytes;
+  if (!linkInstructions(unit, opcodes, jumpTableBytes))
+    return false;
+  if (jumpTableBytes) {
+    // Like the instructions, the jump tables are position independent, and
+    // are copied as they are.
+    const uint8_t *jumpTables = reinterpret_cast<const uint8_t *>(
+        llvh::alignAddr(bytecode + size, sizeof(uint32_t)));
+    opcodes.resize(llvh::alignTo<sizeof(uint32_t)>(size));
+    opcodes.insert(opcodes.end(), jumpTables, jumpTables + jumpTableBytes);
+  }
+
+  OptValue<uint32_t> name = mapString(unit, header.functionName());
+  if (!name)
+    return error(unit, "invalid function name");
+  FunctionHeader linkedHeader(
+      size,
+      header.paramCount(),
+      header.frameSize(),
+      header.environmentSize(),
+      *name,
+      header.highestReadCacheIndex(),
+      header.highestWriteCacheIndex());
+  linkedHeader.flags = header.flags();
+  linkedHeader.flags.hasDebugInfo = false;
+  linkedHeader.flags.overflowed = false;
+
+  llvh::ArrayRef<HBCExceptionHandlerInfo> handlers = bc.getExceptionTable(id);
+  auto BF = std::make_unique<BytecodeFunction>(
+      std::move(opcodes),
+      std::move(linkedHeader),
+      std::vector<HBCExceptionHandlerInfo>(handlers.begin(), handlers.end()));
+
+  const DebugOffsets *offsets = debugGen ? bc.getDebugOffsets(id) : nullptr;
+  if (offsets) {
+    const DebugInfo *debugInfo = bc.getDebugInfo();
+    DebugOffsets linkedOffsets;
+    if (offsets->sourceLocations != DebugOffsets::NO_OFFSET) {
+      DebugSourceLocation start;
+      std::vector<DebugSourceLocation> locations;
+      debugInfo->getSourceLocations(
+          offsets->sourceLocations, start, locations);
+      auto linkFile = [&mapping](DebugSourceLocation &loc) {
+        if (loc.filenameId >= mapping.filenames.size())
+          return false;
+        loc.filenameId = mapping.filenames[loc.filenameId];
+        if (loc.sourceMappingUrlId !=
+            facebook::hermes::debugger::kInvalidBreakpoint) {
+          if (loc.sourceMappingUrlId >= mapping.filenames.size())
+            return false;
+          loc.sourceMappingUrlId = mapping.filenames[loc.sourceMappingUrlId];
+        }
+        return true;
+      };
+      if (!linkFile(start))
+        return error(unit, "invalid debug info");
+      for (DebugSourceLocation &loc : locations) {
+        if (!linkFile(loc))
+          return error(unit, "invalid debug info");
+      }
+      linkedOffsets.sourceLocations =
+          debugGen->appendSourceLocations(start, linkedID, locations);
+    }
+    if (offsets->lexicalData != DebugOffsets::NO_OFFSET) {
+      OptValue<uint32_t> parent =
+          debugInfo->getParentFunctionId(offsets->lexicalData);
+      if (parent) {
+        parent = mapFunction(unit, *parent);
+        if (!parent)
+          return error(unit, "invalid debug info");
+      }
+      linkedOffsets.lexicalData = debugGen->appendLexicalData(
+          parent, debugInfo->getVariableNames(offsets->lexicalData));
+    }
+    BF->setDebugOffsets(linkedOffsets);
+  }
+
+  functions[linkedID] = std::move(BF);
+  return true;
+}
+
+std::unique_ptr<BytecodeModule> BytecodeLinker::link() {
+  if (!checkUnits())
+    return nullptr;
+  mappings_.resize(units_.size());
+  mergeStrings();
+
+  // Lay out the functions and regexps of each unit after the previous one.
+  uint32_t functionCount = 0;
+  std::vector<RegExpTableEntry> regExpTable;
+  std::vector<unsigned char> regExpStorage;
+  for (unsigned unit = 0; unit < units_.size(); ++unit) {
+    const BCProviderBase &bc = *units_[unit];
+    mappings_[unit].firstFunction = functionCount;
+    functionCount += bc.getFunctionCount();
+
+    mappings_[unit].firstRegExp = regExpTable.size();
+    uint32_t storageOffset = regExpStorage.size();
+    for (RegExpTableEntry entry : bc.getRegExpTable()) {
+      if ((uint64_t)entry.offset + entry.length >
+          bc.getRegExpStorage().size()) {
+        error(unit, "invalid regexp table");
+        return nullptr;
+      }
+      regExpTable.push_back({entry.offset + storageOffset, entry.length});
+    }
+    regExpStorage.insert(
+        regExpStorage.end(),
+        bc.getRegExpStorage().begin(),
+        bc.getRegExpStorage().end());
+  }
+
+  // Merge the CommonJS modules, in unit order, so that the first module of
+  // the first unit stays the entry point.
+  std::vector<std::pair<uint32_t, uint32_t>> cjsModules;
+  std::vector<std::pair<uint32_t, uint32_t>> functionSources;
+  llvh::DenseSet<uint32_t> moduleNames;
+  for (unsigned unit = 0; unit < units_.size(); ++unit) {
+    const BCProviderBase &bc = *units_[unit];
+    for (const auto &module : bc.getCJSModuleTable()) {
+      OptValue<uint32_t> name = mapString(unit, module.first);
+      OptValue<uint32_t> function = mapFunction(unit, module.second);
+      if (!name || !function) {
+        error(unit, "invalid CommonJS module table");
+        return nullptr;
+      }
+      if (!moduleNames.insert(*name).second) {
+        std::string utf8Storage;
+        error(
+            unit,
+            "duplicate CommonJS module " +
+                getStringFromEntry(
+                    bc.getStringTableEntry(module.first),
+                    bc.getStringStorage(),
+                    utf8Storage));
+        return nullptr;
+      }
+      cjsModules.push_back({*name, *function});
+    }
+    for (const auto &source : bc.getFunctionSourceTable()) {
+      OptValue<uint32_t> function = mapFunction(unit, source.first);
+      OptValue<uint32_t> str = mapString(unit, source.second);
+      if (!function || !str) {
+        error(unit, "invalid function source table");
+        return nullptr;
+      }
+      functionSources.push_back({*function, *str});
+    }
+  }
+
+  // Renumber the filenames of the debug info of each unit.
+  llvh::Optional<DebugInfoGenerator> debugGen;
+  if (!options_.stripDebugInfoSection) {
+    UniquingFilenameTable filenames;
+    for (unsigned unit = 0; unit < units_.size(); ++unit) {
+      const DebugInfo *debugInfo = units_[unit]->getDebugInfo();
+      for (uint32_t i = 0, e = debugInfo->getFilenameTable().size(); i < e;
+           ++i) {
+        mappings_[unit].filenames.push_back(
+            filenames.addFilename(debugInfo->getFilenameByID(i)));
+      }
+    }
+    debugGen.emplace(std::move(filenames));
+  }
+
+  std::vector<std::unique_ptr<BytecodeFunction>> functions(functionCount);
+  for (unsigned unit = 0; unit < units_.size(); ++unit) {
+    for (uint32_t id = 0, e = units_[unit]->getFunctionCount(); id < e; ++id) {
+      if (!linkFunction(
+              unit, id, functions, debugGen ? debugGen.getPointer() : nullptr))
+        return nullptr;
+    }
+  }
+
+  BytecodeOptions bcOptions;
+  bcOptions.staticBuiltins = units_[0]->getBytecodeOptions().staticBuiltins;
+  for (const BCProviderBase *bc : units_)
+    bcOptions.hasAsync |= bc->getBytecodeOptions().hasAsync;
+
+  auto kinds = strings_.getStringKinds();
+  auto hashes = strings_.getIdentifierHashes();
+  auto BM = std::make_unique<BytecodeModule>(
+      functionCount,
+      std::move(kinds),
+      std::move(hashes),
+      strings_.acquireStringTable(),
+      strings_.acquireStringStorage(),
+      std::move(regExpTable),
+      std::move(regExpStorage),
+      units_[0]->getGlobalFunctionIndex(),
+      std::move(arrayBuffer_),
+      std::move(objKeyBuffer_),
+      std::move(objValBuffer_),
+      /* segmentID */ 0,
+      std::move(cjsModules),
+      std::vector<std::pair<uint32_t, uint32_t>>{},
+      std::move(functionSources),
+      bcOptions);
+  for (uint32_t id = 0; id < functionCount; ++id)
+    BM->setFunction(id, std::move(functions[id]));
+  if (debugGen)
+    BM->setDebugInfo(debugGen->serializeWithMove());
+  return BM;
+}
+
+} // namespace
+
+std::unique_ptr<BytecodeModule> hermes::hbc::linkBytecodeUnits(
+    llvh::ArrayRef<const BCProviderBase *> units,
+    const BytecodeGenerationOptions &options,
+    std::string *outError) {
+  return BytecodeLinker(units, options, outError).link();
+}
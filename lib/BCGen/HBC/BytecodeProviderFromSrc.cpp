@@ -155,6 +155,7 @@ BCProviderFromSrc::createBCProviderFromSrc(
       compileFlags.preemptiveFunctionCompilationThreshold);
   context->setPreemptiveFileCompilationThreshold(
       compileFlags.preemptiveFileCompilationThreshold);
+  context->setPreParseThreads(compileFlags.preParseThreads);
 
   if (compileFlags.lazy && !compileFlags.optimize) {
     context->setLazyCompilation(true);
@@ -7,12 +7,22 @@
 
 #include "hermes/BCGen/HBC/BytecodeStream.h"
 
+#include "hermes/Support/LZ4.h"
+
+#include "llvh/ADT/BitVector.h"
+
 using namespace hermes;
 using namespace hbc;
 
 // ============================ File ============================
 void BytecodeSerializer::serialize(BytecodeModule &BM, const SHA1 &sourceHash) {
   bytecodeModule_ = &BM;
+  if (isLayout_) {
+    functionLayout_ = computeFunctionLayout(
+        options_.functionLayoutOrder, BM.getNumFunctions());
+  }
+  BytecodeOptions bytecodeOptions = BM.getBytecodeOptions();
+  bytecodeOptions.compressedBytecode = options_.compressBytecode;
   uint32_t cjsModuleCount = BM.getBytecodeOptions().cjsModulesStaticallyResolved
       ? BM.getCJSModuleTableStatic().size()
       : BM.getCJSModuleTable().size();
@@ -37,15 +47,19 @@ void BytecodeSerializer::serialize(BytecodeModule &BM, const SHA1 &sourceHash) {
       cjsModuleCount,
       static_cast<uint32_t>(BM.getFunctionSourceTable().size()),
       debugInfoOffset_,
-      BM.getBytecodeOptions()};
+      bytecodeOptions};
   writeBinary(header);
   // Sizes of file and function headers are tuned for good cache line packing.
   // If you reorder the format, try to avoid headers crossing cache lines.
   visitBytecodeSegmentsInOrder(*this);
-  serializeFunctionsBytecode(BM);
+  if (options_.compressBytecode) {
+    serializeCompressedFunctionsBytecode(BM);
+  } else {
+    serializeFunctionsBytecode(BM);
+  }
 
-  for (auto &entry : BM.getFunctionTable()) {
-    serializeFunctionInfo(*entry);
+  for (uint32_t id : functionLayout_) {
+    serializeFunctionInfo(BM.getFunction(id));
   }
 
   serializeDebugInfo(BM);
@@ -173,18 +187,112 @@ void BytecodeSerializer::serializeDebugOffsets(BytecodeFunction &BF) {
 }
 
 // ============================ Function ============================
-void BytecodeSerializer::serializeFunctionsBytecode(BytecodeModule &BM) {
+/* static */ std::vector<uint32_t> BytecodeSerializer::computeFunctionLayout(
+    llvh::ArrayRef<uint32_t> preferredOrder,
+    uint32_t numFunctions) {
+  std::vector<uint32_t> layout;
+  layout.reserve(numFunctions);
+  llvh::BitVector placed(numFunctions);
+  for (uint32_t id : preferredOrder) {
+    if (id < numFunctions && !placed.test(id)) {
+      placed.set(id);
+      layout.push_back(id);
+    }
+  }
+  for (uint32_t id = 0; id < numFunctions; ++id) {
+    if (!placed.test(id)) {
+      layout.push_back(id);
+    }
+  }
+  return layout;
+}
+
+/// Writes function bodies to the output stream, at their offsets in the file.
+class BytecodeSerializer::StreamBodySink {
+  BytecodeSerializer &serializer_;
+
+ public:
+  explicit StreamBodySink(BytecodeSerializer &serializer)
+      : serializer_(serializer) {}
+
+  uint32_t offset() const {
+    return serializer_.loc_;
+  }
+  void write(ArrayRef<uint8_t> bytes) {
+    serializer_.writeBinaryArray(bytes);
+  }
+  void pad(unsigned alignment) {
+    serializer_.pad(alignment);
+  }
+  void finishFunction() {}
+};
+
+/// Writes function bodies to compressedChunks_, at offsets relative to the
+/// start of the first chunk.
+class BytecodeSerializer::ChunkBodySink {
+  BytecodeSerializer &serializer_;
+  /// The uncompressed contents of the chunk being filled.
+  std::vector<uint8_t> chunk_;
+  /// The offset of chunk_ from the start of the first chunk.
+  uint32_t chunkOffset_{0};
+
+ public:
+  explicit ChunkBodySink(BytecodeSerializer &serializer)
+      : serializer_(serializer) {
+    serializer_.compressedChunks_.clear();
+  }
+
+  uint32_t offset() const {
+    return chunkOffset_ + chunk_.size();
+  }
+  void write(ArrayRef<uint8_t> bytes) {
+    chunk_.insert(chunk_.end(), bytes.begin(), bytes.end());
+  }
+  void pad(unsigned alignment) {
+    chunk_.resize(llvh::alignTo(chunk_.size(), alignment));
+  }
+  void finishFunction() {
+    if (chunk_.size() >= COMPRESSED_CHUNK_SIZE) {
+      finishChunk();
+    }
+  }
+
+  /// Compress the last chunk, if any is started. There is always at least
+  /// one chunk.
+  void finish() {
+    if (!chunk_.empty() || serializer_.compressedChunks_.empty()) {
+      finishChunk();
+    }
+  }
+
+ private:
+  void finishChunk() {
+    pad(sizeof(uint32_t));
+    CompressedChunk compressed{
+        chunkOffset_, static_cast<uint32_t>(chunk_.size()), {}};
+    lz4::compress(chunk_, compressed.data);
+    serializer_.compressedChunks_.push_back(std::move(compressed));
+    chunkOffset_ += chunk_.size();
+    chunk_.clear();
+  }
+};
+
+template <typename Sink>
+void BytecodeSerializer::serializeFunctionBodies(
+    BytecodeModule &BM,
+    Sink &sink) {
   // Map from opcodes and jumptables to offsets, used to deduplicate bytecode.
   using DedupKey = llvh::ArrayRef<opcode_atom_t>;
   llvh::DenseMap<DedupKey, uint32_t> bcMap;
-  for (auto &entry : BM.getFunctionTable()) {
+  for (uint32_t id : functionLayout_) {
+    BytecodeFunction *entry = &BM.getFunction(id);
     if (options_.optimizationEnabled) {
       // If identical bytecode exists, we'll reuse it.
       bool reuse = false;
       if (isLayout_) {
         // Deduplicate the bytecode during layout phase.
         DedupKey key = entry->getOpcodeArray();
-        auto pair = bcMap.insert(std::make_pair(key, loc_));
+        auto pair = bcMap.insert(std::make_pair(key, sink.offset()));
         if (!pair.second) {
           reuse = true;
           entry->setOffset(pair.first->second);
@@ -192,8 +300,10 @@ void BytecodeSerializer::serializeFunctionsBytecode(BytecodeModule &BM) {
       } else {
         // Cheaply determine whether bytecode was deduplicated.
         assert(entry->getOffset() && "Function lacks offset after layout");
-        assert(entry->getOffset() <= loc_ && "Function has too large offset");
-        reuse = entry->getOffset() < loc_;
+        assert(
+            entry->getOffset() <= sink.offset() &&
+            "Function has too large offset");
+        reuse = entry->getOffset() < sink.offset();
       }
       if (reuse) {
         continue;
@@ -202,24 +312,61 @@ void BytecodeSerializer::serializeFunctionsBytecode(BytecodeModule &BM) {
 
     // Set the offset of this function's bytecode.
     if (isLayout_) {
-      entry->setOffset(loc_);
+      entry->setOffset(sink.offset());
     }
 
     // Serialize opcodes.
-    writeBinaryArray(entry->getOpcodesOnly());
+    ArrayRef<opcode_atom_t> opcodes = entry->getOpcodesOnly();
+    sink.write(opcodes);
 
     // Serialize any jump table after the opcode block.
-    if (!entry->getJumpTablesOnly().empty()) {
-      pad(sizeof(uint32_t));
-      writeBinaryArray(entry->getJumpTablesOnly());
+    ArrayRef<uint32_t> jumpTables = entry->getJumpTablesOnly();
+    if (!jumpTables.empty()) {
+      sink.pad(sizeof(uint32_t));
+      sink.write(ArrayRef<uint8_t>(
+          reinterpret_cast<const uint8_t *>(jumpTables.data()),
+          jumpTables.size() * sizeof(uint32_t)));
     }
     if (options_.padFunctionBodiesPercent) {
-      size_t size = entry->getOpcodesOnly().size();
+      size_t size = opcodes.size();
       size = (size * options_.padFunctionBodiesPercent) / 100;
-      while (size--)
-        writeBinary('\0');
-      pad(sizeof(uint32_t));
+      sink.write(std::vector<uint8_t>(size));
+      sink.pad(sizeof(uint32_t));
     }
+    sink.finishFunction();
+  }
+}
+
+void BytecodeSerializer::serializeFunctionsBytecode(BytecodeModule &BM) {
+  StreamBodySink sink{*this};
+  serializeFunctionBodies(BM, sink);
+}
+
+void BytecodeSerializer::serializeCompressedFunctionsBytecode(
+    BytecodeModule &BM) {
+  if (isLayout_) {
+    // Lay out the function bodies as serializeFunctionsBytecode() would, but
+    // into chunks in memory.
+    ChunkBodySink sink{*this};
+    serializeFunctionBodies(BM, sink);
+    sink.finish();
+  }
+
+  pad(BYTECODE_ALIGNMENT);
+  uint32_t dataOffset = loc_ + sizeof(CompressedChunkTableHeader) +
+      compressedChunks_.size() * sizeof(CompressedChunkEntry);
+  writeBinary(CompressedChunkTableHeader{
+      static_cast<uint32_t>(compressedChunks_.size())});
+  for (const CompressedChunk &chunk : compressedChunks_) {
+    writeBinary(CompressedChunkEntry{
+        dataOffset,
+        static_cast<uint32_t>(chunk.data.size()),
+        chunk.uncompressedOffset,
+        chunk.uncompressedSize});
+    dataOffset += chunk.data.size();
+  }
+  for (const CompressedChunk &chunk : compressedChunks_) {
+    writeBinaryArray(llvh::makeArrayRef(chunk.data));
   }
 }
 
@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/BCGen/HBC/CompileCache.h"
+
+#include "hermes/BCGen/HBC/BytecodeStream.h"
+#include "hermes/Support/MemoryBuffer.h"
+
+#include "llvh/Support/FileSystem.h"
+#include "llvh/Support/Path.h"
+#include "llvh/Support/SHA1.h"
+#include "llvh/Support/raw_ostream.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace hermes {
+namespace hbc {
+
+constexpr uint64_t CompileCache::kDefaultMaxSize;
+
+namespace {
+
+/// Owns the bytecode of an entry that was just compiled.
+class StringBuffer final : public Buffer {
+  std::string bytecode_;
+
+ public:
+  StringBuffer(std::string &&bytecode) : bytecode_(std::move(bytecode)) {
+    data_ = reinterpret_cast<const uint8_t *>(bytecode_.data());
+    size_ = bytecode_.size();
+  }
+};
+
+} // namespace
+
+SHA1 CompileCache::computeKey(
+    llvh::ArrayRef<uint8_t> source,
+    llvh::StringRef sourceURL,
+    const CompileFlags &flags) {
+  // Everything besides the source that changes the generated bytecode. The
+  // lazy compilation thresholds don't, since entries are compiled eagerly.
+  std::string config;
+  llvh::raw_string_ostream os{config};
+  os << "v" << BYTECODE_VERSION << ";url=" << sourceURL
+     << ";optimize=" << flags.optimize << ";debug=" << flags.debug
+     << ";strict=" << flags.strict << ";staticBuiltins="
+     << (flags.staticBuiltins ? (*flags.staticBuiltins ? "1" : "0") : "auto")
+     << ";asyncBreakCheck=" << flags.emitAsyncBreakCheck
+     << ";libHermes=" << flags.includeLibHermes
+     << ";instrumentIR=" << flags.instrumentIR
+     << ";generators=" << flags.enableGenerator;
+  os.flush();
+
+  llvh::SHA1 hasher;
+  hasher.update(source);
+  hasher.update(llvh::ArrayRef<uint8_t>(
+      reinterpret_cast<const uint8_t *>(config.data()), config.size()));
+  llvh::StringRef digest = hasher.final();
+  SHA1 key;
+  assert(digest.size() == key.size() && "unexpected SHA1 size");
+  std::copy(digest.begin(), digest.end(), key.begin());
+  return key;
+}
+
+std::string CompileCache::getEntryPath(const SHA1 &key) const {
+  llvh::SmallString<128> path{directory_};
+  llvh::sys::path::append(path, hashAsString(key) + ".hbc");
+  return path.str();
+}
+
+std::unique_ptr<BCProviderFromBuffer> CompileCache::load(
+    const SHA1 &key) const {
+  auto file = llvh::MemoryBuffer::getFile(
+      getEntryPath(key),
+      /* FileSize */ -1,
+      /* RequiresNullTerminator */ false);
+  if (!file)
+    return nullptr;
+  // The file may have been truncated or corrupted, e.g. by a crash while it
+  // was being written on a file system without atomic renames.
+  llvh::ArrayRef<uint8_t> bytecode(
+      reinterpret_cast<const uint8_t *>((*file)->getBufferStart()),
+      (*file)->getBufferSize());
+  if (!BCProviderFromBuffer::bytecodeStreamSanityCheck(bytecode) ||
+      !BCProviderFromBuffer::bytecodeHashIsValid(bytecode)) {
+    return nullptr;
+  }
+  auto ret = BCProviderFromBuffer::createBCProviderFromBuffer(
+      std::make_unique<OwnedMemoryBuffer>(std::move(*file)));
+  return std::move(ret.first);
+}
+
+bool CompileCache::store(const SHA1 &key, llvh::ArrayRef<uint8_t> bytecode)
+    const {
+  if (llvh::sys::fs::create_directories(directory_))
+    return false;
+  std::string path = getEntryPath(key);
+  int fd;
+  llvh::SmallString<128> tempPath;
+  if (llvh::sys::fs::createUniqueFile(path + ".tmp-%%%%%%%%", fd, tempPath))
+    return false;
+  {
+    llvh::raw_fd_ostream os{fd, /* shouldClose */ true};
+    os.write(reinterpret_cast<const char *>(bytecode.data()), bytecode.size());
+    os.close();
+    if (os.has_error()) {
+      os.clear_error();
+      llvh::sys::fs::remove(tempPath);
+      return false;
+    }
+  }
+  if (llvh::sys::fs::rename(tempPath, path)) {
+    llvh::sys::fs::remove(tempPath);
+    return false;
+  }
+  evict(path);
+  return true;
+}
+
+void CompileCache::evict(llvh::StringRef keepPath) const {
+  struct Entry {
+    std::string path;
+    llvh::sys::TimePoint<> modified;
+    uint64_t size;
+  };
+  std::vector<Entry> entries;
+  uint64_t totalSize = 0;
+  std::error_code ec;
+  for (llvh::sys::fs::directory_iterator it{directory_, ec}, end;
+       !ec && it != end;
+       it.increment(ec)) {
+    // Temporary files belong to stores that are still in progress.
+    if (llvh::sys::path::extension(it->path()) != ".hbc")
+      continue;
+    llvh::sys::fs::file_status status;
+    if (llvh::sys::fs::status(it->path(), status))
+      continue;
+    entries.push_back(
+        Entry{it->path(), status.getLastModificationTime(), status.getSize()});
+    totalSize += status.getSize();
+  }
+  if (totalSize <= maxSize_)
+    return;
+
+  std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) {
+    return a.modified < b.modified;
+  });
+  for (const Entry &entry : entries) {
+    if (totalSize <= maxSize_)
+      break;
+    if (entry.path == keepPath)
+      continue;
+    // Another process sharing the directory may have removed it already.
+    if (!llvh::sys::fs::remove(entry.path))
+      totalSize -= entry.size;
+  }
+}
+
+std::pair<std::unique_ptr<BCProvider>, std::string> CompileCache::getOrCompile(
+    std::unique_ptr<Buffer> buffer,
+    llvh::StringRef sourceURL,
+    std::unique_ptr<SourceMap> sourceMap,
+    const CompileFlags &flags) {
+  // The input source map changes the debug info, but is not part of the key.
+  if (sourceMap) {
+    return BCProviderFromSrc::createBCProviderFromSrc(
+        std::move(buffer), sourceURL, std::move(sourceMap), flags);
+  }
+
+  llvh::ArrayRef<uint8_t> source{buffer->data(), buffer->size()};
+  SHA1 key = computeKey(source, sourceURL, flags);
+  if (auto cached = load(key))
+    return {std::move(cached), std::string{}};
+
+  SHA1 sourceHash = llvh::SHA1::hash(source);
+  CompileFlags eagerFlags = flags;
+  eagerFlags.lazy = false;
+  auto compiled = BCProviderFromSrc::createBCProviderFromSrc(
+      std::move(buffer), sourceURL, nullptr, eagerFlags);
+  if (!compiled.first)
+    return {nullptr, std::move(compiled.second)};
+
+  std::string bytecode;
+  {
+    llvh::raw_string_ostream os{bytecode};
+    BytecodeGenerationOptions opts{EmitBundle};
+    opts.optimizationEnabled = flags.optimize;
+    BytecodeSerializer serializer{os, opts};
+    serializer.serialize(*compiled.first->getBytecodeModule(), sourceHash);
+  }
+  // Failing to store the entry only costs the next run a compilation.
+  store(
+      key,
+      llvh::ArrayRef<uint8_t>(
+          reinterpret_cast<const uint8_t *>(bytecode.data()),
+          bytecode.size()));
+
+  // Run the serialized bytecode, so that a miss behaves exactly like a hit.
+  auto ret = BCProviderFromBuffer::createBCProviderFromBuffer(
+      std::make_unique<StringBuffer>(std::move(bytecode)));
+  if (!ret.first)
+    return {nullptr, std::move(ret.second)};
+  return {std::move(ret.first), std::string{}};
+}
+
+} // namespace hbc
+} // namespace hermes
@@ -10,7 +10,6 @@
 
 #include "hermes/BCGen/HBC/BytecodeDataProvider.h"
 #include "hermes/Support/HashString.h"
-#include "hermes/Support/JenkinsHash.h"
 #include "hermes/Support/Statistic.h"
 #include "hermes/Support/Timer.h"
 #include "hermes/Support/UTF8.h"
@@ -22,6 +21,11 @@
 #include <climits>
 #include <deque>
 
+#if !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+#define HERMES_STRING_PACKER_HAS_THREADS
+#include <thread>
+#endif
+
 using namespace hermes;
 using llvh::ArrayRef;
 using llvh::MutableArrayRef;
@@ -41,6 +45,15 @@ constexpr size_t npos = ~size_t(0);
 /// Longest string that we'll attempt to pack.
 constexpr size_t kMaximumPackableStringLength = 24 * 1024;
 
+/// Number of suffixes examined when looking for a string containing another
+/// one. Short strings are contained in a great many others, and any of them
+/// saves the same space, so looking at all of them is wasted work.
+constexpr size_t kMaximumParentCandidates = 16;
+
+/// Pack the UTF-16 strings on their own thread when both kinds have at least
+/// this many strings.
+constexpr size_t kMinimumStringsForThread = 1024;
+
 /// A helper class responsible for deciding how to "pack" strings, that is, lay
 /// out strings in a linear array suitable for ConsecutiveStringStorage. It is
 /// templated on the character type (char or char16_t).
@@ -77,12 +90,26 @@ class StringPacker {
     /// The amount that our chars_ overlaps with prev_->chars_.
     size_t overlapAmount_ = 0;
 
-    /// Entries that may not be set as our next_, because they would introduce
-    /// a cycle.
-    llvh::DenseSet<const StringEntry *> potentialCycles_;
+    /// If we are the first string of a chain of next_ links, the last one, and
+    /// if we are the last, the first one. nullptr stands for this entry
+    /// itself, and the values at other positions in a chain are stale.
+    StringEntry *chainEnd_ = nullptr;
+    StringEntry *chainStart_ = nullptr;
 
     StringEntry(uint32_t stringID, ArrayRef<CharT> chars)
         : stringID_(stringID), chars_(chars) {}
+
+    /// \return the last string of the chain we start.
+    StringEntry *chainEnd() {
+      assert(!prev_ && "Not the start of a chain");
+      return chainEnd_ ? chainEnd_ : this;
+    }
+
+    /// \return the first string of the chain we end.
+    StringEntry *chainStart() {
+      assert(!next_ && "Not the end of a chain");
+      return chainStart_ ? chainStart_ : this;
+    }
   };
 
   /// A Trigram represents three packed characters.
@@ -114,36 +141,17 @@ class StringPacker {
     return result;
   }
 
-  /// HashedSuffix is a model of DenseMapInfo suitable for hashing string
-  /// suffixes. When iterating over the suffixes, it is N^2 to hash each suffix
-  /// separately. We can do better by retaining the hash of the previous suffix
-  /// and simply incorporating the next character into it.
-  struct HashedSuffix {
-    /// The string that has been hashed.
+  /// A suffix of one of the strings being packed.
+  struct Suffix {
+    /// The characters of the suffix.
     ArrayRef<CharT> chars_;
 
-    /// The hash value of chars_.
-    JenkinsHash hash_;
+    /// The string it is a suffix of.
+    StringEntry *entry_;
 
-    /// DenseMapInfo interface. \return the empty key, deferring to ArrayRef.
-    static HashedSuffix getEmptyKey() {
-      return {llvh::DenseMapInfo<ArrayRef<CharT>>::getEmptyKey(), 0};
-    }
-
-    /// DenseMapInfo interface. \return the tombstone key, deferring to
-    /// ArrayRef.
-    static HashedSuffix getTombstoneKey() {
-      return {llvh::DenseMapInfo<ArrayRef<CharT>>::getTombstoneKey(), 0};
-    }
-
-    /// DenseMapInfo interface. \return the hash, which we have cached.
-    static unsigned getHashValue(const HashedSuffix &s) {
-      return s.hash_;
-    }
-
-    /// DenseMapInfo interface. \return whether two suffixes are equal.
-    static bool isEqual(const HashedSuffix &lhs, const HashedSuffix &rhs) {
-      return lhs.hash_ == rhs.hash_ && lhs.chars_ == rhs.chars_;
+    /// \return the character at index pos, or -1 if pos >= our length.
+    int extCharAt(size_t pos) const {
+      return pos >= chars_.size() ? -1 : chars_[pos];
     }
   };
 
@@ -152,13 +160,16 @@ class StringPacker {
     /// The suffix represented by this entry.
     ArrayRef<CharT> suffix_;
 
-    /// The list of StringEntries that have this suffix.
-    std::vector<StringEntry *> entries_;
+    /// The StringEntries that have this suffix, in increasing stringID order.
+    ArrayRef<StringEntry *> entries_;
 
-    /// Convenience move constructor from a std::pair.
-    /// This is used to extract SuffixArrayEntries from our uniquing map.
-    SuffixArrayEntry(std::pair<HashedSuffix, std::vector<StringEntry *>> &&kv)
-        : suffix_(std::move(kv.first.chars_)), entries_(std::move(kv.second)) {}
+    /// entries_ before this index can't be placed before another string,
+    /// because they already have a next_ or a parent_. This is maintained by
+    /// planLayout(), so that it doesn't examine them over and over.
+    size_t firstCandidate_ = 0;
+
+    SuffixArrayEntry(ArrayRef<CharT> suffix, ArrayRef<StringEntry *> entries)
+        : suffix_(suffix), entries_(entries) {}
 
     /// \return the character at index pos, or -1 if pos >= our length.
     int extCharAt(size_t pos) const {
@@ -166,12 +177,15 @@ class StringPacker {
     }
   };
 
+  /// A generalized suffix array, with the storage for its entries_ lists.
+  struct SuffixArray {
+    std::vector<SuffixArrayEntry> entries_;
+    std::vector<StringEntry *> owners_;
+  };
+
   // Given pointers \p begin and \p end, sort the range [begin, end) starting at
   // the character index \p charIdx. This is a recursive function.
-  static void radixQuicksort(
-      SuffixArrayEntry *begin,
-      SuffixArrayEntry *end,
-      size_t charIdx) {
+  static void radixQuicksort(Suffix *begin, Suffix *end, size_t charIdx) {
     for (;;) {
       if (end - begin <= 1) {
         // Already sorted.
@@ -184,9 +198,9 @@ class StringPacker {
       // Final state adds:
       //  [lower, upper) == pivot
       int pivotChar = begin->extCharAt(charIdx);
-      SuffixArrayEntry *lower = begin;
-      SuffixArrayEntry *upper = end;
-      for (SuffixArrayEntry *cursor = begin + 1; cursor < upper;) {
+      Suffix *lower = begin;
+      Suffix *upper = end;
+      for (Suffix *cursor = begin + 1; cursor < upper;) {
         int testChar = cursor->extCharAt(charIdx);
         if (testChar < pivotChar) {
           std::swap(*lower++, *cursor++);
@@ -218,14 +232,14 @@ class StringPacker {
   /// \return a generalized suffix array over the given \p strings.
   /// Only suffixes that begin with an element of \p prefixesOfInterest (or are
   /// shorter than TrigramCharCount) are included.
-  static std::vector<SuffixArrayEntry> buildSuffixArray(
+  static SuffixArray buildSuffixArray(
       MutableArrayRef<StringEntry> strings,
       const llvh::DenseSet<Trigram> &prefixesOfInterest) {
-    // Unique each suffix, that is, for each suffix that begins with
-    // prefixOfInterest construct the list of strings containing it. A rough
-    // test showed 8 suffixes per string is a reasonable initial capacity.
-    llvh::DenseMap<HashedSuffix, std::vector<StringEntry *>, HashedSuffix>
-        suffixMap(8 * strings.size());
+    // Collect every suffix that begins with a prefixOfInterest and sort them,
+    // which brings together the strings that share each suffix. A rough test
+    // showed 8 suffixes per string is a reasonable initial capacity.
+    std::vector<Suffix> suffixes;
+    suffixes.reserve(8 * strings.size());
     for (StringEntry &entry : strings) {
       size_t charsSize = entry.chars_.size();
       // Skip excessively long strings.
@@ -233,25 +247,35 @@ class StringPacker {
         continue;
       }
       const CharT *chars = entry.chars_.data();
-      JenkinsHash hash = 0;
-      size_t i = charsSize;
-      while (i--) {
-        hash = updateJenkinsHash(hash, chars[i]);
+      for (size_t i = 0; i < charsSize; ++i) {
         if (i + TrigramCharCount <= charsSize &&
             !prefixesOfInterest.count(makeTrigram(&chars[i])))
           continue;
-        ArrayRef<CharT> suffix(&chars[i], charsSize - i);
-        suffixMap[HashedSuffix{suffix, hash}].push_back(&entry);
+        suffixes.push_back({ArrayRef<CharT>(&chars[i], charsSize - i), &entry});
       }
     }
-
-    // Move our suffixes to an array, and sort it.
-    std::vector<SuffixArrayEntry> result;
-    if (!suffixMap.empty()) {
-      result.reserve(suffixMap.size());
-      std::move(suffixMap.begin(), suffixMap.end(), std::back_inserter(result));
-      SuffixArrayEntry *entries = &result[0];
-      radixQuicksort(entries, entries + result.size(), 0);
+    if (suffixes.empty()) {
+      return {};
+    }
+    radixQuicksort(&suffixes[0], &suffixes[0] + suffixes.size(), 0);
+
+    // Make one entry per distinct suffix. The owners of all entries share one
+    // array, which must not be resized once we hand out references into it.
+    SuffixArray result;
+    result.owners_.reserve(suffixes.size());
+    for (size_t i = 0, e = suffixes.size(); i < e;) {
+      size_t groupStart = result.owners_.size();
+      ArrayRef<CharT> chars = suffixes[i].chars_;
+      for (; i < e && suffixes[i].chars_ == chars; ++i) {
+        result.owners_.push_back(suffixes[i].entry_);
+      }
+      // strings is in stringID order, so ordering the owners by address
+      // orders them by stringID.
+      auto *groupBegin = &result.owners_[groupStart];
+      auto *groupEnd = &result.owners_[0] + result.owners_.size();
+      std::sort(groupBegin, groupEnd);
+      result.entries_.emplace_back(
+          chars, ArrayRef<StringEntry *>(groupBegin, groupEnd));
     }
     return result;
   }
@@ -264,7 +288,7 @@ class StringPacker {
   /// Also note overlap is directed: there is no overlap from "peasoup" to
   /// "splitpea" because no suffix of "peasoup" is a prefix of "splitpea".
   struct Overlap {
-    ArrayRef<StringEntry *> srcs_;
+    SuffixArrayEntry *srcs_;
     StringEntry *dst_;
   };
 
@@ -279,7 +303,7 @@ class StringPacker {
   /// leftString->rightString to \p overlaps
   static void computeOverlapsAndParentForEntry(
       StringEntry *rightString,
-      ArrayRef<SuffixArrayEntry> suffixArray,
+      MutableArrayRef<SuffixArrayEntry> suffixArray,
       WeightIndexedOverlaps *overlaps) {
     // This is a subtle function. We want to compute Overlaps, indexed by
     // overlap amount, and simultaneously identify parents. Iterate over
@@ -323,7 +347,7 @@ class StringPacker {
           if (overlaps->size() <= overlapAmount) {
             overlaps->resize(overlapAmount + 1);
           }
-          Overlap ov = {lower->entries_, rightString};
+          Overlap ov = {&*lower, rightString};
           (*overlaps)[overlapAmount].push_back(ov);
         }
       } else {
@@ -332,7 +356,12 @@ class StringPacker {
         // That means that rightEntry is wholly contained within some string.
         // Of course it is wholly contained within itself; if it's also
         // contained within some OTHER string, we found a parent.
-        // For compressibility, choose the parent with the lowest stringID.
+        // For compressibility, choose the parent with the lowest stringID
+        // among the first few suffixes. Each suffix lists its entries in
+        // stringID order, so only its first entry that isn't us can win.
+        if (upper - lower > (ptrdiff_t)kMaximumParentCandidates) {
+          upper = lower + kMaximumParentCandidates;
+        }
         for (auto cursor = lower; cursor < upper; ++cursor) {
           for (StringEntry *parent : cursor->entries_) {
             // Can't parent ourselves.
@@ -342,22 +371,23 @@ class StringPacker {
             // Don't parent if we have an existing parent with a lower ID.
             // This means that we prefer parents that tend to end up early in
             // the string table.
-            if (rightString->parent_ &&
-                rightString->parent_->stringID_ < parent->stringID_)
-              continue;
-
-            // We found a parent.
-            // rightEntry is a prefix of one of parent's suffixes.
-            // Therefore rightEntry appears in the parent at the same offset of
-            // the suffix within the parent.
-            // A parent should always be longer than its child; otherwise we
-            // must have duplicate strings.
-            assert(
-                parent->chars_.size() > rightString->chars_.size() &&
-                "non-unique strings passed to StringPacker");
-            rightString->parent_ = parent;
-            rightString->offsetInParent_ =
-                parent->chars_.size() - cursor->suffix_.size();
+            if (!rightString->parent_ ||
+                parent->stringID_ < rightString->parent_->stringID_) {
+              // We found a parent.
+              // rightEntry is a prefix of one of parent's suffixes.
+              // Therefore rightEntry appears in the parent at the same offset
+              // of the suffix within the parent.
+              // A parent should always be longer than its child; otherwise we
+              // must have duplicate strings.
+              assert(
+                  parent->chars_.size() > rightString->chars_.size() &&
+                  "non-unique strings passed to StringPacker");
+              rightString->parent_ = parent;
+              rightString->offsetInParent_ =
+                  parent->chars_.size() - cursor->suffix_.size();
+            }
+            // The remaining entries of this suffix have higher IDs.
+            break;
           }
         }
       }
@@ -369,7 +399,7 @@ class StringPacker {
   /// \p return the list of Overlaps indexed by weight (amount of overlap).
   static WeightIndexedOverlaps computeOverlapsAndParents(
       MutableArrayRef<StringEntry> stringEntries,
-      ArrayRef<SuffixArrayEntry> suffixArray) {
+      MutableArrayRef<SuffixArrayEntry> suffixArray) {
     WeightIndexedOverlaps result;
     for (StringEntry &entry : stringEntries) {
       computeOverlapsAndParentForEntry(&entry, suffixArray, &result);
@@ -380,7 +410,7 @@ class StringPacker {
   /// Indicate if we can add the edge from \p src to \p dst to our Hamiltonian
   /// path, that is, whether we can take advantage of the overlap between src
   /// and dst by positioning dst to overlap a suffix of src.
-  static bool canOverlap(const StringEntry *src, const StringEntry *dst) {
+  static bool canOverlap(StringEntry *src, StringEntry *dst) {
     // Are we trying to overlap ourself?
     if (src == dst)
       return false;
@@ -393,8 +423,9 @@ class StringPacker {
     if (src->next_ || dst->prev_)
       return false;
 
-    // Would forming src->dst create a cycle?
-    if (src->potentialCycles_.count(dst))
+    // Would forming src->dst create a cycle? That is the case if src is at the
+    // end of the chain that dst starts.
+    if (src->chainStart() == dst)
       return false;
 
     // This edge is OK!
@@ -418,22 +449,26 @@ class StringPacker {
           // dst is already spoken for, no need to consider it further.
           continue;
         }
-        for (StringEntry *src : overlap.srcs_) {
+        // Strings never lose their next_ or parent_, so skip the ones that
+        // have them once and for all.
+        SuffixArrayEntry &srcs = *overlap.srcs_;
+        while (srcs.firstCandidate_ < srcs.entries_.size() &&
+               (srcs.entries_[srcs.firstCandidate_]->next_ ||
+                srcs.entries_[srcs.firstCandidate_]->parent_)) {
+          ++srcs.firstCandidate_;
+        }
+        for (StringEntry *src :
+             srcs.entries_.drop_front(srcs.firstCandidate_)) {
           if (canOverlap(src, dst)) {
-            // Apply the Overlap.
+            // Apply the Overlap, joining the chain that ends with src to the
+            // one that starts with dst.
+            StringEntry *start = src->chainStart();
+            StringEntry *end = dst->chainEnd();
             src->next_ = dst;
             dst->prev_ = src;
             dst->overlapAmount_ = overlapAmount;
-
-            // Traverse to the start and end of our new chain, and mark the fact
-            // that end->start is prohibited because it would produce a cycle.
-            StringEntry *end = dst;
-            while (end->next_)
-              end = end->next_;
-            StringEntry *start = src;
-            while (start->prev_)
-              start = start->prev_;
-            end->potentialCycles_.insert(start);
+            start->chainEnd_ = end;
+            end->chainStart_ = start;
 
             // We picked an entry to come before dst, so we're done with dst.
             break;
@@ -503,7 +538,7 @@ class StringPacker {
       MutableArrayRef<StringEntry> strings) {
     auto prefixSet = buildPrefixTrigramSet(strings);
     auto suffixes = buildSuffixArray(strings, prefixSet);
-    auto overlaps = computeOverlapsAndParents(strings, suffixes);
+    auto overlaps = computeOverlapsAndParents(strings, suffixes.entries_);
     planLayout(overlaps);
     std::vector<CharT> storage;
     for (StringEntry &entry : strings) {
@@ -630,9 +665,25 @@ class StringTableBuilder {
         AreStatisticsEnabled());
     // Note these assignments use efficient move-assignment, not copying.
     if (optimize) {
-      *asciiStorage =
-          StringPacker<unsigned char>::optimizingPackStrings(asciiStrings_);
-      *u16Storage = StringPacker<char16_t>::optimizingPackStrings(u16Strings_);
+      // The two kinds of strings are packed independently of each other.
+#ifdef HERMES_STRING_PACKER_HAS_THREADS
+      if (asciiStrings_.size() >= kMinimumStringsForThread &&
+          u16Strings_.size() >= kMinimumStringsForThread) {
+        std::thread u16Thread([this, u16Storage]() {
+          *u16Storage =
+              StringPacker<char16_t>::optimizingPackStrings(u16Strings_);
+        });
+        *asciiStorage =
+            StringPacker<unsigned char>::optimizingPackStrings(asciiStrings_);
+        u16Thread.join();
+      } else
+#endif
+      {
+        *asciiStorage =
+            StringPacker<unsigned char>::optimizingPackStrings(asciiStrings_);
+        *u16Storage =
+            StringPacker<char16_t>::optimizingPackStrings(u16Strings_);
+      }
     } else {
       *asciiStorage =
           StringPacker<unsigned char>::fastPackStrings(asciiStrings_);
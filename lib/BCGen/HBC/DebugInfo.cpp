@@ -10,6 +10,8 @@
 #include "hermes/BCGen/HBC/ConsecutiveStringStorage.h"
 #include "hermes/SourceMap/SourceMapGenerator.h"
 
+#include <algorithm>
+
 using namespace hermes;
 using namespace hbc;
 
@@ -28,6 +30,14 @@ struct FunctionDebugInfoDeserializer {
     current_.column = decode1Int();
   }
 
+  /// Construct a deserializer that resumes deserializing at \p offset in \p
+  /// data, where the location is \p current. The function index is unknown.
+  FunctionDebugInfoDeserializer(
+      llvh::ArrayRef<uint8_t> data,
+      uint32_t offset,
+      const DebugSourceLocation &current)
+      : data_(data), offset_(offset), functionIndex_(0), current_(current) {}
+
   /// \return the next debug location, or None if we reach the end.
   /// Sample usage: while (auto loc = fdid.next()) {...}
   OptValue<DebugSourceLocation> next() {
@@ -117,6 +127,79 @@ OptValue<uint32_t> DebugInfo::getFilenameForAddress(
   return value;
 }
 
+/// Source location streams with at least this many entries get indexed.
+static constexpr unsigned kLocationIndexThreshold = 64;
+/// Number of source location entries between checkpoints in the index.
+static constexpr unsigned kLocationCheckpointInterval = 16;
+
+DebugInfo::LocationIndex &DebugInfo::LocationIndexPtr::getOrCreate() {
+  LocationIndex *index = get();
+  if (index) {
+    return *index;
+  }
+  auto *fresh = new LocationIndex();
+  if (ptr_.compare_exchange_strong(
+          index, fresh, std::memory_order_acq_rel, std::memory_order_acquire)) {
+    return *fresh;
+  }
+  // Another thread installed one first.
+  delete fresh;
+  return *index;
+}
+
+bool DebugInfo::findLocationCheckpoint(
+    uint32_t debugOffset,
+    uint32_t offsetInFunction,
+    OptValue<LocationCheckpoint> &checkpoint) const {
+  LocationIndex *index = locationIndex_.get();
+  if (!index) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lk{index->mutex};
+  auto it = index->checkpoints.find(debugOffset);
+  if (it == index->checkpoints.end()) {
+    return false;
+  }
+  const std::vector<LocationCheckpoint> &checkpoints = it->second;
+  auto after = std::upper_bound(
+      checkpoints.begin(),
+      checkpoints.end(),
+      offsetInFunction,
+      [](uint32_t address, const LocationCheckpoint &cp) {
+        return address < cp.location.address;
+      });
+  if (after != checkpoints.begin()) {
+    checkpoint = *(after - 1);
+  }
+  return true;
+}
+
+void DebugInfo::buildLocationIndex(uint32_t debugOffset) const {
+  std::vector<LocationCheckpoint> checkpoints;
+  FunctionDebugInfoDeserializer fdid(data_.getData(), debugOffset);
+  uint32_t locationOffset = fdid.getOffset();
+  uint32_t lastAddress = 0;
+  uint32_t count = 0;
+  while (auto loc = fdid.next()) {
+    // Lookups stop at the first address past the target, so resuming from a
+    // checkpoint is only equivalent if addresses never decrease.
+    if (loc->address < lastAddress) {
+      checkpoints.clear();
+      break;
+    }
+    lastAddress = loc->address;
+    if (++count % kLocationCheckpointInterval == 0) {
+      checkpoints.push_back(
+          LocationCheckpoint{locationOffset, fdid.getOffset(), *loc});
+    }
+    locationOffset = fdid.getOffset();
+  }
+  checkpoints.shrink_to_fit();
+  LocationIndex &index = locationIndex_.getOrCreate();
+  std::lock_guard<std::mutex> lk{index.mutex};
+  index.checkpoints.insert({debugOffset, std::move(checkpoints)});
+}
+
 OptValue<DebugSourceLocation> DebugInfo::getLocationForAddress(
     uint32_t debugOffset,
     uint32_t offsetInFunction) const {
@@ -125,13 +208,33 @@ OptValue<DebugSourceLocation> DebugInfo::getLocationForAddress(
   DebugSourceLocation lastLocation = fdid.getCurrent();
   uint32_t lastLocationOffset = debugOffset;
   uint32_t nextLocationOffset = fdid.getOffset();
+
+  // Short walks don't look at the index, so they never take its lock.
+  bool indexed = false;
+  uint32_t numDecoded = 0;
   while (auto loc = fdid.next()) {
     if (loc->address > offsetInFunction)
       break;
     lastLocation = *loc;
     lastLocationOffset = nextLocationOffset;
     nextLocationOffset = fdid.getOffset();
+    if (++numDecoded != kLocationIndexThreshold) {
+      continue;
+    }
+    OptValue<LocationCheckpoint> checkpoint;
+    indexed = findLocationCheckpoint(debugOffset, offsetInFunction, checkpoint);
+    if (checkpoint && checkpoint->nextOffset > nextLocationOffset) {
+      fdid = FunctionDebugInfoDeserializer(
+          data_.getData(), checkpoint->nextOffset, checkpoint->location);
+      lastLocation = checkpoint->location;
+      lastLocationOffset = checkpoint->locationOffset;
+      nextLocationOffset = checkpoint->nextOffset;
+    }
+  }
+  if (!indexed && numDecoded >= kLocationIndexThreshold) {
+    buildLocationIndex(debugOffset);
   }
+
   if (auto file = getFilenameForAddress(lastLocationOffset)) {
     lastLocation.address = offsetInFunction;
     lastLocation.filenameId = *file;
@@ -140,6 +243,36 @@ OptValue<DebugSourceLocation> DebugInfo::getLocationForAddress(
   return llvh::None;
 }
 
+void DebugInfo::getSourceLocations(
+    uint32_t debugOffset,
+    DebugSourceLocation &start,
+    std::vector<DebugSourceLocation> &locations) const {
+  // The file regions are sorted by offset, and a new one starts wherever the
+  // file changes, so track the region while decoding.
+  unsigned region = 0;
+  auto setFile = [this, &region](uint32_t offset, DebugSourceLocation &loc) {
+    while (region + 1 < files_.size() &&
+           files_[region + 1].fromAddress <= offset) {
+      ++region;
+    }
+    if (region < files_.size() && files_[region].fromAddress <= offset) {
+      loc.filenameId = files_[region].filenameId;
+      loc.sourceMappingUrlId = files_[region].sourceMappingUrlId;
+    }
+  };
+
+  FunctionDebugInfoDeserializer fdid(sourceLocationsData(), debugOffset);
+  start = fdid.getCurrent();
+  setFile(debugOffset, start);
+  uint32_t locationOffset = fdid.getOffset();
+  while (auto next = fdid.next()) {
+    DebugSourceLocation loc = *next;
+    setFile(locationOffset, loc);
+    locations.push_back(loc);
+    locationOffset = fdid.getOffset();
+  }
+}
+
 OptValue<DebugSearchResult> DebugInfo::getAddressForLocation(
     uint32_t filenameId,
     uint32_t targetLine,
@@ -431,6 +564,15 @@ DebugInfoGenerator::DebugInfoGenerator(UniquingFilenameTable &&filenameTable)
 uint32_t DebugInfoGenerator::appendLexicalData(
     OptValue<uint32_t> parentFunc,
     llvh::ArrayRef<Identifier> names) {
+  llvh::SmallVector<llvh::StringRef, 4> strs;
+  for (Identifier name : names)
+    strs.push_back(name.str());
+  return appendLexicalData(parentFunc, strs);
+}
+
+uint32_t DebugInfoGenerator::appendLexicalData(
+    OptValue<uint32_t> parentFunc,
+    llvh::ArrayRef<llvh::StringRef> names) {
   assert(validData && "DebugInfoGenerator not valid");
   if (!parentFunc.hasValue() && names.empty()) {
     return kEmptyLexicalDataOffset;
@@ -438,8 +580,8 @@ uint32_t DebugInfoGenerator::appendLexicalData(
   const uint32_t startOffset = lexicalData_.size();
   appendSignedLEB128(lexicalData_, parentFunc ? *parentFunc : int64_t(-1));
   appendSignedLEB128(lexicalData_, names.size());
-  for (Identifier name : names)
-    appendString(lexicalData_, name.str());
+  for (llvh::StringRef name : names)
+    appendString(lexicalData_, name);
   return startOffset;
 }
 
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/BCGen/HBC/FunctionTrace.h"
+
+#include "llvh/ADT/SmallVector.h"
+#include "llvh/Support/raw_ostream.h"
+
+namespace hermes {
+namespace hbc {
+
+bool parseFunctionTrace(
+    llvh::StringRef contents,
+    llvh::StringRef fileName,
+    std::vector<uint32_t> &ids) {
+  llvh::SmallVector<llvh::StringRef, 64> lines;
+  contents.split(lines, '\n');
+  for (size_t i = 0, e = lines.size(); i < e; ++i) {
+    llvh::StringRef line = lines[i].trim();
+    if (line.empty() || line.startswith("#")) {
+      continue;
+    }
+    uint32_t id;
+    if (line.getAsInteger(10, id)) {
+      llvh::errs() << fileName << ":" << i + 1
+                   << ": error: expected a function ID\n";
+      return false;
+    }
+    ids.push_back(id);
+  }
+  return true;
+}
+
+} // namespace hbc
+} // namespace hermes
@@ -223,12 +223,15 @@ std::unique_ptr<BytecodeModule> hbc::generateBytecodeModule(
   }
 
   // Add each function to BMGen so that each function has a unique ID.
+  std::vector<Function *> functionsByID;
   for (auto &F : *M) {
     if (!shouldGenerate(&F)) {
       continue;
     }
 
     unsigned index = BMGen.addFunction(&F);
+    assert(index == functionsByID.size() && "Function IDs are not sequential");
+    functionsByID.push_back(&F);
     if (&F == entryPoint) {
       BMGen.setEntryPointIndex(index);
     }
@@ -257,12 +260,11 @@ std::unique_ptr<BytecodeModule> hbc::generateBytecodeModule(
   // Allow reusing the debug cache between functions
   HBCISelDebugCache debugCache;
 
-  // Bytecode generation for each function.
-  for (auto &F : *M) {
-    if (!shouldGenerate(&F)) {
-      continue;
-    }
-
+  // Bytecode generation for each function, in the order they will be laid
+  // out, so that literal buffers used together are also laid out together.
+  for (uint32_t id : BytecodeSerializer::computeFunctionLayout(
+           options.functionLayoutOrder, functionsByID.size())) {
+    Function &F = *functionsByID[id];
     std::unique_ptr<BytecodeFunctionGenerator> funcGen;
 
     if (F.isLazy()) {
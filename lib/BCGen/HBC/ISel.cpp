@@ -549,7 +549,7 @@ void HBCISel::generateStorePropertyInst(
   if (auto *Lit = llvh::dyn_cast<LiteralString>(prop)) {
     // Property is a string
     auto id = BCFGen_->getIdentifierID(Lit);
-    if (id <= UINT16_MAX)
+    if (fitsOperand(id, UINT16_MAX))
       BCFGen_->emitPutById(
           objReg, valueReg, acquirePropertyWriteCacheIndex(id), id);
     else
@@ -572,7 +572,7 @@ void HBCISel::generateTryStoreGlobalPropertyInst(
   auto *Lit = cast<LiteralString>(prop);
 
   auto id = BCFGen_->getIdentifierID(Lit);
-  if (id <= UINT16_MAX) {
+  if (fitsOperand(id, UINT16_MAX)) {
     BCFGen_->emitTryPutById(
         objReg, valueReg, acquirePropertyWriteCacheIndex(id), id);
   } else {
@@ -636,15 +636,15 @@ void HBCISel::generateStoreNewOwnPropertyInst(
   auto id = BCFGen_->getIdentifierID(strProp);
 
   if (isEnumerable) {
-    if (id > UINT16_MAX) {
+    if (!fitsOperand(id, UINT16_MAX)) {
       BCFGen_->emitPutNewOwnByIdLong(objReg, valueReg, id);
-    } else if (id > UINT8_MAX) {
+    } else if (!fitsOperand(id, UINT8_MAX)) {
       BCFGen_->emitPutNewOwnById(objReg, valueReg, id);
     } else {
       BCFGen_->emitPutNewOwnByIdShort(objReg, valueReg, id);
     }
   } else {
-    if (id > UINT16_MAX) {
+    if (!fitsOperand(id, UINT16_MAX)) {
       BCFGen_->emitPutNewOwnNEByIdLong(objReg, valueReg, id);
     } else {
       BCFGen_->emitPutNewOwnNEById(objReg, valueReg, id);
@@ -673,7 +673,7 @@ void HBCISel::generateDeletePropertyInst(
 
   if (auto *Lit = llvh::dyn_cast<LiteralString>(prop)) {
     auto id = BCFGen_->getIdentifierID(Lit);
-    if (id <= UINT16_MAX)
+    if (fitsOperand(id, UINT16_MAX))
       BCFGen_->emitDelById(resultReg, objReg, id);
     else
       BCFGen_->emitDelByIdLong(resultReg, objReg, id);
@@ -692,10 +692,10 @@ void HBCISel::generateLoadPropertyInst(
 
   if (auto *Lit = llvh::dyn_cast<LiteralString>(prop)) {
     auto id = BCFGen_->getIdentifierID(Lit);
-    if (id > UINT16_MAX) {
+    if (!fitsOperand(id, UINT16_MAX)) {
       BCFGen_->emitGetByIdLong(
           resultReg, objReg, acquirePropertyReadCacheIndex(id), id);
-    } else if (id > UINT8_MAX) {
+    } else if (!fitsOperand(id, UINT8_MAX)) {
       BCFGen_->emitGetById(
           resultReg, objReg, acquirePropertyReadCacheIndex(id), id);
     } else {
@@ -719,7 +719,7 @@ void HBCISel::generateTryLoadGlobalPropertyInst(
   auto *Lit = cast<LiteralString>(prop);
 
   auto id = BCFGen_->getIdentifierID(Lit);
-  if (id > UINT16_MAX) {
+  if (!fitsOperand(id, UINT16_MAX)) {
     BCFGen_->emitTryGetByIdLong(
         resultReg, objReg, acquirePropertyReadCacheIndex(id), id);
   } else {
@@ -768,7 +768,7 @@ void HBCISel::generateAllocArrayInst(AllocArrayInst *Inst, BasicBlock *next) {
     }
     auto bufIndex =
         BCFGen_->BMGen_.addArrayBuffer(ArrayRef<Literal *>{elements});
-    if (bufIndex <= UINT16_MAX) {
+    if (fitsOperand(bufIndex, UINT16_MAX)) {
       BCFGen_->emitNewArrayWithBuffer(
           encodeValue(Inst), sizeHint, elementCount, bufIndex);
     } else {
@@ -796,7 +796,7 @@ void HBCISel::generateHBCCreateFunctionInst(
   auto code = BCFGen_->getFunctionID(Inst->getFunctionCode());
   bool isGen = llvh::isa<GeneratorFunction>(Inst->getFunctionCode());
   bool isAsync = llvh::isa<AsyncFunction>(Inst->getFunctionCode());
-  if (LLVM_LIKELY(code <= UINT16_MAX)) {
+  if (LLVM_LIKELY(fitsOperand(code, UINT16_MAX))) {
     // Most of the cases, function index will be less than 2^16.
     if (isAsync) {
       BCFGen_->emitCreateAsyncClosure(output, env, code);
@@ -835,7 +835,8 @@ void HBCISel::generateHBCAllocObjectFromBufferInst(
 
   auto buffIdxs = BCFGen_->BMGen_.addObjectBuffer(
       llvh::ArrayRef<Literal *>{objKeys}, llvh::ArrayRef<Literal *>{objVals});
-  if (buffIdxs.first <= UINT16_MAX && buffIdxs.second <= UINT16_MAX) {
+  if (fitsOperand(buffIdxs.first, UINT16_MAX) &&
+      fitsOperand(buffIdxs.second, UINT16_MAX)) {
     BCFGen_->emitNewObjectWithBuffer(
         result, sizeHint, e, buffIdxs.first, buffIdxs.second);
   } else {
@@ -930,7 +931,7 @@ void HBCISel::generateHBCCreateGeneratorInst(
   auto env = encodeValue(Inst->getEnvironment());
   auto output = encodeValue(Inst);
   auto code = BCFGen_->getFunctionID(Inst->getFunctionCode());
-  if (LLVM_LIKELY(code <= UINT16_MAX)) {
+  if (LLVM_LIKELY(fitsOperand(code, UINT16_MAX))) {
     // Most of the cases, function index will be less than 2^16.
     BCFGen_->emitCreateGenerator(output, env, code);
   } else {
@@ -1295,7 +1296,7 @@ void HBCISel::generateHBCCallDirectInst(
       Inst->getNumArguments() <= HBCCallDirectInst::MAX_ARGUMENTS &&
       "too many arguments to CallDirect");
 
-  if (LLVM_LIKELY(code <= UINT16_MAX)) {
+  if (LLVM_LIKELY(fitsOperand(code, UINT16_MAX))) {
     // Most of the cases, function index will be less than 2^16.
     BCFGen_->emitCallDirect(output, Inst->getNumArguments(), code);
   } else {
@@ -1402,7 +1403,7 @@ void HBCISel::generateHBCLoadConstInst(
     }
     case ValueKind::LiteralStringKind: {
       auto idx = BCFGen_->getStringID(cast<LiteralString>(literal));
-      if (idx <= UINT16_MAX) {
+      if (fitsOperand(idx, UINT16_MAX)) {
         BCFGen_->emitLoadConstString(output, idx);
       } else {
         BCFGen_->emitLoadConstStringLongIndex(output, idx);
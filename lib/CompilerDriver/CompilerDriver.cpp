@@ -13,6 +13,7 @@
 #include "hermes/AST/SemValidate.h"
 #include "hermes/AST2JS/AST2JS.h"
 #include "hermes/BCGen/HBC/BytecodeDisassembler.h"
+#include "hermes/BCGen/HBC/FunctionTrace.h"
 #include "hermes/BCGen/HBC/HBC.h"
 #include "hermes/BCGen/RegAlloc.h"
 #include "hermes/ConsoleHost/ConsoleHost.h"
@@ -279,6 +280,12 @@ static opt<bool> EagerCompilation(
     desc("Force fully eager compilation"),
     cat(CompilerCategory));
 
+static opt<unsigned> PreParseThreads(
+    "preparse-threads",
+    init(1),
+    desc("Pre-parse large files for lazy compilation on up to N threads"),
+    cat(CompilerCategory));
+
 /// The following flags are exported so it may be used by the VM driver as well.
 opt<bool> BasicBlockProfiling(
     "basic-block-profiling",
@@ -532,6 +539,28 @@ static opt<std::string> BaseBytecodeFile(
     llvh::cl::init(""),
     cat(CompilerCategory));
 
+static opt<std::string> FunctionOrderFile(
+    "function-order",
+    desc("Lay out the bytecode of the functions listed in this file first, "
+         "in the listed order. The file has one function ID per line, as "
+         "written by hvm -function-trace."),
+    init(""),
+    cat(CompilerCategory));
+
+static opt<bool> CompressBytecode(
+    "compress-bytecode",
+    desc("Compress function bodies in the bytecode file. Each chunk of "
+         "functions is decompressed when one of them first runs."),
+    init(false),
+    cat(CompilerCategory));
+
+static opt<bool> ObjectUnit(
+    "object-unit",
+    desc("Emit a bytecode object unit for the CommonJS modules in the input "
+         "files, to be combined with other units by hbc-link."),
+    init(false),
+    cat(CompilerCategory));
+
 static opt<unsigned> PadFunctionBodiesPercent(
     "pad-function-bodies-percent",
     desc(
@@ -948,6 +977,18 @@ bool validateFlags() {
       err("Multiple files must use CommonJS modules.");
   }
 
+  // Validate object unit flags.
+  if (cl::ObjectUnit) {
+    if (!cl::CommonJS)
+      err("-object-unit requires -commonjs");
+    if (cl::StaticRequire)
+      err("-object-unit doesn't support -fstatic-require");
+    if (cl::DumpTarget != EmitBundle)
+      err("-object-unit only works with -emit-binary");
+    if (!cl::BaseBytecodeFile.empty())
+      err("-object-unit doesn't support -base-bytecode");
+  }
+
   // Validate source map output flags.
   if (cl::OutputSourceMap) {
     if (cl::BytecodeOutputFilename.empty())
@@ -1099,6 +1140,7 @@ std::shared_ptr<Context> createContext(
     // By default with no optimization, use lazy compilation for "large" files
     context->setLazyCompilation(true);
   }
+  context->setPreParseThreads(cl::PreParseThreads);
 
   if (cl::CommonJS) {
     context->setUseCJSModules(true);
@@ -1464,6 +1506,20 @@ bool readBaseBytecodeMap(
   return true;
 }
 
+/// Read a list of function IDs, one per line, from \p inputPath into \p
+/// order. Empty lines and lines starting with '#' are ignored.
+/// Prints out error messages to stderr in case of failure.
+/// \return whether it succeeded.
+bool readFunctionOrder(
+    std::vector<uint32_t> &order,
+    llvh::StringRef inputPath) {
+  auto fileBuf = memoryBufferFromFile(inputPath);
+  if (!fileBuf) {
+    return false;
+  }
+  return hbc::parseFunctionTrace(fileBuf->getBuffer(), inputPath, order);
+}
+
 /// Read a resolution table. Given a file name, it maps every require string
 /// to the actual file which must be required.
 /// Prints out error messages to stderr in case of failure.
@@ -1947,6 +2003,15 @@ CompileResult processSourceFiles(
 
   genOptions.stripFunctionNames = cl::StripFunctionNames;
 
+  genOptions.compressBytecode = cl::CompressBytecode;
+  genOptions.objectUnit = cl::ObjectUnit;
+
+  if (!cl::FunctionOrderFile.empty() &&
+      !readFunctionOrder(
+          genOptions.functionLayoutOrder, cl::FunctionOrderFile)) {
+    return InputFileError;
+  }
+
   // If the dump target is None, return bytecode in an executable form.
   if (cl::DumpTarget == Execute) {
     assert(
@@ -15,6 +15,8 @@
 #include "hermes/VM/JSObject.h"
 #include "hermes/VM/MockedEnvironment.h"
 #include "hermes/VM/NativeArgs.h"
+#include "hermes/VM/Profiler/CodeCoverageProfiler.h"
+#include "hermes/VM/Profiler/JSPerfMap.h"
 #include "hermes/VM/Profiler/SamplingProfiler.h"
 #include "hermes/VM/Runtime.h"
 #include "hermes/VM/StringPrimitive.h"
@@ -22,6 +24,9 @@
 #include "hermes/VM/TimeLimitMonitor.h"
 #include "hermes/VM/instrumentation/PerfEvents.h"
 
+#include "llvh/Support/FileSystem.h"
+#include "llvh/Support/raw_ostream.h"
+
 namespace hermes {
 
 ConsoleHostContext::ConsoleHostContext(vm::Runtime *runtime) {
@@ -253,6 +258,30 @@ auto maybeCatchException(const F &f) -> decltype(f()) {
 #endif
 }
 
+/// Write the IDs of the functions of \p bytecode that ran in \p runtime to
+/// \p fileName, one per line, in the order they first ran.
+void writeFunctionTrace(
+    vm::Runtime *runtime,
+    const hbc::BCProvider *bytecode,
+    const std::string &fileName) {
+  std::error_code EC;
+  llvh::raw_fd_ostream os(fileName, EC, llvh::sys::fs::F_Text);
+  if (EC) {
+    llvh::errs() << "Error! Failed to open file: " << fileName << "\n";
+    return;
+  }
+  for (auto &module : runtime->getRuntimeModules()) {
+    if (module.getBytecode() != bytecode) {
+      continue;
+    }
+    for (uint32_t id :
+         runtime->getCodeCoverageProfiler().getExecutedFunctionIDsInOrder(
+             &module)) {
+      os << id << '\n';
+    }
+  }
+}
+
 bool executeHBCBytecodeImpl(
     std::shared_ptr<hbc::BCProvider> &&bytecode,
     const ExecuteOptions &options,
@@ -265,6 +294,18 @@ bool executeHBCBytecodeImpl(
 
   std::unique_ptr<vm::StatSamplingThread> statSampler;
   auto runtime = vm::Runtime::create(options.runtimeConfig);
+  if (options.runtimeConfig.getEnableJSPerfMap() && !runtime->getJSPerfMap()) {
+    // The runtime runs fine without the map, but perf won't symbolize JS.
+    if (!vm::JSPerfMap::isSupported()) {
+      llvh::errs() << "Warning: -perf-map is not supported by this build "
+                      "(requires HERMESVM_JS_PERF_MAP on Linux)\n";
+    } else {
+      const std::string &path = options.runtimeConfig.getJSPerfMapPath();
+      llvh::errs() << "Warning: -perf-map could not open "
+                   << (path.empty() ? vm::JSPerfMap::getPerfMapPath() : path)
+                   << "\n";
+    }
+  }
   if (options.stabilizeInstructionCount) {
     // Try to limit features that can introduce unpredictable CPU instruction
     // behavior. Date is a potential cause, but is not handled currently.
@@ -317,6 +358,11 @@ bool executeHBCBytecodeImpl(
     vm::SamplingProfiler::enable();
   }
 
+  const hbc::BCProvider *mainBytecode = bytecode.get();
+  if (!options.functionTraceFile.empty()) {
+    vm::CodeCoverageProfiler::enableGlobal();
+  }
+
   llvh::StringRef sourceURL{};
   if (filename)
     sourceURL = *filename;
@@ -368,6 +414,11 @@ bool executeHBCBytecodeImpl(
     vm::TimeLimitMonitor::getInstance().unwatchRuntime(runtime.get());
   }
 
+  if (!options.functionTraceFile.empty()) {
+    vm::CodeCoverageProfiler::disableGlobal();
+    writeFunctionTrace(runtime.get(), mainBytecode, options.functionTraceFile);
+  }
+
 #ifdef HERMESVM_PROFILER_OPCODE
   runtime->dumpOpcodeStats(llvh::outs());
 #endif
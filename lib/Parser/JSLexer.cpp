@@ -8,6 +8,7 @@
 #include "hermes/Parser/JSLexer.h"
 
 #include "dtoa/dtoa.h"
+#include "hermes/Support/ByteScan.h"
 #include "hermes/Support/Conversions.h"
 
 #include "llvh/ADT/ScopeExit.h"
@@ -376,10 +377,9 @@ const Token *JSLexer::advance(GrammarContext grammarContext) {
 
       case '\t':
       case ' ':
-        // Spaces frequently come in groups, so use a tight inner loop to skip.
-        do
-          ++curCharPtr_;
-        while (*curCharPtr_ == '\t' || *curCharPtr_ == ' ');
+        // Spaces frequently come in groups (indentation), so skip them in
+        // bulk.
+        curCharPtr_ = bytescan::skipSpacesAndTabs(curCharPtr_ + 1, bufferEnd_);
         continue;
 
       // No-break space \u00A0 is UTF8 encoded as: c2 a0
@@ -1228,6 +1228,8 @@ llvh::StringRef JSLexer::lineCommentHelper(const char *start) {
   const char *cur = start + 2;
 
   for (;;) {
+    // Skip the ordinary characters in bulk.
+    cur = bytescan::findFirstOfOrNonASCII<'\n', '\r', '\0'>(cur, bufferEnd_);
     switch ((unsigned char)*cur) {
       case 0:
         if (cur == bufferEnd_) {
@@ -1301,6 +1303,9 @@ const char *JSLexer::skipBlockComment(const char *start) {
   const char *cur = start + 2;
 
   for (;;) {
+    // Skip the ordinary characters in bulk.
+    cur = bytescan::findFirstOfOrNonASCII<'*', '\n', '\r', '\0'>(
+        cur, bufferEnd_);
     switch ((unsigned char)*cur) {
       case 0:
         if (cur == bufferEnd_) {
@@ -1641,16 +1646,13 @@ TokenKind JSLexer::scanReservedWord(const char *start, unsigned length) {
 
 template <JSLexer::IdentifierMode Mode>
 void JSLexer::scanIdentifierFastPath(const char *start) {
-  const char *end = start;
-
   // Quickly consume the ASCII identifier part.
-  char ch;
-  do
-    ch = (unsigned char)*++end;
-  while (ch == '_' || ch == '$' || ((ch | 32) >= 'a' && (ch | 32) <= 'z') ||
-         (ch >= '0' && ch <= '9') ||
-         (Mode == IdentifierMode::JSX && ch == '-') ||
-         (Mode == IdentifierMode::Flow && ch == '@'));
+  constexpr char extraPart = Mode == IdentifierMode::JSX
+      ? '-'
+      : Mode == IdentifierMode::Flow ? '@' : 0;
+  const char *end =
+      bytescan::skipASCIIIdentifierParts(start + 1, bufferEnd_, extraPart);
+  char ch = *end;
 
   // Check whether a slow part of the identifier follows.
   if (LLVM_UNLIKELY(ch == '\\')) {
@@ -1732,6 +1734,13 @@ void JSLexer::scanString() {
   tmpStorage_.clear();
 
   for (;;) {
+    // Copy the characters that need no special handling in bulk.
+    const char *run = bytescan::
+        findFirstOfOrNonASCII<'\'', '"', '\\', '\n', '\r', '&', '\0'>(
+            curCharPtr_, bufferEnd_);
+    tmpStorage_.append(curCharPtr_, run);
+    curCharPtr_ = run;
+
     if (*curCharPtr_ == quoteCh) {
       ++curCharPtr_;
       break;
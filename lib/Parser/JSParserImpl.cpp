@@ -12,6 +12,17 @@
 
 #include "llvh/Support/SaveAndRestore.h"
 
+#include <atomic>
+#include <vector>
+
+#if defined(_WIN32)
+#define HERMES_PARSER_HAS_THREADS
+#include <thread>
+#elif !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+#define HERMES_PARSER_HAS_THREADS
+#include <pthread.h>
+#endif
+
 using llvh::cast;
 using llvh::dyn_cast;
 using llvh::isa;
@@ -6551,11 +6562,203 @@ Optional<ESTree::NodePtr> castNode(Optional<T> node) {
 }
 } // namespace
 
+/// A part of a buffer that is pre-parsed on its own.
+struct PreParseChunk {
+  /// The source of the chunk, inside the buffer being pre-parsed.
+  StringRef source;
+  /// Whether the chunk pre-parsed without any errors or warnings.
+  bool success{false};
+  /// Whether the chunk starts with a "use strict" directive.
+  bool useStrict{false};
+  bool useStaticBuiltin{false};
+  /// The functions found in the chunk, keyed by locations in \c source.
+  PreParsedBufferInfo info{};
+};
+
+namespace {
+/// Buffers are only split for parallel pre-parsing before a line that starts
+/// with this, which is how Metro emits each module factory in a bundle.
+constexpr llvh::StringLiteral kPreParseChunkStart{"\n__d("};
+
+/// Don't split buffers into chunks smaller than this.
+constexpr size_t kMinPreParseChunkSize = 256 * 1024;
+
+/// Split \p buffer into chunks of roughly \p targetSize bytes, each of which
+/// (but the first) starts with kPreParseChunkStart.
+std::vector<PreParseChunk> splitForPreParse(
+    StringRef buffer,
+    size_t targetSize) {
+  std::vector<PreParseChunk> chunks;
+  size_t start = 0;
+  while (start < buffer.size()) {
+    size_t end = buffer.size();
+    if (buffer.size() - start > targetSize) {
+      size_t next = buffer.find(kPreParseChunkStart, start + targetSize);
+      if (next != StringRef::npos)
+        end = next + 1;
+    }
+    chunks.emplace_back();
+    chunks.back().source = buffer.slice(start, end);
+    start = end;
+  }
+  return chunks;
+}
+
+#ifdef HERMES_PARSER_HAS_THREADS
+/// Run \p work on the calling thread and up to \p numThreads - 1 others, and
+/// wait for all of them to finish. Threads that can't be started are skipped.
+void runOnThreads(unsigned numThreads, llvh::function_ref<void()> work) {
+#ifdef _WIN32
+  // Secondary threads get the same stack size as the main thread.
+  std::vector<std::thread> threads;
+  for (unsigned i = 1; i < numThreads; ++i)
+    threads.emplace_back([work]() { work(); });
+  work();
+  for (std::thread &thread : threads)
+    thread.join();
+#else
+  // The parser's recursion limit assumes a main thread sized stack, which is
+  // larger than the default for secondary threads on some platforms.
+  constexpr size_t kStackSize = 8 << 20;
+  pthread_attr_t attr;
+  pthread_attr_init(&attr);
+  pthread_attr_setstacksize(&attr, kStackSize);
+  std::vector<pthread_t> threads;
+  for (unsigned i = 1; i < numThreads; ++i) {
+    pthread_t thread;
+    if (pthread_create(
+            &thread,
+            &attr,
+            [](void *arg) -> void * {
+              (*static_cast<llvh::function_ref<void()> *>(arg))();
+              return nullptr;
+            },
+            &work) != 0) {
+      break;
+    }
+    threads.push_back(thread);
+  }
+  pthread_attr_destroy(&attr);
+  work();
+  for (pthread_t thread : threads)
+    pthread_join(thread, nullptr);
+#endif
+}
+#endif
+} // namespace
+
+bool JSParserImpl::preParseChunk(
+    Context &context,
+    PreParseChunk &chunk,
+    bool strictMode) {
+  // Every chunk gets a context of its own, since contexts are not thread-safe,
+  // and a copy of its source, since the lexer relies on a NUL terminator.
+  Context chunkContext;
+  chunkContext.setStrictMode(strictMode);
+  chunkContext.setParseJSX(context.getParseJSX());
+  chunkContext.setParseFlow(
+      context.getParseFlowAmbiguous()
+          ? ParseFlowSetting::ALL
+          : context.getParseFlow() ? ParseFlowSetting::UNAMBIGUOUS
+                                   : ParseFlowSetting::NONE);
+  chunkContext.setParseTS(context.getParseTS());
+  SourceErrorManager &sm = chunkContext.getSourceErrorManager();
+  // The chunk's messages would be meaningless to the user, so they are
+  // collected and discarded. The buffer is pre-parsed again as a whole if
+  // there are any, including lexer errors the parser recovered from.
+  CollectMessagesRAII collect(&sm, /* discardMessages */ true);
+
+  const char *start = chunk.source.begin();
+  auto copy = llvh::MemoryBuffer::getMemBufferCopy(chunk.source);
+  const char *copyStart = copy->getBufferStart();
+  uint32_t chunkBufferId = sm.addNewSourceBuffer(std::move(copy));
+  auto translate = [start, copyStart](SMLoc loc) {
+    return SMLoc::getFromPointer(start + (loc.getPointer() - copyStart));
+  };
+
+  JSParserImpl parser(chunkContext, chunkBufferId, PreParse);
+  auto result = parser.parse();
+  chunk.success = result.hasValue() && !collect.hasMessages();
+  if (!chunk.success)
+    return false;
+  chunk.useStaticBuiltin = parser.getUseStaticBuiltin();
+  for (ESTree::Node &stmt : (*result)->_body) {
+    auto *exprStmt = dyn_cast<ESTree::ExpressionStatementNode>(&stmt);
+    if (!exprStmt || !exprStmt->_directive)
+      break;
+    if (exprStmt->_directive == parser.useStrictIdent_)
+      chunk.useStrict = true;
+  }
+
+  for (auto &entry :
+       chunkContext.getPreParsedBufferInfo(chunkBufferId)->functionInfo) {
+    PreParsedFunctionInfo &info = entry.second;
+    info.end = translate(info.end);
+    chunk.info.functionInfo[translate(entry.first)] = std::move(info);
+  }
+  return true;
+}
+
+bool JSParserImpl::preParseBufferInParallel(
+    Context &context,
+    uint32_t bufferId,
+    bool &useStaticBuiltinDetected) {
+#ifdef HERMES_PARSER_HAS_THREADS
+  StringRef buffer =
+      context.getSourceErrorManager().getSourceBuffer(bufferId)->getBuffer();
+  unsigned numThreads = context.getPreParseThreads();
+  // Use a few chunks per thread, so that threads that finish early can take
+  // over the work of others.
+  std::vector<PreParseChunk> chunks = splitForPreParse(
+      buffer, std::max(buffer.size() / (numThreads * 4), kMinPreParseChunkSize));
+  if (chunks.size() < 2)
+    return false;
+
+  // A directive prologue can only appear in the first chunk, so the others
+  // start in the strict mode of the context. If the first chunk turns out to
+  // make the whole program strict, they would need to be redone, so the
+  // buffer is pre-parsed as a whole instead.
+  bool strictMode = context.isStrictMode();
+  std::atomic<size_t> nextChunk{0};
+  std::atomic<bool> failed{false};
+  runOnThreads(std::min<size_t>(numThreads, chunks.size()), [&]() {
+    while (!failed) {
+      size_t i = nextChunk++;
+      if (i >= chunks.size())
+        break;
+      if (!preParseChunk(context, chunks[i], strictMode))
+        failed = true;
+    }
+  });
+
+  if (failed || (chunks.front().useStrict && !strictMode))
+    return false;
+
+  // Merge in chunk order, so the result doesn't depend on the scheduling.
+  PreParsedBufferInfo *preParsed = context.getPreParsedBufferInfo(bufferId);
+  for (PreParseChunk &chunk : chunks) {
+    for (auto &entry : chunk.info.functionInfo)
+      preParsed->functionInfo[entry.first] = std::move(entry.second);
+  }
+  useStaticBuiltinDetected = chunks.front().useStaticBuiltin;
+  return true;
+#else
+  return false;
+#endif
+}
+
 bool JSParserImpl::preParseBuffer(
     Context &context,
     uint32_t bufferId,
     bool &useStaticBuiltinDetected) {
   PerfSection preparsing("Pre-Parsing JavaScript");
+  // Large buffers may be pre-parsed in chunks on several threads. If that
+  // fails for any reason, pre-parse the buffer as a whole, so that the errors
+  // are reported the same way in both modes.
+  if (context.getPreParseThreads() > 1 &&
+      preParseBufferInParallel(context, bufferId, useStaticBuiltinDetected)) {
+    return true;
+  }
   AllocationScope scope(context.getAllocator());
   JSParserImpl parser(context, bufferId, PreParse);
   auto result = parser.parse();
@@ -75,6 +75,8 @@ static constexpr Param ParamReturn{1 << 1};
 static constexpr Param ParamDefault{1 << 2};
 static constexpr Param ParamTagged{1 << 3};
 
+struct PreParseChunk;
+
 /// An EcmaScript 5.1 parser.
 /// It is a standard recursive descent LL(1) parser with no tricks. The only
 /// complication, is the need to communicate information to the lexer whether
@@ -151,6 +153,23 @@ class JSParserImpl {
       uint32_t bufferId,
       bool &useStaticBuiltinDetected);
 
+  /// Pre-parse the given buffer id by splitting it into chunks, which are
+  /// pre-parsed concurrently on up to Context::getPreParseThreads() threads.
+  /// \return false if the buffer could not be split, or any chunk could not
+  /// be pre-parsed on its own, in which case nothing is stored in the
+  /// \p Context.
+  static bool preParseBufferInParallel(
+      Context &context,
+      uint32_t bufferId,
+      bool &useStaticBuiltinDetected);
+
+  /// Pre-parse \p chunk as a program of its own, with \p strictMode as the
+  /// initial strict mode. \return true on success.
+  static bool preParseChunk(
+      Context &context,
+      PreParseChunk &chunk,
+      bool strictMode);
+
   /// Parse the AST of a specified function type at a given starting point.
   /// This is used for lazy compilation to parse and compile the function on
   /// the first call.
@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/Support/LZ4.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace hermes {
+namespace lz4 {
+
+// An LZ4 block is a sequence of (literals, match) pairs, ending with a pair
+// that only has literals. Each pair starts with a token whose high nibble is
+// the number of literals and whose low nibble is the match length minus
+// kMinMatch. A nibble of 15 is followed by bytes that are added to it, up to
+// and including the first byte that isn't 255. The literals follow, then the
+// match offset as 16 bits little endian, then any extra match length bytes.
+namespace {
+
+constexpr size_t kMinMatch = 4;
+/// The last kLastLiterals bytes of a block are always literals.
+constexpr size_t kLastLiterals = 5;
+/// No match may start in the last kMatchStartLimit bytes of a block.
+constexpr size_t kMatchStartLimit = 12;
+constexpr size_t kMaxOffset = 65535;
+constexpr unsigned kHashLog = 14;
+
+inline uint32_t read32(const uint8_t *p) {
+  uint32_t v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+inline uint32_t hash(uint32_t sequence) {
+  return (sequence * 2654435761u) >> (32 - kHashLog);
+}
+
+/// Append \p len to \p dst in the extra length byte encoding, having already
+/// stored 15 in the token.
+void writeExtraLength(size_t len, std::vector<uint8_t> &dst) {
+  for (; len >= 255; len -= 255) {
+    dst.push_back(255);
+  }
+  dst.push_back(static_cast<uint8_t>(len));
+}
+
+/// Append a sequence of the literals \p literals followed by a match of
+/// \p matchLen bytes at \p offset. A zero \p matchLen ends the block.
+void writeSequence(
+    llvh::ArrayRef<uint8_t> literals,
+    size_t offset,
+    size_t matchLen,
+    std::vector<uint8_t> &dst) {
+  size_t litLen = literals.size();
+  size_t tokenPos = dst.size();
+  dst.push_back(static_cast<uint8_t>(std::min<size_t>(litLen, 15) << 4));
+  if (litLen >= 15) {
+    writeExtraLength(litLen - 15, dst);
+  }
+  dst.insert(dst.end(), literals.begin(), literals.end());
+  if (matchLen == 0) {
+    return;
+  }
+
+  dst.push_back(static_cast<uint8_t>(offset));
+  dst.push_back(static_cast<uint8_t>(offset >> 8));
+  size_t len = matchLen - kMinMatch;
+  dst[tokenPos] |= static_cast<uint8_t>(std::min<size_t>(len, 15));
+  if (len >= 15) {
+    writeExtraLength(len - 15, dst);
+  }
+}
+
+/// Read an extra length from [\p ip, \p end) and add it to \p len.
+/// \return false if the input ends first.
+bool readExtraLength(const uint8_t *&ip, const uint8_t *end, size_t &len) {
+  uint8_t b;
+  do {
+    if (ip == end) {
+      return false;
+    }
+    b = *ip++;
+    len += b;
+  } while (b == 255);
+  return true;
+}
+
+} // namespace
+
+void compress(llvh::ArrayRef<uint8_t> src, std::vector<uint8_t> &dst) {
+  const uint8_t *base = src.data();
+  size_t size = src.size();
+  size_t anchor = 0;
+
+  if (size > kMatchStartLimit) {
+    // Positions of the last sequence seen with each hash. A stale or
+    // colliding entry is caught by comparing the bytes.
+    std::vector<uint32_t> table(1u << kHashLog, 0);
+    size_t matchStartEnd = size - kMatchStartLimit;
+    size_t matchEnd = size - kLastLiterals;
+    size_t pos = 0;
+    while (pos < matchStartEnd) {
+      uint32_t sequence = read32(base + pos);
+      uint32_t &slot = table[hash(sequence)];
+      size_t candidate = slot;
+      slot = static_cast<uint32_t>(pos);
+      if (candidate >= pos || pos - candidate > kMaxOffset ||
+          read32(base + candidate) != sequence) {
+        // Skip ahead faster through data that doesn't compress.
+        pos += 1 + ((pos - anchor) >> 6);
+        continue;
+      }
+
+      size_t len = kMinMatch;
+      while (pos + len < matchEnd && base[candidate + len] == base[pos + len]) {
+        ++len;
+      }
+      writeSequence(
+          llvh::makeArrayRef(base + anchor, pos - anchor),
+          pos - candidate,
+          len,
+          dst);
+      pos += len;
+      anchor = pos;
+    }
+  }
+
+  writeSequence(llvh::makeArrayRef(base + anchor, size - anchor), 0, 0, dst);
+}
+
+bool decompress(
+    llvh::ArrayRef<uint8_t> src,
+    llvh::MutableArrayRef<uint8_t> dst) {
+  const uint8_t *ip = src.begin();
+  const uint8_t *srcEnd = src.end();
+  uint8_t *op = dst.begin();
+  uint8_t *dstEnd = dst.end();
+
+  while (true) {
+    if (ip == srcEnd) {
+      return false;
+    }
+    uint8_t token = *ip++;
+
+    size_t litLen = token >> 4;
+    if (litLen == 15 && !readExtraLength(ip, srcEnd, litLen)) {
+      return false;
+    }
+    if (litLen > static_cast<size_t>(srcEnd - ip) ||
+        litLen > static_cast<size_t>(dstEnd - op)) {
+      return false;
+    }
+    std::memcpy(op, ip, litLen);
+    ip += litLen;
+    op += litLen;
+
+    if (ip == srcEnd) {
+      // The last sequence has no match.
+      return op == dstEnd;
+    }
+
+    if (srcEnd - ip < 2) {
+      return false;
+    }
+    size_t offset = ip[0] | (ip[1] << 8);
+    ip += 2;
+    if (offset == 0 || offset > static_cast<size_t>(op - dst.begin())) {
+      return false;
+    }
+
+    size_t matchLen = token & 15;
+    if (matchLen == 15 && !readExtraLength(ip, srcEnd, matchLen)) {
+      return false;
+    }
+    matchLen += kMinMatch;
+    if (matchLen > static_cast<size_t>(dstEnd - op)) {
+      return false;
+    }
+    const uint8_t *match = op - offset;
+    if (offset >= matchLen) {
+      std::memcpy(op, match, matchLen);
+      op += matchLen;
+    } else {
+      // The match overlaps the bytes it produces, repeating a short pattern.
+      for (size_t i = 0; i < matchLen; ++i) {
+        *op++ = *match++;
+      }
+    }
+  }
+}
+
+} // namespace lz4
+} // namespace hermes
@@ -11,6 +11,7 @@
 #include "hermes/Support/OSCompat.h"
 
 #include <cassert>
+#include <cstring>
 #include <vector>
 
 #include <signal.h>
@@ -155,12 +156,35 @@ void vm_free_aligned(void *p, size_t sz) {
   vm_free(p, sz);
 }
 
+llvh::ErrorOr<void *> vm_reserve_aligned(size_t sz, size_t alignment) {
+  // There is no way to reserve memory without allocating it.
+  return vm_allocate_aligned(sz, alignment);
+}
+
+void vm_release_aligned(void *p, size_t sz) {
+  vm_free_aligned(p, sz);
+}
+
+bool vm_commit(void *p, size_t sz) {
+  return true;
+}
+
+void vm_uncommit(void *p, size_t sz) {
+  // The memory stays allocated, but must read as zero when it is reused.
+  memset(p, 0, sz);
+}
+
 void vm_hugepage(void *p, size_t sz) {
   assert(
       reinterpret_cast<uintptr_t>(p) % page_size() == 0 &&
       "Precondition: pointer is page-aligned.");
 }
 
+bool vm_bind_local_numa(void *p, size_t sz) {
+  // Not implemented.
+  return false;
+}
+
 void vm_unused(void *p, size_t sz) {
 #ifndef NDEBUG
   const size_t PS = page_size();
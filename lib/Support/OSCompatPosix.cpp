@@ -201,6 +201,65 @@ void vm_free_aligned(void *p, size_t sz) {
   vm_free(p, sz);
 }
 
+llvh::ErrorOr<void *> vm_reserve_aligned(size_t sz, size_t alignment) {
+  assert(sz > 0 && sz % page_size() == 0);
+  assert(alignment > 0 && alignment % page_size() == 0);
+
+  // A PROT_NONE mapping isn't charged against the commit limit. Where the
+  // kernel honours MAP_NORESERVE, the pages aren't charged when they are
+  // committed either; under strict overcommit only committed pages are.
+  // Reserve enough to contain an aligned subsection, and trim the rest.
+  const size_t excessSize = sz + alignment - page_size_real();
+  void *raw = mmap(
+      nullptr,
+      excessSize,
+      PROT_NONE,
+      MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+      -1,
+      0);
+  if (raw == MAP_FAILED) {
+    return std::error_code(errno, std::generic_category());
+  }
+  char *aligned = alignAlloc(raw, alignment);
+  size_t excessAtFront = aligned - static_cast<char *>(raw);
+  size_t excessAtBack = excessSize - excessAtFront - sz;
+  if (excessAtFront)
+    munmap(raw, excessAtFront);
+  if (excessAtBack)
+    munmap(aligned + sz, excessAtBack);
+  return aligned;
+}
+
+void vm_release_aligned(void *p, size_t sz) {
+  auto ret = munmap(p, sz);
+  assert(!ret && "Failed to release reserved memory region.");
+  (void)ret;
+}
+
+bool vm_commit(void *p, size_t sz) {
+  assert(
+      reinterpret_cast<uintptr_t>(p) % page_size() == 0 &&
+      "Precondition: pointer is page-aligned.");
+  return mprotect(p, sz, PROT_READ | PROT_WRITE) == 0;
+}
+
+void vm_uncommit(void *p, size_t sz) {
+  assert(
+      reinterpret_cast<uintptr_t>(p) % page_size() == 0 &&
+      "Precondition: pointer is page-aligned.");
+  // Revoking access with mprotect would keep the commit charge, so map fresh
+  // reserved pages over the region instead.
+  void *result = mmap(
+      p,
+      sz,
+      PROT_NONE,
+      MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED,
+      -1,
+      0);
+  assert(result != MAP_FAILED && "Failed to uncommit memory region.");
+  (void)result;
+}
+
 void vm_hugepage(void *p, size_t sz) {
   assert(
       reinterpret_cast<uintptr_t>(p) % page_size() == 0 &&
@@ -212,6 +271,39 @@ void vm_hugepage(void *p, size_t sz) {
 #endif
 }
 
+bool vm_bind_local_numa(void *p, size_t sz) {
+  assert(
+      reinterpret_cast<uintptr_t>(p) % page_size() == 0 &&
+      "Precondition: pointer is page-aligned.");
+
+#if defined(__linux__) && defined(SYS_mbind) && defined(SYS_getcpu)
+  // Avoid a dependency on libnuma by invoking the syscalls directly.
+  // MPOL_PREFERRED (rather than MPOL_BIND) lets the kernel fall back to other
+  // nodes instead of failing the fault when the local node is exhausted.
+  constexpr int kMPolPreferred = 1;
+  unsigned cpu = 0, node = 0;
+  if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0)
+    return false;
+  constexpr unsigned kBitsPerWord = sizeof(unsigned long) * 8;
+  unsigned long nodeMask[4] = {0, 0, 0, 0};
+  if (node >= sizeof(nodeMask) * 8)
+    return false;
+  nodeMask[node / kBitsPerWord] = 1ul << (node % kBitsPerWord);
+  // maxnode is the number of bits in the mask plus one.
+  return syscall(
+             SYS_mbind,
+             p,
+             sz,
+             kMPolPreferred,
+             nodeMask,
+             sizeof(nodeMask) * 8 + 1,
+             0) == 0;
+#else
+  (void)sz;
+  return false;
+#endif
+}
+
 void vm_unused(void *p, size_t sz) {
 #ifndef NDEBUG
   const size_t PS = page_size();
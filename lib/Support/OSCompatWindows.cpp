@@ -241,12 +241,53 @@ void vm_free_aligned(void *p, size_t sz) {
 #endif
 }
 
+llvh::ErrorOr<void *> vm_reserve_aligned(size_t sz, size_t alignment) {
+  assert(sz > 0 && sz % page_size() == 0);
+  assert(alignment > 0 && alignment % page_size() == 0);
+  // Reserve enough to contain an aligned subsection. Reserved pages are not
+  // charged against the commit limit, so the excess costs only address space.
+  llvh::ErrorOr<void *> result =
+      vm_allocate_impl(nullptr, sz + alignment - page_size_real(), MEM_RESERVE);
+  if (!result) {
+    return result;
+  }
+  return static_cast<void *>(alignAlloc(*result, alignment));
+}
+
+void vm_release_aligned(void *p, size_t sz) {
+  // p may not be the base of the reservation, see vm_reserve_aligned.
+  MEMORY_BASIC_INFORMATION mbi;
+  SIZE_T query_ret = VirtualQuery(p, &mbi, sizeof(MEMORY_BASIC_INFORMATION));
+  assert(
+      query_ret != 0 && "Failed to invoke VirtualQuery in vm_release_aligned");
+  (void)query_ret;
+
+  BOOL ret = VirtualFree(mbi.AllocationBase, 0, MEM_RELEASE);
+  assert(ret && "Failed to invoke VirtualFree in vm_release_aligned.");
+  (void)ret;
+}
+
+bool vm_commit(void *p, size_t sz) {
+  return VirtualAlloc(p, sz, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+}
+
+void vm_uncommit(void *p, size_t sz) {
+  BOOL ret = VirtualFree(p, sz, MEM_DECOMMIT);
+  assert(ret && "Failed to invoke VirtualFree in vm_uncommit.");
+  (void)ret;
+}
+
 void vm_hugepage(void *p, size_t sz) {
   assert(
       reinterpret_cast<uintptr_t>(p) % page_size() == 0 &&
       "Precondition: pointer is page-aligned.");
 }
 
+bool vm_bind_local_numa(void *p, size_t sz) {
+  // Not implemented.
+  return false;
+}
+
 void vm_unused(void *p, size_t sz) {
 #ifndef NDEBUG
   const size_t PS = page_size();
@@ -7,7 +7,11 @@
 
 #include "hermes/Support/UTF16Stream.h"
 
+#include "hermes/Support/ASCIIScan.h"
+
+#include <algorithm>
 #include <cstdlib>
+#include <cstring>
 
 #include "llvh/ADT/ArrayRef.h"
 #include "llvh/Support/ConvertUTF.h"
@@ -18,14 +22,47 @@ namespace hermes {
 /// Number of char16_t in the internal conversion buffer (if UTF8 input).
 static constexpr size_t kChunkChars = 1024;
 
+/// Number of bytes in the input buffer (if UTF8 input read by a Reader).
+static constexpr size_t kInputBytes = 4096;
+
+/// The longest UTF8 sequence, in bytes.
+static constexpr size_t kMaxUTF8SequenceLength = 4;
+
 UTF16Stream::UTF16Stream(llvh::ArrayRef<uint8_t> utf8)
     : utf8Begin_(utf8.begin()), utf8End_(utf8.end()), storage_(kChunkChars) {
   // Exhaust the buffer and refill it.
   cur_ = end_ = storage_.end();
 }
 
+UTF16Stream::UTF16Stream(Reader reader)
+    : storage_(kChunkChars), reader_(std::move(reader)), input_(kInputBytes) {
+  // Exhaust both buffers and refill them.
+  cur_ = end_ = storage_.end();
+  utf8Begin_ = utf8End_ = input_.begin();
+}
+
+void UTF16Stream::readInput() {
+  size_t size = utf8End_ - utf8Begin_;
+  std::memmove(input_.begin(), utf8Begin_, size);
+  do {
+    size_t count = reader_(input_.begin() + size, input_.size() - size);
+    assert(count <= input_.size() - size && "reader overran the buffer");
+    if (count == 0) {
+      reader_ = nullptr;
+    }
+    size += count;
+  } while (reader_ && size < kMaxUTF8SequenceLength);
+  utf8Begin_ = input_.begin();
+  utf8End_ = input_.begin() + size;
+}
+
 bool UTF16Stream::refill() {
   assert(cur_ == end_ && "cannot refill when data remains");
+  if (reader_ && size_t(utf8End_ - utf8Begin_) < kMaxUTF8SequenceLength) {
+    // Top up the input so that it holds at least one whole character, unless
+    // it has ended.
+    readInput();
+  }
   if (utf8Begin_ == utf8End_) {
     // Pass-through mode, or final chunk already converted.
     // Either way, there's nothing (more) to convert.
@@ -41,13 +78,10 @@ bool UTF16Stream::refill() {
   // Fast case for any ASCII prefix...
   {
     int len = std::min(end_ - cur_, utf8End_ - utf8Begin_);
-    int index = 0;
-    while (index < len && utf8Begin_[index] < 128) {
-      out[index] = utf8Begin_[index];
-      ++index;
-    }
-    utf8Begin_ += index;
-    out += index;
+    const char *begin = reinterpret_cast<const char *>(utf8Begin_);
+    const char *asciiEnd = asciiscan::findNonASCII(begin, begin + len);
+    out = std::copy(utf8Begin_, utf8Begin_ + (asciiEnd - begin), out);
+    utf8Begin_ += asciiEnd - begin;
   }
 
   // ...and call the library for any non-ASCII remainder. Conversion always
@@ -59,9 +93,13 @@ bool UTF16Stream::refill() {
       (llvh::UTF16 *)const_cast<char16_t *>(end_),
       llvh::lenientConversion);
 
-  if (cRes != llvh::ConversionResult::targetExhausted) {
-    // Indicate that we have converted the final chunk.
+  if (cRes == llvh::ConversionResult::sourceIllegal ||
+      (!reader_ && cRes != llvh::ConversionResult::targetExhausted)) {
+    // Indicate that we have converted the final chunk. While a reader still
+    // has input, a character cut off at the end of the input read so far is
+    // completed by the next read instead.
     utf8Begin_ = utf8End_;
+    reader_ = nullptr;
   }
   end_ = out;
 
@@ -7,6 +7,8 @@
 
 #include "hermes/Support/UTF8.h"
 
+#include "hermes/Support/ASCIIScan.h"
+
 namespace hermes {
 
 void encodeUTF8(char *&dst, uint32_t cp) {
@@ -132,6 +134,10 @@ void convertUTF16ToUTF8WithSingleSurrogates(
 }
 
 bool isAllASCII(const uint8_t *start, const uint8_t *end) {
+#ifdef HERMES_BYTESCAN_VECTOR
+  const char *e = reinterpret_cast<const char *>(end);
+  return asciiscan::findNonASCII(reinterpret_cast<const char *>(start), e) == e;
+#else
   const uint8_t *cursor = start;
   size_t len = end - start;
   static_assert(
@@ -167,6 +173,11 @@ bool isAllASCII(const uint8_t *start, const uint8_t *end) {
   if (mask & 0x80u)
     return false;
   return true;
+#endif
+}
+
+bool isAllASCII(const char16_t *start, const char16_t *end) {
+  return asciiscan::findNonASCII(start, end) == end;
 }
 
 } // namespace hermes
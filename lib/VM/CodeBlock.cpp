@@ -15,6 +15,7 @@
 #include "hermes/Support/Conversions.h"
 #include "hermes/Support/PerfSection.h"
 #include "hermes/VM/GCPointer-inline.h"
+#include "hermes/VM/LazyCompileQueue.h"
 #include "hermes/VM/Runtime.h"
 #include "hermes/VM/RuntimeModule.h"
 #include "hermes/VM/SerializedLiteralParser.h"
@@ -214,6 +215,19 @@ OptValue<uint32_t> CodeBlock::getDebugSourceLocationsOffset() const {
   return ret;
 }
 
+#ifndef HERMESVM_LEAN
+namespace {
+/// \return a lock for using the Context of a lazy function in \p
+/// runtimeModule, which the background compiler may be using at the same time.
+std::unique_lock<std::mutex> lockLazyContext(RuntimeModule *runtimeModule) {
+  if (auto *queue = runtimeModule->getRuntime()->getLazyCompileQueue()) {
+    return queue->lockContexts();
+  }
+  return std::unique_lock<std::mutex>{};
+}
+} // namespace
+#endif
+
 OptValue<hbc::DebugSourceLocation> CodeBlock::getSourceLocation(
     uint32_t offset) const {
 #ifndef HERMESVM_LEAN
@@ -226,6 +240,7 @@ OptValue<hbc::DebugSourceLocation> CodeBlock::getSourceLocation(
     auto sourceLoc = lazyData->span.Start;
 
     SourceErrorManager::SourceCoords coords;
+    auto lock = lockLazyContext(runtimeModule_);
     if (!lazyData->context->getSourceErrorManager().findBufferLineAndLoc(
             sourceLoc, coords)) {
       return llvh::None;
@@ -298,6 +313,7 @@ SourceErrorManager::SourceCoords CodeBlock::getLazyFunctionLoc(
   auto *provider = (hbc::BCProviderLazy *)getRuntimeModule()->getBytecode();
   auto *func = provider->getBytecodeFunction();
   auto *lazyData = func->getLazyCompilationData();
+  auto lock = lockLazyContext(runtimeModule_);
   lazyData->context->getSourceErrorManager().findBufferLineAndLoc(
       start ? lazyData->span.Start : lazyData->span.End, coords);
 #endif
@@ -305,40 +321,18 @@ SourceErrorManager::SourceCoords CodeBlock::getLazyFunctionLoc(
 }
 
 #ifndef HERMESVM_LEAN
-namespace {
-std::unique_ptr<hbc::BytecodeModule> compileLazyFunction(
-    hbc::LazyCompilationData *lazyData) {
-  assert(lazyData);
-  LLVM_DEBUG(
-      llvh::dbgs() << "Compiling lazy function " << lazyData->originalName
-                   << "\n");
-
-  Module M{lazyData->context};
-  auto pair = hermes::generateLazyFunctionIR(lazyData, &M);
-  Function *entryPoint = pair.first;
-  Function *lexicalRoot = pair.second;
-
-  // We look up source map URLs by iterating modules and finding the first one
-  // with a matching buffer id, which will be the root module. These lazily
-  // compiled compiled modules therefore don't need to duplicate the URL,
-  // which can be several MB if it encodes the source map itself.
-  BytecodeGenerationOptions opts = BytecodeGenerationOptions::defaults();
-  opts.stripSourceMappingURL = true;
-
-  auto bytecodeModule =
-      hbc::generateBytecodeModule(&M, lexicalRoot, entryPoint, opts);
-
-  return bytecodeModule;
-}
-} // namespace
-
 void CodeBlock::lazyCompileImpl(Runtime *runtime) {
   assert(isLazy() && "Laziness has not been checked");
   PerfSection perf("Lazy function compilation");
   auto *provider = (hbc::BCProviderLazy *)runtimeModule_->getBytecode();
   auto *func = provider->getBytecodeFunction();
   auto *lazyData = func->getLazyCompilationData();
-  auto bcModule = compileLazyFunction(lazyData);
+  LLVM_DEBUG(
+      llvh::dbgs() << "Compiling lazy function " << lazyData->originalName
+                   << "\n");
+  LazyCompileQueue *queue = runtime->getLazyCompileQueue();
+  auto bcModule =
+      queue ? queue->getOrCompile(lazyData) : compileLazyFunction(lazyData);
 
   runtimeModule_->initializeLazyMayAllocate(
       hbc::BCProviderFromSrc::createBCProviderFromSrc(std::move(bcModule)));
@@ -50,6 +50,7 @@ GCBase::GCBase(
       heapKind_(kind),
       analyticsCallback_(gcConfig.getAnalyticsCallback()),
       recordGcStats_(gcConfig.getShouldRecordStats()),
+      streamHeapSnapshots_(gcConfig.getStreamHeapSnapshots()),
       // Start off not in GC.
       inGC_(false),
       name_(gcConfig.getName()),
@@ -136,8 +137,7 @@ std::error_code GCBase::createSnapshotToFile(const std::string &fileName) {
   if (code) {
     return code;
   }
-  createSnapshot(os);
-  return std::error_code{};
+  return createSnapshot(os);
 }
 
 namespace {
@@ -479,9 +479,10 @@ struct SnapshotRootAcceptor : public SnapshotAcceptor,
 
 } // namespace
 
-void GCBase::createSnapshot(GC *gc, llvh::raw_ostream &os) {
+std::error_code GCBase::createSnapshot(GC *gc, llvh::raw_ostream &os) {
   JSONEmitter json(os);
-  HeapSnapshot snap(json, gcCallbacks_->getStackTracesTree());
+  HeapSnapshot snap(
+      json, gcCallbacks_->getStackTracesTree(), streamHeapSnapshots_);
 
   const auto rootScan = [gc, &snap, this]() {
     {
@@ -581,6 +582,10 @@ void GCBase::createSnapshot(GC *gc, llvh::raw_ostream &os) {
   // Write the singleton number nodes into the snapshot.
   primitiveAcceptor.writeAllNodes();
   snap.endSection(HeapSnapshot::Section::Nodes);
+  if (auto ec = snap.checkSpools()) {
+    hermesLog("HermesGC", "Heap snapshot abandoned: %s", ec.message().c_str());
+    return ec;
+  }
 
   snap.beginSection(HeapSnapshot::Section::Edges);
   rootScan();
@@ -600,6 +605,11 @@ void GCBase::createSnapshot(GC *gc, llvh::raw_ostream &os) {
     cell->getVT()->snapshotMetaData.addLocations(cell, gc, snap);
   });
   snap.endSection(HeapSnapshot::Section::Locations);
+  if (auto ec = snap.checkSpools()) {
+    hermesLog("HermesGC", "Heap snapshot abandoned: %s", ec.message().c_str());
+    return ec;
+  }
+  return std::error_code{};
 }
 
 void GCBase::snapshotAddGCNativeNodes(HeapSnapshot &snap) {
@@ -656,8 +666,7 @@ void GCBase::checkTripwire(size_t dataSize) {
 
     std::error_code createSnapshot(std::ostream &os) override {
       llvh::raw_os_ostream ros(os);
-      gc_->createSnapshot(ros);
-      return std::error_code{};
+      return gc_->createSnapshot(ros);
     }
 
    private:
@@ -1832,9 +1841,11 @@ void GCBase::sizeDiagnosticCensus(size_t allocatedBytes) {
     // We include ExternalStringPrimitives because we're including external
     // memory in the overall heap size. We do not include
     // BufferedStringPrimitives because they just store a pointer to an
-    // ExternalStringPrimitive (which is already tracked).
+    // ExternalStringPrimitive (which is already tracked), nor
+    // SlicedStringPrimitives, whose characters belong to their parent.
     auto *strprim = dyn_vmcast<StringPrimitive>(cell);
-    if (strprim && !isBufferedStringPrimitive(cell)) {
+    if (strprim && !isBufferedStringPrimitive(cell) &&
+        !isSlicedStringPrimitive(cell)) {
       auto &stat = strprim->isASCII()
           ? acceptor.diagnostic.stats.breakdown["StringPrimitive (ASCII)"]
           : acceptor.diagnostic.stats.breakdown["StringPrimitive (UTF-16)"];
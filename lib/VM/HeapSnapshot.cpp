@@ -7,6 +7,7 @@
 
 #include "hermes/VM/HeapSnapshot.h"
 
+#include "hermes/Platform/Logging.h"
 #include "hermes/Support/Conversions.h"
 #include "hermes/Support/JSONEmitter.h"
 #include "hermes/Support/UTF8.h"
@@ -14,6 +15,15 @@
 #include "hermes/VM/StackTracesTree.h"
 #include "hermes/VM/StringPrimitive.h"
 
+#include "llvh/ADT/Hashing.h"
+#include "llvh/ADT/SmallString.h"
+#include "llvh/Support/FileSystem.h"
+#include "llvh/Support/Process.h"
+#include "llvh/Support/raw_ostream.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
 #include <type_traits>
 
 namespace hermes {
@@ -34,23 +44,277 @@ const char *kSectionLabels[] = {
 
 } // namespace
 
-HeapSnapshot::HeapSnapshot(JSONEmitter &json, StackTracesTree *stackTracesTree)
+/// The strings of a streaming snapshot. They are appended to a temporary file
+/// as they are interned, and read back one at a time when the "strings"
+/// section is emitted. Only short strings are deduplicated, through a
+/// direct-mapped cache, so memory use does not grow with the number or size
+/// of the strings in the heap. Duplicate entries in the "strings" section are
+/// allowed by the format.
+class HeapSnapshot::SpooledStringTable {
+ public:
+  /// The number of entries in the deduplication cache.
+  static constexpr size_t kCacheSize = 1 << 12;
+  /// Strings longer than this are never deduplicated.
+  static constexpr size_t kMaxCachedLength = 128;
+
+  /// \return a table whose first string has index \p firstIndex, or nullptr
+  ///   if no temporary file could be created.
+  static std::unique_ptr<SpooledStringTable> create(uint32_t firstIndex) {
+    llvh::SmallString<128> path;
+    if (llvh::sys::fs::createTemporaryFile(
+            "hermes-heap-snapshot", "strings", path)) {
+      return nullptr;
+    }
+    std::FILE *file = std::fopen(path.c_str(), "w+b");
+    if (!file) {
+      llvh::sys::fs::remove(path);
+      return nullptr;
+    }
+    return std::unique_ptr<SpooledStringTable>(
+        new SpooledStringTable(file, path, firstIndex));
+  }
+
+  ~SpooledStringTable() {
+    std::fclose(file_);
+    llvh::sys::fs::remove(path_);
+  }
+
+  /// \return the index of \p str, which is a new index unless \p str was
+  ///   found in the cache.
+  uint32_t insert(llvh::StringRef str) {
+    const bool cacheable = str.size() <= kMaxCachedLength;
+    CacheEntry &entry = cache_[llvh::hash_value(str) % kCacheSize];
+    if (cacheable && entry.index != kEmpty && entry.str == str) {
+      return entry.index;
+    }
+    // Strings are stored as a 32-bit length followed by the UTF-8 bytes. Once
+    // a write fails, the table can't be emitted, so stop writing.
+    const uint32_t len = str.size();
+    if (!failed_ &&
+        (std::fwrite(&len, sizeof(len), 1, file_) != 1 ||
+         std::fwrite(str.data(), 1, len, file_) != len)) {
+      failed_ = true;
+    }
+    const uint32_t index = nextIndex_++;
+    if (cacheable) {
+      entry.str.assign(str.begin(), str.end());
+      entry.index = index;
+    }
+    return index;
+  }
+
+  /// Write out any buffered strings.
+  /// \return an error if not every string could be written to the file.
+  std::error_code flush() {
+    if (failed_ || std::fflush(file_) != 0) {
+      failed_ = true;
+      return std::make_error_code(std::errc::io_error);
+    }
+    return std::error_code{};
+  }
+
+  /// Emit every string in the table to \p json, in index order.
+  /// \return an error if the file could not be read back, in which case only
+  ///   the strings before the one that failed have been emitted.
+  /// \pre flush() has succeeded.
+  std::error_code emitAll(JSONEmitter &json) {
+    if (std::fseek(file_, 0, SEEK_SET) != 0) {
+      return std::make_error_code(std::errc::io_error);
+    }
+    std::string buf;
+    for (uint32_t i = firstIndex_; i < nextIndex_; ++i) {
+      uint32_t len = 0;
+      if (std::fread(&len, sizeof(len), 1, file_) != 1) {
+        return std::make_error_code(std::errc::io_error);
+      }
+      buf.resize(len);
+      if (std::fread(&buf[0], 1, len, file_) != len) {
+        return std::make_error_code(std::errc::io_error);
+      }
+      json.emitValue(buf);
+    }
+    return std::error_code{};
+  }
+
+ private:
+  static constexpr uint32_t kEmpty = UINT32_MAX;
+
+  struct CacheEntry {
+    std::string str;
+    uint32_t index{kEmpty};
+  };
+
+  SpooledStringTable(
+      std::FILE *file,
+      const llvh::SmallVectorImpl<char> &path,
+      uint32_t firstIndex)
+      : file_(file),
+        path_(path.begin(), path.end()),
+        firstIndex_(firstIndex),
+        nextIndex_(firstIndex),
+        cache_(kCacheSize) {}
+
+  std::FILE *const file_;
+  const llvh::SmallString<128> path_;
+  const uint32_t firstIndex_;
+  uint32_t nextIndex_;
+  /// Whether writing to the file has failed.
+  bool failed_{false};
+  std::vector<CacheEntry> cache_;
+};
+
+/// The node index of a streaming snapshot. The ID and index of each node are
+/// appended to a temporary file as nodes are added. Once the "nodes" section
+/// is complete, the file is mapped and sorted by ID, and edges find the index
+/// of their target by binary search. The mapping is backed by the file, so
+/// the OS can write its pages out instead of keeping them in memory.
+class HeapSnapshot::SpooledNodeIndex {
+ public:
+  /// \return an empty index, or nullptr if no temporary file could be
+  ///   created.
+  static std::unique_ptr<SpooledNodeIndex> create() {
+    int fd;
+    llvh::SmallString<128> path;
+    if (llvh::sys::fs::createTemporaryFile(
+            "hermes-heap-snapshot", "nodes", fd, path)) {
+      return nullptr;
+    }
+    return std::unique_ptr<SpooledNodeIndex>(new SpooledNodeIndex(fd, path));
+  }
+
+  ~SpooledNodeIndex() {
+    // The file can't be removed while it is mapped on some platforms.
+    region_.reset();
+    os_.clear_error();
+    llvh::sys::Process::SafelyCloseFileDescriptor(fd_);
+    llvh::sys::fs::remove(path_);
+  }
+
+  /// Record that node \p id has index \p index.
+  void add(NodeID id, NodeIndex index) {
+    // Zero the whole entry so that no uninitialized padding is written.
+    Entry entry;
+    std::memset(&entry, 0, sizeof(entry));
+    entry.id = id;
+    entry.index = index;
+    os_.write(reinterpret_cast<const char *>(&entry), sizeof(entry));
+    ++size_;
+  }
+
+  /// Sort the index once all nodes have been added.
+  /// \return an error if the file could not be written or mapped, in which
+  ///   case lookup() must not be called.
+  std::error_code finish() {
+    os_.flush();
+    if (os_.has_error()) {
+      return os_.error();
+    }
+    if (size_ == 0) {
+      return std::error_code{};
+    }
+    std::error_code ec;
+    region_.reset(new llvh::sys::fs::mapped_file_region(
+        fd_,
+        llvh::sys::fs::mapped_file_region::readwrite,
+        size_ * sizeof(Entry),
+        0,
+        ec));
+    if (ec) {
+      region_.reset();
+      return ec;
+    }
+    std::sort(begin(), end(), [](const Entry &a, const Entry &b) {
+      return a.id < b.id;
+    });
+    assert(
+        std::adjacent_find(
+            begin(),
+            end(),
+            [](const Entry &a, const Entry &b) { return a.id == b.id; }) ==
+            end() &&
+        "Duplicate node ID");
+    return std::error_code{};
+  }
+
+  /// \return the index of node \p id.
+  /// \pre finish() has succeeded.
+  NodeIndex lookup(NodeID id) const {
+    assert(region_ && "Index has not been sorted");
+    const Entry *it = std::lower_bound(
+        begin(), end(), id, [](const Entry &entry, NodeID id) {
+          return entry.id < id;
+        });
+    assert(it != end() && it->id == id && "Node must have been added");
+    return it->index;
+  }
+
+ private:
+  struct Entry {
+    NodeID id;
+    NodeIndex index;
+  };
+
+  SpooledNodeIndex(int fd, const llvh::SmallVectorImpl<char> &path)
+      : fd_(fd),
+        path_(path.begin(), path.end()),
+        os_(fd, /* shouldClose */ false) {}
+
+  Entry *begin() const {
+    return reinterpret_cast<Entry *>(region_->data());
+  }
+  Entry *end() const {
+    return begin() + size_;
+  }
+
+  const int fd_;
+  const llvh::SmallString<128> path_;
+  llvh::raw_fd_ostream os_;
+  /// The number of nodes added.
+  size_t size_{0};
+  /// The file, once it has been sorted.
+  std::unique_ptr<llvh::sys::fs::mapped_file_region> region_;
+};
+
+HeapSnapshot::HeapSnapshot(
+    JSONEmitter &json,
+    StackTracesTree *stackTracesTree,
+    bool streaming)
     : json_(json),
       stackTracesTree_(stackTracesTree),
       stringTable_(
           stackTracesTree ? stackTracesTree->getStringTable()
                           : std::make_shared<StringSetVector>()) {
+  if (streaming) {
+    // Strings already in stringTable_ (those of the stack traces tree) keep
+    // their indices, and new strings are numbered after them.
+    spooledStrings_ = SpooledStringTable::create(stringTable_->size());
+    spooledNodes_ = SpooledNodeIndex::create();
+  }
   json_.openDict();
   emitMeta();
 }
 
 HeapSnapshot::~HeapSnapshot() {
+  if (error_) {
+    // The snapshot was abandoned. Leave the output unterminated so that it
+    // can't be mistaken for a complete snapshot.
+    return;
+  }
   assert(
       edgeCount_ == expectedEdges_ && "Fewer edges added than were expected");
-  emitStrings();
+  if (!emitStrings()) {
+    return;
+  }
   json_.closeDict(); // top level
 }
 
+std::error_code HeapSnapshot::checkSpools() {
+  if (!error_ && spooledStrings_) {
+    error_ = spooledStrings_->flush();
+  }
+  return error_;
+}
+
 void HeapSnapshot::beginSection(Section section) {
   auto i = index(nextSection_);
 
@@ -82,6 +346,10 @@ void HeapSnapshot::endSection(Section section) {
   json_.closeArray();
   nextSection_ = static_cast<Section>(index(section) + 1);
   sectionOpened_ = false;
+
+  if (section == Section::Nodes && spooledNodes_ && !error_) {
+    error_ = spooledNodes_->finish();
+  }
 }
 
 void HeapSnapshot::beginNode() {
@@ -108,11 +376,9 @@ void HeapSnapshot::endNode(
   nodeStats.count++;
   nodeStats.size += selfSize;
   assert(nextSection_ == Section::Nodes && sectionOpened_);
-  auto res = nodeToIndex_.try_emplace(id, nodeCount_++);
-  assert(res.second);
-  (void)res;
+  addNodeIndex(id);
   json_.emitValue(index(type));
-  json_.emitValue(stringTable_->insert(name));
+  json_.emitValue(internString(name));
   json_.emitValue(id);
   json_.emitValue(selfSize);
   json_.emitValue(currEdgeCount_);
@@ -139,12 +405,9 @@ void HeapSnapshot::addNamedEdge(
   assert(nextSection_ == Section::Edges && sectionOpened_);
 
   json_.emitValue(index(type));
-  json_.emitValue(stringTable_->insert(name));
-
-  auto nodeIt = nodeToIndex_.find(toNode);
-  assert(nodeIt != nodeToIndex_.end());
+  json_.emitValue(internString(name));
   // Point to the beginning of the target node in the `nodes` flat array.
-  json_.emitValue(nodeIt->second * V8_SNAPSHOT_NODE_FIELD_COUNT);
+  json_.emitValue(getNodeIndex(toNode) * V8_SNAPSHOT_NODE_FIELD_COUNT);
 }
 
 void HeapSnapshot::addIndexedEdge(
@@ -163,11 +426,8 @@ void HeapSnapshot::addIndexedEdge(
 
   json_.emitValue(index(type));
   json_.emitValue(edgeIndex);
-
-  auto nodeIt = nodeToIndex_.find(toNode);
-  assert(nodeIt != nodeToIndex_.end());
   // Point to the beginning of the target node in the `nodes` flat array.
-  json_.emitValue(nodeIt->second * V8_SNAPSHOT_NODE_FIELD_COUNT);
+  json_.emitValue(getNodeIndex(toNode) * V8_SNAPSHOT_NODE_FIELD_COUNT);
 }
 
 void HeapSnapshot::addLocation(
@@ -178,11 +438,7 @@ void HeapSnapshot::addLocation(
   assert(
       nextSection_ == Section::Locations && sectionOpened_ &&
       "Shouldn't be emitting locations until the location section starts");
-  auto nodeIt = nodeToIndex_.find(id);
-  assert(
-      nodeIt != nodeToIndex_.end() &&
-      "Couldn't add a location for an object that doesn't exist");
-  json_.emitValue(nodeIt->second * V8_SNAPSHOT_NODE_FIELD_COUNT);
+  json_.emitValue(getNodeIndex(id) * V8_SNAPSHOT_NODE_FIELD_COUNT);
   json_.emitValue(script);
   // The serialized format uses 0-based indexing for line and column, but the
   // parameters are 1-based.
@@ -424,14 +680,51 @@ void HeapSnapshot::emitAllocationTraceInfo() {
   endSection(Section::TraceTree);
 }
 
-void HeapSnapshot::emitStrings() {
+bool HeapSnapshot::emitStrings() {
+  if (checkSpools()) {
+    return false;
+  }
   beginSection(Section::Strings);
 
   for (const auto &str : *stringTable_) {
     json_.emitValue(str);
   }
+  if (spooledStrings_) {
+    if ((error_ = spooledStrings_->emitAll(json_))) {
+      hermesLog(
+          "HermesGC",
+          "Heap snapshot strings could not be read back: %s",
+          error_.message().c_str());
+      return false;
+    }
+  }
 
   endSection(Section::Strings);
+  return true;
+}
+
+uint32_t HeapSnapshot::internString(llvh::StringRef str) {
+  return spooledStrings_ ? spooledStrings_->insert(str)
+                         : stringTable_->insert(str);
+}
+
+void HeapSnapshot::addNodeIndex(NodeID id) {
+  if (spooledNodes_) {
+    spooledNodes_->add(id, nodeCount_++);
+    return;
+  }
+  auto res = nodeToIndex_.try_emplace(id, nodeCount_++);
+  assert(res.second);
+  (void)res;
+}
+
+HeapSnapshot::NodeIndex HeapSnapshot::getNodeIndex(NodeID id) const {
+  if (spooledNodes_) {
+    return spooledNodes_->lookup(id);
+  }
+  auto nodeIt = nodeToIndex_.find(id);
+  assert(nodeIt != nodeToIndex_.end() && "Node must have been added");
+  return nodeIt->second;
 }
 
 ChromeSamplingMemoryProfile::ChromeSamplingMemoryProfile(JSONEmitter &json)
@@ -25,6 +25,7 @@
 #include "hermes/VM/Operations.h"
 #include "hermes/VM/Profiler.h"
 #include "hermes/VM/Profiler/CodeCoverageProfiler.h"
+#include "hermes/VM/Profiler/JSPerfMap.h"
 #include "hermes/VM/PropertyAccessor.h"
 #include "hermes/VM/RuntimeModule-inline.h"
 #include "hermes/VM/StackFrame-inline.h"
@@ -123,19 +124,26 @@ static const WrapperFunc interpWrappers[] = {PROFILER_SYMBOLS(LIST_ITEM)};
 
 /// Initialize the state of some internal variables based on the current
 /// code block.
-#define INIT_STATE_FOR_CODEBLOCK(codeBlock)                      \
-  do {                                                           \
-    strictMode = (codeBlock)->isStrictMode();                    \
-    defaultPropOpFlags = DEFAULT_PROP_OP_FLAGS(strictMode);      \
-    if (EnableCrashTrace) {                                      \
-      auto *bc = (codeBlock)->getRuntimeModule()->getBytecode(); \
-      bytecodeFileStart = bc->getRawBuffer().data();             \
-      auto hash = bc->getSourceHash();                           \
-      runtime->crashTrace_.recordModule(                         \
-          bc->getSegmentID(),                                    \
-          (codeBlock)->getRuntimeModule()->getSourceURL(),       \
-          llvh::StringRef((const char *)&hash, sizeof(hash)));   \
-    }                                                            \
+#define INIT_STATE_FOR_CODEBLOCK(codeBlock)                               \
+  do {                                                                    \
+    strictMode = (codeBlock)->isStrictMode();                             \
+    defaultPropOpFlags = DEFAULT_PROP_OP_FLAGS(strictMode);               \
+    if (EnableCrashTrace) {                                               \
+      auto *bc = (codeBlock)->getRuntimeModule()->getBytecode();          \
+      if (bc->getBytecodeOptions().compressedBytecode) {                  \
+        /* Function bodies aren't in the file, so record offsets into */  \
+        /* the decompressed function bodies instead. */                   \
+        bytecodeFileStart = (uintptr_t)(codeBlock)->begin() -             \
+            bc->getFunctionHeader((codeBlock)->getFunctionID()).offset(); \
+      } else {                                                            \
+        bytecodeFileStart = (uintptr_t)bc->getRawBuffer().data();         \
+      }                                                                   \
+      auto hash = bc->getSourceHash();                                    \
+      runtime->crashTrace_.recordModule(                                  \
+          bc->getSegmentID(),                                             \
+          (codeBlock)->getRuntimeModule()->getSourceURL(),                \
+          llvh::StringRef((const char *)&hash, sizeof(hash)));            \
+    }                                                                     \
   } while (0)
 
 CallResult<PseudoHandle<JSGenerator>> Interpreter::createGenerator_RJS(
@@ -381,6 +389,67 @@ CallResult<PseudoHandle<>> Interpreter::getByValTransient_RJS(
       runtime->makeHandle<JSObject>(res.getValue()), runtime, name, base);
 }
 
+inline HermesValue Interpreter::getByValObjectFast(
+    Runtime *runtime,
+    JSObject *base,
+    HermesValue name) {
+  if (LLVM_UNLIKELY(!base->hasFastIndexProperties()))
+    return HermesValue::encodeEmptyValue();
+  OptValue<uint32_t> arrayIndex = toArrayIndexFastPath(name);
+  if (LLVM_UNLIKELY(!arrayIndex))
+    return HermesValue::encodeEmptyValue();
+  const uint32_t index = *arrayIndex;
+
+  switch (base->getKind()) {
+    case CellKind::ArrayKind:
+      // A hole reads as empty, so the slow path will look at the prototypes.
+      return vmcast<JSArray>(base)->at(runtime, index);
+#define TYPED_ARRAY(name, type)                                          \
+  case CellKind::name##ArrayKind: {                                      \
+    auto *arr = vmcast<name##Array>(base);                               \
+    if (LLVM_LIKELY(arr->attached(runtime) && index < arr->getLength())) \
+      return SafeNumericEncoder<type>::encode(arr->at(runtime, index));  \
+    return HermesValue::encodeEmptyValue();                              \
+  }
+#include "hermes/VM/TypedArrays.def"
+    default:
+      return HermesValue::encodeEmptyValue();
+  }
+}
+
+inline bool Interpreter::putByValObjectFast(
+    Runtime *runtime,
+    JSObject *base,
+    HermesValue name,
+    HermesValue value) {
+  if (LLVM_UNLIKELY(!base->hasFastIndexProperties()))
+    return false;
+  OptValue<uint32_t> arrayIndex = toArrayIndexFastPath(name);
+  if (LLVM_UNLIKELY(!arrayIndex))
+    return false;
+  const uint32_t index = *arrayIndex;
+
+  switch (base->getKind()) {
+    case CellKind::ArrayKind:
+      return ArrayImpl::trySetExistingElementAt(
+          vmcast<JSArray>(base), runtime, index, value);
+#define TYPED_ARRAY(name, type)                                           \
+  case CellKind::name##ArrayKind: {                                       \
+    /* Converting other values to numbers may run user code. */           \
+    auto *arr = vmcast<name##Array>(base);                                \
+    if (LLVM_UNLIKELY(                                                    \
+            !value.isNumber() || !arr->attached(runtime) ||               \
+            index >= arr->getLength()))                                   \
+      return false;                                                       \
+    arr->at(runtime, index) = name##Array::toDestType(value.getNumber()); \
+    return true;                                                          \
+  }
+#include "hermes/VM/TypedArrays.def"
+    default:
+      return false;
+  }
+}
+
 static ExecutionStatus
 transientObjectPutErrorMessage(Runtime *runtime, Handle<> base, SymbolID id) {
   // Emit an error message that looks like:
@@ -843,6 +912,11 @@ CallResult<HermesValue> Runtime::interpretFunction(CodeBlock *newCodeBlock) {
   }
   return interpWrappers[id](this, newCodeBlock);
 #else
+#ifdef HERMESVM_JS_PERF_MAP
+  if (LLVM_UNLIKELY(jsPerfMap_ != nullptr)) {
+    return jsPerfMap_->interpretFunction(newCodeBlock);
+  }
+#endif
   return interpretFunctionImpl(newCodeBlock);
 #endif
 }
@@ -932,6 +1006,9 @@ CallResult<HermesValue> Interpreter::interpretFunction(
   bool strictMode;
   // Default flags when accessing properties.
   PropOpFlags defaultPropOpFlags;
+  // Whether calls and returns go through a native frame per JS call. Read
+  // once here instead of at every call and return.
+  const bool nativeFramePerJSCall = runtime->hasNativeFramePerJSCall();
 
 // These CAPTURE_IP* macros should wrap around any major calls out of the
 // interpreter loop. They stash and retrieve the IP via the current Runtime
@@ -1001,7 +1078,7 @@ CallResult<HermesValue> Interpreter::interpretFunction(
   CallResult<Handle<Arguments>> resArgs{ExecutionStatus::EXCEPTION};
   CallResult<bool> boolRes{ExecutionStatus::EXCEPTION};
   // Start of the bytecode file, used to calculate IP offset in crash traces.
-  const uint8_t *bytecodeFileStart;
+  uintptr_t bytecodeFileStart;
 
   // Mark the gcScope so we can clear all allocated handles.
   // Remember how many handles the scope has so we can clear them in the loop.
@@ -1012,9 +1089,7 @@ CallResult<HermesValue> Interpreter::interpretFunction(
 
   INIT_OPCODE_PROFILER;
 
-#if !defined(HERMESVM_PROFILER_EXTERN)
 tailCall:
-#endif
   PROFILER_ENTER_FUNCTION(curCodeBlock);
 
 #ifdef HERMES_ENABLE_DEBUGGER
@@ -1102,7 +1177,7 @@ tailCall:
     INC_OPCODE_COUNT;                                                        \
     if (EnableCrashTrace) {                                                  \
       runtime->crashTrace_.recordInst(                                       \
-          (uint32_t)((const uint8_t *)ip - bytecodeFileStart), ip->opCode);  \
+          (uint32_t)((uintptr_t)ip - bytecodeFileStart), ip->opCode);        \
     }                                                                        \
   }
 
@@ -1631,20 +1706,19 @@ tailCall:
 
         CodeBlock *calleeBlock = func->getCodeBlock();
         CAPTURE_IP(calleeBlock->lazyCompile(runtime));
-#if defined(HERMESVM_PROFILER_EXTERN)
-        CAPTURE_IP(res = runtime->interpretFunction(calleeBlock));
-        if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
-          goto exception;
+        if (LLVM_UNLIKELY(nativeFramePerJSCall)) {
+          CAPTURE_IP(res = runtime->interpretFunction(calleeBlock));
+          if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+            goto exception;
+          }
+          O1REG(Call) = *res;
+          gcScope.flushToSmallCount(KEEP_HANDLES);
+          ip = nextIP;
+          DISPATCH;
         }
-        O1REG(Call) = *res;
-        gcScope.flushToSmallCount(KEEP_HANDLES);
-        ip = nextIP;
-        DISPATCH;
-#else
         curCodeBlock = calleeBlock;
         CAPTURE_IP_SET();
         goto tailCall;
-#endif
       }
       CAPTURE_IP(
           resPH = Interpreter::handleCallSlowPath(runtime, &O2REG(Call)));
@@ -1695,21 +1769,21 @@ tailCall:
         assert(!SingleStep && "can't single-step a call");
 
         CAPTURE_IP(calleeBlock->lazyCompile(runtime));
-#if defined(HERMESVM_PROFILER_EXTERN)
-        CAPTURE_IP(res = runtime->interpretFunction(calleeBlock));
-        if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
-          goto exception;
+        if (LLVM_UNLIKELY(nativeFramePerJSCall)) {
+          CAPTURE_IP(res = runtime->interpretFunction(calleeBlock));
+          if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+            goto exception;
+          }
+          O1REG(CallDirect) = *res;
+          gcScope.flushToSmallCount(KEEP_HANDLES);
+          ip = ip->opCode == OpCode::CallDirect
+              ? NEXTINST(CallDirect)
+              : NEXTINST(CallDirectLongIndex);
+          DISPATCH;
         }
-        O1REG(CallDirect) = *res;
-        gcScope.flushToSmallCount(KEEP_HANDLES);
-        ip = ip->opCode == OpCode::CallDirect ? NEXTINST(CallDirect)
-                                              : NEXTINST(CallDirectLongIndex);
-        DISPATCH;
-#else
         curCodeBlock = calleeBlock;
         CAPTURE_IP_SET();
         goto tailCall;
-#endif
       }
 
       CASE(GetBuiltinClosure) {
@@ -1830,10 +1904,10 @@ tailCall:
           return res;
         }
 
-// Return because of recursive calling structure
-#if defined(HERMESVM_PROFILER_EXTERN)
-        return res;
-#endif
+        // Return because of recursive calling structure
+        if (LLVM_UNLIKELY(nativeFramePerJSCall)) {
+          return res;
+        }
 
         INIT_STATE_FOR_CODEBLOCK(curCodeBlock);
         O1REG(Call) = res.getValue();
@@ -2567,6 +2641,16 @@ tailCall:
       CASE(GetByVal) {
         CallResult<HermesValue> propRes{ExecutionStatus::EXCEPTION};
         if (LLVM_LIKELY(O2REG(GetByVal).isObject())) {
+          // Fast path: in-bounds elements of arrays and typed arrays.
+          HermesValue fastRes = Interpreter::getByValObjectFast(
+              runtime,
+              vmcast<JSObject>(O2REG(GetByVal)),
+              O3REG(GetByVal));
+          if (LLVM_LIKELY(!fastRes.isEmpty())) {
+            O1REG(GetByVal) = fastRes;
+            ip = NEXTINST(GetByVal);
+            DISPATCH;
+          }
           CAPTURE_IP(
               resPH = JSObject::getComputed_RJS(
                   Handle<JSObject>::vmcast(&O2REG(GetByVal)),
@@ -2594,6 +2678,15 @@ tailCall:
 
       CASE(PutByVal) {
         if (LLVM_LIKELY(O1REG(PutByVal).isObject())) {
+          // Fast path: in-bounds elements of arrays and typed arrays.
+          if (LLVM_LIKELY(Interpreter::putByValObjectFast(
+                  runtime,
+                  vmcast<JSObject>(O1REG(PutByVal)),
+                  O2REG(PutByVal),
+                  O3REG(PutByVal)))) {
+            ip = NEXTINST(PutByVal);
+            DISPATCH;
+          }
           CAPTURE_IP_ASSIGN(
               auto putRes,
               JSObject::putComputed_RJS(
@@ -3623,10 +3716,10 @@ tailCall:
     if (!curCodeBlock)
       return ExecutionStatus::EXCEPTION;
 
-// Return because of recursive calling structure
-#ifdef HERMESVM_PROFILER_EXTERN
-    return ExecutionStatus::EXCEPTION;
-#endif
+    // Return because of recursive calling structure
+    if (LLVM_UNLIKELY(nativeFramePerJSCall)) {
+      return ExecutionStatus::EXCEPTION;
+    }
   // Handle the exception.
   exception:
     UPDATE_OPCODE_TIME_SPENT;
@@ -3734,10 +3827,10 @@ tailCall:
           isCallType(ip->opCode) &&
           "return address is not Call-type instruction");
 
-// Return because of recursive calling structure
-#ifdef HERMESVM_PROFILER_EXTERN
-      return ExecutionStatus::EXCEPTION;
-#endif
+      // Return because of recursive calling structure
+      if (LLVM_UNLIKELY(nativeFramePerJSCall)) {
+        return ExecutionStatus::EXCEPTION;
+      }
     }
 
     INIT_STATE_FOR_CODEBLOCK(curCodeBlock);
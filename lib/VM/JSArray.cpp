@@ -153,6 +153,9 @@ ExecutionStatus ArrayImpl::setStorageEndIndex(
     if (newLength <= beginIndex) {
       // the new length is prior to beginIndex, clearing the storage.
       selfHandle->endIndex_ = beginIndex;
+      // With no elements left, the kind can start over.
+      selfHandle->flags_.elementsKind =
+          static_cast<uint32_t>(ElementsKind::Int32);
       // Remove the storage. If this array grows again it can be re-allocated.
       self->setIndexedStorage(runtime, nullptr, &runtime->getHeap());
       return ExecutionStatus::RETURNED;
@@ -189,6 +192,8 @@ CallResult<bool> ArrayImpl::_setOwnIndexedImpl(
   if (LLVM_UNLIKELY(self->flags_.frozen))
     return false;
 
+  self->updateElementsKind(value.get());
+
   // Check whether the index is within the storage.
   if (LLVM_LIKELY(index >= beginIndex && index < endIndex)) {
     self->getIndexedStorage(runtime)->set(
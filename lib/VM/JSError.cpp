@@ -238,11 +238,12 @@ ExecutionStatus JSError::setMessage(
 /// set. Names are returned in reverse order (topmost frame is first).
 /// In case of error returns a nullptr handle.
 /// \param skipTopFrame if true, skip the top frame.
+/// \param count the number of frames to return names for.
 static Handle<PropStorage> getCallStackFunctionNames(
     Runtime *runtime,
     bool skipTopFrame,
-    size_t sizeHint) {
-  auto arrRes = PropStorage::create(runtime, sizeHint);
+    size_t count) {
+  auto arrRes = PropStorage::create(runtime, count);
   if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION)) {
     runtime->clearThrownValue();
     return Runtime::makeNullHandle<PropStorage>();
@@ -256,6 +257,8 @@ static Handle<PropStorage> getCallStackFunctionNames(
   uint32_t frameIndex = 0;
   uint32_t namesIndex = 0;
   for (StackFramePtr cf : runtime->getStackFrames()) {
+    if (namesIndex == count)
+      break;
     if (frameIndex++ == 0 && skipTopFrame)
       continue;
 
@@ -346,6 +349,10 @@ ExecutionStatus JSError::recordStackTrace(
     return ArrayStorageSmall::push_back(domains, runtime, domain);
   };
 
+  // Record at most this many frames. One more entry than that is recorded
+  // below, since the last one is always removed.
+  const size_t maxDepth = runtime->getErrorStackCaptureDepth();
+
   if (!skipTopFrame) {
     if (codeBlock) {
       stack->emplace_back(codeBlock, codeBlock->getOffsetOf(ip));
@@ -362,6 +369,8 @@ ExecutionStatus JSError::recordStackTrace(
   // Fill in the call stack.
   // Each stack frame tracks information about the caller.
   for (StackFramePtr cf : runtime->getStackFrames()) {
+    if (stack->size() > maxDepth)
+      break;
     CodeBlock *savedCodeBlock = cf.getSavedCodeBlock();
     const Inst *const savedIP = cf.getSavedIP();
     // Go up one frame and get the callee code block but use the current
@@ -386,11 +395,16 @@ ExecutionStatus JSError::recordStackTrace(
   }
   selfHandle->domains_.set(runtime, domains.get(), &runtime->getHeap());
 
-  // Remove the last entry.
+  // Remove the last entry. It is either the native frame that called into the
+  // runtime, or one past the maximum depth.
   stack->pop_back();
 
-  auto funcNames =
-      getCallStackFunctionNames(runtime, skipTopFrame, stack->size());
+  // Looking up the names of the callees is the most expensive part of
+  // recording the stack, so it may be left to the stack accessor, which
+  // falls back to the names in the bytecode.
+  auto funcNames = runtime->hasLazyErrorStackNames()
+      ? Runtime::makeNullHandle<PropStorage>()
+      : getCallStackFunctionNames(runtime, skipTopFrame, stack->size());
 
   // Either the function names is empty, or they have the same count.
   assert(
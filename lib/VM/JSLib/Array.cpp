@@ -1315,6 +1315,71 @@ CallResult<HermesValue> sortSparse(
 
   return O.getHermesValue();
 }
+
+/// \return true if the decimal string of \p a sorts before the decimal string
+/// of \p b, without creating the strings.
+bool int32StringLess(int32_t a, int32_t b) {
+  // The minus sign sorts before all digits.
+  if ((a < 0) != (b < 0))
+    return a < 0;
+  uint64_t ua = a < 0 ? 0u - (uint32_t)a : (uint32_t)a;
+  uint64_t ub = b < 0 ? 0u - (uint32_t)b : (uint32_t)b;
+  unsigned aDigits = 1, bDigits = 1;
+  for (uint64_t x = ua; x >= 10; x /= 10)
+    ++aDigits;
+  for (uint64_t x = ub; x >= 10; x /= 10)
+    ++bDigits;
+  // Pad the shorter number with zeros, so that the numbers compare like the
+  // strings. If they are then equal, the shorter string is a prefix of the
+  // other one.
+  for (unsigned i = aDigits; i < bDigits; ++i)
+    ua *= 10;
+  for (unsigned i = bDigits; i < aDigits; ++i)
+    ub *= 10;
+  if (ua != ub)
+    return ua < ub;
+  return aDigits < bDigits;
+}
+
+/// Sort the array \p arr of length \p len with the default comparison, if its
+/// elements are all int32 numbers without holes and it can be written to. The
+/// numbers are then sorted by their strings, which are never created, and
+/// written back in place.
+/// \return true if the array was sorted, false if it has to be sorted by the
+///   generic routine.
+bool sortInt32Array(Runtime *runtime, Handle<JSArray> arr, uint64_t len) {
+  if (!arr->hasFastIndexProperties() ||
+      arr->getElementsKind() != ElementsKind::Int32 ||
+      arr->getBeginIndex() != 0 || arr->getEndIndex() != len) {
+    return false;
+  }
+
+  std::vector<int32_t> values;
+  values.reserve(len);
+  for (JSArray::size_type i = 0; i != len; ++i) {
+    HermesValue hv = arr->at(runtime, i);
+    // A hole has to be looked up on the prototype chain.
+    if (hv.isEmpty())
+      return false;
+    values.push_back(static_cast<int32_t>(hv.getNumber()));
+  }
+
+  std::stable_sort(values.begin(), values.end(), int32StringLess);
+
+  for (JSArray::size_type i = 0; i != len; ++i) {
+    if (!JSArray::trySetExistingElementAt(
+            *arr,
+            runtime,
+            i,
+            HermesValue::encodeNumberValue(values[i]))) {
+      // Only the first write can fail, when the array is frozen, and then
+      // nothing has been written.
+      assert(i == 0 && "writing to an array failed while sorting it");
+      return false;
+    }
+  }
+  return true;
+}
 } // anonymous namespace
 
 /// ES5.1 15.4.4.11.
@@ -1343,6 +1408,15 @@ arrayPrototypeSort(void *, Runtime *runtime, NativeArgs args) {
   }
   uint64_t len = *intRes;
 
+  // Arrays of int32 numbers are common enough to sort them by their strings
+  // without creating the strings.
+  if (!compareFn) {
+    if (auto arr = Handle<JSArray>::dyn_vmcast(O)) {
+      if (sortInt32Array(runtime, arr, len))
+        return O.getHermesValue();
+    }
+  }
+
   // If we are not sorting a regular dense array, use a special routine which
   // first copies all properties into an array.
   // Proxies  and host objects however are excluded because they are weird.
@@ -1361,6 +1435,42 @@ arrayPrototypeSort(void *, Runtime *runtime, NativeArgs args) {
   return O.getHermesValue();
 }
 
+/// \return the element at index \p k of \p O if it can be read directly from
+/// the storage of a JSArray, or empty if it has to be looked up as a
+/// property: \p O is not an array with fast index properties, or the element
+/// is a hole, which may be inherited from the prototype chain.
+static inline HermesValue
+getStoredElement(Runtime *runtime, JSObject *O, double k) {
+  auto *arr = dyn_vmcast<JSArray>(O);
+  if (LLVM_LIKELY(arr && arr->hasFastIndexProperties()) &&
+      k < arr->getEndIndex()) {
+    return arr->at(runtime, k);
+  }
+  return HermesValue::encodeEmptyValue();
+}
+
+/// Get the element at index \p k of \p O for the methods that call a
+/// callback on every element and skip the missing ones.
+/// \return the value of the element, or empty if \p O has no property \p k.
+/// The elements of an array are read straight from its storage. This is
+/// checked again for every element, since the callback can change the array.
+static inline CallResult<PseudoHandle<>> getElementIfPresent(
+    Runtime *runtime,
+    Handle<JSObject> O,
+    Handle<> k,
+    MutableHandle<JSObject> &descObjHandle,
+    MutableHandle<SymbolID> &tmpPropNameStorage) {
+  HermesValue stored = getStoredElement(runtime, *O, k->getNumber());
+  if (LLVM_LIKELY(!stored.isEmpty())) {
+    return createPseudoHandle(stored);
+  }
+  ComputedPropertyDescriptor desc;
+  JSObject::getComputedPrimitiveDescriptor(
+      O, runtime, k, descObjHandle, tmpPropNameStorage, desc);
+  return JSObject::getComputedPropertyValue_RJS(
+      O, runtime, descObjHandle, tmpPropNameStorage, desc, k);
+}
+
 inline CallResult<HermesValue>
 arrayPrototypeForEach(void *, Runtime *runtime, NativeArgs args) {
   GCScope gcScope(runtime);
@@ -1394,16 +1504,12 @@ arrayPrototypeForEach(void *, Runtime *runtime, NativeArgs args) {
   MutableHandle<SymbolID> tmpPropNameStorage{runtime};
 
   // Loop through and execute the callback on all existing values.
-  // TODO: Implement a fast path for actual arrays.
   auto marker = gcScope.createMarker();
   while (k->getDouble() < len) {
     gcScope.flushToMarker(marker);
 
-    ComputedPropertyDescriptor desc;
-    JSObject::getComputedPrimitiveDescriptor(
-        O, runtime, k, descObjHandle, tmpPropNameStorage, desc);
-    CallResult<PseudoHandle<>> propRes = JSObject::getComputedPropertyValue_RJS(
-        O, runtime, descObjHandle, tmpPropNameStorage, desc, k);
+    CallResult<PseudoHandle<>> propRes = getElementIfPresent(
+        runtime, O, k, descObjHandle, tmpPropNameStorage);
     if (LLVM_UNLIKELY(propRes == ExecutionStatus::EXCEPTION)) {
       return ExecutionStatus::EXCEPTION;
     }
@@ -2427,6 +2533,73 @@ arrayPrototypeShift(void *, Runtime *runtime, NativeArgs args) {
   return first.get();
 }
 
+/// Search the elements of \p O below \p len, starting at index \p k and
+/// moving down if \p reverse, or else up, for \p searchElement. Elements are
+/// compared using SameValueZero if \p sameValueZero, or else using strict
+/// equality. Only the elements in the storage of a JSArray are searched, by
+/// reading them directly, up to the first hole, which has to be looked up on
+/// the prototype chain.
+/// \return true if the element at index \p k matches. Otherwise \p k is set
+///   to the index at which the search has to continue by reading properties.
+static bool searchArrayStorage(
+    Runtime *runtime,
+    JSObject *O,
+    double len,
+    HermesValue searchElement,
+    bool sameValueZero,
+    bool reverse,
+    double &k) {
+  auto *arr = dyn_vmcast<JSArray>(O);
+  if (!arr || !arr->hasFastIndexProperties())
+    return false;
+  // The length can be lower than the end of the storage if the array grew
+  // while the arguments were converted.
+  const double begin = arr->getBeginIndex();
+  const double end = std::min<double>(arr->getEndIndex(), len);
+  if (!(k >= begin && k < end))
+    return false;
+
+  NoAllocScope noAlloc{runtime};
+  auto *storage = arr->getIndexedStorage(runtime);
+  const int64_t size = end - begin;
+  const int64_t step = reverse ? -1 : 1;
+  int64_t i = k - begin;
+  auto scan = [&](auto matches) {
+    for (; i >= 0 && i < size; i += step) {
+      HermesValue elem = storage->at(i);
+      if (elem.isEmpty())
+        break;
+      if (matches(elem))
+        return true;
+    }
+    return false;
+  };
+
+  bool found;
+  if (arr->getElementsKind() != ElementsKind::Generic) {
+    // Numbers are compared directly, and nothing else can match.
+    if (!searchElement.isNumber()) {
+      found = scan([](HermesValue) { return false; });
+    } else if (sameValueZero && std::isnan(searchElement.getNumber())) {
+      found =
+          scan([](HermesValue elem) { return std::isnan(elem.getNumber()); });
+    } else {
+      const double x = searchElement.getNumber();
+      found = scan([x](HermesValue elem) { return elem.getNumber() == x; });
+    }
+  } else if (sameValueZero) {
+    found = scan([searchElement](HermesValue elem) {
+      return isSameValueZero(searchElement, elem);
+    });
+  } else {
+    found = scan([searchElement](HermesValue elem) {
+      return strictEqualityTest(searchElement, elem);
+    });
+  }
+  k = begin + i;
+  return found;
+}
+
 /// Used to help with indexOf and lastIndexOf.
 /// \p reverse true if searching in reverse (lastIndexOf), false otherwise.
 static inline CallResult<HermesValue>
@@ -2494,6 +2667,14 @@ indexOfHelper(Runtime *runtime, NativeArgs args, const bool reverse) {
 
   // Search for the element.
   auto searchElement = args.getArgHandle(0);
+  {
+    double kIndex = k->getDouble();
+    if (searchArrayStorage(
+            runtime, *O, len, *searchElement, false, reverse, kIndex)) {
+      return HermesValue::encodeDoubleValue(kIndex);
+    }
+    k = HermesValue::encodeDoubleValue(kIndex);
+  }
   auto marker = gcScope.createMarker();
   while (true) {
     gcScope.flushToMarker(marker);
@@ -2693,11 +2874,8 @@ everySomeHelper(Runtime *runtime, NativeArgs args, const bool every) {
   while (k->getDouble() < len) {
     gcScope.flushToMarker(marker);
 
-    ComputedPropertyDescriptor desc;
-    JSObject::getComputedPrimitiveDescriptor(
-        O, runtime, k, descObjHandle, tmpPropNameStorage, desc);
-    CallResult<PseudoHandle<>> propRes = JSObject::getComputedPropertyValue_RJS(
-        O, runtime, descObjHandle, tmpPropNameStorage, desc, k);
+    CallResult<PseudoHandle<>> propRes = getElementIfPresent(
+        runtime, O, k, descObjHandle, tmpPropNameStorage);
     if (LLVM_UNLIKELY(propRes == ExecutionStatus::EXCEPTION)) {
       return ExecutionStatus::EXCEPTION;
     }
@@ -2789,16 +2967,12 @@ arrayPrototypeMap(void *, Runtime *runtime, NativeArgs args) {
   MutableHandle<JSObject> descObjHandle{runtime};
 
   // Main loop to execute callback and store the results in A.
-  // TODO: Implement a fast path for actual arrays.
   auto marker = gcScope.createMarker();
   while (k->getDouble() < len) {
     gcScope.flushToMarker(marker);
 
-    ComputedPropertyDescriptor desc;
-    JSObject::getComputedPrimitiveDescriptor(
-        O, runtime, k, descObjHandle, tmpPropNameStorage, desc);
-    CallResult<PseudoHandle<>> propRes = JSObject::getComputedPropertyValue_RJS(
-        O, runtime, descObjHandle, tmpPropNameStorage, desc, k);
+    CallResult<PseudoHandle<>> propRes = getElementIfPresent(
+        runtime, O, k, descObjHandle, tmpPropNameStorage);
     if (LLVM_UNLIKELY(propRes == ExecutionStatus::EXCEPTION)) {
       return ExecutionStatus::EXCEPTION;
     }
@@ -2874,11 +3048,8 @@ arrayPrototypeFilter(void *, Runtime *runtime, NativeArgs args) {
   while (k->getDouble() < len) {
     gcScope.flushToMarker(marker);
 
-    ComputedPropertyDescriptor desc;
-    JSObject::getComputedPrimitiveDescriptor(
-        O, runtime, k, descObjHandle, tmpPropNameStorage, desc);
-    CallResult<PseudoHandle<>> propRes = JSObject::getComputedPropertyValue_RJS(
-        O, runtime, descObjHandle, tmpPropNameStorage, desc, k);
+    CallResult<PseudoHandle<>> propRes = getElementIfPresent(
+        runtime, O, k, descObjHandle, tmpPropNameStorage);
     if (LLVM_UNLIKELY(propRes == ExecutionStatus::EXCEPTION)) {
       return ExecutionStatus::EXCEPTION;
     }
@@ -3006,12 +3177,15 @@ arrayPrototypeFind(void *ctx, Runtime *runtime, NativeArgs args) {
   auto marker = gcScope.createMarker();
   while (kHandle->getNumber() < len) {
     gcScope.flushToMarker(marker);
-    if (LLVM_UNLIKELY(
-            (propRes = JSObject::getComputed_RJS(O, runtime, kHandle)) ==
-            ExecutionStatus::EXCEPTION)) {
-      return ExecutionStatus::EXCEPTION;
+    kValue = getStoredElement(runtime, *O, kHandle->getNumber());
+    if (LLVM_UNLIKELY(kValue->isEmpty())) {
+      if (LLVM_UNLIKELY(
+              (propRes = JSObject::getComputed_RJS(O, runtime, kHandle)) ==
+              ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      kValue = std::move(*propRes);
     }
-    kValue = std::move(*propRes);
     auto callRes = Callable::executeCall3(
         predicate,
         runtime,
@@ -3103,12 +3277,8 @@ reduceHelper(Runtime *runtime, NativeArgs args, const bool reverse) {
           break;
         }
       }
-      ComputedPropertyDescriptor kDesc;
-      JSObject::getComputedPrimitiveDescriptor(
-          O, runtime, k, kDescObjHandle, kNameTmpStorage, kDesc);
-      CallResult<PseudoHandle<>> propRes =
-          JSObject::getComputedPropertyValue_RJS(
-              O, runtime, kDescObjHandle, kNameTmpStorage, kDesc, k);
+      CallResult<PseudoHandle<>> propRes = getElementIfPresent(
+          runtime, O, k, kDescObjHandle, kNameTmpStorage);
       if (LLVM_UNLIKELY(propRes == ExecutionStatus::EXCEPTION)) {
         return ExecutionStatus::EXCEPTION;
       }
@@ -3137,11 +3307,8 @@ reduceHelper(Runtime *runtime, NativeArgs args, const bool reverse) {
       }
     }
 
-    ComputedPropertyDescriptor kDesc;
-    JSObject::getComputedPrimitiveDescriptor(
-        O, runtime, k, kDescObjHandle, kNameTmpStorage, kDesc);
-    CallResult<PseudoHandle<>> propRes = JSObject::getComputedPropertyValue_RJS(
-        O, runtime, kDescObjHandle, kNameTmpStorage, kDesc, k);
+    CallResult<PseudoHandle<>> propRes = getElementIfPresent(
+        runtime, O, k, kDescObjHandle, kNameTmpStorage);
     if (LLVM_UNLIKELY(propRes == ExecutionStatus::EXCEPTION)) {
       return ExecutionStatus::EXCEPTION;
     }
@@ -3359,6 +3526,11 @@ arrayPrototypeIncludes(void *, Runtime *runtime, NativeArgs args) {
     }
   }
 
+  // Elements in the storage of an array are compared directly.
+  if (searchArrayStorage(runtime, *O, len, args.getArg(0), true, false, k)) {
+    return HermesValue::encodeBoolValue(true);
+  }
+
   MutableHandle<> kHandle{runtime};
 
   // 7. Repeat, while k < len
@@ -7,6 +7,8 @@
 
 #include "JSONLexer.h"
 
+#include "hermes/Support/ASCIIScan.h"
+#include "hermes/Support/OptValue.h"
 #include "hermes/VM/StringPrimitive.h"
 
 #include "dtoa/dtoa.h"
@@ -73,6 +75,69 @@ ExecutionStatus JSONLexer::advance() {
   }
 }
 
+ExecutionStatus JSONLexer::advanceStrAsSymbol() {
+  // Skip whitespaces.
+  while (curCharPtr_.hasChar() && isJSONWhiteSpace(*curCharPtr_)) {
+    ++curCharPtr_;
+  }
+  if (!curCharPtr_.hasChar() || *curCharPtr_ != u'"') {
+    return advance();
+  }
+
+  token_.setFirstChar(u'"');
+  ++curCharPtr_;
+  SmallU16String<32> chars;
+  if (LLVM_UNLIKELY(scanStringChars(chars) == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  auto symRes = internKey(chars.arrayRef());
+  if (LLVM_UNLIKELY(symRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  token_.setSymbol(*symRes);
+  return ExecutionStatus::RETURNED;
+}
+
+/// \return the index of the key \p chars in a key cache of \p size entries.
+static uint32_t keyCacheIndex(UTF16Ref chars, uint32_t size) {
+  if (chars.empty()) {
+    return 0;
+  }
+  return (chars.size() * 31 + chars.front() * 7 + chars.back()) & (size - 1);
+}
+
+CallResult<SymbolID> JSONLexer::internKey(UTF16Ref chars) {
+  static_assert(
+      (kKeyCacheSize & (kKeyCacheSize - 1)) == 0,
+      "kKeyCacheSize must be a power of 2");
+  if (LLVM_UNLIKELY(!keyCache_)) {
+    auto cacheRes =
+        ArrayStorage::create(runtime_, kKeyCacheSize, kKeyCacheSize);
+    if (LLVM_UNLIKELY(cacheRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    keyCache_ = vmcast<ArrayStorage>(*cacheRes);
+  }
+
+  IdentifierTable &identifierTable = runtime_->getIdentifierTable();
+  const uint32_t index = keyCacheIndex(chars, kKeyCacheSize);
+  HermesValue cached = keyCache_->at(index);
+  if (cached.isSymbol() &&
+      identifierTable.getStringView(runtime_, cached.getSymbol())
+          .equals(chars)) {
+    return cached.getSymbol();
+  }
+
+  auto symRes = identifierTable.getSymbolHandle(runtime_, chars);
+  if (LLVM_UNLIKELY(symRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  // The cache keeps the symbol alive until the caller has stored it.
+  keyCache_->set(
+      index, HermesValue::encodeSymbolValue(**symRes), &runtime_->getHeap());
+  return **symRes;
+}
+
 CallResult<char16_t> JSONLexer::consumeUnicode() {
   uint16_t val = 0;
   for (unsigned i = 0; i < 4; ++i) {
@@ -94,6 +159,88 @@ CallResult<char16_t> JSONLexer::consumeUnicode() {
   return static_cast<char16_t>(val);
 }
 
+static bool isDigit(char ch) {
+  return ch >= '0' && ch <= '9';
+}
+
+/// Parse \p str, made of the characters of a JSON number, if it is a
+/// well-formed number whose value can be computed exactly from its digits
+/// with a single multiplication or division: at most 19 digits forming an
+/// integer below 2^53, scaled by a power of ten between 10^-22 and 10^22.
+/// Both operands are exact doubles then, so the correctly rounded result of
+/// the operation is also what strtod() returns.
+/// \return the value, or llvh::None to parse \p str with strtod().
+static OptValue<double> parseNumberFast(llvh::ArrayRef<char> str) {
+  static const double kPowersOf10[] = {
+      1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+  constexpr int kMaxDigits = 19;
+  constexpr int kMaxExponent = 22;
+
+  const char *p = str.begin();
+  const char *end = str.end();
+  const bool negative = p != end && *p == '-';
+  if (negative) {
+    ++p;
+  }
+  // The integer part cannot start with 0 unless it's 0, let strtod() report
+  // the error.
+  if (p == end || !isDigit(*p) ||
+      (*p == '0' && p + 1 != end && isDigit(p[1]))) {
+    return llvh::None;
+  }
+
+  uint64_t mantissa = 0;
+  int numDigits = 0;
+  int exponent = 0;
+  for (; p != end && isDigit(*p); ++p) {
+    if (++numDigits > kMaxDigits) {
+      return llvh::None;
+    }
+    mantissa = mantissa * 10 + (*p - '0');
+  }
+  if (p != end && *p == '.') {
+    ++p;
+    if (p == end || !isDigit(*p)) {
+      return llvh::None;
+    }
+    for (; p != end && isDigit(*p); ++p) {
+      if (++numDigits > kMaxDigits) {
+        return llvh::None;
+      }
+      mantissa = mantissa * 10 + (*p - '0');
+      --exponent;
+    }
+  }
+  if (p != end && (*p | 32) == 'e') {
+    ++p;
+    const bool negativeExp = p != end && *p == '-';
+    if (p != end && (*p == '-' || *p == '+')) {
+      ++p;
+    }
+    if (p == end || !isDigit(*p)) {
+      return llvh::None;
+    }
+    int exp = 0;
+    for (; p != end && isDigit(*p); ++p) {
+      if (exp > kMaxExponent + kMaxDigits) {
+        return llvh::None;
+      }
+      exp = exp * 10 + (*p - '0');
+    }
+    exponent += negativeExp ? -exp : exp;
+  }
+  if (p != end || mantissa > (uint64_t(1) << 53) || exponent < -kMaxExponent ||
+      exponent > kMaxExponent) {
+    return llvh::None;
+  }
+
+  double value = static_cast<double>(mantissa);
+  value = exponent < 0 ? value / kPowersOf10[-exponent]
+                       : value * kPowersOf10[exponent];
+  return negative ? -value : value;
+}
+
 ExecutionStatus JSONLexer::scanNumber() {
   llvh::SmallVector<char, 32> str8;
   while (curCharPtr_.hasChar()) {
@@ -113,6 +260,11 @@ ExecutionStatus JSONLexer::scanNumber() {
     return errorWithChar(u"Unexpected token in number: ", str8[1]);
   }
 
+  if (auto fast = parseNumberFast(str8)) {
+    token_.setNumber(*fast);
+    return ExecutionStatus::RETURNED;
+  }
+
   str8.push_back('\0');
 
   char *endPtr;
@@ -128,23 +280,42 @@ ExecutionStatus JSONLexer::scanString() {
   assert(*curCharPtr_ == '"');
   ++curCharPtr_;
   SmallU16String<32> tmpStorage;
+  if (LLVM_UNLIKELY(
+          scanStringChars(tmpStorage) == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
 
+  // If the string exists in the identifier table, use that one.
+  if (auto existing =
+          runtime_->getIdentifierTable().getExistingStringPrimitiveOrNull(
+              runtime_, tmpStorage.arrayRef())) {
+    token_.setString(runtime_->makeHandle<StringPrimitive>(existing));
+    return ExecutionStatus::RETURNED;
+  }
+  auto strRes = StringPrimitive::create(runtime_, tmpStorage.arrayRef());
+  if (LLVM_UNLIKELY(strRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  token_.setString(runtime_->makeHandle<StringPrimitive>(*strRes));
+  return ExecutionStatus::RETURNED;
+}
+
+ExecutionStatus JSONLexer::scanStringChars(
+    llvh::SmallVectorImpl<char16_t> &tmpStorage) {
   while (curCharPtr_.hasChar()) {
+    // Copy the run of literal characters in bulk.
+    llvh::ArrayRef<char16_t> avail = curCharPtr_.available();
+    const char16_t *runEnd =
+        asciiscan::findQuoteBackslashOrControl(avail.begin(), avail.end());
+    tmpStorage.append(avail.begin(), runEnd);
+    curCharPtr_.skip(runEnd - avail.begin());
+    if (runEnd == avail.end()) {
+      continue;
+    }
+
     if (*curCharPtr_ == '"') {
       // End of string.
       ++curCharPtr_;
-      // If the string exists in the identifier table, use that one.
-      if (auto existing =
-              runtime_->getIdentifierTable().getExistingStringPrimitiveOrNull(
-                  runtime_, tmpStorage.arrayRef())) {
-        token_.setString(runtime_->makeHandle<StringPrimitive>(existing));
-        return ExecutionStatus::RETURNED;
-      }
-      auto strRes = StringPrimitive::create(runtime_, tmpStorage.arrayRef());
-      if (LLVM_UNLIKELY(strRes == ExecutionStatus::EXCEPTION)) {
-        return ExecutionStatus::EXCEPTION;
-      }
-      token_.setString(runtime_->makeHandle<StringPrimitive>(*strRes));
       return ExecutionStatus::RETURNED;
     } else if (*curCharPtr_ <= '\u001F') {
       return error(u"U+0000 thru U+001F is not allowed in string");
@@ -196,9 +367,6 @@ ExecutionStatus JSONLexer::scanString() {
         default:
           return errorWithChar(u"Invalid escape sequence: ", *curCharPtr_);
       }
-    } else {
-      tmpStorage.push_back(*curCharPtr_);
-      ++curCharPtr_;
     }
   }
   return error("Unexpected end of input");
@@ -9,6 +9,7 @@
 #define HERMES_PARSER_JSONLEXER_H
 
 #include "hermes/Support/UTF16Stream.h"
+#include "hermes/VM/ArrayStorage.h"
 #include "hermes/VM/IdentifierTable.h"
 #include "hermes/VM/Runtime.h"
 #include "hermes/VM/SmallXString.h"
@@ -46,6 +47,8 @@ class JSONToken {
   JSONTokenKind kind_{JSONTokenKind::None};
   double numberValue_{};
   MutableHandle<StringPrimitive> stringValue_;
+  /// The value of a String token scanned by advanceStrAsSymbol().
+  MutableHandle<SymbolID> symbolValue_;
 
   /// The starting character of this token.
   char16_t firstChar_{};
@@ -54,7 +57,8 @@ class JSONToken {
   const JSONToken &operator=(const JSONToken &) = delete;
 
  public:
-  explicit JSONToken(Runtime *runtime) : stringValue_(runtime) {}
+  explicit JSONToken(Runtime *runtime)
+      : stringValue_(runtime), symbolValue_(runtime) {}
 
   JSONTokenKind getKind() const {
     return kind_;
@@ -70,6 +74,11 @@ class JSONToken {
     return stringValue_;
   }
 
+  Handle<SymbolID> getStrAsSymbol() const {
+    assert(getKind() == JSONTokenKind::String);
+    return symbolValue_;
+  }
+
   char16_t getFirstChar() const {
     return firstChar_;
   }
@@ -96,6 +105,10 @@ class JSONToken {
     kind_ = JSONTokenKind::String;
     stringValue_ = str.get();
   }
+  void setSymbol(SymbolID sym) {
+    kind_ = JSONTokenKind::String;
+    symbolValue_ = sym;
+  }
 };
 
 class JSONLexer {
@@ -106,9 +119,21 @@ class JSONLexer {
 
   JSONToken token_;
 
+  /// Number of entries in keyCache_.
+  static constexpr uint32_t kKeyCacheSize = 64;
+
+  /// The symbols of recently scanned object keys, indexed by the hash
+  /// computed by keyCacheIndex(). Records usually repeat the same few keys,
+  /// which can then be found without going to the identifier table. Created
+  /// on first use.
+  MutableHandle<ArrayStorage> keyCache_;
+
  public:
   JSONLexer(Runtime *runtime, UTF16Stream &&stream)
-      : curCharPtr_(std::move(stream)), runtime_(runtime), token_(runtime) {}
+      : curCharPtr_(std::move(stream)),
+        runtime_(runtime),
+        token_(runtime),
+        keyCache_(runtime) {}
 
   /// \return the current token.
   const JSONToken *getCurToken() const {
@@ -123,6 +148,11 @@ class JSONLexer {
   /// All whitespace is skipped before the new token.
   LLVM_NODISCARD ExecutionStatus advance();
 
+  /// Like advance(), but if the next token is a string, set it as a symbol
+  /// (see JSONToken::getStrAsSymbol()) instead of creating a string. Used for
+  /// the keys of objects.
+  LLVM_NODISCARD ExecutionStatus advanceStrAsSymbol();
+
   /// Raise a JSON parse exception with message \p msg.
   /// token_ will also be invalidated.
   LLVM_NODISCARD ExecutionStatus error(const TwineChar16 &msg) {
@@ -145,6 +175,15 @@ class JSONLexer {
   /// Parse a JSONString.
   LLVM_NODISCARD ExecutionStatus scanString();
 
+  /// Parse the characters of a JSONString, after the opening quote, into
+  /// \p chars, and consume the closing quote.
+  LLVM_NODISCARD ExecutionStatus
+  scanStringChars(llvh::SmallVectorImpl<char16_t> &chars);
+
+  /// \return the symbol for the object key \p chars, from keyCache_ or else
+  /// from the identifier table.
+  CallResult<SymbolID> internKey(UTF16Ref chars);
+
   /// Parse a reserved keyword.
   LLVM_NODISCARD ExecutionStatus scanWord(const char *word, JSONTokenKind kind);
 
@@ -10,8 +10,10 @@
 #include "Object.h"
 
 #include "hermes/Support/Compiler.h"
+#include "hermes/Support/Conversions.h"
 #include "hermes/Support/JSON.h"
 #include "hermes/Support/UTF16Stream.h"
+#include "hermes/Support/UTF8.h"
 #include "hermes/VM/ArrayLike.h"
 #include "hermes/VM/ArrayStorage.h"
 #include "hermes/VM/Callable.h"
@@ -21,6 +23,7 @@
 
 #include "JSONLexer.h"
 
+#include "llvh/ADT/DenseSet.h"
 #include "llvh/ADT/SmallString.h"
 #include "llvh/Support/SaveAndRestore.h"
 
@@ -57,6 +60,12 @@ class RuntimeJSONParser {
   /// is needed to protect some HermesValue.
   MutableHandle<> tmpHandle_;
 
+  /// The contents of the arrays and objects being parsed: the elements of
+  /// arrays, and the keys (as symbols) and values of objects, in pairs. They
+  /// are pushed here as they are parsed, and moved into an array or object of
+  /// the right size once it is complete.
+  MutableHandle<ArrayStorage> pending_;
+
   /// How many more nesting levels we allow before error.
   /// Decremented every time a nested level is started,
   /// and incremented again when leaving the nest.
@@ -71,7 +80,8 @@ class RuntimeJSONParser {
       : runtime_(runtime),
         lexer_(runtime, std::move(jsonString)),
         reviver_(reviver),
-        tmpHandle_(runtime) {}
+        tmpHandle_(runtime),
+        pending_(runtime) {}
 
   /// Parse JSON string through lexer_, create objects using runtime_.
   /// If errors occur, this function will return undefined, and the error
@@ -79,10 +89,25 @@ class RuntimeJSONParser {
   CallResult<HermesValue> parse();
 
  private:
+  /// The hidden class of the last object parsed among the elements of an
+  /// array or the values of an object, and the keys it was built from, in
+  /// order. Siblings usually have the same keys, and can then be created
+  /// with the class directly instead of adding their properties one by one.
+  struct ShapeHint {
+    /// The class, which also keeps the keys alive. Null before the first
+    /// object.
+    MutableHandle<HiddenClass> clazz;
+    llvh::SmallVector<SymbolID, 8> keys;
+
+    explicit ShapeHint(Runtime *runtime) : clazz(runtime) {}
+  };
+
   /// Parse a JSON value, starting from the current token.
   /// When this function is finished, the current token will be set
   /// to the next token after the current parsed value.
-  CallResult<HermesValue> parseValue();
+  /// \param hint the shape of the previous sibling of the value, updated if
+  ///   the value is an object.
+  CallResult<HermesValue> parseValue(ShapeHint &hint);
 
   /// Parse a JSON array, starting from the "[" token.
   /// When this function is finished, the current token must be "]".
@@ -90,7 +115,13 @@ class RuntimeJSONParser {
 
   /// Parse a JSON object, starting from the "{" token.
   /// When this function is finished, the current token must be "}".
-  CallResult<HermesValue> parseObject();
+  CallResult<HermesValue> parseObject(ShapeHint &hint);
+
+  /// Create an object with the keys and values in pending_ from index
+  /// \p begin onwards, using or updating \p hint.
+  CallResult<HermesValue> createObject(
+      ShapeHint &hint,
+      ArrayStorage::size_type begin);
 
   /// Use reviver to filter the result.
   CallResult<HermesValue> revive(Handle<> value);
@@ -107,6 +138,152 @@ class RuntimeJSONParser {
   ExecutionStatus filter(Handle<JSObject> val, Handle<> key);
 };
 
+/// The output of JSON.stringify. Characters are stored in a byte each for as
+/// long as they are all ASCII, which is the common case, and the buffer
+/// switches to UTF-16 at the first character that is not.
+class StringifyOutput {
+ public:
+  size_t size() const {
+    return isASCII_ ? ascii_.size() : utf16_.size();
+  }
+
+  void push_back(char16_t ch) {
+    if (LLVM_LIKELY(isASCII_)) {
+      if (LLVM_LIKELY(ch < 0x80)) {
+        ascii_.push_back(static_cast<char>(ch));
+        return;
+      }
+      widen();
+    }
+    utf16_.push_back(ch);
+  }
+
+  void append(std::initializer_list<char16_t> chars) {
+    for (char16_t ch : chars) {
+      push_back(ch);
+    }
+  }
+
+  /// Append [begin, end), which must be ASCII.
+  void append(const char *begin, const char *end) {
+    if (LLVM_LIKELY(isASCII_)) {
+      ascii_.append(begin, end);
+    } else {
+      utf16_.append(begin, end);
+    }
+  }
+
+  void append(const char16_t *begin, const char16_t *end) {
+    if (LLVM_LIKELY(isASCII_)) {
+      const char16_t *nonASCII = asciiscan::findNonASCII(begin, end);
+      ascii_.append(begin, nonASCII);
+      if (nonASCII == end) {
+        return;
+      }
+      widen();
+      begin = nonASCII;
+    }
+    utf16_.append(begin, end);
+  }
+
+  /// Append \p value as a quoted JSON string.
+  void appendQuoted(StringView value) {
+    if (value.isASCII()) {
+      const char *p = value.castToCharPtr();
+      quoteStringForJSON(*this, p, p + value.length());
+    } else {
+      const char16_t *p = value.castToChar16Ptr();
+      quoteStringForJSON(*this, p, p + value.length());
+    }
+  }
+
+  /// Append the characters in [begin, end) of \p other.
+  void append(const StringifyOutput &other, size_t begin, size_t end) {
+    if (other.isASCII_) {
+      const char *p = other.ascii_.data();
+      append(p + begin, p + end);
+    } else {
+      const char16_t *p = other.utf16_.data();
+      append(p + begin, p + end);
+    }
+  }
+
+  /// Drop the characters from \p size onwards.
+  void truncate(size_t size) {
+    assert(size <= this->size() && "truncate cannot grow the output");
+    if (isASCII_) {
+      ascii_.resize(size);
+    } else {
+      utf16_.resize(size);
+    }
+  }
+
+  /// Create a string with the contents of the output, which may take over its
+  /// storage: the output must not be used afterwards.
+  CallResult<HermesValue> toString(Runtime *runtime) {
+    if (isASCII_) {
+      return StringPrimitive::createEfficient(runtime, std::move(ascii_));
+    }
+    return StringPrimitive::createEfficient(runtime, std::move(utf16_));
+  }
+
+  /// Pass the contents of the output to \p sink as UTF-8, and empty it.
+  void flushTo(const JSONStringifySink &sink) {
+    if (isASCII_) {
+      sink(ascii_);
+      ascii_.clear();
+      return;
+    }
+    std::string utf8;
+    convertUTF16ToUTF8WithReplacements(
+        utf8, llvh::ArrayRef<char16_t>(utf16_.data(), utf16_.size()));
+    sink(utf8);
+    utf16_.clear();
+    isASCII_ = true;
+  }
+
+ private:
+  /// Copy the ASCII characters so far to utf16_ and use it from now on.
+  void widen() {
+    utf16_.assign(ascii_.begin(), ascii_.end());
+    ascii_ = std::string();
+    isASCII_ = false;
+  }
+
+  /// Whether every character so far was ASCII and is stored in ascii_.
+  bool isASCII_{true};
+  std::string ascii_;
+  std::u16string utf16_;
+};
+
+/// How to serialize the objects of one hidden class: the enumerable string
+/// keyed properties that JO() visits, in order, with their keys already
+/// quoted. Only plain objects whose class has no index-like names and no
+/// enumerable accessors get a plan; their properties are read straight from
+/// their slots.
+struct ShapePlan {
+  /// A property to serialize. Its quoted key, followed by the ':' and space
+  /// separating it from its value, ends at \c textEnd in \c keyText and
+  /// starts where the previous one ends.
+  struct Entry {
+    size_t textEnd;
+    SlotIndex slot;
+    SymbolID name;
+  };
+
+  /// Index of the class of this plan in JSONStringifyer::planClasses_.
+  uint32_t index;
+
+  /// Whether objects of the class can be serialized with the plan at all.
+  bool eligible{true};
+
+  /// Whether the class has an own property named toJSON.
+  bool hasToJSON{false};
+
+  StringifyOutput keyText{};
+  llvh::SmallVector<Entry, 8> entries{};
+};
+
 /// This class wraps the functionality required to stringify an object
 /// as JSON.
 class JSONStringifyer {
@@ -165,7 +342,32 @@ class JSONStringifyer {
       RuntimeJSONParser::MAX_RECURSION_DEPTH};
 
   /// The output buffer. The serialization process will append into it.
-  llvh::SmallVector<char16_t, 32> output_{};
+  StringifyOutput output_{};
+
+  /// Where the output is passed when it grows past kSinkChunkSize, or null if
+  /// it is returned as a string at the end.
+  const JSONStringifySink *sink_{nullptr};
+
+  /// How many characters the output may hold before it is passed to sink_.
+  static constexpr size_t kSinkChunkSize = 1 << 14;
+
+  /// The most plans kept by one stringify call.
+  static constexpr uint32_t kMaxShapePlans = 32;
+
+  /// The hidden classes that have been given a plan, at the index of their
+  /// plan in shapePlans_.
+  MutableHandle<ArrayStorage> planClasses_;
+
+  /// The plans, which are never freed before stringify returns, so that
+  /// callers further up the recursion can keep using theirs.
+  std::vector<std::unique_ptr<ShapePlan>> shapePlans_{};
+
+  /// Index of the plan found last, which is checked first.
+  uint32_t lastPlan_{0};
+
+  /// The class of Object.prototype when it was last found to have no toJSON
+  /// property. Null if it has not been checked, or was a dictionary.
+  MutableHandle<HiddenClass> protoClassWithoutToJSON_;
 
  public:
   explicit JSONStringifyer(Runtime *runtime)
@@ -179,7 +381,9 @@ class JSONStringifyer {
         tmpHandle2_(runtime),
         operationStrValue_(runtime),
         operationJOK_(runtime),
-        operationStrHolder_(runtime) {}
+        operationStrHolder_(runtime),
+        planClasses_(runtime),
+        protoClassWithoutToJSON_(runtime) {}
 
   LLVM_NODISCARD ExecutionStatus init(Handle<> replacer, Handle<> space) {
     auto arrRes = PropStorage::create(runtime_, 4);
@@ -193,6 +397,11 @@ class JSONStringifyer {
       return ExecutionStatus::EXCEPTION;
     }
     stackJO_ = vmcast<PropStorage>(*arrRes);
+    auto classesRes = ArrayStorage::create(runtime_, kMaxShapePlans);
+    if (LLVM_UNLIKELY(classesRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    planClasses_ = vmcast<ArrayStorage>(*classesRes);
     auto cr = initializeReplacer(replacer);
     if (LLVM_UNLIKELY(cr == ExecutionStatus::EXCEPTION)) {
       return ExecutionStatus::EXCEPTION;
@@ -203,6 +412,12 @@ class JSONStringifyer {
   /// Stringify \p value.
   CallResult<HermesValue> stringify(Handle<> value);
 
+  /// Stringify \p value, passing the output to \p sink as it is produced.
+  /// \return whether the result is not undefined.
+  CallResult<bool> stringifyToSink(
+      Handle<> value,
+      const JSONStringifySink &sink);
+
  private:
   /// Check the type of replacer, initialize
   /// ReplacerFunction (replacerFunction_) and PropertyList (propertyList_).
@@ -213,6 +428,21 @@ class JSONStringifyer {
   /// Covers step 5, 6, 7, 8 in ES5.1 15.12.3.
   ExecutionStatus initializeSpace(Handle<> space);
 
+  /// Steps 9 to 11 in ES5.1 15.12.3: serialize \p value into output_.
+  /// \return whether the result is not undefined.
+  CallResult<bool> serializeRoot(Handle<> value);
+
+  /// Pass the output to sink_ if there is one and the output has grown past
+  /// kSinkChunkSize. Only called after an array element or object property
+  /// has been completed: the output is only ever rolled back to the start of
+  /// a property whose value turned out to be undefined, and such a value
+  /// does not recurse, so nothing that has been passed on is rolled back.
+  void maybeFlush() {
+    if (sink_ && output_.size() >= kSinkChunkSize) {
+      output_.flushTo(*sink_);
+    }
+  }
+
   /// Implement the Str(key, holder) abstract operation to serialize a value.
   /// According to the spec, \p key should always be a string.
   /// However if this function is called from operationJA, we
@@ -222,6 +452,13 @@ class JSONStringifyer {
   /// \return whether the result is not undefined.
   CallResult<bool> operationStr(HermesValue key);
 
+  /// Steps 2 to 11 of Str(key, holder), for the value already read into
+  /// operationStrValue_ and the key in tmpHandle_.
+  CallResult<bool> serializeValue();
+
+  /// Append the number \p num to output_, without creating a string.
+  void appendNumber(double num);
+
   /// Implement the abstract operation Quote(value).
   /// It wraps a String value in double quotes and escapes characters within it.
   void operationQuote(StringView value);
@@ -233,8 +470,24 @@ class JSONStringifyer {
 
   /// Implement the abstract operation JO(value). The value to operate on
   /// is always the current last element in stackValue_.
-  /// It serializes an object.
-  ExecutionStatus operationJO();
+  /// It serializes an object, with \p plan if it is not null.
+  ExecutionStatus operationJO(const ShapePlan *plan);
+
+  /// Steps 8 to 10 of JO(value), with the keys and slots in \p plan instead
+  /// of enumerating the properties of the object.
+  /// \return whether any property was serialized.
+  CallResult<bool> operationJOWithPlan(const ShapePlan &plan);
+
+  /// \return the plan for the objects of the class of \p obj, creating it if
+  /// needed, or nullptr if they must be serialized without one.
+  ShapePlan *getShapePlan(Handle<JSObject> obj);
+
+  /// Create the plan for \p clazz.
+  std::unique_ptr<ShapePlan> createShapePlan(Handle<HiddenClass> clazz);
+
+  /// \return true if a toJSON property cannot be found on \p obj, whose
+  /// class has \p plan, so that Str() need not look it up.
+  bool lacksToJSON(JSObject *obj, const ShapePlan &plan);
 
   /// Append '\n' and indent to output_.
   /// The indent is constructed according to depthCount_.
@@ -258,11 +511,18 @@ class JSONStringifyer {
 } // namespace
 
 CallResult<HermesValue> RuntimeJSONParser::parse() {
+  auto pendingRes = ArrayStorage::create(runtime_, 64);
+  if (LLVM_UNLIKELY(pendingRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  pending_ = vmcast<ArrayStorage>(*pendingRes);
+
   // parseValue() requires one token to start with.
   if (LLVM_UNLIKELY(lexer_.advance() == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
-  auto parRes = parseValue();
+  ShapeHint hint{runtime_};
+  auto parRes = parseValue(hint);
   if (LLVM_UNLIKELY(parRes == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
@@ -281,7 +541,7 @@ CallResult<HermesValue> RuntimeJSONParser::parse() {
   return parRes;
 }
 
-CallResult<HermesValue> RuntimeJSONParser::parseValue() {
+CallResult<HermesValue> RuntimeJSONParser::parseValue(ShapeHint &hint) {
   llvh::SaveAndRestore<decltype(remainingDepth_)> oldDepth{
       remainingDepth_, remainingDepth_ - 1};
   if (remainingDepth_ <= 0) {
@@ -298,7 +558,7 @@ CallResult<HermesValue> RuntimeJSONParser::parseValue() {
           HermesValue::encodeDoubleValue(lexer_.getCurToken()->getNumber());
       break;
     case JSONTokenKind::LBrace: {
-      auto parRes = parseObject();
+      auto parRes = parseObject(hint);
       if (LLVM_UNLIKELY(parRes == ExecutionStatus::EXCEPTION)) {
         return ExecutionStatus::EXCEPTION;
       }
@@ -342,35 +602,29 @@ CallResult<HermesValue> RuntimeJSONParser::parseArray() {
   assert(
       lexer_.getCurToken()->getKind() == JSONTokenKind::LSquare &&
       "Wrong entrance to parseArray");
-  auto arrRes = JSArray::create(runtime_, 4, 0);
-  if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION)) {
-    return ExecutionStatus::EXCEPTION;
-  }
-  auto array = *arrRes;
 
   if (LLVM_UNLIKELY(lexer_.advance() == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
+  const ArrayStorage::size_type begin = pending_->size();
   if (lexer_.getCurToken()->getKind() != JSONTokenKind::RSquare) {
-    MutableHandle<> indexValue{runtime_};
+    ShapeHint hint{runtime_};
     GCScope gcScope{runtime_};
     auto marker = gcScope.createMarker();
 
-    for (uint32_t index = 0;; ++index) {
+    for (;;) {
       gcScope.flushToMarker(marker);
 
-      auto parRes = parseValue();
+      auto parRes = parseValue(hint);
       if (LLVM_UNLIKELY(parRes == ExecutionStatus::EXCEPTION)) {
         return ExecutionStatus::EXCEPTION;
       }
-
-      indexValue = HermesValue::encodeDoubleValue(index);
-      (void)JSObject::defineOwnComputedPrimitive(
-          array,
-          runtime_,
-          indexValue,
-          DefinePropertyFlags::getDefaultNewPropertyFlags(),
-          runtime_->makeHandle(*parRes));
+      if (LLVM_UNLIKELY(
+              ArrayStorage::push_back(
+                  pending_, runtime_, runtime_->makeHandle(*parRes)) ==
+              ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
 
       if (lexer_.getCurToken()->getKind() == JSONTokenKind::Comma) {
         if (LLVM_UNLIKELY(lexer_.advance() == ExecutionStatus::EXCEPTION)) {
@@ -388,20 +642,39 @@ CallResult<HermesValue> RuntimeJSONParser::parseArray() {
         "Unexpected break for array parse");
   }
 
+  // Now that the length is known, allocate the array at its final size.
+  const JSArray::size_type length = pending_->size() - begin;
+  auto arrRes = JSArray::create(runtime_, length, length);
+  if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  auto array = *arrRes;
+  if (LLVM_UNLIKELY(
+          JSArray::setStorageEndIndex(array, runtime_, length) ==
+          ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  for (JSArray::size_type i = 0; i < length; ++i) {
+    JSArray::unsafeSetExistingElementAt(
+        *array, runtime_, i, pending_->at(begin + i));
+  }
+  ArrayStorage::resizeWithinCapacity(*pending_, runtime_, begin);
+
   return array.getHermesValue();
 }
 
-CallResult<HermesValue> RuntimeJSONParser::parseObject() {
+CallResult<HermesValue> RuntimeJSONParser::parseObject(ShapeHint &hint) {
   assert(
       lexer_.getCurToken()->getKind() == JSONTokenKind::LBrace &&
       "Wrong entrance to parseObject");
-  auto object = runtime_->makeHandle(JSObject::create(runtime_));
 
-  if (LLVM_UNLIKELY(lexer_.advance() == ExecutionStatus::EXCEPTION)) {
+  if (LLVM_UNLIKELY(
+          lexer_.advanceStrAsSymbol() == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
+  const ArrayStorage::size_type begin = pending_->size();
   if (lexer_.getCurToken()->getKind() != JSONTokenKind::RBrace) {
-    MutableHandle<StringPrimitive> key{runtime_};
+    ShapeHint valueHint{runtime_};
     GCScope gcScope{runtime_};
     auto marker = gcScope.createMarker();
     for (;;) {
@@ -411,7 +684,15 @@ CallResult<HermesValue> RuntimeJSONParser::parseObject() {
               lexer_.getCurToken()->getKind() != JSONTokenKind::String)) {
         return lexer_.error("Expect a string key in JSON object");
       }
-      key = lexer_.getCurToken()->getString().get();
+      if (LLVM_UNLIKELY(
+              ArrayStorage::push_back(
+                  pending_,
+                  runtime_,
+                  runtime_->makeHandle(HermesValue::encodeSymbolValue(
+                      *lexer_.getCurToken()->getStrAsSymbol()))) ==
+              ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
 
       if (LLVM_UNLIKELY(lexer_.advance() == ExecutionStatus::EXCEPTION)) {
         return ExecutionStatus::EXCEPTION;
@@ -425,20 +706,20 @@ CallResult<HermesValue> RuntimeJSONParser::parseObject() {
         return ExecutionStatus::EXCEPTION;
       }
 
-      auto parRes = parseValue();
+      auto parRes = parseValue(valueHint);
       if (LLVM_UNLIKELY(parRes == ExecutionStatus::EXCEPTION)) {
         return ExecutionStatus::EXCEPTION;
       }
-
-      (void)JSObject::defineOwnComputedPrimitive(
-          object,
-          runtime_,
-          key,
-          DefinePropertyFlags::getDefaultNewPropertyFlags(),
-          runtime_->makeHandle(*parRes));
+      if (LLVM_UNLIKELY(
+              ArrayStorage::push_back(
+                  pending_, runtime_, runtime_->makeHandle(*parRes)) ==
+              ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
 
       if (lexer_.getCurToken()->getKind() == JSONTokenKind::Comma) {
-        if (LLVM_UNLIKELY(lexer_.advance() == ExecutionStatus::EXCEPTION)) {
+        if (LLVM_UNLIKELY(
+                lexer_.advanceStrAsSymbol() == ExecutionStatus::EXCEPTION)) {
           return ExecutionStatus::EXCEPTION;
         }
         continue;
@@ -453,6 +734,95 @@ CallResult<HermesValue> RuntimeJSONParser::parseObject() {
         "Unexpected stop for object parse");
   }
 
+  auto objRes = createObject(hint, begin);
+  if (LLVM_UNLIKELY(objRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  ArrayStorage::resizeWithinCapacity(*pending_, runtime_, begin);
+  return *objRes;
+}
+
+CallResult<HermesValue> RuntimeJSONParser::createObject(
+    ShapeHint &hint,
+    ArrayStorage::size_type begin) {
+  const uint32_t numProps = (pending_->size() - begin) / 2;
+  auto keyAt = [this, begin](uint32_t i) {
+    return pending_->at(begin + 2 * i).getSymbol();
+  };
+  auto valueAt = [this, begin](uint32_t i) {
+    return pending_->at(begin + 2 * i + 1);
+  };
+
+  bool sameKeys = hint.clazz && hint.keys.size() == numProps;
+  for (uint32_t i = 0; sameKeys && i < numProps; ++i) {
+    sameKeys = hint.keys[i] == keyAt(i);
+  }
+
+  MutableHandle<HiddenClass> clazz{runtime_};
+  if (sameKeys) {
+    clazz = hint.clazz.get();
+  } else {
+    llvh::SmallDenseSet<uint32_t, 16> seen;
+    for (uint32_t i = 0; i < numProps; ++i) {
+      if (LLVM_UNLIKELY(!seen.insert(keyAt(i).unsafeGetRaw()).second)) {
+        // A repeated key keeps its first position and its last value, so
+        // define the properties one by one.
+        auto object = runtime_->makeHandle(JSObject::create(runtime_));
+        MutableHandle<> key{runtime_};
+        GCScopeMarkerRAII marker{runtime_};
+        for (uint32_t j = 0; j < numProps; ++j) {
+          key = HermesValue::encodeSymbolValue(keyAt(j));
+          (void)JSObject::defineOwnComputedPrimitive(
+              object,
+              runtime_,
+              key,
+              DefinePropertyFlags::getDefaultNewPropertyFlags(),
+              runtime_->makeHandle(valueAt(j)));
+          marker.flush();
+        }
+        return object.getHermesValue();
+      }
+    }
+
+    // Build the class, starting from the one of empty objects.
+    clazz = runtime_->getHiddenClassForPrototypeRaw(
+        vmcast<JSObject>(runtime_->objectPrototype),
+        JSObject::numOverlapSlots<JSObject>());
+    GCScopeMarkerRAII marker{runtime_};
+    for (uint32_t i = 0; i < numProps; ++i) {
+      auto addRes = HiddenClass::addProperty(
+          clazz,
+          runtime_,
+          keyAt(i),
+          PropertyFlags::defaultNewNamedPropertyFlags());
+      if (LLVM_UNLIKELY(addRes == ExecutionStatus::EXCEPTION)) {
+        return ExecutionStatus::EXCEPTION;
+      }
+      assert(addRes->second == i && "properties must be in consecutive slots");
+      clazz = addRes->first.get();
+      marker.flush();
+    }
+
+    // Dictionary classes belong to a single object, don't share them.
+    if (clazz->isDictionary()) {
+      hint.clazz = nullptr;
+      hint.keys.clear();
+    } else {
+      hint.clazz = clazz.get();
+      hint.keys.clear();
+      for (uint32_t i = 0; i < numProps; ++i) {
+        hint.keys.push_back(keyAt(i));
+      }
+    }
+  }
+
+  auto object = runtime_->makeHandle(JSObject::create(runtime_, clazz));
+  for (uint32_t i = 0; i < numProps; ++i) {
+    // Encode the value before reading the object, since it may allocate.
+    auto shv = SmallHermesValue::encodeHermesValue(valueAt(i), runtime_);
+    // We made this object, it's not a Proxy.
+    JSObject::setNamedSlotValueUnsafe(object.get(), runtime_, i, shv);
+  }
   return object.getHermesValue();
 }
 
@@ -572,11 +942,31 @@ CallResult<HermesValue> runtimeJSONParse(
     Runtime *runtime,
     Handle<StringPrimitive> jsonString,
     Handle<Callable> reviver) {
-  // Our parser requires UTF16 data that does not move during GCs, so
-  // in most cases we'll need to copy, except for external 16-bit strings.
+  // Our parser requires data that does not move during GCs, so in most cases
+  // we'll need to copy, except for external strings. ASCII strings are
+  // streamed as UTF8, which is widened to UTF16 a chunk at a time, instead of
+  // all at once.
+  if (jsonString->isASCII()) {
+    llvh::SmallVector<uint8_t, 32> storage8;
+    llvh::ArrayRef<uint8_t> bytes;
+    if (LLVM_UNLIKELY(jsonString->isExternal())) {
+      ASCIIRef chars = jsonString->getStringRef<char>();
+      bytes = llvh::ArrayRef<uint8_t>(
+          reinterpret_cast<const uint8_t *>(chars.data()), chars.size());
+    } else {
+      StringView view = StringPrimitive::createStringView(runtime, jsonString);
+      const uint8_t *chars =
+          reinterpret_cast<const uint8_t *>(view.castToCharPtr());
+      storage8.append(chars, chars + view.length());
+      bytes = storage8;
+    }
+    RuntimeJSONParser parser{runtime, UTF16Stream(bytes), reviver};
+    return parser.parse();
+  }
+
   UTF16Ref ref;
   SmallU16String<32> storage;
-  if (LLVM_UNLIKELY(jsonString->isExternal() && !jsonString->isASCII())) {
+  if (LLVM_UNLIKELY(jsonString->isExternal())) {
     ref = jsonString->getStringRef<char16_t>();
   } else {
     StringPrimitive::createStringView(runtime, jsonString)
@@ -740,36 +1130,46 @@ CallResult<bool> JSONStringifyer::operationStr(HermesValue key) {
     return ExecutionStatus::EXCEPTION;
   }
   operationStrValue_.set(propRes->get());
+  return serializeValue();
+}
+
+CallResult<bool> JSONStringifyer::serializeValue() {
+  GCScopeMarkerRAII marker{runtime_};
 
+  // The plan for the value if it is a plain object. It is dropped if the
+  // value is replaced.
+  const ShapePlan *plan = nullptr;
   if (auto valueObj = Handle<JSObject>::dyn_vmcast(operationStrValue_)) {
+    plan = getShapePlan(valueObj);
     // Str.2.
-    // Str.2.a: check if toJSON exists in value.
-    if (LLVM_UNLIKELY(
-            (propRes = JSObject::getNamed_RJS(
-                 valueObj,
-                 runtime_,
-                 Predefined::getSymbolID(Predefined::toJSON))) ==
-            ExecutionStatus::EXCEPTION)) {
-      return ExecutionStatus::EXCEPTION;
-    }
-    // Str.2.b: check if toJSON is a Callable.
-    if (auto toJSON = Handle<Callable>::dyn_vmcast(
-            runtime_->makeHandle(std::move(*propRes)))) {
-      if (!tmpHandle_->isString()) {
-        // Lazily convert key to a string.
-        auto status = toString_RJS(runtime_, tmpHandle_);
-        assert(
-            status != ExecutionStatus::EXCEPTION &&
-            "toString on a property cannot fail");
-        tmpHandle_ = status->getHermesValue();
-      }
-      // Call toJSON with key as argument, value as this.
-      auto callRes = Callable::executeCall1(
-          toJSON, runtime_, operationStrValue_, *tmpHandle_);
-      if (LLVM_UNLIKELY(callRes == ExecutionStatus::EXCEPTION)) {
+    // Str.2.a: check if toJSON exists in value, unless the plan shows that
+    // it cannot.
+    if (!plan || !lacksToJSON(*valueObj, *plan)) {
+      auto propRes = JSObject::getNamed_RJS(
+          valueObj, runtime_, Predefined::getSymbolID(Predefined::toJSON));
+      if (LLVM_UNLIKELY(propRes == ExecutionStatus::EXCEPTION)) {
         return ExecutionStatus::EXCEPTION;
       }
-      operationStrValue_ = std::move(*callRes);
+      // Str.2.b: check if toJSON is a Callable.
+      if (auto toJSON = Handle<Callable>::dyn_vmcast(
+              runtime_->makeHandle(std::move(*propRes)))) {
+        if (!tmpHandle_->isString()) {
+          // Lazily convert key to a string.
+          auto status = toString_RJS(runtime_, tmpHandle_);
+          assert(
+              status != ExecutionStatus::EXCEPTION &&
+              "toString on a property cannot fail");
+          tmpHandle_ = status->getHermesValue();
+        }
+        // Call toJSON with key as argument, value as this.
+        auto callRes = Callable::executeCall1(
+            toJSON, runtime_, operationStrValue_, *tmpHandle_);
+        if (LLVM_UNLIKELY(callRes == ExecutionStatus::EXCEPTION)) {
+          return ExecutionStatus::EXCEPTION;
+        }
+        operationStrValue_ = std::move(*callRes);
+        plan = nullptr;
+      }
     }
   }
 
@@ -850,11 +1250,7 @@ CallResult<bool> JSONStringifyer::operationStr(HermesValue key) {
   // Str.9.
   if (operationStrValue_->isNumber()) {
     if (std::isfinite(operationStrValue_->getNumber())) {
-      auto status = toString_RJS(runtime_, operationStrValue_);
-      assert(
-          status != ExecutionStatus::EXCEPTION &&
-          "toString on a number cannot fail");
-      appendToOutput(status->get());
+      appendNumber(operationStrValue_->getNumber());
     } else {
       appendToOutput(Predefined::getSymbolID(Predefined::null));
     }
@@ -880,7 +1276,8 @@ CallResult<bool> JSONStringifyer::operationStr(HermesValue key) {
     if (LLVM_UNLIKELY(isArrayRes == ExecutionStatus::EXCEPTION)) {
       return ExecutionStatus::EXCEPTION;
     }
-    ExecutionStatus status = *isArrayRes ? operationJA() : operationJO();
+    ExecutionStatus status =
+        *isArrayRes ? operationJA() : operationJO(plan);
     popValueFromStack();
     if (LLVM_UNLIKELY(status == ExecutionStatus::EXCEPTION)) {
       return ExecutionStatus::EXCEPTION;
@@ -892,8 +1289,31 @@ CallResult<bool> JSONStringifyer::operationStr(HermesValue key) {
   return false;
 }
 
+void JSONStringifyer::appendNumber(double num) {
+  char buf[NUMBER_TO_STRING_BUF_SIZE];
+  char *end = buf + sizeof(buf);
+  char *p = end;
+  // Integers are the common case, and are written out directly.
+  if (num >= INT32_MIN && num <= INT32_MAX &&
+      num == static_cast<int32_t>(num)) {
+    int32_t n = static_cast<int32_t>(num);
+    uint32_t digits = n < 0 ? 0u - static_cast<uint32_t>(n) : n;
+    do {
+      *--p = '0' + digits % 10;
+      digits /= 10;
+    } while (digits);
+    if (n < 0) {
+      *--p = '-';
+    }
+  } else {
+    p = buf;
+    end = buf + numberToString(num, buf, sizeof(buf));
+  }
+  output_.append(p, end);
+}
+
 void JSONStringifyer::operationQuote(StringView value) {
-  quoteStringForJSON(output_, value);
+  output_.appendQuoted(value);
 }
 
 ExecutionStatus JSONStringifyer::operationJA() {
@@ -939,6 +1359,7 @@ ExecutionStatus JSONStringifyer::operationJA() {
       // operationStr returns undefined, we need to replace with null.
       appendToOutput(Predefined::getSymbolID(Predefined::null));
     }
+    maybeFlush();
   }
   depthCount_ = stepBack;
 
@@ -949,7 +1370,7 @@ ExecutionStatus JSONStringifyer::operationJA() {
   return ExecutionStatus::RETURNED;
 }
 
-ExecutionStatus JSONStringifyer::operationJO() {
+ExecutionStatus JSONStringifyer::operationJO(const ShapePlan *plan) {
   GCScopeMarkerRAII marker{runtime_};
 
   // JO.3.
@@ -964,119 +1385,298 @@ ExecutionStatus JSONStringifyer::operationJO() {
   auto beginningLoc = output_.size();
   indent();
 
-  if (propertyList_) {
-    // JO.5.
-    operationJOK_ = propertyList_.get();
+  // The toJSON lookup in Str.2 may have run a getter or a proxy trap that
+  // added or deleted properties since the plan was taken. Classes with plans
+  // are never dictionaries, so any such change also changed the class.
+  if (plan &&
+      vmcast<JSObject>(
+          stackValue_->at(stackValue_->size() - 1).getObject(runtime_))
+              ->getClass(runtime_) !=
+          planClasses_->at(plan->index).getObject()) {
+    plan = nullptr;
+  }
+
+  bool hasElement = false;
+  if (plan) {
+    auto planRes = operationJOWithPlan(*plan);
+    if (LLVM_UNLIKELY(planRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    hasElement = *planRes;
   } else {
-    // JO.6.
-    tmpHandle_ = HermesValue::encodeObjectValue(
-        stackValue_->at(stackValue_->size() - 1).getObject(runtime_));
-    if (LLVM_LIKELY(!Handle<JSObject>::vmcast(tmpHandle_)->isProxyObject())) {
-      // enumerableOwnProperties_RJS is the spec definition, and is
-      // used below on proxies so the correct traps get called.  In
-      // the common case of a non-proxy object, we can do less work by
-      // calling getOwnPropertyNames.
-      auto cr = JSObject::getOwnPropertyNames(
-          Handle<JSObject>::vmcast(tmpHandle_), runtime_, true);
-      if (cr == ExecutionStatus::EXCEPTION) {
+    if (propertyList_) {
+      // JO.5.
+      operationJOK_ = propertyList_.get();
+    } else {
+      // JO.6.
+      tmpHandle_ = HermesValue::encodeObjectValue(
+          stackValue_->at(stackValue_->size() - 1).getObject(runtime_));
+      if (LLVM_LIKELY(
+              !Handle<JSObject>::vmcast(tmpHandle_)->isProxyObject())) {
+        // enumerableOwnProperties_RJS is the spec definition, and is
+        // used below on proxies so the correct traps get called.  In
+        // the common case of a non-proxy object, we can do less work by
+        // calling getOwnPropertyNames.
+        auto cr = JSObject::getOwnPropertyNames(
+            Handle<JSObject>::vmcast(tmpHandle_), runtime_, true);
+        if (cr == ExecutionStatus::EXCEPTION) {
+          return ExecutionStatus::EXCEPTION;
+        }
+        operationJOK_ = **cr;
+      } else {
+        CallResult<HermesValue> ownPropRes = enumerableOwnProperties_RJS(
+            runtime_,
+            Handle<JSObject>::vmcast(tmpHandle_),
+            EnumerableOwnPropertiesKind::Key);
+        if (ownPropRes == ExecutionStatus::EXCEPTION) {
+          return ExecutionStatus::EXCEPTION;
+        }
+        operationJOK_ = vmcast<JSArray>(*ownPropRes);
+      }
+    }
+
+    marker.flush();
+
+    // JO.8.
+    for (uint32_t index = 0, len = operationJOK_->getEndIndex(); index < len;
+         ++index) {
+      // JO.8.a.
+      // We are speculating that the Str operation will not return undefined,
+      // and just append the key/value pair to the output. If it turns out
+      // that the Str operation does return undefined, we roll back to
+      // curLocation.
+      auto savedLocation = output_.size();
+
+      if (hasElement) {
+        // JO.10.
+        output_.push_back(u',');
+        indent();
+      }
+
+      tmpHandle_ = operationJOK_->at(runtime_, index);
+      if (LLVM_UNLIKELY(!tmpHandle_->isString())) {
+        // property may come from getOwnPropertyNames, which may contain
+        // numbers. getOwnPropertyNames and propertyList_ are both only
+        // populated with strings, numbers, and undefined only.
+        // None of them are objects, so toString cannot throw.
+        assert(!tmpHandle_->isObject() && "property name is an object");
+        auto status = toString_RJS(runtime_, tmpHandle_);
+        assert(
+            status != ExecutionStatus::EXCEPTION &&
+            "toString on a property cannot fail");
+        tmpHandle_ = status->getHermesValue();
+      }
+      // tmpHandle now contains property as string.
+      // JO.8.b.i
+      operationQuote(StringPrimitive::createStringView(
+          runtime_, Handle<StringPrimitive>::vmcast(tmpHandle_)));
+      // JO.8.b.ii
+      output_.push_back(u':');
+      // JO.8.b.iii
+      if (gap_.get()) {
+        output_.push_back(u' ');
+      }
+
+      // JO.9.a.
+      operationStrHolder_ = vmcast<JSObject>(
+          stackValue_->at(stackValue_->size() - 1).getObject(runtime_));
+
+      tmpHandle2_ = operationJOK_.getHermesValue();
+      if (PropStorage::push_back(stackJO_, runtime_, tmpHandle2_) ==
+          ExecutionStatus::EXCEPTION) {
         return ExecutionStatus::EXCEPTION;
       }
-      operationJOK_ = **cr;
-    } else {
-      CallResult<HermesValue> ownPropRes = enumerableOwnProperties_RJS(
-          runtime_,
-          Handle<JSObject>::vmcast(tmpHandle_),
-          EnumerableOwnPropertiesKind::Key);
-      if (ownPropRes == ExecutionStatus::EXCEPTION) {
+
+      // Flush just before recursion (propStoragePushBack may create handles).
+      marker.flush();
+      auto result = operationStr(*tmpHandle_);
+
+      operationJOK_ =
+          vmcast<JSArray>(stackJO_->pop_back(runtime_).getObject(runtime_));
+
+      if (LLVM_UNLIKELY(result == ExecutionStatus::EXCEPTION)) {
         return ExecutionStatus::EXCEPTION;
       }
-      operationJOK_ = vmcast<JSArray>(*ownPropRes);
+
+      if (LLVM_UNLIKELY(!result.getValue())) {
+        // Str returns undefined, we need to roll back.
+        output_.truncate(savedLocation);
+      } else {
+        hasElement = true;
+        maybeFlush();
+      }
     }
   }
+  // It's important to reset depthCount_ first, because the last
+  // indent before } should be the old indent.
+  depthCount_ = stepBack;
 
-  marker.flush();
+  if (hasElement) {
+    indent();
+  } else {
+    // If the object is empty, we need to roll back the first indent.
+    output_.truncate(beginningLoc);
+  }
+  output_.push_back(u'}');
+  return ExecutionStatus::RETURNED;
+}
+
+CallResult<bool> JSONStringifyer::operationJOWithPlan(const ShapePlan &plan) {
+  GCScopeMarkerRAII marker{runtime_};
 
-  // JO.8.
   bool hasElement = false;
-  for (uint32_t index = 0, len = operationJOK_->getEndIndex(); index < len;
-       ++index) {
+  size_t textBegin = 0;
+  for (const ShapePlan::Entry &entry : plan.entries) {
     // JO.8.a.
-    // We are speculating that the Str operation will not return undefined,
-    // and just append the key/value pair to the output. If it turns out
-    // that the Str operation does return undefined, we roll back to
-    // curLocation.
     auto savedLocation = output_.size();
-
     if (hasElement) {
       // JO.10.
       output_.push_back(u',');
       indent();
     }
-
-    tmpHandle_ = operationJOK_->at(runtime_, index);
-    if (LLVM_UNLIKELY(!tmpHandle_->isString())) {
-      // property may come from getOwnPropertyNames, which may contain numbers.
-      // getOwnPropertyNames and propertyList_ are both only populated
-      // with strings, numbers, and undefined only.
-      // None of them are objects, so toString cannot throw.
-      assert(!tmpHandle_->isObject() && "property name is an object");
-      auto status = toString_RJS(runtime_, tmpHandle_);
-      assert(
-          status != ExecutionStatus::EXCEPTION &&
-          "toString on a property cannot fail");
-      tmpHandle_ = status->getHermesValue();
-    }
-    // tmpHandle now contains property as string.
-    // JO.8.b.i
-    operationQuote(StringPrimitive::createStringView(
-        runtime_, Handle<StringPrimitive>::vmcast(tmpHandle_)));
-    // JO.8.b.ii
-    output_.push_back(u':');
-    // JO.8.b.iii
-    if (gap_.get()) {
-      output_.push_back(u' ');
-    }
-
-    // JO.9.a.
-    operationStrHolder_ = vmcast<JSObject>(
+    // JO.8.b: the quoted key and separator.
+    output_.append(plan.keyText, textBegin, entry.textEnd);
+    textBegin = entry.textEnd;
+
+    // JO.9.a. Materializing a lazy identifier can allocate, so the holder is
+    // only read from the stack once the key is in place.
+    tmpHandle_ = HermesValue::encodeStringValue(
+        runtime_->getStringPrimFromSymbolID(entry.name));
+    JSObject *holder = vmcast<JSObject>(
         stackValue_->at(stackValue_->size() - 1).getObject(runtime_));
-
-    tmpHandle2_ = operationJOK_.getHermesValue();
-    if (PropStorage::push_back(stackJO_, runtime_, tmpHandle2_) ==
-        ExecutionStatus::EXCEPTION) {
-      return ExecutionStatus::EXCEPTION;
+    operationStrHolder_ = holder;
+    CallResult<bool> result{false};
+    if (LLVM_LIKELY(
+            holder->getClass(runtime_) ==
+            planClasses_->at(plan.index).getObject())) {
+      // The property is still a data property in the same slot.
+      operationStrValue_ =
+          JSObject::getNamedSlotValueUnsafe(holder, runtime_, entry.slot)
+              .unboxToHV(runtime_);
+      result = serializeValue();
+    } else {
+      // A toJSON method has changed the object since the keys were taken,
+      // so the property has to be looked up.
+      result = operationStr(*tmpHandle_);
     }
-
-    // Flush just before recursion (propStoragePushBack may create handles).
-    marker.flush();
-    auto result = operationStr(*tmpHandle_);
-
-    operationJOK_ =
-        vmcast<JSArray>(stackJO_->pop_back(runtime_).getObject(runtime_));
-
     if (LLVM_UNLIKELY(result == ExecutionStatus::EXCEPTION)) {
       return ExecutionStatus::EXCEPTION;
     }
-
-    if (LLVM_UNLIKELY(!result.getValue())) {
+    if (LLVM_UNLIKELY(!*result)) {
       // Str returns undefined, we need to roll back.
-      output_.resize(savedLocation);
+      output_.truncate(savedLocation);
     } else {
       hasElement = true;
+      maybeFlush();
     }
+    marker.flush();
   }
-  // It's important to reset depthCount_ first, because the last
-  // indent before } should be the old indent.
-  depthCount_ = stepBack;
+  return hasElement;
+}
 
-  if (hasElement) {
-    indent();
-  } else {
-    // If the object is empty, we need to roll back the first indent.
-    output_.resize(beginningLoc);
+ShapePlan *JSONStringifyer::getShapePlan(Handle<JSObject> obj) {
+  // Replacers can change both the keys and the values, and only ordinary
+  // objects keep all their properties in their class.
+  if (replacerFunction_ || propertyList_ ||
+      obj->getKind() != CellKind::ObjectKind) {
+    return nullptr;
   }
-  output_.push_back(u'}');
-  return ExecutionStatus::RETURNED;
+  assert(
+      !obj->isProxyObject() && !obj->isHostObject() &&
+      "plain objects cannot be proxies or host objects");
+  HiddenClass *clazz = obj->getClass(runtime_);
+  const uint32_t numPlans = planClasses_->size();
+  uint32_t index = lastPlan_;
+  if (index >= numPlans || planClasses_->at(index).getObject() != clazz) {
+    index = 0;
+    while (index < numPlans && planClasses_->at(index).getObject() != clazz) {
+      ++index;
+    }
+  }
+  if (index == numPlans) {
+    if (numPlans == kMaxShapePlans) {
+      return nullptr;
+    }
+    auto clazzHandle = runtime_->makeHandle(clazz);
+    auto plan = createShapePlan(clazzHandle);
+    auto status = ArrayStorage::push_back(planClasses_, runtime_, clazzHandle);
+    assert(
+        status != ExecutionStatus::EXCEPTION &&
+        "planClasses_ has room for every plan");
+    (void)status;
+    plan->index = index;
+    shapePlans_.push_back(std::move(plan));
+  }
+  lastPlan_ = index;
+  ShapePlan *plan = shapePlans_[index].get();
+  return plan->eligible ? plan : nullptr;
+}
+
+std::unique_ptr<ShapePlan> JSONStringifyer::createShapePlan(
+    Handle<HiddenClass> clazz) {
+  auto plan = std::make_unique<ShapePlan>();
+  // The keys of dictionaries can change without a change of class, and
+  // index-like keys are enumerated before the others.
+  if (clazz->isDictionary() || clazz->getHasIndexLikeProperties()) {
+    plan->eligible = false;
+    return plan;
+  }
+  ShapePlan &p = *plan;
+  const SymbolID toJSON = Predefined::getSymbolID(Predefined::toJSON);
+  const bool hasGap = gap_.get();
+  HiddenClass::forEachProperty(
+      clazz,
+      runtime_,
+      [this, &p, toJSON, hasGap](SymbolID id, NamedPropertyDescriptor desc) {
+        if (id == toJSON) {
+          p.hasToJSON = true;
+        }
+        if (!isPropertyNamePrimitive(id) || !desc.flags.enumerable) {
+          return;
+        }
+        // Getters are run by Get(), in the generic path.
+        if (desc.flags.accessor) {
+          p.eligible = false;
+          return;
+        }
+        p.keyText.appendQuoted(
+            runtime_->getIdentifierTable().getStringView(runtime_, id));
+        p.keyText.push_back(u':');
+        if (hasGap) {
+          p.keyText.push_back(u' ');
+        }
+        p.entries.push_back({p.keyText.size(), desc.slot, id});
+      });
+  return plan;
+}
+
+bool JSONStringifyer::lacksToJSON(JSObject *obj, const ShapePlan &plan) {
+  if (plan.hasToJSON) {
+    return false;
+  }
+  JSObject *parent = obj->getParent(runtime_);
+  if (!parent) {
+    return true;
+  }
+  JSObject *proto = runtime_->objectPrototypeRawPtr;
+  if (parent != proto || proto->getParent(runtime_)) {
+    return false;
+  }
+  HiddenClass *protoClass = proto->getClass(runtime_);
+  if (protoClass == protoClassWithoutToJSON_.get()) {
+    return true;
+  }
+  if (HiddenClass::findPropertyNoAlloc(
+          protoClass,
+          runtime_,
+          Predefined::getSymbolID(Predefined::toJSON))) {
+    return false;
+  }
+  // A dictionary can gain a property without changing class.
+  if (!protoClass->isDictionary()) {
+    protoClassWithoutToJSON_ = protoClass;
+  }
+  return true;
 }
 
 void JSONStringifyer::indent() {
@@ -1115,13 +1715,18 @@ void JSONStringifyer::appendToOutput(SymbolID identifierID) {
 }
 
 void JSONStringifyer::appendToOutput(const StringPrimitive *str) {
-  str->appendUTF16String(output_);
+  if (str->isASCII()) {
+    ASCIIRef ref = str->getStringRef<char>();
+    output_.append(ref.begin(), ref.end());
+  } else {
+    UTF16Ref ref = str->getStringRef<char16_t>();
+    output_.append(ref.begin(), ref.end());
+  }
 }
 
-CallResult<HermesValue> JSONStringifyer::stringify(Handle<> value) {
+CallResult<bool> JSONStringifyer::serializeRoot(Handle<> value) {
   // All previous steps have been covered by the constructor.
-  // Clear the output buffer.
-  output_.clear();
+  assert(output_.size() == 0 && "stringify can only be called once");
 
   // Step 9, 10 in ES5.1 15.12.3.
   operationStrHolder_ = JSObject::create(runtime_).get();
@@ -1137,18 +1742,36 @@ CallResult<HermesValue> JSONStringifyer::stringify(Handle<> value) {
   (void)status;
 
   // Step 11 in ES5.1 15.12.3.
-  status = operationStr(HermesValue::encodeStringValue(
+  return operationStr(HermesValue::encodeStringValue(
       runtime_->getPredefinedString(Predefined::emptyString)));
+}
+
+CallResult<HermesValue> JSONStringifyer::stringify(Handle<> value) {
+  auto status = serializeRoot(value);
   if (LLVM_UNLIKELY(status == ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
   if (status.getValue()) {
-    return StringPrimitive::create(runtime_, output_);
+    return output_.toString(runtime_);
   } else {
     return HermesValue::encodeUndefinedValue();
   }
 }
 
+CallResult<bool> JSONStringifyer::stringifyToSink(
+    Handle<> value,
+    const JSONStringifySink &sink) {
+  sink_ = &sink;
+  auto status = serializeRoot(value);
+  if (LLVM_UNLIKELY(status == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  if (status.getValue()) {
+    output_.flushTo(sink);
+  }
+  return status;
+}
+
 CallResult<HermesValue> runtimeJSONStringify(
     Runtime *runtime,
     Handle<> value,
@@ -1163,5 +1786,20 @@ CallResult<HermesValue> runtimeJSONStringify(
   return stringifyer.stringify(value);
 }
 
+CallResult<bool> runtimeJSONStringifyToSink(
+    Runtime *runtime,
+    Handle<> value,
+    Handle<> replacer,
+    Handle<> space,
+    const JSONStringifySink &sink) {
+  GCScope gcScope{runtime, "runtimeJSONStringifyToSink"};
+
+  JSONStringifyer stringifyer{runtime};
+  if (stringifyer.init(replacer, space) == ExecutionStatus::EXCEPTION) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  return stringifyer.stringifyToSink(value, sink);
+}
+
 } // namespace vm
 } // namespace hermes
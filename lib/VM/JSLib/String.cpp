@@ -12,6 +12,8 @@
 #include "JSLibInternal.h"
 
 #include "hermes/Platform/Unicode/PlatformUnicode.h"
+#include "hermes/Support/ASCIIScan.h"
+#include "hermes/Support/StringSearch.h"
 #include "hermes/VM/JSLib/RuntimeCommonStorage.h"
 #include "hermes/VM/Operations.h"
 #include "hermes/VM/PrimitiveBox.h"
@@ -776,75 +778,43 @@ static CallResult<HermesValue> convertCase(
     Handle<StringPrimitive> S,
     const bool upperCase,
     const bool useCurrentLocale) {
+  // The ASCII letters whose case changes.
+  const char lo = upperCase ? 'a' : 'A';
+  const char hi = upperCase ? 'z' : 'Z';
+
+  if (!useCurrentLocale && S->isASCII()) {
+    // Fast path for ASCII strings, which can be checked in place.
+    ASCIIRef str = S->getStringRef<char>();
+    const char *first = asciiscan::findInRange(str.begin(), str.end(), lo, hi);
+    if (first == str.end()) {
+      // We don't have to allocate anything.
+      return S.getHermesValue();
+    }
+    // Copy before allocating, which may move S.
+    llvh::SmallVector<char, 32> buff{str.begin(), first};
+    buff.resize(str.size());
+    asciiscan::flipCaseInRange(
+        first, str.end(), buff.data() + (first - str.begin()), lo, hi);
+    return StringPrimitive::createEfficient(
+        runtime, ASCIIRef(buff.data(), buff.size()));
+  }
+
   // Copying is unavoidable in this function, do it early on.
   SmallU16String<32> buff;
   // Must copy instead of just getting the reference, because later operations
   // may trigger GC and hence invalid pointers inside S.
   S->appendUTF16String(buff);
-  UTF16Ref str = buff.arrayRef();
-
-  if (!useCurrentLocale) {
-    // Try a fast path for ASCII strings.
-    // First, bitwise-or all the characters to see if any one isn't ASCII.
-    char16_t mask = 0;
-    // Also, check if we have to do work or we can just return S directly.
-    bool noop = true;
-    if (upperCase) {
-      for (const auto c : str) {
-        mask |= c;
-        // It's still a noop if the character isn't a lowercase ASCII.
-        noop &= !('a' <= c && c <= 'z');
-      }
-    } else {
-      for (const auto c : str) {
-        mask |= c;
-        // It's still a noop if the character isn't an uppercase ASCII.
-        noop &= !('A' <= c && c <= 'Z');
-      }
-    }
-    if (mask <= 127) {
-      if (noop) {
-        // We don't have to allocate anything.
-        return S.getHermesValue();
-      }
-
-      if (str.size() == 1) {
-        // Use the Runtime stored representations of single-character strings.
-        char16_t c = str[0];
-        if (upperCase) {
-          char16_t isLower = 'a' <= c && c <= 'z';
-          return runtime->getCharacterString(c & ~(isLower << 5))
-              .getHermesValue();
-        } else {
-          char16_t isUpper = 'A' <= c && c <= 'Z';
-          return runtime->getCharacterString(c | (isUpper << 5))
-              .getHermesValue();
-        }
-      }
 
-      SafeUInt32 len(S->getStringLength());
-      auto builder = StringBuilder::createStringBuilder(runtime, len);
-      if (builder == ExecutionStatus::EXCEPTION) {
-        return ExecutionStatus::EXCEPTION;
-      }
-      char16_t ch;
-      if (upperCase) {
-        for (const char16_t c : str) {
-          // If it is lower, then clear the 5th bit, else do nothing.
-          char16_t isLower = 'a' <= c && c <= 'z';
-          ch = c & ~(isLower << 5);
-          builder->appendCharacter(ch);
-        }
-      } else {
-        for (const char16_t c : str) {
-          // If it is upper, then set the 5th bit, else do nothing.
-          char16_t isUpper = 'A' <= c && c <= 'Z';
-          ch = c | (isUpper << 5);
-          builder->appendCharacter(ch);
-        }
-      }
-      return HermesValue::encodeStringValue(*builder->getStringPrimitive());
+  if (!useCurrentLocale && isAllASCII(buff.begin(), buff.end())) {
+    // A UTF-16 string made of ASCII characters, which can be converted in
+    // place.
+    char16_t *first = const_cast<char16_t *>(
+        asciiscan::findInRange<char16_t>(buff.begin(), buff.end(), lo, hi));
+    if (first == buff.end()) {
+      return S.getHermesValue();
     }
+    asciiscan::flipCaseInRange<char16_t>(first, buff.end(), first, lo, hi);
+    return StringPrimitive::createEfficient(runtime, buff.arrayRef());
   }
   platform_unicode::convertToCase(
       buff,
@@ -969,30 +939,45 @@ stringPrototypeSubstr(void *, Runtime *runtime, NativeArgs args) {
   }
 }
 
-/// \return the number of characters to trim from the begin iterator.
-static size_t trimStart(
-    StringView::const_iterator begin,
-    StringView::const_iterator end) {
-  size_t toTrim = 0;
-  while (begin != end &&
-         (isWhiteSpaceChar(*begin) || isLineTerminatorChar(*begin))) {
-    ++begin;
-    ++toTrim;
-  }
-  return toTrim;
+/// \return true if \p c is a white space or a line terminator.
+static bool isTrimmedChar(char16_t c) {
+  return isWhiteSpaceChar(c) || isLineTerminatorChar(c);
+}
+
+/// \return the number of characters to trim from the start of \p str.
+static size_t trimStart(const StringView &str) {
+  auto trim = [](const auto *begin, const auto *end) -> size_t {
+    // Skip the ASCII ones in bulk, and the others one by one.
+    const auto *p = begin;
+    while ((p = asciiscan::skipASCIISpace(p, end)) != end &&
+           isTrimmedChar(*p)) {
+      ++p;
+    }
+    return p - begin;
+  };
+  if (str.isASCII()) {
+    return trim(str.castToCharPtr(), str.castToCharPtr() + str.length());
+  }
+  return trim(str.castToChar16Ptr(), str.castToChar16Ptr() + str.length());
 }
 
-/// \return the number of characters to trim from the end iterator.
-static size_t trimEnd(
-    StringView::const_iterator begin,
-    StringView::const_iterator end) {
-  size_t toTrim = 0;
-  while (begin != end &&
-         (isWhiteSpaceChar(*(end - 1)) || isLineTerminatorChar(*(end - 1)))) {
-    --end;
-    ++toTrim;
-  }
-  return toTrim;
+/// \return the number of characters to trim from the end of \p str, after
+/// the first \p start characters.
+static size_t trimEnd(const StringView &str, size_t start = 0) {
+  auto trim = [](const auto *begin, const auto *end) -> size_t {
+    const auto *p = end;
+    while ((p = asciiscan::skipASCIISpaceBackward(begin, p)) != begin &&
+           isTrimmedChar(p[-1])) {
+      --p;
+    }
+    return end - p;
+  };
+  if (str.isASCII()) {
+    const char *chars = str.castToCharPtr();
+    return trim(chars + start, chars + str.length());
+  }
+  const char16_t *chars = str.castToChar16Ptr();
+  return trim(chars + start, chars + str.length());
 }
 
 CallResult<HermesValue>
@@ -1012,11 +997,8 @@ stringPrototypeTrim(void *, Runtime *runtime, NativeArgs args) {
   size_t beginIdx = 0, endIdx = S->getStringLength();
   {
     auto str = StringPrimitive::createStringView(runtime, S);
-    auto begin = str.begin();
-    auto end = str.end();
-    beginIdx = trimStart(begin, end);
-    begin += beginIdx;
-    endIdx -= trimEnd(begin, end);
+    beginIdx = trimStart(str);
+    endIdx -= trimEnd(str, beginIdx);
   }
 
   return StringPrimitive::slice(runtime, S, beginIdx, endIdx - beginIdx);
@@ -1039,9 +1021,7 @@ stringPrototypeTrimStart(void *, Runtime *runtime, NativeArgs args) {
   size_t beginIdx = 0;
   {
     auto str = StringPrimitive::createStringView(runtime, S);
-    auto begin = str.begin();
-    auto end = str.end();
-    beginIdx = trimStart(begin, end);
+    beginIdx = trimStart(str);
   }
 
   return StringPrimitive::slice(
@@ -1065,9 +1045,7 @@ stringPrototypeTrimEnd(void *, Runtime *runtime, NativeArgs args) {
   size_t endIdx = S->getStringLength();
   {
     auto str = StringPrimitive::createStringView(runtime, S);
-    auto begin = str.begin();
-    auto end = str.end();
-    endIdx -= trimEnd(begin, end);
+    endIdx -= trimEnd(str);
   }
 
   return StringPrimitive::slice(runtime, S, 0, endIdx);
@@ -1351,6 +1329,48 @@ stringPrototypeMatchAll(void *, Runtime *runtime, NativeArgs args) {
       .toCallResultHermesValue();
 }
 
+/// Find \p needle in \p hay with the search kernels of StringSearch.h.
+/// \param start  the search finds the first match that starts at or after
+///   \p start or, if \p reverse, the last match that starts at or before it.
+///   Requires: start <= hay.length().
+/// \return the index of the match, or None if there is none.
+static OptValue<uint32_t> searchStringView(
+    const StringView &hay,
+    const StringView &needle,
+    uint32_t start,
+    bool reverse) {
+  assert(start <= hay.length() && "search starts past the end");
+  const size_t begin = reverse ? 0 : start;
+  const size_t end = reverse
+      ? std::min(hay.length(), (size_t)start + needle.length())
+      : hay.length();
+  auto find = [&](const auto *h, const auto *n) -> OptValue<uint32_t> {
+    auto *found = reverse
+        ? stringsearch::findLast(h + begin, h + end, n, needle.length())
+        : stringsearch::findFirst(h + begin, h + end, n, needle.length());
+    if (!found)
+      return llvh::None;
+    return static_cast<uint32_t>(found - h);
+  };
+
+  if (hay.isASCII()) {
+    if (needle.isASCII())
+      return find(hay.castToCharPtr(), needle.castToCharPtr());
+    // A UTF-16 needle can only occur in an ASCII string if it is all ASCII.
+    llvh::SmallVector<char, 32> narrow;
+    for (char16_t c : needle) {
+      if (c > 0x7f)
+        return llvh::None;
+      narrow.push_back(c);
+    }
+    return find(hay.castToCharPtr(), narrow.data());
+  }
+  if (!needle.isASCII())
+    return find(hay.castToChar16Ptr(), needle.castToChar16Ptr());
+  llvh::SmallVector<char16_t, 32> wide{needle.begin(), needle.end()};
+  return find(hay.castToChar16Ptr(), wide.data());
+}
+
 /// This provides a shared implementation of three operations in ES2021:
 /// 6.1.4.1 Runtime Semantics: StringIndexOf ( string, searchValue, fromIndex )
 ///   when clampPostion=false,
@@ -1451,35 +1471,10 @@ static CallResult<HermesValue> stringDirectedIndexOf(
   // Let start be min(max(pos, 0), len).
   uint32_t start = static_cast<uint32_t>(std::min(std::max(pos, 0.), len));
 
-  // TODO: good candidate for Boyer-Moore on large needles/haystacks
-  // TODO: good candidate for memchr on length-1 needles
   auto SView = StringPrimitive::createStringView(runtime, S);
   auto searchStrView = StringPrimitive::createStringView(runtime, searchStr);
-  double ret = -1;
-  if (reverse) {
-    // lastIndexOf
-    uint32_t lastPossibleMatchEnd =
-        std::min(SView.length(), start + searchStrView.length());
-    auto foundIter = std::search(
-        SView.rbegin() + (SView.length() - lastPossibleMatchEnd),
-        SView.rend(),
-        searchStrView.rbegin(),
-        searchStrView.rend());
-    if (foundIter != SView.rend() || searchStrView.empty()) {
-      ret = SView.rend() - foundIter - searchStrView.length();
-    }
-  } else {
-    // indexOf
-    auto foundIter = std::search(
-        SView.begin() + start,
-        SView.end(),
-        searchStrView.begin(),
-        searchStrView.end());
-    if (foundIter != SView.end() || searchStrView.empty()) {
-      ret = foundIter - SView.begin();
-    }
-  }
-  return HermesValue::encodeDoubleValue(ret);
+  auto found = searchStringView(SView, searchStrView, start, reverse);
+  return HermesValue::encodeDoubleValue(found ? *found : -1.0);
 }
 
 /// ES12 6.1.4.1 Runtime Semantics: StringIndexOf ( string, searchValue,
@@ -1956,11 +1951,9 @@ stringPrototypeReplace(void *, Runtime *runtime, NativeArgs args) {
   auto strView = StringPrimitive::createStringView(runtime, string);
   if (!strView.empty()) {
     auto searchView = StringPrimitive::createStringView(runtime, searchString);
-    auto searchResult = std::search(
-        strView.begin(), strView.end(), searchView.begin(), searchView.end());
-
-    if (searchResult != strView.end()) {
-      pos = searchResult - strView.begin();
+    auto searchResult = searchStringView(strView, searchView, 0, false);
+    if (searchResult) {
+      pos = *searchResult;
     } else {
       return string.getHermesValue();
     }
@@ -2257,12 +2250,9 @@ static OptValue<uint32_t> splitMatch(
   auto SStr = StringPrimitive::createStringView(runtime, S);
   auto RStr = StringPrimitive::createStringView(runtime, R);
 
-  auto sliced = SStr.slice(q);
-  auto searchResult =
-      std::search(sliced.begin(), sliced.end(), RStr.begin(), RStr.end());
-
-  if (searchResult != sliced.end()) {
-    return q + (searchResult - sliced.begin()) + r;
+  auto searchResult = searchStringView(SStr, RStr, q, false);
+  if (searchResult) {
+    return *searchResult + r;
   }
   return llvh::None;
 }
@@ -2568,15 +2558,10 @@ CallResult<HermesValue> stringPrototypeIncludesOrStartsWith(
   // k, return false.
   auto SView = StringPrimitive::createStringView(runtime, S);
   auto searchStrView = StringPrimitive::createStringView(runtime, searchStr);
-  auto foundIter = std::search(
-      SView.begin() + start,
-      SView.end(),
-      searchStrView.begin(),
-      searchStrView.end());
-  // Note: searchStrView.empty check is needed in the special case that S is
-  // empty, searchStr is empty, and start = 0
   return HermesValue::encodeBoolValue(
-      foundIter != SView.end() || searchStrView.empty());
+      searchStringView(
+          SView, searchStrView, static_cast<uint32_t>(start), false)
+          .hasValue());
 }
 
 CallResult<HermesValue>
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMESVM_LEAN
+
+#include "hermes/VM/LazyCompileQueue.h"
+
+#include "hermes/BCGen/HBC/HBC.h"
+
+#include <algorithm>
+
+namespace hermes {
+namespace vm {
+
+std::unique_ptr<hbc::BytecodeModule> compileLazyFunction(
+    hbc::LazyCompilationData *lazyData) {
+  assert(lazyData);
+  Module M{lazyData->context};
+  auto pair = hermes::generateLazyFunctionIR(lazyData, &M);
+  Function *entryPoint = pair.first;
+  Function *lexicalRoot = pair.second;
+
+  // We look up source map URLs by iterating modules and finding the first one
+  // with a matching buffer id, which will be the root module. These lazily
+  // compiled compiled modules therefore don't need to duplicate the URL,
+  // which can be several MB if it encodes the source map itself.
+  BytecodeGenerationOptions opts = BytecodeGenerationOptions::defaults();
+  opts.stripSourceMappingURL = true;
+
+  auto bytecodeModule =
+      hbc::generateBytecodeModule(&M, lexicalRoot, entryPoint, opts);
+
+  return bytecodeModule;
+}
+
+std::unique_ptr<LazyCompileQueue> LazyCompileQueue::create() {
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+  return nullptr;
+#else
+  std::unique_ptr<LazyCompileQueue> queue{new LazyCompileQueue()};
+  queue->worker_ = std::thread(&LazyCompileQueue::workerLoop, queue.get());
+  return queue;
+#endif
+}
+
+LazyCompileQueue::~LazyCompileQueue() {
+  {
+    std::lock_guard<std::mutex> lk{mutex_};
+    shouldExit_ = true;
+  }
+  cond_.notify_all();
+  if (worker_.joinable()) {
+    worker_.join();
+  }
+}
+
+void LazyCompileQueue::enqueue(const hbc::LazyCompilationData &lazyData) {
+  Key key = getKey(lazyData);
+  {
+    std::lock_guard<std::mutex> lk{mutex_};
+    if (pending_.size() >= kMaxPending || (compiling_ && *compiling_ == key) ||
+        ready_.count(key)) {
+      return;
+    }
+    for (const auto &pending : pending_) {
+      if (getKey(pending) == key) {
+        return;
+      }
+    }
+    pending_.push_back(lazyData);
+  }
+  // The JS thread may be waiting on the same condition, so wake everyone to
+  // be sure the worker is among them.
+  cond_.notify_all();
+}
+
+std::unique_ptr<hbc::BytecodeModule> LazyCompileQueue::getOrCompile(
+    hbc::LazyCompilationData *lazyData) {
+  Key key = getKey(*lazyData);
+  {
+    std::unique_lock<std::mutex> lk{mutex_};
+    // If the worker is compiling this very function, it will be done sooner
+    // than if we started over.
+    cond_.wait(lk, [this, &key] { return !compiling_ || *compiling_ != key; });
+
+    auto it = ready_.find(key);
+    if (it != ready_.end()) {
+      std::unique_ptr<hbc::BytecodeModule> bcModule =
+          std::move(it->second.second);
+      ready_.erase(it);
+      readyOrder_.erase(std::find(readyOrder_.begin(), readyOrder_.end(), key));
+      ++numHits_;
+      return bcModule;
+    }
+
+    // Not reached yet, so the worker mustn't compile it a second time.
+    auto pendingIt =
+        std::find_if(pending_.begin(), pending_.end(), [&key](const auto &p) {
+          return getKey(p) == key;
+        });
+    if (pendingIt != pending_.end()) {
+      pending_.erase(pendingIt);
+    }
+  }
+
+  std::lock_guard<std::mutex> compileLock{compileMutex_};
+  return compileLazyFunction(lazyData);
+}
+
+void LazyCompileQueue::workerLoop() {
+  std::unique_lock<std::mutex> lk{mutex_};
+  while (true) {
+    cond_.wait(lk, [this] { return shouldExit_ || !pending_.empty(); });
+    if (shouldExit_) {
+      return;
+    }
+
+    hbc::LazyCompilationData lazyData = std::move(pending_.front());
+    pending_.pop_front();
+    Key key = getKey(lazyData);
+    compiling_ = key;
+    lk.unlock();
+
+    std::unique_ptr<hbc::BytecodeModule> bcModule;
+    {
+      std::lock_guard<std::mutex> compileLock{compileMutex_};
+      bcModule = compileLazyFunction(&lazyData);
+    }
+
+    lk.lock();
+    compiling_ = llvh::None;
+    if (ready_.size() >= kMaxReady) {
+      ready_.erase(readyOrder_.front());
+      readyOrder_.pop_front();
+    }
+    // Keep the Context alive along with the result, so that its address
+    // can't be reused by another Context while the key is in the map.
+    ready_[key] = {std::move(lazyData.context), std::move(bcModule)};
+    readyOrder_.push_back(key);
+    cond_.notify_all();
+  }
+}
+
+} // namespace vm
+} // namespace hermes
+
+#endif // HERMESVM_LEAN
@@ -43,7 +43,10 @@ void CodeCoverageProfiler::markExecutedSlowPath(CodeBlock *codeBlock) {
   assert(
       funcId < moduleFuncMap.size() &&
       "funcId is out of bound for moduleFuncMap.");
-  moduleFuncMap[funcId] = true;
+  if (!moduleFuncMap[funcId]) {
+    moduleFuncMap[funcId] = true;
+    executedFuncOrderMap_[codeBlock->getRuntimeModule()].push_back(funcId);
+  }
 }
 
 /* static */ std::
@@ -100,6 +103,16 @@ CodeCoverageProfiler::getExecutedFunctionsLocal() {
   return funcInfos;
 }
 
+std::vector<uint32_t> CodeCoverageProfiler::getExecutedFunctionIDsInOrder(
+    RuntimeModule *module) {
+  std::lock_guard<std::mutex> lk(localMutex_);
+  auto it = executedFuncOrderMap_.find(module);
+  if (it == executedFuncOrderMap_.end()) {
+    return {};
+  }
+  return it->second;
+}
+
 std::vector<bool> &CodeCoverageProfiler::getModuleFuncMapRef(
     RuntimeModule *module) {
   auto funcMapIter = executedFuncBitsArrayMap_.find(module);
@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/VM/Profiler/HeapSamplingProfiler.h"
+
+#include "hermes/Support/JSONEmitter.h"
+#include "hermes/VM/Callable.h"
+#include "hermes/VM/Runtime.h"
+#include "hermes/VM/StackFrame-inline.h"
+
+#include "llvh/ADT/SmallVector.h"
+
+#include <algorithm>
+
+namespace hermes {
+namespace vm {
+
+constexpr size_t HeapSamplingProfiler::kDefaultMaxStackDepth;
+constexpr size_t HeapSamplingProfiler::kDefaultMaxLiveSamples;
+constexpr size_t HeapSamplingProfiler::kDefaultMaxStackNodes;
+
+HeapSamplingProfiler::HeapSamplingProfiler(
+    Runtime *runtime,
+    size_t samplingInterval,
+    size_t maxStackDepth,
+    size_t maxLiveSamples,
+    size_t maxStackNodes,
+    int64_t seed)
+    : runtime_(runtime),
+      maxStackDepth_(maxStackDepth),
+      maxLiveSamples_(maxLiveSamples),
+      // The root always exists.
+      maxStackNodes_(std::max<size_t>(maxStackNodes, 1)),
+      randomEngine_(
+          seed < 0 ? std::random_device()()
+                   : static_cast<std::minstd_rand::result_type>(seed)),
+      dist_(1.0 / std::max<size_t>(samplingInterval, 1)) {
+  rootFunctionID_ = strings_.insert("(root)");
+  anonymousFunctionID_ = strings_.insert("(anonymous)");
+  // The root doesn't correspond to any frame; give it an empty location.
+  const auto emptyID = strings_.insert("");
+  frames_.push_back(Frame{rootFunctionID_, emptyID, 0, 0, 0});
+  stackNodes_.push_back(StackNode{0, 0});
+  bytesUntilSample_ = nextSampleDistance();
+}
+
+size_t HeapSamplingProfiler::sample(const GCCell *ptr, uint32_t sz) {
+  if (samples_.size() >= maxLiveSamples_) {
+    ++numDroppedSamples_;
+    return nextSampleDistance();
+  }
+  const uint32_t stack = captureStack();
+  samples_.push_back(Sample{
+      WeakRoot<GCCell>{const_cast<GCCell *>(ptr), runtime_},
+      sz,
+      stack,
+      nextOrdinal_++});
+  return nextSampleDistance();
+}
+
+void HeapSamplingProfiler::markWeakRoots(WeakRootAcceptor &acceptor) {
+  size_t numLive = 0;
+  for (Sample &sample : samples_) {
+    if (!sample.cell) {
+      continue;
+    }
+    // The acceptor clears the roots of objects that were freed.
+    acceptor.acceptWeak(sample.cell);
+    if (sample.cell) {
+      ++numLive;
+    }
+  }
+  if (numLive == samples_.size()) {
+    return;
+  }
+  // Drop the samples whose objects were freed, keeping the rest in order.
+  std::vector<Sample> live;
+  live.reserve(numLive);
+  for (const Sample &sample : samples_) {
+    if (sample.cell) {
+      live.push_back(sample);
+    }
+  }
+  samples_.swap(live);
+}
+
+size_t HeapSamplingProfiler::numLiveSamples() const {
+  return samples_.size();
+}
+
+size_t HeapSamplingProfiler::numDroppedSamples() const {
+  return numDroppedSamples_;
+}
+
+size_t HeapSamplingProfiler::nextSampleDistance() {
+  // Always allocate at least one byte between samples, so that a single
+  // allocation can't be sampled twice.
+  return std::max<size_t>(dist_(randomEngine_), 1);
+}
+
+uint32_t HeapSamplingProfiler::captureStack() {
+  // Collect the innermost maxStackDepth_ JS frames, innermost first.
+  llvh::SmallVector<std::pair<const CodeBlock *, uint32_t>, 32> frames;
+  const inst::Inst *ip = runtime_->getCurrentIP();
+  for (ConstStackFramePtr frame : runtime_->getStackFrames()) {
+    if (frames.size() >= maxStackDepth_) {
+      break;
+    }
+    if (const CodeBlock *codeBlock = frame.getCalleeCodeBlock()) {
+      // The IP may not belong to this frame if it was called from native
+      // code, or if it hasn't been saved yet.
+      const uint32_t offset =
+          ip && codeBlock->contains(ip) ? codeBlock->getOffsetOf(ip) : 0;
+      frames.emplace_back(codeBlock, offset);
+    }
+    ip = frame.getSavedIP();
+  }
+
+  // Insert the stack into the tree, outermost frame first. If the tree is
+  // full, attribute the sample to the longest prefix already in it.
+  uint32_t node = 0;
+  for (auto it = frames.rbegin(), e = frames.rend(); it != e; ++it) {
+    OptValue<uint32_t> frameID = internFrame(it->first, it->second);
+    if (!frameID) {
+      break;
+    }
+    auto childIt = stackChildren_.find({node, *frameID});
+    if (childIt != stackChildren_.end()) {
+      node = childIt->second;
+      continue;
+    }
+    if (stackNodes_.size() >= maxStackNodes_) {
+      break;
+    }
+    const uint32_t child = stackNodes_.size();
+    stackNodes_.push_back(StackNode{node, *frameID});
+    stackChildren_[{node, *frameID}] = child;
+    node = child;
+  }
+  return node;
+}
+
+OptValue<uint32_t> HeapSamplingProfiler::internFrame(
+    const CodeBlock *codeBlock,
+    uint32_t offset) {
+  auto it = frameIDs_.find({codeBlock, offset});
+  if (it != frameIDs_.end()) {
+    return it->second;
+  }
+  // A new frame can only be used by a new stack node, so bound the frame
+  // table by the same limit.
+  if (frames_.size() >= maxStackNodes_) {
+    return llvh::None;
+  }
+
+  // Symbolize the frame the same way the StackTracesTree does.
+  RuntimeModule *runtimeModule = codeBlock->getRuntimeModule();
+  std::string scriptName;
+  int32_t lineNo, columnNo;
+  if (auto location = codeBlock->getSourceLocation(offset)) {
+    scriptName = runtimeModule->getBytecode()->getDebugInfo()->getFilenameByID(
+        location->filenameId);
+    lineNo = location->line;
+    columnNo = location->column;
+  } else {
+    auto sourceURL = runtimeModule->getSourceURL();
+    scriptName = sourceURL.empty() ? "unknown" : sourceURL;
+    lineNo = runtimeModule->getBytecode()->getSegmentID() + 1;
+    columnNo = codeBlock->getVirtualOffset() + offset + 1;
+  }
+  auto nameStr = codeBlock->getNameString(runtime_->getHeap().getCallbacks());
+  auto nameID =
+      nameStr.empty() ? anonymousFunctionID_ : strings_.insert(nameStr);
+
+  const uint32_t frameID = frames_.size();
+  frames_.push_back(Frame{
+      nameID,
+      strings_.insert(scriptName),
+      runtimeModule->getScriptID(),
+      lineNo,
+      columnNo});
+  frameIDs_[{codeBlock, offset}] = frameID;
+  return frameID;
+}
+
+void HeapSamplingProfiler::writeChromeProfile(llvh::raw_ostream &os) {
+  // Nodes are only ever appended, and always after their parent, so children
+  // lists built in index order are in creation order.
+  std::vector<uint64_t> selfSizes(stackNodes_.size());
+  for (const Sample &sample : samples_) {
+    selfSizes[sample.stack] += sample.size;
+  }
+  std::vector<llvh::SmallVector<uint32_t, 2>> children(stackNodes_.size());
+  for (uint32_t i = 1, e = stackNodes_.size(); i < e; ++i) {
+    children[stackNodes_[i].parent].push_back(i);
+  }
+
+  JSONEmitter json{os};
+  json.openDict();
+  json.emitKey("head");
+
+  // Emit the tree with an explicit stack, since it may be deep.
+  // Each entry is a node and the index of the next child to emit.
+  llvh::SmallVector<std::pair<uint32_t, uint32_t>, 32> worklist;
+  auto openNode = [&](uint32_t node) {
+    const Frame &frame = frames_[stackNodes_[node].frame];
+    json.openDict();
+    json.emitKey("callFrame");
+    json.openDict();
+    json.emitKeyValue("functionName", strings_[frame.functionName]);
+    json.emitKeyValue("scriptId", std::to_string(frame.scriptID));
+    json.emitKeyValue("url", strings_[frame.scriptName]);
+    // Lines and columns are 0-based in the profile.
+    json.emitKeyValue("lineNumber", frame.lineNo - 1);
+    json.emitKeyValue("columnNumber", frame.columnNo - 1);
+    json.closeDict();
+    json.emitKeyValue("selfSize", selfSizes[node]);
+    // IDs start from 1.
+    json.emitKeyValue("id", node + 1);
+    json.emitKey("children");
+    json.openArray();
+    worklist.emplace_back(node, 0);
+  };
+  openNode(0);
+  while (!worklist.empty()) {
+    auto &top = worklist.back();
+    if (top.second < children[top.first].size()) {
+      openNode(children[top.first][top.second++]);
+      continue;
+    }
+    json.closeArray();
+    json.closeDict();
+    worklist.pop_back();
+  }
+
+  json.emitKey("samples");
+  json.openArray();
+  for (const Sample &sample : samples_) {
+    json.openDict();
+    json.emitKeyValue("size", sample.size);
+    json.emitKeyValue("nodeId", sample.stack + 1);
+    json.emitKeyValue("ordinal", sample.ordinal);
+    json.closeDict();
+  }
+  json.closeArray();
+  json.closeDict();
+}
+
+} // namespace vm
+} // namespace hermes
@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/VM/Profiler/JSPerfMap.h"
+
+#include "hermes/Support/OSCompat.h"
+#include "hermes/VM/CodeBlock.h"
+#include "hermes/VM/Runtime.h"
+#include "hermes/VM/RuntimeModule.h"
+
+#include "llvh/Support/raw_ostream.h"
+
+#include <cinttypes>
+#include <cstring>
+
+#ifdef HERMESVM_JSPERFMAP_SUPPORTED
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#ifdef HERMESVM_EXCEPTION_ON_OOM
+#include <exception>
+#endif
+
+namespace hermes {
+namespace vm {
+
+namespace {
+
+#ifdef HERMESVM_JSPERFMAP_SUPPORTED
+/// The machine code of a trampoline. It sets up a frame pointer, so that
+/// frame pointer based unwinders (including perf's default) walk through it,
+/// and calls its second argument with its first.
+#if defined(__x86_64__)
+const uint8_t kTrampolineCode[] = {
+    0x55, // push %rbp
+    0x48, 0x89, 0xe5, // mov %rsp, %rbp
+    0xff, 0xd6, // call *%rsi
+    0x5d, // pop %rbp
+    0xc3, // ret
+};
+#elif defined(__aarch64__)
+const uint32_t kTrampolineCode[] = {
+    0xa9bf7bfd, // stp x29, x30, [sp, #-16]!
+    0x910003fd, // mov x29, sp
+    0xd63f0020, // blr x1
+    0xa8c17bfd, // ldp x29, x30, [sp], #16
+    0xd65f03c0, // ret
+};
+#endif
+
+/// Trampolines are padded to this size, to keep them aligned.
+constexpr size_t kTrampolineSlotSize = 32;
+static_assert(
+    sizeof(kTrampolineCode) <= kTrampolineSlotSize,
+    "trampoline doesn't fit its slot");
+#endif
+
+/// State passed through a trampoline to the function it calls.
+struct TrampolineCall {
+  Runtime *runtime;
+  CodeBlock *codeBlock;
+  CallResult<HermesValue> result{ExecutionStatus::EXCEPTION};
+#ifdef HERMESVM_EXCEPTION_ON_OOM
+  /// The trampolines have no unwind info, so C++ exceptions can't propagate
+  /// through them. They are caught on the inside and rethrown on the outside.
+  std::exception_ptr exception;
+#endif
+};
+
+} // namespace
+
+bool JSPerfMap::isSupported() {
+#ifdef HERMESVM_JSPERFMAP_SUPPORTED
+  return true;
+#else
+  return false;
+#endif
+}
+
+std::string JSPerfMap::getPerfMapPath() {
+#ifdef HERMESVM_JSPERFMAP_SUPPORTED
+  return "/tmp/perf-" + std::to_string(getpid()) + ".map";
+#else
+  return std::string();
+#endif
+}
+
+std::unique_ptr<JSPerfMap> JSPerfMap::create(
+    Runtime *runtime,
+    const std::string &path) {
+  if (!isSupported()) {
+    return nullptr;
+  }
+  // Several runtimes in the process may share the map, so only ever append
+  // whole lines to it.
+  FILE *file =
+      fopen(path.empty() ? getPerfMapPath().c_str() : path.c_str(), "a");
+  if (!file) {
+    return nullptr;
+  }
+  return std::unique_ptr<JSPerfMap>(new JSPerfMap(runtime, file));
+}
+
+JSPerfMap::~JSPerfMap() {
+  fclose(file_);
+#ifdef HERMESVM_JSPERFMAP_SUPPORTED
+  // No JS runs on the runtime's thread anymore, so no trampoline is on the
+  // stack. The map still names the trampolines, so only free their pages and
+  // keep the addresses reserved, rather than let a later mapping reuse them.
+  for (char *chunk : chunks_) {
+    oscompat::vm_uncommit(chunk, oscompat::page_size());
+  }
+#endif
+}
+
+std::string JSPerfMap::getSymbolName(
+    const CodeBlock *codeBlock,
+    GCBase::GCCallbacks *callbacks) {
+  RuntimeModule *runtimeModule = codeBlock->getRuntimeModule();
+  std::string name;
+  llvh::raw_string_ostream os{name};
+  os << "JS:" << codeBlock->getNameString(callbacks) << "(";
+  if (auto location = codeBlock->getSourceLocation()) {
+    os << runtimeModule->getBytecode()->getDebugInfo()->getFilenameByID(
+              location->filenameId)
+       << ":" << location->line << ":" << location->column;
+  } else {
+    os << runtimeModule->getBytecode()->getSegmentID() << ":"
+       << codeBlock->getVirtualOffset();
+  }
+  os << ")";
+  // Symbol names end at the end of the line.
+  for (char &c : os.str()) {
+    if (c == '\n' || c == '\r') {
+      c = ' ';
+    }
+  }
+  return name;
+}
+
+JSPerfMap::Trampoline JSPerfMap::getTrampoline(CodeBlock *codeBlock) {
+#ifdef HERMESVM_JSPERFMAP_SUPPORTED
+  auto it = trampolines_.find(codeBlock);
+  if (it != trampolines_.end()) {
+    return it->second;
+  }
+
+  const size_t chunkSize = oscompat::page_size();
+  if (chunks_.empty() || chunkUsed_ + kTrampolineSlotSize > chunkSize) {
+    // The previous chunk is full. It stays mapped until the map is destroyed,
+    // since its trampolines may still be on the stack.
+    void *mem = mmap(
+        nullptr,
+        chunkSize,
+        PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS,
+        -1,
+        0);
+    if (mem == MAP_FAILED) {
+      return nullptr;
+    }
+    chunks_.push_back(static_cast<char *>(mem));
+    chunkUsed_ = 0;
+  } else if (mprotect(chunks_.back(), chunkSize, PROT_READ | PROT_WRITE) != 0) {
+    return nullptr;
+  }
+  char *chunk = chunks_.back();
+
+  // Only this runtime's thread runs code in the chunk, and it isn't doing so
+  // while the chunk is writable.
+  char *code = chunk + chunkUsed_;
+  std::memcpy(code, kTrampolineCode, sizeof(kTrampolineCode));
+  chunkUsed_ += kTrampolineSlotSize;
+  __builtin___clear_cache(code, code + sizeof(kTrampolineCode));
+  if (mprotect(chunk, chunkSize, PROT_READ | PROT_EXEC) != 0) {
+    hermes_fatal("Unable to make perf map trampolines executable");
+  }
+
+  fprintf(
+      file_,
+      "%" PRIxPTR " %zx %s\n",
+      reinterpret_cast<uintptr_t>(code),
+      sizeof(kTrampolineCode),
+      getSymbolName(codeBlock, runtime_->getHeap().getCallbacks()).c_str());
+  // Make the symbol available to a profiler that is already running.
+  fflush(file_);
+
+  auto trampoline = reinterpret_cast<Trampoline>(code);
+  trampolines_[codeBlock] = trampoline;
+  return trampoline;
+#else
+  return nullptr;
+#endif
+}
+
+CallResult<HermesValue> JSPerfMap::interpretFunction(CodeBlock *codeBlock) {
+  Trampoline trampoline = getTrampoline(codeBlock);
+  if (LLVM_UNLIKELY(!trampoline)) {
+    // The frame won't be symbolized, but the function still has to run.
+    return runtime_->interpretFunctionImpl(codeBlock);
+  }
+  TrampolineCall call{runtime_, codeBlock};
+  trampoline(&call, [](void *ctx) {
+    auto *call = static_cast<TrampolineCall *>(ctx);
+#ifdef HERMESVM_EXCEPTION_ON_OOM
+    try {
+      call->result = call->runtime->interpretFunctionImpl(call->codeBlock);
+    } catch (...) {
+      call->exception = std::current_exception();
+    }
+#else
+    call->result = call->runtime->interpretFunctionImpl(call->codeBlock);
+#endif
+  });
+#ifdef HERMESVM_EXCEPTION_ON_OOM
+  if (call.exception) {
+    std::rethrow_exception(call.exception);
+  }
+#endif
+  return call.result;
+}
+
+} // namespace vm
+} // namespace hermes
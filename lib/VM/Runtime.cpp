@@ -28,11 +28,15 @@
 #include "hermes/VM/JSError.h"
 #include "hermes/VM/JSLib.h"
 #include "hermes/VM/JSLib/RuntimeCommonStorage.h"
+#include "hermes/VM/LazyCompileQueue.h"
 #include "hermes/VM/MockedEnvironment.h"
 #include "hermes/VM/Operations.h"
 #include "hermes/VM/PredefinedStringIDs.h"
 #include "hermes/VM/Profiler/CodeCoverageProfiler.h"
+#include "hermes/VM/Profiler/HeapSamplingProfiler.h"
+#include "hermes/VM/Profiler/JSPerfMap.h"
 #include "hermes/VM/Profiler/SamplingProfiler.h"
+#include "hermes/VM/SegmentPool.h"
 #include "hermes/VM/StackFrame-inline.h"
 #include "hermes/VM/StackTracesTree.h"
 #include "hermes/VM/StringView.h"
@@ -72,12 +76,26 @@ static const Predefined::Str fixedPropCacheNames[(size_t)PropCacheID::_COUNT] =
 #undef V
 };
 
+/// \return the StorageProvider requested by \p gcConfig for the heap of a new
+/// Runtime.
+std::unique_ptr<StorageProvider> createStorageProvider(
+    const GCConfig &gcConfig) {
+  if (gcConfig.getReserveContiguousHeap()) {
+    return StorageProvider::contiguousVAProvider(
+        gcConfig.getMaxHeapSize(), gcConfig.getBindHeapToLocalNUMANode());
+  }
+  if (gcConfig.getUseSegmentPool()) {
+    return std::unique_ptr<StorageProvider>(new PooledStorageProvider());
+  }
+  return StorageProvider::mmapProvider();
+}
+
 } // namespace
 
 /* static */
 std::shared_ptr<Runtime> Runtime::create(const RuntimeConfig &runtimeConfig) {
-  return std::shared_ptr<Runtime>{
-      new Runtime(StorageProvider::mmapProvider(), runtimeConfig)};
+  return std::shared_ptr<Runtime>{new Runtime(
+      createStorageProvider(runtimeConfig.getGCConfig()), runtimeConfig)};
 }
 
 CallResult<PseudoHandle<>> Runtime::getNamed(
@@ -164,6 +182,8 @@ Runtime::Runtime(
       shouldRandomizeMemoryLayout_(runtimeConfig.getRandomizeMemoryLayout()),
       bytecodeWarmupPercent_(runtimeConfig.getBytecodeWarmupPercent()),
       trackIO_(runtimeConfig.getTrackIO()),
+      errorStackCaptureDepth_(runtimeConfig.getErrorStackCaptureDepth()),
+      lazyErrorStackNames_(runtimeConfig.getLazyErrorStackNames()),
       vmExperimentFlags_(runtimeConfig.getVMExperimentFlags()),
       runtimeStats_(runtimeConfig.getEnableSampledStats()),
       commonStorage_(
@@ -294,6 +314,18 @@ Runtime::Runtime(
       ignoreAllocationFailure(JSArray::create(this, 4, 4)).get());
 #endif
 
+  // Every JS frame must be entered the same way, so this has to be decided
+  // before any JS runs.
+  if (runtimeConfig.getEnableJSPerfMap()) {
+    jsPerfMap_ = JSPerfMap::create(this, runtimeConfig.getJSPerfMapPath());
+  }
+
+#ifndef HERMESVM_LEAN
+  if (runtimeConfig.getBackgroundLazyCompilation()) {
+    lazyCompileQueue_ = LazyCompileQueue::create();
+  }
+#endif
+
   codeCoverageProfiler_->disable();
   // Execute our internal bytecode.
   auto jsBuiltinsObj = runInternalBytecode();
@@ -310,6 +342,7 @@ Runtime::Runtime(
 
 Runtime::~Runtime() {
   samplingProfiler.reset();
+  disableHeapSamplingProfiler();
   getHeap().finalizeAll();
   // Now that all objects are finalized, there shouldn't be any native memory
   // keys left in the ID tracker for memory profiling. Assert that the only IDs
@@ -537,6 +570,10 @@ void Runtime::markWeakRoots(WeakRootAcceptor &acceptor, bool markLongLived) {
   }
   for (auto &fn : customMarkWeakRootFuncs_)
     fn(&getHeap(), acceptor);
+  if (heapSamplingProfiler_) {
+    // Sampled objects may be young, so they are visited in every collection.
+    heapSamplingProfiler_->markWeakRoots(acceptor);
+  }
   acceptor.endRootSection();
 }
 
@@ -1695,7 +1732,7 @@ void Runtime::dumpCallFrames() {
 }
 
 StackRuntime::StackRuntime(const RuntimeConfig &config)
-    : StackRuntime(StorageProvider::mmapProvider(), config) {}
+    : StackRuntime(createStorageProvider(config.getGCConfig()), config) {}
 
 StackRuntime::StackRuntime(
     std::shared_ptr<StorageProvider> provider,
@@ -1939,6 +1976,38 @@ ExecutionStatus Runtime::notifyTimeout() {
   return raiseTimeoutError();
 }
 
+void Runtime::enableHeapSamplingProfiler(
+    size_t samplingInterval,
+    size_t maxStackDepth,
+    size_t maxLiveSamples,
+    int64_t seed) {
+  disableHeapSamplingProfiler();
+  heapSamplingProfiler_ = std::make_unique<HeapSamplingProfiler>(
+      this,
+      samplingInterval,
+      maxStackDepth,
+      maxLiveSamples,
+      HeapSamplingProfiler::kDefaultMaxStackNodes,
+      seed);
+  getHeap().setAllocationSampler(heapSamplingProfiler_.get());
+}
+
+bool Runtime::writeHeapSamplingProfile(llvh::raw_ostream &os) {
+  if (!heapSamplingProfiler_) {
+    return false;
+  }
+  heapSamplingProfiler_->writeChromeProfile(os);
+  return true;
+}
+
+void Runtime::disableHeapSamplingProfiler() {
+  if (!heapSamplingProfiler_) {
+    return;
+  }
+  getHeap().setAllocationSampler(nullptr);
+  heapSamplingProfiler_.reset();
+}
+
 #ifdef HERMES_ENABLE_ALLOCATION_LOCATION_TRACES
 
 std::pair<const CodeBlock *, const inst::Inst *>
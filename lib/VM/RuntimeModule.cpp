@@ -12,7 +12,9 @@
 #include "hermes/VM/CodeBlock.h"
 #include "hermes/VM/Domain.h"
 #include "hermes/VM/HiddenClass.h"
+#include "hermes/VM/LazyCompileQueue.h"
 #include "hermes/VM/Predefined.h"
+#include "hermes/VM/Profiler/JSPerfMap.h"
 #include "hermes/VM/Runtime.h"
 #include "hermes/VM/RuntimeModule-inline.h"
 #include "hermes/VM/StringPrimitive.h"
@@ -71,6 +73,9 @@ RuntimeModule::~RuntimeModule() {
   for (auto *block : functionMap_) {
     if (block != nullptr && block->getRuntimeModule() == this) {
       runtime_->getHeap().getIDTracker().untrackNative(block);
+      if (JSPerfMap *perfMap = runtime_->getJSPerfMap()) {
+        perfMap->forgetCodeBlock(block);
+      }
       delete block;
     }
   }
@@ -176,6 +181,12 @@ RuntimeModule *RuntimeModule::createLazyModule(
 
   RM->bcProvider_ = hbc::BCProviderLazy::createBCProviderLazy(bcFunction);
 
+  // A closure is being created for the function, so it will likely be called
+  // soon.
+  if (auto *queue = runtime->getLazyCompileQueue()) {
+    queue->enqueue(*bcFunction->getLazyCompilationData());
+  }
+
   // We don't know which function index this block will eventually represent,
   // so just add it as 0 to ensure ownership. We'll move it later in
   // `initializeLazy`.
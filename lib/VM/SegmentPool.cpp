@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/VM/SegmentPool.h"
+
+#include "hermes/Support/OSCompat.h"
+#include "hermes/VM/AlignedStorage.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace hermes {
+namespace vm {
+
+constexpr size_t SegmentPool::kDefaultMaxPooled;
+constexpr size_t SegmentPool::kDefaultMaxResident;
+constexpr std::chrono::milliseconds SegmentPool::kDefaultIdleTimeout;
+
+SegmentPool::~SegmentPool() {
+  {
+    std::lock_guard<std::mutex> lk{mtx_};
+    shouldExit_ = true;
+  }
+  idleCond_.notify_one();
+  if (idleThread_.joinable()) {
+    idleThread_.join();
+  }
+  clear();
+}
+
+/* static */
+SegmentPool &SegmentPool::getInstance() {
+  // Intentionally leaked: Runtimes destroyed by static destructors may still
+  // return their storage. Its idle thread, if any, is never joined.
+  static SegmentPool *instance = new SegmentPool();
+  return *instance;
+}
+
+llvh::ErrorOr<void *> SegmentPool::acquire(const char *name) {
+  void *storage = nullptr;
+  {
+    std::lock_guard<std::mutex> lk{mtx_};
+    trimLocked(Clock::now());
+    // Prefer the most recently returned storage, which is the most likely to
+    // still be backed by physical pages.
+    if (!resident_.empty()) {
+      storage = resident_.back().storage;
+      resident_.pop_back();
+    } else if (!released_.empty()) {
+      storage = released_.back();
+      released_.pop_back();
+    }
+  }
+
+  if (!storage) {
+    auto result = oscompat::vm_allocate_aligned(
+        AlignedStorage::size(), AlignedStorage::size());
+    if (!result) {
+      return result;
+    }
+    storage = *result;
+#ifdef HERMESVM_ALLOW_HUGE_PAGES
+    oscompat::vm_hugepage(storage, AlignedStorage::size());
+#endif
+  }
+
+  oscompat::vm_name(storage, AlignedStorage::size(), name);
+  return storage;
+}
+
+void SegmentPool::release(void *storage) {
+  assert(storage && "Cannot release null storage");
+  {
+    std::lock_guard<std::mutex> lk{mtx_};
+    if (resident_.size() + released_.size() < maxPooled_) {
+      auto now = Clock::now();
+      resident_.push_back({storage, now});
+      trimLocked(now);
+      scheduleIdleReleaseLocked();
+      return;
+    }
+  }
+  oscompat::vm_free_aligned(storage, AlignedStorage::size());
+}
+
+void SegmentPool::releaseIdle() {
+  std::lock_guard<std::mutex> lk{mtx_};
+  for (const ResidentEntry &entry : resident_) {
+    oscompat::vm_unused(entry.storage, AlignedStorage::size());
+    released_.push_back(entry.storage);
+  }
+  resident_.clear();
+}
+
+void SegmentPool::clear() {
+  std::lock_guard<std::mutex> lk{mtx_};
+  for (const ResidentEntry &entry : resident_) {
+    oscompat::vm_free_aligned(entry.storage, AlignedStorage::size());
+  }
+  for (void *storage : released_) {
+    oscompat::vm_free_aligned(storage, AlignedStorage::size());
+  }
+  resident_.clear();
+  released_.clear();
+}
+
+void SegmentPool::setLimits(
+    size_t maxPooled,
+    size_t maxResident,
+    std::chrono::milliseconds idleTimeout) {
+  std::lock_guard<std::mutex> lk{mtx_};
+  maxPooled_ = maxPooled;
+  maxResident_ = std::min(maxResident, maxPooled);
+  idleTimeout_ = idleTimeout;
+  trimLocked(Clock::now());
+  scheduleIdleReleaseLocked();
+}
+
+size_t SegmentPool::maxPooled() const {
+  std::lock_guard<std::mutex> lk{mtx_};
+  return maxPooled_;
+}
+
+size_t SegmentPool::maxResident() const {
+  std::lock_guard<std::mutex> lk{mtx_};
+  return maxResident_;
+}
+
+std::chrono::milliseconds SegmentPool::idleTimeout() const {
+  std::lock_guard<std::mutex> lk{mtx_};
+  return idleTimeout_;
+}
+
+size_t SegmentPool::numPooled() const {
+  std::lock_guard<std::mutex> lk{mtx_};
+  return resident_.size() + released_.size();
+}
+
+size_t SegmentPool::numResident() const {
+  std::lock_guard<std::mutex> lk{mtx_};
+  return resident_.size();
+}
+
+void SegmentPool::trimLocked(Clock::time_point now) {
+  // resident_ is ordered oldest first, so idle entries form a prefix. The
+  // idle time is compared in milliseconds, since converting a large timeout
+  // to the clock's finer duration would overflow.
+  auto idleTime = [now](const ResidentEntry &entry) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        now - entry.since);
+  };
+  size_t numToRelease = 0;
+  while (numToRelease < resident_.size() &&
+         (resident_.size() - numToRelease > maxResident_ ||
+          idleTime(resident_[numToRelease]) >= idleTimeout_)) {
+    ++numToRelease;
+  }
+  for (size_t i = 0; i < numToRelease; ++i) {
+    oscompat::vm_unused(resident_[i].storage, AlignedStorage::size());
+    released_.push_back(resident_[i].storage);
+  }
+  resident_.erase(resident_.begin(), resident_.begin() + numToRelease);
+
+  // Unmap the storages that no longer fit, starting with released ones.
+  while (resident_.size() + released_.size() > maxPooled_) {
+    void *storage;
+    if (!released_.empty()) {
+      storage = released_.back();
+      released_.pop_back();
+    } else {
+      storage = resident_.front().storage;
+      resident_.erase(resident_.begin());
+    }
+    oscompat::vm_free_aligned(storage, AlignedStorage::size());
+  }
+}
+
+void SegmentPool::scheduleIdleReleaseLocked() {
+  if (resident_.empty() || idleTimeout_ == std::chrono::milliseconds::max()) {
+    return;
+  }
+  if (!idleThread_.joinable()) {
+    idleThread_ = std::thread(&SegmentPool::idleLoop, this);
+  } else {
+    idleCond_.notify_one();
+  }
+}
+
+void SegmentPool::idleLoop() {
+  std::unique_lock<std::mutex> lk{mtx_};
+  while (!shouldExit_) {
+    if (resident_.empty() ||
+        idleTimeout_ == std::chrono::milliseconds::max()) {
+      idleCond_.wait(lk);
+    } else {
+      // Cap the wait, since a long timeout would overflow the clock's
+      // duration. Waking up early only re-checks the deadline.
+      auto wait = std::min<std::chrono::milliseconds>(
+          idleTimeout_, std::chrono::hours(24));
+      idleCond_.wait_until(lk, resident_.front().since + wait);
+    }
+    // The wait may end because of a timeout, a notification or a spurious
+    // wakeup; in all cases, release what has timed out by now.
+    if (!shouldExit_) {
+      trimLocked(Clock::now());
+    }
+  }
+}
+
+llvh::ErrorOr<void *> PooledStorageProvider::newStorageImpl(const char *name) {
+  return pool_.acquire(name);
+}
+
+void PooledStorageProvider::deleteStorageImpl(void *storage) {
+  if (!storage) {
+    return;
+  }
+  pool_.release(storage);
+}
+
+} // namespace vm
+} // namespace hermes
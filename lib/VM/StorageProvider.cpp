@@ -19,6 +19,7 @@
 #include <cassert>
 #include <limits>
 #include <stack>
+#include <vector>
 
 namespace hermes {
 namespace vm {
@@ -52,6 +53,110 @@ class MallocStorageProvider final : public StorageProvider {
   llvh::DenseMap<void *, void *> lowLimToAllocHandle_;
 };
 
+class ContiguousVAStorageProvider final : public StorageProvider {
+ public:
+  ContiguousVAStorageProvider(size_t size, bool bindLocalNUMA);
+  ~ContiguousVAStorageProvider() override;
+
+  llvh::ErrorOr<void *> newStorageImpl(const char *name) override;
+  void deleteStorageImpl(void *storage) override;
+
+ private:
+  /// Apply the huge page and NUMA policies to the \p sz bytes at \p mem.
+  void adviseRegion(void *mem, size_t sz);
+
+  /// \return true if \p storage was handed out from the reserved range.
+  bool inRange(void *storage) const {
+    return start_ <= storage && storage < end_;
+  }
+
+  /// Whether to prefer memory from the local NUMA node.
+  const bool bindLocalNUMA_;
+
+  /// The reserved range [start_, end_). Both are null if the reservation
+  /// failed. Only the storages handed out from it are committed.
+  char *start_{nullptr};
+  char *end_{nullptr};
+
+  /// The start of the part of the range that has never been handed out.
+  char *level_{nullptr};
+
+  /// Storages inside the range that were deleted and uncommitted, and can be
+  /// reused.
+  std::vector<void *> freeList_;
+};
+
+ContiguousVAStorageProvider::ContiguousVAStorageProvider(
+    size_t size,
+    bool bindLocalNUMA)
+    : bindLocalNUMA_(bindLocalNUMA) {
+  size = llvh::alignTo(std::max<size_t>(size, 1), AlignedStorage::size());
+  // Only reserve the address space here. Committing all of it would charge
+  // the whole maximum heap against the commit limit, and fail under strict
+  // overcommit.
+  auto result = oscompat::vm_reserve_aligned(size, AlignedStorage::size());
+  if (!result) {
+    // Fall back to allocating each segment separately.
+    return;
+  }
+  start_ = level_ = static_cast<char *>(*result);
+  end_ = start_ + size;
+}
+
+ContiguousVAStorageProvider::~ContiguousVAStorageProvider() {
+  if (start_)
+    oscompat::vm_release_aligned(start_, end_ - start_);
+}
+
+void ContiguousVAStorageProvider::adviseRegion(void *mem, size_t sz) {
+  oscompat::vm_hugepage(mem, sz);
+  if (bindLocalNUMA_)
+    oscompat::vm_bind_local_numa(mem, sz);
+}
+
+llvh::ErrorOr<void *> ContiguousVAStorageProvider::newStorageImpl(
+    const char *name) {
+  void *mem;
+  if (!freeList_.empty() || level_ < end_) {
+    mem = freeList_.empty() ? level_ : freeList_.back();
+    if (!oscompat::vm_commit(mem, AlignedStorage::size())) {
+      return std::make_error_code(std::errc::not_enough_memory);
+    }
+    if (freeList_.empty()) {
+      level_ += AlignedStorage::size();
+    } else {
+      freeList_.pop_back();
+    }
+    // Uncommitting a storage drops its advice, so apply it on every commit.
+    adviseRegion(mem, AlignedStorage::size());
+  } else {
+    auto result = oscompat::vm_allocate_aligned(
+        AlignedStorage::size(), AlignedStorage::size());
+    if (!result) {
+      return result;
+    }
+    mem = *result;
+    adviseRegion(mem, AlignedStorage::size());
+  }
+  assert(isAligned(mem));
+  oscompat::vm_name(mem, AlignedStorage::size(), name);
+  return mem;
+}
+
+void ContiguousVAStorageProvider::deleteStorageImpl(void *storage) {
+  if (!storage) {
+    return;
+  }
+  if (!inRange(storage)) {
+    oscompat::vm_free_aligned(storage, AlignedStorage::size());
+    return;
+  }
+  // Keep the address range for reuse, but give its pages and their commit
+  // charge back to the OS in the meantime.
+  oscompat::vm_uncommit(storage, AlignedStorage::size());
+  freeList_.push_back(storage);
+}
+
 llvh::ErrorOr<void *> VMAllocateStorageProvider::newStorageImpl(
     const char *name) {
   assert(AlignedStorage::size() % oscompat::page_size() == 0);
@@ -110,6 +215,14 @@ std::unique_ptr<StorageProvider> StorageProvider::mallocProvider() {
   return std::unique_ptr<StorageProvider>(new MallocStorageProvider);
 }
 
+/* static */
+std::unique_ptr<StorageProvider> StorageProvider::contiguousVAProvider(
+    size_t size,
+    bool bindLocalNUMA) {
+  return std::unique_ptr<StorageProvider>(
+      new ContiguousVAStorageProvider(size, bindLocalNUMA));
+}
+
 llvh::ErrorOr<void *> StorageProvider::newStorage(const char *name) {
   auto res = newStorageImpl(name);
 
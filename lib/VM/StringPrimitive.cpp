@@ -243,6 +243,32 @@ CallResult<HermesValue> StringPrimitive::slice(
   assert(
       start + length <= str->getStringLength() && "Invalid length for slice");
 
+  if (length >= SLICED_STRING_MIN_SIZE) {
+    // Reference the characters of the parent instead of copying them. A slice
+    // of a slice references the parent of the original slice.
+    StringPrimitive *parent = str.get();
+    uint32_t offset = start;
+    if (auto *sliced = dyn_vmcast<SlicedASCIIStringPrimitive>(parent)) {
+      parent = sliced->getParent();
+      offset += sliced->offset_;
+    } else if (auto *sliced = dyn_vmcast<SlicedUTF16StringPrimitive>(parent)) {
+      parent = sliced->getParent();
+      offset += sliced->offset_;
+    }
+    // Otherwise copy, so a short slice doesn't keep a long parent alive.
+    if (length * SLICED_STRING_MAX_PARENT_RATIO >= parent->getStringLength()) {
+      auto parentHnd = runtime->makeHandle(parent);
+      if (parent->isASCII()) {
+        return SlicedASCIIStringPrimitive::create(
+                   runtime, parentHnd, offset, length)
+            .getHermesValue();
+      }
+      return SlicedUTF16StringPrimitive::create(
+                 runtime, parentHnd, offset, length)
+          .getHermesValue();
+    }
+  }
+
   SafeUInt32 safeLen(length);
 
   auto builder =
@@ -679,5 +705,39 @@ void BufferedStringPrimitive<T>::_snapshotAddNodesImpl(
 
 template class BufferedStringPrimitive<char16_t>;
 template class BufferedStringPrimitive<char>;
+
+//===----------------------------------------------------------------------===//
+// SlicedStringPrimitive<T>
+
+void SlicedASCIIStringPrimitiveBuildMeta(
+    const GCCell *cell,
+    Metadata::Builder &mb) {
+  const auto *self = static_cast<const SlicedASCIIStringPrimitive *>(cell);
+  mb.setVTable(&SlicedASCIIStringPrimitive::vt);
+  mb.addField("parent", &self->parentHV_);
+}
+void SlicedUTF16StringPrimitiveBuildMeta(
+    const GCCell *cell,
+    Metadata::Builder &mb) {
+  const auto *self = static_cast<const SlicedUTF16StringPrimitive *>(cell);
+  mb.setVTable(&SlicedUTF16StringPrimitive::vt);
+  mb.addField("parent", &self->parentHV_);
+}
+
+template <typename T>
+PseudoHandle<StringPrimitive> SlicedStringPrimitive<T>::create(
+    Runtime *runtime,
+    Handle<StringPrimitive> parent,
+    uint32_t offset,
+    uint32_t length) {
+  // As with BufferedStringPrimitive, the size is known, but the cell is
+  // derived from VariableSizeRuntimeCell.
+  auto *cell = runtime->makeAVariable<SlicedStringPrimitive<T>>(
+      sizeof(SlicedStringPrimitive<T>), runtime, parent, offset, length);
+  return createPseudoHandle<StringPrimitive>(cell);
+}
+
+template class SlicedStringPrimitive<char16_t>;
+template class SlicedStringPrimitive<char>;
 } // namespace vm
 } // namespace hermes
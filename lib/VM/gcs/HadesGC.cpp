@@ -1347,7 +1347,7 @@ void HadesGC::getCrashManagerHeapInfo(
   crashInfo.used_ = info.allocatedBytes;
 }
 
-void HadesGC::createSnapshot(llvh::raw_ostream &os) {
+std::error_code HadesGC::createSnapshot(llvh::raw_ostream &os) {
   std::lock_guard<Mutex> lk{gcMutex_};
   // No allocations are allowed throughout the entire heap snapshot process.
   NoAllocScope scope{this};
@@ -1356,7 +1356,7 @@ void HadesGC::createSnapshot(llvh::raw_ostream &os) {
   {
     GCCycle cycle{this, gcCallbacks_, "Heap Snapshot"};
     WeakRefLock lk{weakRefMutex()};
-    GCBase::createSnapshot(this, os);
+    return GCBase::createSnapshot(this, os);
   }
 }
 
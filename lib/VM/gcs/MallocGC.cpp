@@ -583,9 +583,9 @@ bool MallocGC::isMostRecentFinalizableObj(const GCCell *cell) const {
 }
 #endif
 
-void MallocGC::createSnapshot(llvh::raw_ostream &os) {
+std::error_code MallocGC::createSnapshot(llvh::raw_ostream &os) {
   GCCycle cycle{this};
-  GCBase::createSnapshot(this, os);
+  return GCBase::createSnapshot(this, os);
 }
 
 /// @name Forward instantiations
@@ -190,6 +190,26 @@ enum class GCEventKind {
   /* Whether to use mprotect on GC metadata between GCs. */               \
   F(constexpr, bool, ProtectMetadata, false)                              \
                                                                           \
+  /* Whether to reserve address space for MaxHeapSize up front and */     \
+  /* carve segments out of it, backed by huge pages where available. */   \
+  F(constexpr, bool, ReserveContiguousHeap, false)                        \
+                                                                          \
+  /* With ReserveContiguousHeap, whether to prefer memory from the */     \
+  /* NUMA node of the thread creating the runtime. */                     \
+  F(constexpr, bool, BindHeapToLocalNUMANode, false)                      \
+                                                                          \
+  /* Whether to take segments from, and return them to, a pool shared */  \
+  /* by all Runtimes in the process, instead of mapping fresh ones. */    \
+  /* Ignored if ReserveContiguousHeap is set. The pool's limits belong */ \
+  /* to the process, and are set by the host with */                      \
+  /* HermesRuntime::setSegmentPoolLimits. */                              \
+  F(constexpr, bool, UseSegmentPool, false)                               \
+                                                                          \
+  /* Whether heap snapshots should bound their memory use by */           \
+  /* spooling strings and the node index to temporary files, at some */   \
+  /* cost in speed and size. */                                           \
+  F(constexpr, bool, StreamHeapSnapshots, false)                          \
+                                                                          \
   /* Callout for an analytics event. */                                   \
   F(HERMES_NON_CONSTEXPR,                                                 \
     std::function<void(const GCAnalyticsEvent &)>,                        \
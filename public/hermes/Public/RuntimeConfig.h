@@ -93,6 +93,26 @@ class PinnedHermesValue;
   /* all bytecode buffers > 64 kB passed to Hermes must be mmap:ed. */ \
   F(constexpr, bool, TrackIO, false)                                   \
                                                                        \
+  /* Call each JS function through a native trampoline listed in */    \
+  /* /tmp/perf-<pid>.map, so that Linux perf can symbolize JS */       \
+  /* frames. Slows down calls. Only supported on Linux, in builds */   \
+  /* with HERMESVM_JS_PERF_MAP. Otherwise, or if the map can't be */   \
+  /* opened, calls are made as usual and Runtime::getJSPerfMap() */    \
+  /* returns null. */                                                  \
+  F(constexpr, bool, EnableJSPerfMap, false)                           \
+                                                                       \
+  /* With EnableJSPerfMap, the perf map to append to instead of */     \
+  /* /tmp/perf-<pid>.map. */                                           \
+  F(HERMES_NON_CONSTEXPR, std::string, JSPerfMapPath, "")              \
+                                                                       \
+  /* Maximum number of frames recorded in an Error's stack trace. */   \
+  F(constexpr, uint32_t, ErrorStackCaptureDepth, UINT32_MAX)           \
+                                                                       \
+  /* Don't look up callee names when an Error's stack trace is */      \
+  /* recorded. Names then come from the bytecode when the stack is */  \
+  /* read, and native frames are anonymous. */                         \
+  F(constexpr, bool, LazyErrorStackNames, false)                       \
+                                                                       \
   /* Enable contents of HermesInternal */                              \
   F(constexpr, bool, EnableHermesInternal, true)                       \
                                                                        \
@@ -108,6 +128,21 @@ class PinnedHermesValue;
   /* Choose whether generators are enabled. */                         \
   F(constexpr, bool, EnableGenerator, true)                            \
                                                                        \
+  /* Threads used to pre-parse large sources for lazy compilation. */  \
+  F(constexpr, uint32_t, PreParseThreads, 1)                           \
+                                                                       \
+  /* Compile lazy functions on a background thread once a closure */   \
+  /* is created for them, ahead of their first call. */                \
+  F(constexpr, bool, BackgroundLazyCompilation, false)                 \
+                                                                       \
+  /* If not empty, persist the bytecode compiled from source in this */\
+  /* directory, and reuse it across runs. */                           \
+  F(HERMES_NON_CONSTEXPR, std::string, CompileCacheDirectory, "")      \
+                                                                       \
+  /* The maximum total size in bytes of the compile cache entries. */  \
+  /* The least recently written ones are evicted. */                   \
+  F(constexpr, uint64_t, CompileCacheMaxSize, 64 << 20)                \
+                                                                       \
   /* An interface for managing crashes. */                             \
   F(HERMES_NON_CONSTEXPR,                                              \
     std::shared_ptr<CrashManager>,                                     \
@@ -0,0 +1,115 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// Array builtins that call a callback on every element read the elements of
+// arrays directly, and must see the changes made by the callback.
+
+'use strict';
+
+print('callback elements');
+// CHECK-LABEL: callback elements
+
+function visited(method, arr, cb) {
+  var seen = [];
+  arr[method](function(v, i, o) {
+    seen.push(i + ':' + v);
+    if (cb) return cb(v, i, o);
+    return true;
+  });
+  return seen.join();
+}
+
+// Holes are skipped, unless an element is inherited.
+print(visited('forEach', [1, , 3]));
+// CHECK-NEXT: 0:1,2:3
+Array.prototype[1] = 'proto';
+print(visited('forEach', [1, , 3]));
+// CHECK-NEXT: 0:1,1:proto,2:3
+print([1, , 3].map(function(v) { return v + '!'; }).join());
+// CHECK-NEXT: 1!,proto!,3!
+print([1, , 3].find(function(v) { return typeof v === 'string'; }));
+// CHECK-NEXT: proto
+delete Array.prototype[1];
+print([1, , 3].find(function(v) { return v === undefined; }));
+// CHECK-NEXT: undefined
+print([1, , 3].findIndex(function(v) { return v === undefined; }));
+// CHECK-NEXT: 1
+var mapped = [1, , 3].map(function(v) { return v * 2; });
+print(mapped.length, 1 in mapped, mapped.join());
+// CHECK-NEXT: 3 false 2,,6
+
+// Elements written by the callback are seen, appended ones are not.
+print(visited('forEach', [1, 2, 3], function(v, i, o) {
+  o[i + 1] = v * 10;
+  o.push(0);
+}));
+// CHECK-NEXT: 0:1,1:10,2:100
+
+// Elements removed by the callback are skipped.
+print(visited('forEach', [1, 2, 3, 4], function(v, i, o) {
+  o.length = 2;
+}));
+// CHECK-NEXT: 0:1,1:2
+print(visited('map', [1, 2, 3, 4], function(v, i, o) {
+  delete o[i + 1];
+}));
+// CHECK-NEXT: 0:1,2:3
+print(visited('filter', [1, 2, 3], function(v, i, o) {
+  o.shift();
+  return true;
+}));
+// CHECK-NEXT: 0:1,1:3
+
+// An element can become an accessor.
+print(visited('every', [1, 2, 3], function(v, i, o) {
+  if (i === 0) {
+    Object.defineProperty(o, 2, {
+      get: function() {
+        return 'getter';
+      },
+    });
+  }
+  return true;
+}));
+// CHECK-NEXT: 0:1,1:2,2:getter
+
+// Frozen and non-array receivers.
+print(Object.freeze([1, 2, 3]).map(function(v) { return v + 1; }).join());
+// CHECK-NEXT: 2,3,4
+var arrayLike = {length: 3, 0: 'a', 2: 'c'};
+print(
+  Array.prototype.filter
+    .call(arrayLike, function() {
+      return true;
+    })
+    .join(),
+);
+// CHECK-NEXT: a,c
+
+// reduce and reduceRight start at the first present element.
+print([, , 1, 2, , 3].reduce(function(a, b) { return a + '+' + b; }));
+// CHECK-NEXT: 1+2+3
+print([, , 1, 2, , 3].reduceRight(function(a, b) { return a + '+' + b; }));
+// CHECK-NEXT: 3+2+1
+print([1, 2, 3, 4].reduce(function(a, b, i, o) {
+  o.pop();
+  return a + b;
+}));
+// CHECK-NEXT: 6
+print([1, 2, 3, 4].reduceRight(function(a, b, i, o) {
+  o[0] = 100;
+  return a + b;
+}));
+// CHECK-NEXT: 109
+
+print([1, 2, 3].some(function(v, i, o) {
+  o[2] = 'x';
+  return v === 'x';
+}));
+// CHECK-NEXT: true
@@ -0,0 +1,114 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -Xhermes-internal-test-methods -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -Xhermes-internal-test-methods -O0 %s | %FileCheck --match-full-lines %s
+
+// Element reads and writes that GetByVal/PutByVal handle without calling
+// getComputed/putComputed, and the cases that must still take the slow path.
+
+'use strict';
+
+print('element fast path');
+// CHECK-LABEL: element fast path
+
+function get(a, i) {
+  return a[i];
+}
+function put(a, i, v) {
+  a[i] = v;
+}
+
+var a = [1, 2, 3];
+put(a, 1, 20);
+print(get(a, 0), get(a, 1), get(a, 2), get(a, 3));
+// CHECK-NEXT: 1 20 3 undefined
+print(get(a, '2'), get(a, 2.5), get(a, -1));
+// CHECK-NEXT: 3 undefined undefined
+
+// Holes are looked up on the prototype chain, for reads and for writes.
+var holey = [0, , 2];
+Object.defineProperty(Array.prototype, 1, {
+  get: function() {
+    return 'proto';
+  },
+  set: function(v) {
+    print('proto setter', v);
+  },
+  configurable: true,
+});
+print(get(holey, 1));
+// CHECK-NEXT: proto
+put(holey, 1, 'x');
+// CHECK-NEXT: proto setter x
+print(holey.hasOwnProperty(1));
+// CHECK-NEXT: false
+delete Array.prototype[1];
+
+// Frozen arrays can't be written, in strict mode that throws.
+var frozen = Object.freeze([1, 2]);
+try {
+  put(frozen, 0, 10);
+} catch (e) {
+  print(e.name);
+}
+// CHECK-NEXT: TypeError
+print(get(frozen, 0));
+// CHECK-NEXT: 1
+
+// Sealed arrays can still be written.
+var sealed = Object.seal([1, 2]);
+put(sealed, 0, 10);
+print(get(sealed, 0));
+// CHECK-NEXT: 10
+
+// Read-only elements aren't in the fast index properties.
+var ro = [1, 2];
+Object.defineProperty(ro, 0, {writable: false});
+try {
+  put(ro, 0, 10);
+} catch (e) {
+  print(e.name);
+}
+// CHECK-NEXT: TypeError
+print(get(ro, 0));
+// CHECK-NEXT: 1
+
+// Typed arrays convert on write, values that aren't numbers included.
+var u8 = new Uint8Array(2);
+put(u8, 0, 257);
+put(u8, 1, {
+  valueOf: function() {
+    return 7;
+  },
+});
+print(get(u8, 0), get(u8, 1), get(u8, 2));
+// CHECK-NEXT: 1 7 undefined
+var clamped = new Uint8ClampedArray(1);
+put(clamped, 0, 300);
+print(get(clamped, 0));
+// CHECK-NEXT: 255
+var f32 = new Float32Array(1);
+put(f32, 0, 0.1);
+print(get(f32, 0) === Math.fround(0.1));
+// CHECK-NEXT: true
+put(u8, 5, 1);
+print(u8.length, get(u8, 5));
+// CHECK-NEXT: 2 undefined
+
+// Detached buffers read as 0 and throw on write.
+var detached = new Int32Array(4);
+put(detached, 0, 42);
+HermesInternal.detachArrayBuffer(detached.buffer);
+print(get(detached, 0));
+// CHECK-NEXT: 0
+try {
+  put(detached, 0, 1);
+} catch (e) {
+  print(e.name);
+}
+// CHECK-NEXT: TypeError
@@ -0,0 +1,86 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+
+// Array builtins that read the storage of arrays of numbers directly must
+// behave like the generic versions.
+
+'use strict';
+
+print('elements kind');
+// CHECK-LABEL: elements kind
+
+function stringOrder(a, b) {
+  a = String(a);
+  b = String(b);
+  return a < b ? -1 : a > b ? 1 : 0;
+}
+
+var ints = [10, 9, -1, 100, 0, -10, 1, -2147483648, 2147483647, 19, -9, 2];
+var expected = ints.slice().sort(stringOrder).join();
+print(ints.sort().join() === expected, ints.join());
+// CHECK-NEXT: true -1,-10,-2147483648,-9,0,1,10,100,19,2,2147483647,9
+
+// Equal strings keep their order.
+print([1, 10, 1, 0].sort().join());
+// CHECK-NEXT: 0,1,1,10
+
+// -0 is sorted like a double, and stays -0.
+var zeros = [1, -0, 0];
+zeros.sort();
+print(Object.is(zeros[0], -0) || Object.is(zeros[1], -0));
+// CHECK-NEXT: true
+
+// Holes are moved to the end.
+var holey = [3, , 1];
+holey.sort();
+print(holey.length, 2 in holey, holey.join());
+// CHECK-NEXT: 3 false 1,3,
+
+// Frozen arrays can't be sorted.
+try {
+  Object.freeze([2, 1]).sort();
+} catch (e) {
+  print(e.name);
+}
+// CHECK-NEXT: TypeError
+
+var nums = [1, 2.5, NaN, -0, 3];
+print(nums.indexOf(2.5), nums.indexOf(NaN), nums.indexOf(0), nums.indexOf('3'));
+// CHECK-NEXT: 1 -1 3 -1
+print(nums.includes(NaN), nums.includes(0), nums.includes('1'));
+// CHECK-NEXT: true true false
+print(nums.lastIndexOf(1), nums.lastIndexOf(3, -2), nums.indexOf(3, -1));
+// CHECK-NEXT: 0 -1 4
+
+// Holes are looked up on the prototype chain.
+var sparse = [1, , 3];
+Array.prototype[1] = 'proto';
+print(sparse.indexOf('proto'), sparse.includes('proto'));
+// CHECK-NEXT: 1 true
+print(sparse.lastIndexOf('proto'));
+// CHECK-NEXT: 1
+delete Array.prototype[1];
+print(sparse.indexOf(undefined), sparse.includes(undefined));
+// CHECK-NEXT: -1 true
+
+// Elements added while the arguments are converted are not searched.
+var growing = [1, 2];
+print(
+  growing.indexOf(5, {
+    valueOf: function() {
+      growing.push(5);
+      return 0;
+    },
+  }),
+);
+// CHECK-NEXT: -1
+
+var mixed = [1, 'a', {}, 'a'];
+print(mixed.indexOf('a'), mixed.lastIndexOf('a'), mixed.includes(1));
+// CHECK-NEXT: 1 3 true
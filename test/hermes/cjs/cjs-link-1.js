@@ -0,0 +1,47 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermesc -emit-binary -commonjs -object-unit -out %t.1.hbc %s
+// RUN: %hermesc -emit-binary -commonjs -object-unit -out %t.2.hbc %S/cjs-link-2.js
+// RUN: %hbc-link -out=%t.hbc %t.1.hbc %t.2.hbc && %hermes %t.hbc | %FileCheck --match-full-lines %s
+// RUN: %hbc-link -O -out=%t.O.hbc %t.1.hbc %t.2.hbc && %hermes %t.O.hbc | %FileCheck --match-full-lines %s
+// RUN: %hbc-link -strip-debug-info -out=%t.s.hbc %t.1.hbc %t.2.hbc && %hermes %t.s.hbc | %FileCheck --match-full-lines %s --check-prefix=STRIPPED
+// RUN: ( ! %hbc-link -out=%t.dup.hbc %t.1.hbc %t.1.hbc 2>&1 ) | %FileCheck --match-full-lines %s --check-prefix=DUP
+
+// DUP: Error: unit 1: {{.*}}
+
+print('main start');
+// CHECK-LABEL: main start
+// STRIPPED-LABEL: main start
+
+var mod = require('./cjs-link-2.js');
+// CHECK-NEXT: mod start
+// STRIPPED-NEXT: mod start
+
+print(mod.greet('world'), mod.add(2, 3));
+// CHECK-NEXT: hello world 5
+// STRIPPED-NEXT: hello world 5
+
+var obj = {x: 1, y: 'main', z: [1, 2, 'three']};
+print(JSON.stringify(obj), JSON.stringify(mod.obj));
+// CHECK-NEXT: {"x":1,"y":"main","z":[1,2,"three"]} {"name":"mod","list":["p","q",3]}
+// STRIPPED-NEXT: {"x":1,"y":"main","z":[1,2,"three"]} {"name":"mod","list":["p","q",3]}
+
+print(/ab+c/.test('xabbbc'), mod.match('aqqq'));
+// CHECK-NEXT: true qqq
+// STRIPPED-NEXT: true qqq
+
+try {
+  mod.thrower();
+} catch (e) {
+  print(e.stack);
+}
+// CHECK-NEXT: Error: boom
+// CHECK-NEXT:     at thrower ({{.*}}cjs-link-2.js:22:18)
+// CHECK-NEXT:     at cjs_module ({{.*}}cjs-link-1.js:39:14)
+// STRIPPED-NEXT: Error: boom
+// STRIPPED-NEXT:     at thrower (address at {{.*}})
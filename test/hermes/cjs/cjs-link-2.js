@@ -0,0 +1,23 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: true
+
+print('mod start');
+
+exports.greet = function greet(name) {
+  return 'hello ' + name;
+};
+exports.add = (a, b) => a + b;
+exports.obj = {name: 'mod', list: ['p', 'q', 3]};
+exports.match = function match(str) {
+  return /q+/.exec(str)[0];
+};
+
+exports.thrower = function thrower() {
+  throw new Error('boom');
+};
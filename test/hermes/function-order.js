@@ -0,0 +1,47 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: printf '3\n# third runs first\n\n1\n' > %t.order
+// RUN: %hermesc -O -emit-binary -function-order=%t.order -out %t.hbc %s && %hermes %t.hbc | %FileCheck --match-full-lines %s
+// RUN: (%hbcdump -show-section-ranges %t.hbc && %hbcdump -c "function-info;quit" %t.hbc) | %FileCheck --check-prefix=LAYOUT %s
+// RUN: printf '3\nthird\n' > %t.bad
+// RUN: (! %hermesc -O -emit-binary -function-order=%t.bad -out %t.hbc %s 2>&1) | %FileCheck --check-prefix=BAD %s
+
+// Functions listed in the order file are laid out first, and identical
+// bodies are still shared after reordering.
+
+function first(x) {
+  return x + 1;
+}
+function second(x) {
+  return x + 1;
+}
+function third(x) {
+  switch (x) {
+    case 0: return 'zero';
+    case 1: return 'one';
+    case 2: return 'two';
+    case 3: return 'three';
+    case 4: return 'four';
+    case 5: return 'five';
+  }
+  return 'many';
+}
+
+var fns = [first, second, third];
+print(fns[0](1), fns[1](2), fns[2](3), fns[2](9));
+// CHECK: 2 3 three many
+
+// LAYOUT:      CommonJS module table: [{{[0-9]+}}, [[START:[0-9]+]])
+// LAYOUT:      "FunctionID": 1,
+// LAYOUT-NEXT: "Offset": [[OFFSET:[0-9]+]],
+// LAYOUT:      "FunctionID": 2,
+// LAYOUT-NEXT: "Offset": [[OFFSET]],
+// LAYOUT:      "FunctionID": 3,
+// LAYOUT-NEXT: "Offset": [[START]],
+
+// BAD: {{.*}}.bad:2: error: expected a function ID
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+"use strict";
+
+// Strings and numbers in JSON.parse, from ASCII and UTF-16 sources, with
+// tokens long enough to cross the chunks in which the input is converted.
+
+print('json-lexer');
+// CHECK-LABEL: json-lexer
+
+function parseBoth(text) {
+  var ascii = JSON.parse(text);
+  // Add a non-ASCII string to the source to parse it as UTF-16.
+  var utf16 = JSON.parse('["\u00e9",' + text + ']')[1];
+  return JSON.stringify(ascii) === JSON.stringify(utf16) ? ascii : 'MISMATCH';
+}
+
+print(parseBoth('"plain"'), parseBoth('"a\\"b\\\\c\\/d"'));
+// CHECK-NEXT: plain a"b\c/d
+print(JSON.stringify(parseBoth('"\\b\\f\\n\\r\\t\\u0041\\u00e9\\u20ac"')));
+// CHECK-NEXT: "\b\f\n\r\tAé€"
+var escaped = '["' + 'x'.repeat(40) + '\\n' + 'y'.repeat(40) + '"]';
+print(parseBoth(escaped)[0].length);
+// CHECK-NEXT: 81
+print(JSON.parse('"café \u{1F600}"'));
+// CHECK-NEXT: café 😀
+
+// Long strings, with escapes on both sides of the chunk boundaries.
+var long = '';
+for (var i = 0; i < 300; ++i) long += 'abc\\t' + i + '\\"';
+var parsed = parseBoth('{"k":"' + long + '","n":[' + long.length + ']}');
+print(parsed.k.length, parsed.n[0], parsed.k.slice(0, 12));
+// CHECK-NEXT: 2290 2890 abc	0"abc	1"
+var big = 'z'.repeat(3000);
+print(parseBoth('["' + big + '","' + big + '"]')[1] === big);
+// CHECK-NEXT: true
+
+// Invalid strings.
+function tryParse(text) {
+  try {
+    return JSON.parse(text);
+  } catch (e) {
+    return e.message;
+  }
+}
+print(tryParse('"abc\u0001"'));
+// CHECK-NEXT: JSON Parse error: U+0000 thru U+001F is not allowed in string
+print(tryParse('"' + 'a'.repeat(2000) + '\n"'));
+// CHECK-NEXT: JSON Parse error: U+0000 thru U+001F is not allowed in string
+print(tryParse('"abc'));
+// CHECK-NEXT: JSON Parse error: Unexpected end of input
+print(tryParse('"abc\\'));
+// CHECK-NEXT: JSON Parse error: Unexpected end of input
+print(tryParse('"\\u12"'));
+// CHECK-NEXT: JSON Parse error: Invalid unicode point character: "
+
+// Numbers, parsed exactly or through strtod.
+print(JSON.stringify(parseBoth(
+  '[0,-0,1,-1,42,9007199254740993,123456789012345678901,1.5,-0.25,3.14159]',
+)));
+// CHECK-NEXT: [0,0,1,-1,42,9007199254740992,123456789012345680000,1.5,-0.25,3.14159]
+print(1 / parseBoth('-0'), 1 / parseBoth('[-0.0]')[0]);
+// CHECK-NEXT: -Infinity -Infinity
+print(JSON.stringify(parseBoth(
+  '[1e22,1e23,1e-22,1e-23,2.5E+3,2.5e-3,1e0,0e5,0.1,0.2,0.30000000000000004]',
+)));
+// CHECK-NEXT: [1e+22,1e+23,1e-22,1e-23,2500,0.0025,1,0,0.1,0.2,0.30000000000000004]
+print(JSON.stringify(parseBoth(
+  '[1.7976931348623157e308,5e-324,1e400,-1e400,8.98846567431158e307]',
+)));
+// CHECK-NEXT: [1.7976931348623157e+308,5e-324,null,null,8.98846567431158e+307]
+print(parseBoth('[0.000001234567890123456789]')[0]);
+// CHECK-NEXT: 0.0000012345678901234567
+print(tryParse('01'), tryParse('1.'), tryParse('.5'), tryParse('-'));
+// CHECK-NEXT: JSON Parse error: Unexpected token in number: 1 1 JSON Parse error: Unexpected token: . JSON Parse error: Unexpected token in number: -
+print(tryParse('1e'), tryParse('1e+'), tryParse('+1'), tryParse('1.5.5'));
+// CHECK-NEXT: JSON Parse error: Unexpected token in number: e JSON Parse error: Unexpected token in number: e JSON Parse error: Unexpected token: + JSON Parse error: Unexpected token in number: .
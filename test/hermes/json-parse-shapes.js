@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+"use strict";
+
+// JSON.parse of arrays of records, which share their shapes, and of objects
+// whose keys differ in order, repeat or look like indexes.
+
+print('json-parse-shapes');
+// CHECK-LABEL: json-parse-shapes
+
+var records = JSON.parse(
+  '[{"id":1,"name":"a","tags":[]},{"id":2,"name":"b","tags":[1,2]},' +
+    '{"name":"c","id":3,"tags":null},{"id":4,"name":"d"},' +
+    '{"id":5,"name":"e","tags":[3],"extra":true}]',
+);
+print(records.length);
+// CHECK-NEXT: 5
+for (var r of records) {
+  print(Object.keys(r).join(), JSON.stringify(r));
+}
+// CHECK-NEXT: id,name,tags {"id":1,"name":"a","tags":[]}
+// CHECK-NEXT: id,name,tags {"id":2,"name":"b","tags":[1,2]}
+// CHECK-NEXT: name,id,tags {"name":"c","id":3,"tags":null}
+// CHECK-NEXT: id,name {"id":4,"name":"d"}
+// CHECK-NEXT: id,name,tags,extra {"id":5,"name":"e","tags":[3],"extra":true}
+
+// The objects are ordinary: they can be extended and modified.
+records[0].id = 10;
+records[0].more = 'x';
+delete records[1].name;
+print(JSON.stringify(records[0]), JSON.stringify(records[1]));
+// CHECK-NEXT: {"id":10,"name":"a","tags":[],"more":"x"} {"id":2,"tags":[1,2]}
+print(records[2].id, records[3].tags, records[4].extra);
+// CHECK-NEXT: 3 undefined true
+
+// Repeated keys keep the first position and the last value.
+var dup = JSON.parse('[{"a":1,"b":2},{"a":1,"b":2,"a":3},{"a":4,"b":5}]');
+print(JSON.stringify(dup));
+// CHECK-NEXT: [{"a":1,"b":2},{"a":3,"b":2},{"a":4,"b":5}]
+
+// Index-like keys are enumerated first.
+var idx = JSON.parse('[{"b":1,"2":2,"0":3},{"b":4,"2":5,"0":6}]');
+print(Object.keys(idx[0]).join(), Object.keys(idx[1]).join(), idx[1][0]);
+// CHECK-NEXT: 0,2,b 0,2,b 6
+
+// Keys that are not identifiers, and escaped keys.
+var odd = JSON.parse('{"":1,"a b":2,"\\u0041":3,"__proto__":4,"é":5}');
+print(Object.keys(odd).join('|'), odd[''], odd.A, odd.__proto__, odd['é']);
+// CHECK-NEXT: |a b|A|__proto__|é 1 3 4 5
+print(Object.getPrototypeOf(odd) === Object.prototype);
+// CHECK-NEXT: true
+
+// Objects too large to share their class.
+var big = {};
+for (var i = 0; i < 200; ++i) big['k' + i] = i;
+var bigs = JSON.parse(JSON.stringify([big, big]));
+print(Object.keys(bigs[1]).length, bigs[0].k0, bigs[1].k199);
+// CHECK-NEXT: 200 0 199
+
+// Nested arrays and objects.
+var nested = JSON.parse(
+  '{"a":{"x":[1,[2,[3]],{}],"y":{"z":{}}},"b":{"x":[],"y":null},"c":[]}',
+);
+print(JSON.stringify(nested));
+// CHECK-NEXT: {"a":{"x":[1,[2,[3]],{}],"y":{"z":{}}},"b":{"x":[],"y":null},"c":[]}
+print(nested.a.x.length, nested.a.x[1][1][0], Array.isArray(nested.c));
+// CHECK-NEXT: 3 3 true
+
+// Reviver.
+var revived = JSON.parse('[{"a":1,"b":2},{"a":3,"b":4}]', function(k, v) {
+  return typeof v === 'number' ? v * 10 : v;
+});
+print(JSON.stringify(revived));
+// CHECK-NEXT: [{"a":10,"b":20},{"a":30,"b":40}]
+
+// Errors in keys.
+try {
+  JSON.parse('[{"a":1},{"a":1,2:3}]');
+} catch (e) {
+  print(e.message);
+}
+// CHECK-NEXT: JSON Parse error: Expect a string key in JSON object
+try {
+  JSON.parse('{"a\\x":1}');
+} catch (e) {
+  print(e.message);
+}
+// CHECK-NEXT: JSON Parse error: Invalid escape sequence: x
@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+"use strict";
+
+// JSON.stringify of objects that share their shapes, and of objects and
+// prototypes that change while they are serialized.
+
+print('json-stringify-shapes');
+// CHECK-LABEL: json-stringify-shapes
+
+var records = [];
+for (var i = 0; i < 3; i++) {
+  records.push({id: i - 1, name: 'r' + i, ok: i === 1, score: i / 4});
+}
+print(JSON.stringify(records));
+// CHECK-NEXT: [{"id":-1,"name":"r0","ok":false,"score":0},{"id":0,"name":"r1","ok":true,"score":0.25},{"id":1,"name":"r2","ok":false,"score":0.5}]
+print(JSON.stringify(records.slice(0, 2), null, 2));
+// CHECK-NEXT: [
+// CHECK-NEXT:   {
+// CHECK-NEXT:     "id": -1,
+// CHECK-NEXT:     "name": "r0",
+// CHECK-NEXT:     "ok": false,
+// CHECK-NEXT:     "score": 0
+// CHECK-NEXT:   },
+// CHECK-NEXT:   {
+// CHECK-NEXT:     "id": 0,
+// CHECK-NEXT:     "name": "r1",
+// CHECK-NEXT:     "ok": true,
+// CHECK-NEXT:     "score": 0.25
+// CHECK-NEXT:   }
+// CHECK-NEXT: ]
+
+print('numbers');
+// CHECK-LABEL: numbers
+print(JSON.stringify([0, -0, 7, -2147483648, 2147483647, 2147483648, 1e21,
+                      -1.5e-7, NaN, Infinity, new Number(12)]));
+// CHECK-NEXT: [0,0,7,-2147483648,2147483647,2147483648,1e+21,-1.5e-7,null,null,12]
+
+print('strings');
+// CHECK-LABEL: strings
+var escaped = 'a"b\\c\n\u0001\u001f' + 'x'.repeat(20) + '"';
+print(JSON.stringify({s: escaped, 'k"ey': 1}));
+// CHECK-NEXT: {"s":"a\"b\\c\n\u0001\u001fxxxxxxxxxxxxxxxxxxxx\"","k\"ey":1}
+print(JSON.stringify([{v: 'plain'}, {v: 'café "au lait"'}, {v: 'after'}]));
+// CHECK-NEXT: [{"v":"plain"},{"v":"café \"au lait\""},{"v":"after"}]
+print(JSON.stringify({'été': '€', b: 'x'}));
+// CHECK-NEXT: {"été":"€","b":"x"}
+
+print('skipped');
+// CHECK-LABEL: skipped
+var withHidden = {a: 1, f: function() {}, u: undefined, b: 2};
+Object.defineProperty(withHidden, 'hidden', {value: 3, enumerable: false});
+withHidden[Symbol('s')] = 4;
+print(JSON.stringify([withHidden, withHidden]));
+// CHECK-NEXT: [{"a":1,"b":2},{"a":1,"b":2}]
+print(JSON.stringify({b: 1, 2: 'two', a: 3, 1: 'one'}));
+// CHECK-NEXT: {"1":"one","2":"two","b":1,"a":3}
+var noProto = Object.create(null);
+noProto.x = 1;
+print(JSON.stringify([noProto, noProto]));
+// CHECK-NEXT: [{"x":1},{"x":1}]
+
+print('accessors');
+// CHECK-LABEL: accessors
+var calls = 0;
+var getters = [];
+for (var i = 0; i < 2; i++) {
+  getters.push({
+    a: i,
+    get b() {
+      return ++calls;
+    },
+  });
+}
+print(JSON.stringify(getters), calls);
+// CHECK-NEXT: [{"a":0,"b":1},{"a":1,"b":2}] 2
+
+print('toJSON');
+// CHECK-LABEL: toJSON
+var dated = [{a: 1}, {a: 2, toJSON: function(key) { return 'own ' + key; }}];
+print(JSON.stringify(dated));
+// CHECK-NEXT: [{"a":1},"own 1"]
+function Point(x) {
+  this.x = x;
+}
+Point.prototype.toJSON = function() {
+  return 'P' + this.x;
+};
+print(JSON.stringify([{x: 0}, new Point(1), {x: 2}]));
+// CHECK-NEXT: [{"x":0},"P1",{"x":2}]
+
+// Object.prototype gains a toJSON method in the middle of a serialization.
+var sneaky = [
+  {n: 1},
+  {
+    toJSON: function() {
+      Object.prototype.toJSON = function() {
+        return 'proto';
+      };
+      return 'added';
+    },
+  },
+  {n: 2},
+];
+print(JSON.stringify(sneaky));
+// CHECK-NEXT: [{"n":1},"added","proto"]
+delete Object.prototype.toJSON;
+print(JSON.stringify({n: 3}));
+// CHECK-NEXT: {"n":3}
+
+print('mutation');
+// CHECK-LABEL: mutation
+// toJSON methods of property values that delete, change and add properties
+// of the object being serialized.
+function mutating(obj) {
+  obj.a = {
+    toJSON: function() {
+      delete obj.b;
+      obj.c = 'changed';
+      obj.d = 'added';
+      return 'a';
+    },
+  };
+  return obj;
+}
+print(JSON.stringify([
+  {a: 0, b: 1, c: 2},
+  mutating({a: 0, b: 1, c: 2}),
+  {a: 0, b: 1, c: 2},
+]));
+// CHECK-NEXT: [{"a":0,"b":1,"c":2},{"a":"a","c":"changed"},{"a":0,"b":1,"c":2}]
+var getterTarget = {a: 1, b: 2};
+var viaGetter = {
+  get first() {
+    Object.defineProperty(getterTarget, 'b', {
+      get: function() {
+        return 'got';
+      },
+      enumerable: true,
+    });
+    return 'first';
+  },
+};
+print(JSON.stringify([{a: 1, b: 2}, viaGetter, getterTarget]));
+// CHECK-NEXT: [{"a":1,"b":2},{"first":"first"},{"a":1,"b":"got"}]
+// The lookup of toJSON itself changes the object, through a getter on
+// Object.prototype and through a proxy in the prototype chain.
+Object.defineProperty(Object.prototype, 'toJSON', {
+  get: function() {
+    if (this.a === 1) {
+      delete this.a;
+      this.z = 'added';
+    }
+  },
+  configurable: true,
+});
+print(JSON.stringify({a: 1, b: 2}));
+// CHECK-NEXT: {"b":2,"z":"added"}
+delete Object.prototype.toJSON;
+var proxied = {a: 1, b: 2};
+Object.setPrototypeOf(
+  proxied,
+  new Proxy(
+    {},
+    {
+      get: function(target, key, receiver) {
+        if (key === 'toJSON' && receiver.a === 1) {
+          receiver.a = 5;
+          receiver.q = 9;
+        }
+        return undefined;
+      },
+    },
+  ),
+);
+print(JSON.stringify([{a: 1, b: 2}, proxied]));
+// CHECK-NEXT: [{"a":1,"b":2},{"a":5,"b":2,"q":9}]
+
+print('replacer');
+// CHECK-LABEL: replacer
+print(JSON.stringify([{a: 1, b: 2}, {a: 3, b: 4}], ['b']));
+// CHECK-NEXT: [{"b":2},{"b":4}]
+print(JSON.stringify([{a: 1, b: 2}], function(k, v) {
+  return k === 'a' ? undefined : v;
+}));
+// CHECK-NEXT: [{"b":2}]
+
+print('many shapes');
+// CHECK-LABEL: many shapes
+var shapes = [];
+for (var i = 0; i < 40; i++) {
+  var o = {};
+  o['k' + i] = i;
+  shapes.push(o, o);
+}
+var text = JSON.stringify(shapes);
+print(text.length, text.slice(0, 30), text.slice(-30));
+// CHECK-NEXT: 841 [{"k0":0},{"k0":0},{"k1":1},{" 38":38},{"k39":39},{"k39":39}]
+
+var cyclic = {a: {}};
+cyclic.a.b = cyclic;
+try {
+  JSON.stringify([cyclic, cyclic]);
+} catch (e) {
+  print(e.name, e.message);
+}
+// CHECK-NEXT: TypeError cyclical structure in JSON object
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -gc-sanitize-handles=1 %s | %FileCheck --match-full-lines %s
+"use strict";
+
+// Long substrings reference the characters of the original string instead of
+// copying them.
+
+print('sliced-string');
+// CHECK-LABEL: sliced-string
+
+var digits = '';
+for (var i = 0; i < 100; ++i)
+  digits += i % 10;
+var big = digits + digits + digits + digits + digits;
+
+var s = big.slice(7, 407);
+print(s.length, s.charAt(0), s.charAt(399), s === big.substring(7, 407));
+// CHECK-NEXT: 400 7 6 true
+var t = s.substr(3, 300);
+print(t.length, t.charAt(0), t.charAt(299), t === big.substr(10, 300));
+// CHECK-NEXT: 300 0 9 true
+print(t.slice(0, 10), t.slice(-10));
+// CHECK-NEXT: 0123456789 0123456789
+
+// Slices of concatenated strings.
+var cat = big;
+for (var i = 0; i < 4; ++i)
+  cat += 'x';
+var c = cat.slice(200);
+print(c.length, c.slice(-6));
+// CHECK-NEXT: 304 89xxxx
+
+// Property keys and comparisons.
+var obj = {};
+obj[s] = 1;
+print(obj[big.slice(7, 407)], s < t, s.indexOf(t.slice(0, 50)));
+// CHECK-NEXT: 1 false 3
+
+// trim and split.
+var padded = '   ' + big + '   ';
+var trimmed = padded.trim();
+print(trimmed.length, trimmed === big);
+// CHECK-NEXT: 500 true
+var parts = (big + ',' + big.slice(100) + ',x').split(',');
+print(parts.length, parts[0] === big, parts[1].length, parts[2]);
+// CHECK-NEXT: 3 true 400 x
+
+// UTF-16.
+var u = big + '\u1234';
+var us = u.slice(250);
+print(us.length, us.charCodeAt(us.length - 1).toString(16), us.slice(0, 3));
+// CHECK-NEXT: 251 1234 012
+
+// Repeatedly slicing keeps the contents.
+var r = big;
+while (r.length > 300)
+  r = r.slice(1);
+print(r.length, r.slice(0, 5), r.slice(-5));
+// CHECK-NEXT: 300 01234 56789
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+"use strict";
+
+// Case conversion and trimming of ASCII and UTF-16 strings, long enough to
+// exercise the vector paths.
+
+print('string-case-trim');
+// CHECK-LABEL: string-case-trim
+
+var mixed = 'The Quick Brown Fox Jumps Over The Lazy Dog @[`{ ';
+print(mixed.toUpperCase());
+// CHECK-NEXT: THE QUICK BROWN FOX JUMPS OVER THE LAZY DOG @[`{
+print(mixed.toLowerCase());
+// CHECK-NEXT: the quick brown fox jumps over the lazy dog @[`{
+var upper = 'ALREADY UPPER CASE, WITH 0123456789 AND PUNCTUATION!';
+print(upper.toUpperCase() === upper, 'x'.toUpperCase(), 'Q'.toLowerCase());
+// CHECK-NEXT: true X q
+print(''.toUpperCase().length, '12345678901234567890'.toLowerCase());
+// CHECK-NEXT: 0 12345678901234567890
+
+// UTF-16 strings, with and without non-ASCII characters.
+var utf16 = 'Straße und GRÜßE, Σισύφος';
+print(utf16.toUpperCase());
+// CHECK-NEXT: STRASSE UND GRÜSSE, ΣΙΣΎΦΟΣ
+print(utf16.toLowerCase());
+// CHECK-NEXT: straße und grüße, σισύφος
+var ascii16 = ('Ā Mixed Case ASCII In A UTF-16 String').substring(2);
+print(ascii16.toUpperCase(), ascii16.toLowerCase());
+// CHECK-NEXT: MIXED CASE ASCII IN A UTF-16 STRING mixed case ascii in a utf-16 string
+
+// Trimming.
+var spaces = ' \t\n\v\f\r '.repeat(5);
+var word = 'word in the middle';
+function show(s) {
+  return '[' + s + '] ' + s.length;
+}
+print(show((spaces + word + spaces).trim()));
+// CHECK-NEXT: [word in the middle] 18
+print((spaces + word + spaces).trimStart().length);
+// CHECK-NEXT: 53
+print((spaces + word + spaces).trimEnd().length);
+// CHECK-NEXT: 53
+print(show(spaces.trim()), show(spaces.trimStart()), show(spaces.trimEnd()));
+// CHECK-NEXT: [] 0 [] 0 [] 0
+print(show('x'.trim()), show(' x '.trim()), show(''.trim()));
+// CHECK-NEXT: [x] 1 [x] 1 [] 0
+var uspaces = spaces + '\u2000\u00a0\ufeff\u2028\u3000' + spaces;
+print(show((uspaces + word + '\u1680' + uspaces).trim()));
+// CHECK-NEXT: [word in the middle] 18
+print((uspaces + '\u00e9' + word + uspaces).trimStart().length);
+// CHECK-NEXT: 94
+print((uspaces + word + '\u00e9' + uspaces).trimEnd().length);
+// CHECK-NEXT: 94
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+"use strict";
+
+// Substring search with short and long needles, over ASCII and UTF-16
+// strings.
+
+print('string-search');
+// CHECK-LABEL: string-search
+
+var abc = 'abcdefghijklmnopqrstuvwxyz'.repeat(4);
+var hay = abc + 'hello' + abc + 'hello' + abc;
+print(hay.indexOf('hello'), hay.lastIndexOf('hello'), hay.indexOf('haaal'));
+// CHECK-NEXT: 104 213 -1
+print(hay.indexOf('hello', 105), hay.lastIndexOf('hello', 212));
+// CHECK-NEXT: 213 104
+print(hay.indexOf('z'), hay.lastIndexOf('a'), hay.indexOf('a', 1));
+// CHECK-NEXT: 25 296 26
+print(hay.indexOf(''), hay.indexOf('', 5), hay.indexOf('', 1000));
+// CHECK-NEXT: 0 5 322
+print(hay.lastIndexOf(''), hay.lastIndexOf('', 5), 'aa'.lastIndexOf('', 1));
+// CHECK-NEXT: 322 5 1
+print(hay.lastIndexOf('abc', 0), hay.lastIndexOf('bcd', 0));
+// CHECK-NEXT: 0 -1
+
+// Long needles.
+var needle = abc.slice(3) + 'hello' + 'abc';
+print(needle.length, hay.indexOf(needle), hay.lastIndexOf(needle));
+// CHECK-NEXT: 109 3 112
+print(hay.indexOf(needle + 'x'), hay.includes(needle, 4));
+// CHECK-NEXT: -1 true
+print(hay.indexOf(hay), hay.indexOf(hay + 'a'), hay.lastIndexOf(hay));
+// CHECK-NEXT: 0 -1 0
+
+// UTF-16 haystacks and needles.
+var uhay = 'ābc'.repeat(20) + 'šx' + 'ɡx'.repeat(20);
+print(uhay.indexOf('ɡx'), uhay.lastIndexOf('ābc'), uhay.indexOf('ax'));
+// CHECK-NEXT: 62 57 -1
+print(uhay.indexOf('bc'), uhay.lastIndexOf('x'), uhay.includes('cš'));
+// CHECK-NEXT: 1 101 true
+var uneedle = 'x' + 'ɡx'.repeat(19);
+print(uhay.indexOf(uneedle), uhay.indexOf('š' + uneedle));
+// CHECK-NEXT: 61 60
+print(uhay.indexOf('x'.repeat(40)), hay.indexOf('ā'));
+// CHECK-NEXT: -1 -1
+// An ASCII needle stored as UTF-16.
+var wide = 'helā'.slice(0, 3) + 'lo';
+print(hay.indexOf(wide), hay.lastIndexOf(wide), uhay.indexOf('bcā'));
+// CHECK-NEXT: 104 213 1
+
+// split, replace and replaceAll.
+var parts = hay.split('hello');
+print(parts.length, parts[0] === abc, parts[2] === abc);
+// CHECK-NEXT: 3 true true
+print(uhay.split('ɡ').length, 'a,b,,c'.split(',').join('|'));
+// CHECK-NEXT: 21 a|b||c
+print(hay.replace('hello', '!').length, hay.replaceAll('hello', '!').length);
+// CHECK-NEXT: 318 314
+print(hay.replaceAll(needle, '').length, 'aaaa'.replaceAll('aa', 'b'));
+// CHECK-NEXT: 104 bb
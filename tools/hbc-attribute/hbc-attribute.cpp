@@ -505,6 +505,11 @@ bool attribute(
     return false;
   }
   std::shared_ptr<BCProvider> bc = std::move(ret.first);
+  if (bc->getBytecodeOptions().compressedBytecode) {
+    // Function bodies have no offsets in the file to attribute bytes to.
+    llvh::errs() << "Compressed bytecode is not supported\n";
+    return false;
+  }
 
   // TODO: Add records for the bytecode header and similar.
   UsageCounter counter(bc, emitter, getVirtualOffsets(bc), bundleStart);
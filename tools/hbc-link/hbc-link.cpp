@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Links bytecode object units into one bytecode file. Each unit holds the
+// CommonJS modules of one or more source files, compiled separately with
+// `hermesc -emit-binary -commonjs -object-unit`, so that after a change only
+// the units of the changed modules need to be compiled again. The first module
+// of the first unit is the entry point.
+
+#include "llvh/Support/CommandLine.h"
+#include "llvh/Support/FileSystem.h"
+#include "llvh/Support/InitLLVM.h"
+#include "llvh/Support/MemoryBuffer.h"
+#include "llvh/Support/PrettyStackTrace.h"
+#include "llvh/Support/SHA1.h"
+#include "llvh/Support/Signals.h"
+#include "llvh/Support/raw_ostream.h"
+
+#include "hermes/BCGen/HBC/BytecodeDataProvider.h"
+#include "hermes/BCGen/HBC/BytecodeLinker.h"
+#include "hermes/BCGen/HBC/BytecodeStream.h"
+#include "hermes/Support/MemoryBuffer.h"
+
+#include <string>
+#include <vector>
+
+using namespace hermes;
+
+namespace {
+
+llvh::cl::list<std::string> InputFilenames(
+    llvh::cl::Positional,
+    llvh::cl::OneOrMore,
+    llvh::cl::desc("<object units>"));
+
+llvh::cl::opt<std::string> OutputFilename(
+    "out",
+    llvh::cl::Required,
+    llvh::cl::desc("Output bytecode file"));
+
+llvh::cl::opt<bool> Optimize(
+    "O",
+    llvh::cl::init(false),
+    llvh::cl::desc("Pack the string table, which takes longer"));
+
+llvh::cl::opt<bool> StripDebugInfo(
+    "strip-debug-info",
+    llvh::cl::init(false),
+    llvh::cl::desc("Don't keep the debug info of the units"));
+
+} // namespace
+
+int main(int argc, char **argv) {
+  // Normalize the arg vector.
+  llvh::InitLLVM initLLVM(argc, argv);
+  llvh::sys::PrintStackTraceOnErrorSignal("hbc-link");
+  llvh::PrettyStackTraceProgram X(argc, argv);
+  llvh::llvm_shutdown_obj Y;
+  llvh::cl::ParseCommandLineOptions(
+      argc, argv, "Hermes bytecode object unit linker\n");
+
+  std::vector<std::unique_ptr<llvh::MemoryBuffer>> buffers;
+  std::vector<std::unique_ptr<hbc::BCProviderFromBuffer>> providers;
+  std::vector<const hbc::BCProviderBase *> units;
+  // The linked file is identified by the sources of all its units.
+  llvh::SHA1 hasher;
+  for (const std::string &fileName : InputFilenames) {
+    auto bufOrErr = llvh::MemoryBuffer::getFile(fileName);
+    if (!bufOrErr) {
+      llvh::errs() << "Error: fail to open file: " << fileName << ": "
+                   << bufOrErr.getError().message() << "\n";
+      return 1;
+    }
+    auto ret = hbc::BCProviderFromBuffer::createBCProviderFromBuffer(
+        std::make_unique<MemoryBuffer>(bufOrErr.get().get()));
+    if (!ret.first) {
+      llvh::errs() << fileName << ": " << ret.second << "\n";
+      return 1;
+    }
+    SHA1 unitHash = ret.first->getSourceHash();
+    hasher.update(llvh::ArrayRef<uint8_t>(unitHash.data(), unitHash.size()));
+    buffers.push_back(std::move(bufOrErr.get()));
+    units.push_back(ret.first.get());
+    providers.push_back(std::move(ret.first));
+  }
+
+  BytecodeGenerationOptions options{EmitBundle};
+  options.optimizationEnabled = Optimize;
+  options.stripDebugInfoSection = StripDebugInfo;
+  std::string error;
+  auto BM = hbc::linkBytecodeUnits(units, options, &error);
+  if (!BM) {
+    // Errors name the unit by its position on the command line.
+    llvh::errs() << "Error: " << error << "\n";
+    for (unsigned i = 0; i < InputFilenames.size(); ++i) {
+      llvh::errs() << "  unit " << i << ": " << InputFilenames[i] << "\n";
+    }
+    return 1;
+  }
+
+  std::error_code EC;
+  llvh::raw_fd_ostream OS(OutputFilename, EC, llvh::sys::fs::F_None);
+  if (EC) {
+    llvh::errs() << "Error: fail to open file: " << OutputFilename << ": "
+                 << EC.message() << "\n";
+    return 1;
+  }
+  auto rawHash = hasher.final();
+  SHA1 sourceHash{};
+  std::copy(rawHash.begin(), rawHash.end(), sourceHash.begin());
+  hbc::BytecodeSerializer BS{OS, options};
+  BS.serialize(*BM, sourceHash);
+  return 0;
+}
@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Counts the pages of bytecode files that a function trace touches, to compare
+// the startup footprint of different layouts. The trace is a list of function
+// IDs, one per line, as written by `hvm -function-trace`.
+
+#include "llvh/ADT/BitVector.h"
+#include "llvh/ADT/StringRef.h"
+#include "llvh/Support/CommandLine.h"
+#include "llvh/Support/InitLLVM.h"
+#include "llvh/Support/MemoryBuffer.h"
+#include "llvh/Support/PrettyStackTrace.h"
+#include "llvh/Support/Signals.h"
+#include "llvh/Support/raw_ostream.h"
+
+#include "hermes/BCGen/HBC/BytecodeDataProvider.h"
+#include "hermes/BCGen/HBC/FunctionTrace.h"
+#include "hermes/Support/MemoryBuffer.h"
+#include "hermes/Support/OSCompat.h"
+
+#include <string>
+#include <vector>
+
+using namespace hermes;
+
+namespace {
+
+llvh::cl::list<std::string> InputFilenames(
+    llvh::cl::Positional,
+    llvh::cl::OneOrMore,
+    llvh::cl::desc("<bytecode files>"));
+
+llvh::cl::opt<std::string> TraceFilename(
+    "trace",
+    llvh::cl::Required,
+    llvh::cl::desc("File with the IDs of the functions that ran, one per line"));
+
+llvh::cl::opt<unsigned> PageSize(
+    "page-size",
+    llvh::cl::init(0),
+    llvh::cl::desc("Page size in bytes (default: the system page size)"));
+
+/// Read the function IDs in \p fileName into \p ids.
+/// \return false and print an error if the file is malformed.
+bool readTrace(llvh::StringRef fileName, std::vector<uint32_t> &ids) {
+  auto bufOrErr = llvh::MemoryBuffer::getFileOrSTDIN(fileName);
+  if (!bufOrErr) {
+    llvh::errs() << "Error: fail to open file: " << fileName << ": "
+                 << bufOrErr.getError().message() << "\n";
+    return false;
+  }
+  return hbc::parseFunctionTrace(bufOrErr.get()->getBuffer(), fileName, ids);
+}
+
+/// Records the pages that a range of bytes in a file of \p fileSize spans.
+class PageSet {
+ public:
+  PageSet(size_t fileSize, size_t pageSize)
+      : pageSize_(pageSize), pages_((fileSize + pageSize - 1) / pageSize) {}
+
+  void mark(size_t offset, size_t size) {
+    if (size == 0 || offset >= pages_.size() * pageSize_) {
+      return;
+    }
+    size_t last = std::min(offset + size - 1, pages_.size() * pageSize_ - 1);
+    pages_.set(offset / pageSize_, last / pageSize_ + 1);
+  }
+
+  size_t numPages() const {
+    return pages_.size();
+  }
+  size_t numTouched() const {
+    return pages_.count();
+  }
+
+ private:
+  size_t pageSize_;
+  llvh::BitVector pages_;
+};
+
+/// Print the pages of \p fileName touched by running the functions in
+/// \p trace. \return false if the file can't be loaded.
+bool countPages(
+    const std::string &fileName,
+    llvh::ArrayRef<uint32_t> trace,
+    size_t pageSize) {
+  auto bufOrErr = llvh::MemoryBuffer::getFile(fileName);
+  if (!bufOrErr) {
+    llvh::errs() << "Error: fail to open file: " << fileName << ": "
+                 << bufOrErr.getError().message() << "\n";
+    return false;
+  }
+  auto ret = hbc::BCProviderFromBuffer::createBCProviderFromBuffer(
+      std::make_unique<MemoryBuffer>(bufOrErr.get().get()));
+  if (!ret.first) {
+    llvh::errs() << fileName << ": " << ret.second << "\n";
+    return false;
+  }
+  const hbc::BCProviderFromBuffer &bc = *ret.first;
+  if (bc.getBytecodeOptions().compressedBytecode) {
+    llvh::errs() << fileName << ": compressed bytecode is not supported\n";
+    return false;
+  }
+  const uint8_t *base = bc.getRawBuffer().data();
+  auto offsetOf = [base](const void *p) {
+    return static_cast<const uint8_t *>(p) - base;
+  };
+
+  PageSet bytecode{bc.getRawBuffer().size(), pageSize};
+  PageSet info{bc.getRawBuffer().size(), pageSize};
+  uint32_t numTraced = 0;
+  for (uint32_t id : trace) {
+    if (id >= bc.getFunctionCount()) {
+      continue;
+    }
+    ++numTraced;
+    auto header = bc.getFunctionHeader(id);
+    bytecode.mark(header.offset(), header.bytecodeSizeInBytes());
+    // The info holds the large header, if any, followed by the exception
+    // table and the debug offsets, which are read when the function is
+    // first loaded or throws.
+    const hbc::SmallFuncHeader &small = bc.getSmallFunctionHeaders()[id];
+    if (small.flags.overflowed) {
+      info.mark(small.getLargeHeaderOffset(), sizeof(hbc::FunctionHeader));
+    }
+    auto exceptions = bc.getExceptionTable(id);
+    info.mark(
+        offsetOf(exceptions.data()),
+        exceptions.size() * sizeof(hbc::HBCExceptionHandlerInfo));
+    if (const hbc::DebugOffsets *debugOffsets = bc.getDebugOffsets(id)) {
+      info.mark(offsetOf(debugOffsets), sizeof(hbc::DebugOffsets));
+    }
+  }
+
+  llvh::outs() << fileName << ": " << numTraced << " of "
+               << bc.getFunctionCount() << " functions traced, "
+               << bytecode.numPages() << " pages\n"
+               << "  Bytecode pages touched: " << bytecode.numTouched() << "\n"
+               << "  Function info pages touched: " << info.numTouched()
+               << "\n";
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  // Normalize the arg vector.
+  llvh::InitLLVM initLLVM(argc, argv);
+  llvh::sys::PrintStackTraceOnErrorSignal("hbc-pages");
+  llvh::PrettyStackTraceProgram X(argc, argv);
+  llvh::llvm_shutdown_obj Y;
+  llvh::cl::ParseCommandLineOptions(
+      argc, argv, "Hermes bytecode page footprint tool\n");
+
+  std::vector<uint32_t> trace;
+  if (!readTrace(TraceFilename, trace)) {
+    return 1;
+  }
+  size_t pageSize = PageSize ? PageSize : oscompat::page_size();
+  for (const std::string &fileName : InputFilenames) {
+    if (!countPages(fileName, trace, pageSize)) {
+      return 1;
+    }
+  }
+  return 0;
+}
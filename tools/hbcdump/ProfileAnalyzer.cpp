@@ -648,6 +648,9 @@ void ProfileAnalyzer::dumpIO() {
     os_ << "This command requires trace profile to run (-profile-file).\n";
     return;
   }
+  if (!hasFileOffsets()) {
+    return;
+  }
   uint32_t pageSize = profileDataOpt_.getValue().pageSize;
   auto &executionInfo = profileDataOpt_.getValue().executionInfo;
   auto bcProvider = hbcParser_.getBCProvider();
@@ -904,9 +907,20 @@ llvh::Optional<uint32_t> ProfileAnalyzer::getFunctionFromVirtualOffset(
   return llvh::None;
 }
 
+bool ProfileAnalyzer::hasFileOffsets() {
+  if (hbcParser_.getBCProvider()->getBytecodeOptions().compressedBytecode) {
+    os_ << "This command does not support compressed bytecode.\n";
+    return false;
+  }
+  return true;
+}
+
 llvh::Optional<uint32_t> ProfileAnalyzer::getFunctionFromOffset(
     uint32_t offset) {
   auto *bcProvider = hbcParser_.getBCProvider().get();
+  assert(
+      !bcProvider->getBytecodeOptions().compressedBytecode &&
+      "function bodies have no file offsets");
   uint32_t funcCount = bcProvider->getFunctionCount();
 
   for (uint32_t i = 0; i < funcCount; ++i) {
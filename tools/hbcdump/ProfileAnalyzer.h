@@ -172,7 +172,12 @@ class ProfileAnalyzer {
 
   /// \return the ID of the function, if any, found at a given offset from the
   /// start of the file.
+  /// \pre hasFileOffsets().
   llvh::Optional<uint32_t> getFunctionFromOffset(uint32_t offset);
+
+  /// \return true if function bodies are stored at offsets in the file, which
+  /// is not the case for compressed bytecode. Otherwise, print an error.
+  bool hasFileOffsets();
 };
 
 } // namespace hermes
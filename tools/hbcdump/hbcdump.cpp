@@ -417,6 +417,9 @@ static bool executeCommand(
         os << "Error: cannot parse offset as integer.\n";
         return false;
       }
+      if (!analyzer.hasFileOffsets()) {
+        return false;
+      }
       auto funcId = analyzer.getFunctionFromOffset(offset);
       if (funcId.hasValue()) {
         analyzer.dumpFunctionInfo(*funcId, json);
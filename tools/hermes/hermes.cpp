@@ -110,6 +110,8 @@ static int executeHBCBytecodeFromCL(
           .withEnableSampleProfiling(cl::SampleProfiling)
           .withRandomizeMemoryLayout(cl::RandomizeMemoryLayout)
           .withTrackIO(cl::TrackBytecodeIO)
+          .withEnableJSPerfMap(cl::PerfMap)
+          .withBackgroundLazyCompilation(cl::BackgroundLazyCompilation)
           .withEnableHermesInternal(cl::EnableHermesInternal)
           .withEnableHermesInternalTestMethods(
               cl::EnableHermesInternalTestMethods)
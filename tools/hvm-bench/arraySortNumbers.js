@@ -0,0 +1,29 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * @format
+ */
+
+(function() {
+  var numIter = 200;
+  var len = 1000;
+  var src = [];
+  var seed = 1;
+  for (var i = 0; i < len; i++) {
+    seed = (seed * 16807) % 2147483647;
+    src.push(seed % 100000 - 50000);
+  }
+
+  var sum = 0;
+  for (var i = 0; i < numIter; i++) {
+    // Sorted with the default comparison, by the strings of the numbers.
+    var a = src.slice();
+    a.sort();
+    sum += a[i % len];
+  }
+
+  print('done, sum =', sum);
+})();
@@ -0,0 +1,28 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * @format
+ */
+
+(function() {
+  var numIter = 100;
+  var numbers = [];
+  var strings = [];
+  for (var i = 0; i < 2000; i++) {
+    numbers.push(i, -i * 7, i / 8, i * 1000.25);
+    strings.push(
+      'Lorem ipsum dolor sit amet, consectetur adipiscing elit ' + i,
+      'line ' + i + '\n\t"quoted"',
+    );
+  }
+  var text = JSON.stringify({numbers: numbers, strings: strings});
+
+  for (var i = 0; i < numIter; i++) {
+    JSON.parse(text);
+  }
+
+  print('done');
+})();
@@ -0,0 +1,32 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * @format
+ */
+
+(function() {
+  var numIter = 100;
+  var records = [];
+  for (var i = 0; i < 1000; i++) {
+    records.push({
+      id: i,
+      name: 'user' + i,
+      email: 'user' + i + '@example.com',
+      active: i % 2 === 0,
+      score: i * 1.5,
+      tags: ['a', 'b'],
+      address: {street: 'Main St', city: 'Springfield', zip: '12345'},
+    });
+  }
+  var state = {data: records, count: records.length};
+
+  var length = 0;
+  for (var i = 0; i < numIter; i++) {
+    length += JSON.stringify(state).length;
+  }
+
+  print('done', length);
+})();
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+//===----------------------------------------------------------------------===//
+/// \file
+/// This benchmark measures the throughput of the JavaScript lexer on its own,
+/// without the parser, so that changes to the scanning loops (whitespace,
+/// comments, identifiers and strings) can be evaluated in isolation.
+///
+/// It tokenizes the given source files, or a generated source with long
+/// indentation, comments, identifiers and strings when none are given, and
+/// reports the number of tokens and megabytes lexed per second.
+///
+/// The lexer needs to know whether a '/' starts a regexp, which is normally
+/// decided by the parser. This uses the usual approximation based on the
+/// previous token, which is exact for the generated source.
+//===----------------------------------------------------------------------===//
+#include "hermes/Parser/JSLexer.h"
+#include "hermes/Support/SourceErrorManager.h"
+
+#include "llvh/Support/CommandLine.h"
+#include "llvh/Support/Format.h"
+#include "llvh/Support/ManagedStatic.h"
+#include "llvh/Support/MemoryBuffer.h"
+#include "llvh/Support/PrettyStackTrace.h"
+#include "llvh/Support/Signals.h"
+#include "llvh/Support/raw_ostream.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+using namespace hermes;
+using namespace hermes::parser;
+
+static llvh::cl::list<std::string> InputFiles{
+    llvh::cl::Positional,
+    llvh::cl::desc("<input JS files>")};
+static llvh::cl::opt<unsigned> Repeat{
+    "repeat",
+    llvh::cl::init(20),
+    llvh::cl::desc("Number of times to lex each input")};
+
+namespace {
+
+/// \return a source that exercises every bulk-scanned construct.
+std::string generateSource() {
+  std::string src;
+  for (unsigned i = 0; i < 20000; ++i) {
+    src += "        // Compute the next value of the accumulator for item.\n";
+    src += "        /* A block comment that spans\n";
+    src += "           more than a single line. */\n";
+    src += "        const someLongIdentifierName" + std::to_string(i) +
+        " = anotherQuiteLongIdentifier.propertyName;\n";
+    src += "        message = 'a moderately long string literal value' + \"";
+    src += std::to_string(i) + " another string with some words\";\n";
+  }
+  return src;
+}
+
+/// Lex \p buffer to the end. \return the number of tokens.
+size_t lex(llvh::MemoryBufferRef buffer) {
+  SourceErrorManager sm;
+  JSLexer::Allocator alloc;
+  JSLexer lexer(buffer, sm, alloc);
+  size_t numTokens = 0;
+  JSLexer::GrammarContext grammarContext = JSLexer::AllowRegExp;
+  for (const Token *tok = lexer.advance(grammarContext);
+       tok->getKind() != TokenKind::eof;
+       tok = lexer.advance(grammarContext)) {
+    ++numTokens;
+    switch (tok->getKind()) {
+      case TokenKind::identifier:
+      case TokenKind::numeric_literal:
+      case TokenKind::string_literal:
+      case TokenKind::regexp_literal:
+      case TokenKind::r_paren:
+      case TokenKind::r_square:
+      case TokenKind::r_brace:
+        grammarContext = JSLexer::AllowDiv;
+        break;
+      default:
+        grammarContext = JSLexer::AllowRegExp;
+        break;
+    }
+  }
+  return numTokens;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  // Print a stack trace if we signal out.
+  llvh::sys::PrintStackTraceOnErrorSignal("Hermes lexer bench");
+  llvh::PrettyStackTraceProgram X(argc, argv);
+  // Call llvm_shutdown() on exit to print stats and free memory.
+  llvh::llvm_shutdown_obj Y;
+  llvh::cl::ParseCommandLineOptions(argc, argv, "Hermes lexer benchmark\n");
+
+  std::vector<std::unique_ptr<llvh::MemoryBuffer>> buffers;
+  if (InputFiles.empty()) {
+    buffers.push_back(llvh::MemoryBuffer::getMemBufferCopy(
+        generateSource(), "generated.js"));
+  }
+  for (const std::string &file : InputFiles) {
+    auto buffer = llvh::MemoryBuffer::getFile(file);
+    if (!buffer) {
+      llvh::errs() << "Error reading " << file << ": "
+                   << buffer.getError().message() << "\n";
+      return 1;
+    }
+    buffers.push_back(std::move(*buffer));
+  }
+
+  size_t numTokens = 0;
+  size_t numBytes = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (unsigned i = 0; i < Repeat; ++i) {
+    for (const auto &buffer : buffers) {
+      numTokens += lex(buffer->getMemBufferRef());
+      numBytes += buffer->getBufferSize();
+    }
+  }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  llvh::outs() << "Lexed " << numTokens << " tokens in "
+               << llvh::format("%.3f", elapsed.count()) << "s ("
+               << llvh::format("%.1f", numBytes / 1e6 / elapsed.count())
+               << " MB/s)\n";
+  return 0;
+}
@@ -0,0 +1,30 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * @format
+ */
+
+(function() {
+  var numIter = 500000;
+  var source = 'The Quick Brown Fox Jumps Over The Lazy Dog. '.repeat(8);
+  var lower = source.toLowerCase();
+  var padded = ' \t\n '.repeat(20) + source + ' \r\n '.repeat(20);
+
+  for (var i = 0; i < numIter; i++) {
+    source.toUpperCase();
+  }
+  for (var i = 0; i < numIter; i++) {
+    source.toLowerCase();
+  }
+  for (var i = 0; i < numIter; i++) {
+    lower.toLowerCase();
+  }
+  for (var i = 0; i < numIter; i++) {
+    padded.trim();
+  }
+
+  print('done');
+})();
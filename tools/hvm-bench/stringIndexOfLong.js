@@ -0,0 +1,26 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * @format
+ */
+
+// This benchmark tests searching a large string for a long needle.
+(function() {
+  var text = 'the quick brown fox jumps over the lazy dog, ';
+  var source = text.repeat(1000) + 'hello world' + text.repeat(1000);
+  var needle = text + 'hello world';
+  var numIter = 2000;
+
+  for (var i = 0; i < numIter; i++) {
+    source.indexOf(needle);
+  }
+
+  for (var i = 0; i < numIter; i++) {
+    source.indexOf(text + 'hello there');
+  }
+
+  print('done');
+})();
@@ -62,6 +62,13 @@ static llvh::cl::opt<bool> GCPrintStats(
     llvh::cl::cat(cl::GCCategory),
     llvh::cl::init(false));
 
+static llvh::cl::opt<std::string> FunctionTrace(
+    "function-trace",
+    llvh::cl::desc(
+        "Write the IDs of the functions that ran to this file, in the order "
+        "they first ran, for hermesc -function-order"),
+    llvh::cl::init(""));
+
 // This is the vm driver.
 int main(int argc, char **argv) {
   // Normalize the arg vector.
@@ -124,6 +131,7 @@ int main(int argc, char **argv) {
           .withES6Proxy(cl::ES6Proxy)
           .withIntl(cl::Intl)
           .withTrackIO(cl::TrackBytecodeIO)
+          .withEnableJSPerfMap(cl::PerfMap)
           .withEnableHermesInternal(cl::EnableHermesInternal)
           .withEnableHermesInternalTestMethods(
               cl::EnableHermesInternalTestMethods)
@@ -131,6 +139,7 @@ int main(int argc, char **argv) {
 
   options.stabilizeInstructionCount = cl::StableInstructionCount;
   options.stopAfterInit = cl::StopAfterInit;
+  options.functionTraceFile = FunctionTrace;
 #ifdef HERMESVM_PROFILER_EXTERN
   options.patchProfilerSymbols = cl::PatchProfilerSymbols;
   options.profilerSymbolsFile = cl::ProfilerSymbolsFile;
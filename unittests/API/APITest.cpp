@@ -8,6 +8,7 @@
 #include <gtest/gtest.h>
 #include <hermes/BCGen/HBC/BytecodeFileFormat.h>
 #include <hermes/CompileJS.h>
+#include <hermes/VM/SegmentPool.h>
 #include <hermes/hermes.h>
 
 using namespace facebook::jsi;
@@ -320,6 +321,31 @@ JSON.stringify(JSON.parse(out).callstack.map(x => x.SourceLocation));
   EXPECT_EQ(callstack, expected);
 }
 
+TEST(HermesRuntimeSegmentPoolTest, LimitsSetByHost) {
+  auto &pool = ::hermes::vm::SegmentPool::getInstance();
+  HermesRuntime::setSegmentPoolLimits(4, 1, 60000);
+  auto config = ::hermes::vm::RuntimeConfig::Builder()
+                    .withGCConfig(::hermes::vm::GCConfig::Builder()
+                                      .withUseSegmentPool(true)
+                                      .build())
+                    .build();
+  for (int i = 0; i < 2; ++i) {
+    auto rt = makeHermesRuntime(config);
+    auto buf = std::make_shared<StringBuffer>("[1, 2, 3].length");
+    EXPECT_EQ(3, rt->evaluateJavaScript(buf, "pool.js").getNumber());
+  }
+  // Runtimes that use the pool don't change its limits.
+  EXPECT_EQ(4u, pool.maxPooled());
+  EXPECT_EQ(1u, pool.maxResident());
+  EXPECT_EQ(std::chrono::milliseconds(60000), pool.idleTimeout());
+  EXPECT_LE(pool.numResident(), 1u);
+
+  pool.setLimits(
+      ::hermes::vm::SegmentPool::kDefaultMaxPooled,
+      ::hermes::vm::SegmentPool::kDefaultMaxResident,
+      ::hermes::vm::SegmentPool::kDefaultIdleTimeout);
+}
+
 TEST_F(HermesRuntimeTest, HostObjectWithOwnProperties) {
   class HostObjectWithPropertyNames : public HostObject {
     std::vector<PropNameID> getPropertyNames(Runtime &rt) override {
@@ -531,6 +557,126 @@ TEST_F(HermesRuntimeTest, GlobalObjectTest) {
   EXPECT_EQ(eval("f(10)").getNumber(), 15);
 }
 
+TEST_F(HermesRuntimeTest, JsonUtf8StreamTest) {
+  Value value = eval(
+      "var a = [];"
+      "for (var i = 0; i < 5000; ++i)"
+      "  a.push({id: i, name: 'item \\u00e9\\u20ac' + i, tags: ['x', i % 3]});"
+      "a");
+  std::string expected =
+      eval("JSON.stringify(a)").getString(*rt).utf8(*rt);
+
+  // The text is written out in several pieces.
+  std::string json;
+  size_t pieces = 0;
+  EXPECT_TRUE(
+      rt->writeValueAsJsonUtf8(value, [&](const char *data, size_t size) {
+        json.append(data, size);
+        ++pieces;
+      }));
+  EXPECT_EQ(expected, json);
+  EXPECT_GT(pieces, 1);
+
+  // Read it back in small pieces.
+  size_t pos = 0;
+  Value parsed =
+      rt->createValueFromJsonUtf8Stream([&](uint8_t *buffer, size_t size) {
+        size_t n = std::min<size_t>({size, 1000, json.size() - pos});
+        memcpy(buffer, json.data() + pos, n);
+        pos += n;
+        return n;
+      });
+  rt->global().setProperty(*rt, "parsed", parsed);
+  EXPECT_TRUE(eval("JSON.stringify(parsed) === JSON.stringify(a)").getBool());
+
+  // Values without a JSON representation write nothing.
+  EXPECT_FALSE(rt->writeValueAsJsonUtf8(
+      Value::undefined(), [&](const char *, size_t) { ++pieces; }));
+  EXPECT_FALSE(rt->writeValueAsJsonUtf8(
+      eval("(function() {})"), [&](const char *, size_t) { ++pieces; }));
+
+  // Errors surface as JSErrors.
+  std::string bad = "{\"a\": [1, 2,";
+  pos = 0;
+  EXPECT_THROW(
+      rt->createValueFromJsonUtf8Stream([&](uint8_t *buffer, size_t size) {
+        size_t n = std::min(size, bad.size() - pos);
+        memcpy(buffer, bad.data() + pos, n);
+        pos += n;
+        return n;
+      }),
+      JSError);
+  EXPECT_THROW(
+      rt->writeValueAsJsonUtf8(
+          eval("({toJSON() { throw new Error('no'); }})"),
+          [](const char *, size_t) {}),
+      JSError);
+}
+
+TEST_F(HermesRuntimeTest, JsonUtf8StreamPartialOutputTest) {
+  // Enough text is produced before the error that some of it has already
+  // been written out.
+  eval(
+      "var a = [];"
+      "for (var i = 0; i < 5000; ++i)"
+      "  a.push({id: i, name: 'item' + i});");
+  std::string json;
+  EXPECT_THROW(
+      rt->writeValueAsJsonUtf8(
+          eval("a.concat({toJSON() { throw new Error('no'); }})"),
+          [&](const char *data, size_t size) { json.append(data, size); }),
+      JSError);
+  EXPECT_FALSE(json.empty());
+  EXPECT_EQ('[', json.front());
+  EXPECT_NE(']', json.back());
+
+  json.clear();
+  EXPECT_THROW(
+      rt->writeValueAsJsonUtf8(
+          eval("var c = a.slice(); c.push({self: c}); c"),
+          [&](const char *data, size_t size) { json.append(data, size); }),
+      JSError);
+  EXPECT_FALSE(json.empty());
+  EXPECT_NE(']', json.back());
+}
+
+TEST_F(HermesRuntimeTest, JsonUtf8StreamCallbackThrowsTest) {
+  eval(
+      "var a = [];"
+      "for (var i = 0; i < 5000; ++i)"
+      "  a.push({id: i, name: 'item' + i});");
+
+  // An exception from write is rethrown once serialization has finished, and
+  // write is not called again.
+  size_t calls = 0;
+  EXPECT_THROW(
+      rt->writeValueAsJsonUtf8(
+          eval("a"),
+          [&](const char *, size_t) {
+            ++calls;
+            throw std::runtime_error("write failed");
+          }),
+      std::runtime_error);
+  EXPECT_EQ(1, calls);
+
+  // An exception from read ends the text and is rethrown instead of the
+  // resulting parse error.
+  calls = 0;
+  EXPECT_THROW(
+      rt->createValueFromJsonUtf8Stream([&](uint8_t *buffer, size_t size) {
+        if (calls++ > 0) {
+          throw std::runtime_error("read failed");
+        }
+        buffer[0] = '[';
+        return size_t(1);
+      }),
+      std::runtime_error);
+  EXPECT_EQ(2, calls);
+
+  // The runtime is still usable.
+  EXPECT_EQ(5000, eval("a.length").getNumber());
+}
+
 class HermesRuntimeTestWithDisableGenerator : public HermesRuntimeTestBase {
  public:
   HermesRuntimeTestWithDisableGenerator()
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/BCGen/HBC/CompileCache.h"
+
+#include "llvh/Support/FileSystem.h"
+#include "llvh/Support/raw_ostream.h"
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+
+using namespace hermes;
+using namespace hermes::hbc;
+
+namespace {
+
+class CompileCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_FALSE(
+        llvh::sys::fs::createUniqueDirectory("hermes-compile-cache", dir_));
+  }
+
+  void TearDown() override {
+    llvh::sys::fs::remove_directories(dir_);
+  }
+
+  /// Compile \p src through \p cache.
+  std::unique_ptr<BCProvider> compile(
+      CompileCache &cache,
+      llvh::StringRef src,
+      const CompileFlags &flags) {
+    auto res = cache.getOrCompile(
+        std::make_unique<Buffer>(
+            reinterpret_cast<const uint8_t *>(src.data()), src.size()),
+        "cached.js",
+        nullptr,
+        flags);
+    EXPECT_TRUE(res.first) << res.second;
+    return std::move(res.first);
+  }
+
+  llvh::SmallString<128> dir_;
+};
+
+// Sources must be NUL terminated, which string literals are.
+const char kSource[] =
+    "function outer() { return function inner() { return 1; }; }\n"
+    "outer()();";
+
+llvh::ArrayRef<uint8_t> sourceBytes() {
+  return {reinterpret_cast<const uint8_t *>(kSource), sizeof(kSource) - 1};
+}
+
+TEST_F(CompileCacheTest, StoresAndLoads) {
+  // Entries go in a directory that doesn't exist yet.
+  CompileCache cache{(dir_ + "/entries").str()};
+  CompileFlags flags;
+  flags.lazy = true;
+  flags.preemptiveFileCompilationThreshold = 0;
+  flags.preemptiveFunctionCompilationThreshold = 0;
+  SHA1 key = CompileCache::computeKey(sourceBytes(), "cached.js", flags);
+  EXPECT_FALSE(cache.load(key));
+
+  auto compiled = compile(cache, kSource, flags);
+  ASSERT_TRUE(compiled);
+  // The entry is compiled eagerly, so every function can be loaded from it.
+  EXPECT_EQ(3u, compiled->getFunctionCount());
+  for (uint32_t i = 0; i < compiled->getFunctionCount(); ++i) {
+    EXPECT_FALSE(compiled->isFunctionLazy(i));
+  }
+
+  auto loaded = cache.load(key);
+  ASSERT_TRUE(loaded);
+  EXPECT_EQ(compiled->getFunctionCount(), loaded->getFunctionCount());
+  EXPECT_EQ(llvh::SHA1::hash(sourceBytes()), loaded->getSourceHash());
+}
+
+TEST_F(CompileCacheTest, KeyCoversURLAndFlags) {
+  CompileFlags flags;
+  SHA1 key = CompileCache::computeKey(sourceBytes(), "cached.js", flags);
+  EXPECT_EQ(key, CompileCache::computeKey(sourceBytes(), "cached.js", flags));
+  EXPECT_NE(key, CompileCache::computeKey(sourceBytes(), "other.js", flags));
+  EXPECT_NE(
+      key,
+      CompileCache::computeKey(
+          sourceBytes().drop_back(), "cached.js", flags));
+
+  CompileFlags strictFlags;
+  strictFlags.strict = true;
+  EXPECT_NE(
+      key, CompileCache::computeKey(sourceBytes(), "cached.js", strictFlags));
+
+  // Entries are always compiled eagerly, so laziness doesn't matter.
+  CompileFlags lazyFlags;
+  lazyFlags.lazy = true;
+  EXPECT_EQ(
+      key, CompileCache::computeKey(sourceBytes(), "cached.js", lazyFlags));
+}
+
+TEST_F(CompileCacheTest, ReplacesCorruptEntries) {
+  CompileCache cache{dir_.str()};
+  CompileFlags flags;
+  SHA1 key = CompileCache::computeKey(sourceBytes(), "cached.js", flags);
+  ASSERT_TRUE(compile(cache, kSource, flags));
+  ASSERT_TRUE(cache.load(key));
+
+  // Truncate the entry.
+  {
+    std::error_code ec;
+    llvh::raw_fd_ostream os{cache.getEntryPath(key), ec};
+    ASSERT_FALSE(ec);
+    os << "not bytecode";
+  }
+  EXPECT_FALSE(cache.load(key));
+
+  ASSERT_TRUE(compile(cache, kSource, flags));
+  EXPECT_TRUE(cache.load(key));
+}
+
+TEST_F(CompileCacheTest, EvictsOldestEntries) {
+  CompileFlags flags;
+  // Sources of the same size, so that their entries are the same size too.
+  const char *sources[] = {
+      "function f() { return 1; }\nf();",
+      "function f() { return 2; }\nf();",
+      "function f() { return 3; }\nf();",
+  };
+  auto keyOf = [&flags](const char *src) {
+    return CompileCache::computeKey(
+        llvh::ArrayRef<uint8_t>(
+            reinterpret_cast<const uint8_t *>(src), strlen(src)),
+        "cached.js",
+        flags);
+  };
+
+  // Measure an entry in a cache of its own.
+  uint64_t entrySize;
+  {
+    CompileCache sizing{(dir_ + "/sizing").str()};
+    ASSERT_TRUE(compile(sizing, sources[0], flags));
+    ASSERT_FALSE(llvh::sys::fs::file_size(
+        sizing.getEntryPath(keyOf(sources[0])), entrySize));
+  }
+
+  // Room for two entries but not three.
+  uint64_t maxSize = entrySize * 5 / 2;
+  CompileCache cache{(dir_ + "/entries").str(), maxSize};
+  for (const char *src : sources) {
+    ASSERT_TRUE(compile(cache, src, flags));
+  }
+  // The entry that was just stored is never evicted.
+  EXPECT_TRUE(cache.load(keyOf(sources[2])));
+
+  unsigned numEntries = 0;
+  uint64_t totalSize = 0;
+  std::error_code ec;
+  for (llvh::sys::fs::directory_iterator it{dir_ + "/entries", ec}, end;
+       !ec && it != end;
+       it.increment(ec)) {
+    uint64_t size;
+    ASSERT_FALSE(llvh::sys::fs::file_size(it->path(), size));
+    ++numEntries;
+    totalSize += size;
+  }
+  ASSERT_FALSE(ec);
+  EXPECT_EQ(2u, numEntries);
+  EXPECT_LE(totalSize, maxSize);
+
+  // An entry larger than the whole cache is still kept until the next store.
+  CompileCache tiny{(dir_ + "/tiny").str(), 1};
+  ASSERT_TRUE(compile(tiny, sources[0], flags));
+  EXPECT_TRUE(tiny.load(keyOf(sources[0])));
+  ASSERT_TRUE(compile(tiny, sources[1], flags));
+  EXPECT_FALSE(tiny.load(keyOf(sources[0])));
+  EXPECT_TRUE(tiny.load(keyOf(sources[1])));
+}
+
+} // namespace
@@ -163,4 +163,69 @@ TEST(DebugInfo, TestGetAddress) {
   EXPECT_EQ(3u, result->functionIndex);
   EXPECT_EQ(2u, result->bytecodeOffset);
 }
+
+/// Check every address in [0, \p maxAddress] against a linear scan of \p
+/// locs, from the last address to the first so that long streams are indexed
+/// by the first lookup.
+static void checkAllAddresses(
+    DebugInfo *info,
+    uint32_t offset,
+    llvh::ArrayRef<Loc> locs,
+    uint32_t maxAddress) {
+  for (uint32_t address = maxAddress + 1; address-- > 0;) {
+    const Loc *expected = nullptr;
+    for (const Loc &loc : locs) {
+      if (loc.address > address)
+        break;
+      expected = &loc;
+    }
+    ASSERT_NE(expected, nullptr);
+    checkAddress(
+        info,
+        offset,
+        address,
+        expected->filenameId,
+        expected->line,
+        expected->column,
+        expected->statement);
+  }
+}
+
+TEST(DebugInfo, TestLongFunction) {
+  auto dbg = makeGenerator();
+
+  std::vector<Loc> locs;
+  for (uint32_t i = 0; i < 1000; ++i) {
+    locs.push_back(Loc{3 * i, 1, i + 2, i % 7 + 1, i / 3 + 1});
+  }
+  auto offset1 = dbg.appendSourceLocations(Loc{0, 1, 1, 1, 0}, 0, locs);
+  auto offset2 = dbg.appendSourceLocations(Loc{0, 2, 1, 1, 0}, 1, locs);
+
+  DebugInfo info = dbg.serializeWithMove();
+
+  // Look up the same addresses before and after the stream is indexed.
+  checkAllAddresses(&info, offset1, locs, 3000);
+  checkAllAddresses(&info, offset1, locs, 3000);
+  checkAllAddresses(&info, offset2, locs, 3000);
+}
+
+TEST(DebugInfo, TestLongFunctionUnsorted) {
+  auto dbg = makeGenerator();
+
+  std::vector<Loc> locs;
+  for (uint32_t i = 0; i < 200; ++i) {
+    locs.push_back(Loc{2 * i, 1, i + 2, 1, 1});
+  }
+  // Go back to an earlier address.
+  locs.push_back(Loc{50, 1, 1000, 1, 1});
+  for (uint32_t i = 0; i < 200; ++i) {
+    locs.push_back(Loc{400 + 2 * i, 1, i + 2000, 1, 1});
+  }
+  auto offset = dbg.appendSourceLocations(Loc{0, 1, 1, 1, 0}, 0, locs);
+
+  DebugInfo info = dbg.serializeWithMove();
+
+  checkAllAddresses(&info, offset, locs, 800);
+  checkAllAddresses(&info, offset, locs, 800);
+}
 } // end anonymous namespace
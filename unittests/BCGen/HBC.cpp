@@ -23,6 +23,7 @@
 
 #include "gtest/gtest.h"
 
+#include <algorithm>
 #include <initializer_list>
 
 #define DEBUG_TYPE "hbc-unittests"
@@ -487,5 +488,72 @@ TEST(HBCBytecodeGen, BytecodeOptionHasAsync) {
   EXPECT_TRUE(bytecodeHasAsync->getBytecodeOptions().hasAsync);
 }
 
+TEST(HBCBytecodeGen, CompressedBytecode) {
+  // Enough functions to fill several chunks, with a jump table in each.
+  std::string source;
+  for (int i = 0; i < 500; ++i) {
+    std::string n = std::to_string(i);
+    source += "function f" + n + "(x) { switch (x) { case 0: return " + n +
+        "; case 1: return 'a'; case 2: return 'b'; case 3: return 'c'; " +
+        "case 4: return 'd'; default: return f" + n + "(x - 1); } }\n";
+  }
+
+  auto plainVec = bytecodeForSource(source.c_str());
+  TestCompileFlags flags;
+  flags.compressBytecode = true;
+  auto compressedVec = bytecodeForSource(source.c_str(), flags);
+  EXPECT_LT(compressedVec.size(), plainVec.size());
+
+  auto plain = hbc::BCProviderFromBuffer::createBCProviderFromBuffer(
+                   std::make_unique<VectorBuffer>(plainVec))
+                   .first;
+  auto compressed = hbc::BCProviderFromBuffer::createBCProviderFromBuffer(
+                        std::make_unique<VectorBuffer>(compressedVec))
+                        .first;
+  ASSERT_TRUE(plain);
+  ASSERT_TRUE(compressed);
+  EXPECT_FALSE(plain->getBytecodeOptions().compressedBytecode);
+  EXPECT_TRUE(compressed->getBytecodeOptions().compressedBytecode);
+
+  ASSERT_EQ(plain->getFunctionCount(), compressed->getFunctionCount());
+  // Visit the functions backwards, so chunks aren't decompressed in order.
+  for (uint32_t id = plain->getFunctionCount(); id-- > 0;) {
+    uint32_t size = plain->getFunctionHeader(id).bytecodeSizeInBytes();
+    ASSERT_EQ(size, compressed->getFunctionHeader(id).bytecodeSizeInBytes());
+    const uint8_t *bytecode = compressed->getBytecode(id);
+    EXPECT_TRUE(std::equal(bytecode, bytecode + size, plain->getBytecode(id)));
+  }
+}
+
+TEST(HBCBytecodeGen, CompressedBytecodeMalformedChunk) {
+  TestCompileFlags flags;
+  flags.compressBytecode = true;
+  auto bytecode = bytecodeForSource("function f(x) { return x; }", flags);
+
+  // A chunk can't claim to decompress to more than LZ4 could produce from it,
+  // or loading the file could allocate an arbitrarily large buffer.
+  hbc::BytecodeFileFields<true> fields;
+  std::string error;
+  ASSERT_TRUE(fields.populateFromBuffer(
+      {bytecode.data(), bytecode.size()}, &error));
+  ASSERT_EQ(1u, fields.compressedChunks.size());
+  fields.compressedChunks[0].uncompressedSize = UINT32_MAX;
+  hbc::BCProviderFromBuffer::updateBytecodeHash(bytecode);
+
+  auto ret = hbc::BCProviderFromBuffer::createBCProviderFromBuffer(
+      std::make_unique<VectorBuffer>(bytecode));
+  EXPECT_FALSE(ret.first);
+  EXPECT_EQ("Malformed compressed bytecode chunk table", ret.second);
+}
+
+TEST(HBCBytecodeGen, FunctionLayout) {
+  using V = std::vector<uint32_t>;
+  EXPECT_EQ(V({0, 1, 2, 3}), BytecodeSerializer::computeFunctionLayout({}, 4));
+  // Preferred IDs come first, ignoring duplicates and IDs out of range.
+  EXPECT_EQ(
+      V({3, 1, 0, 2}),
+      BytecodeSerializer::computeFunctionLayout({3, 7, 1, 3}, 4));
+}
+
 } // end anonymous namespace
 #undef DEBUG_TYPE
@@ -585,6 +585,34 @@ TEST(StringStorageTest, NoHang) {
   test1OptimizingStringStorage({sr1, sr2}, __LINE__, false);
 }
 
+// Many strings that overlap with many others, and short strings contained in
+// many others, in both ASCII and UTF-16, so that each kind has enough strings
+// to be packed on its own thread.
+TEST(StringStorageTest, OptimizingManyStrings) {
+  std::vector<std::string> owned;
+  for (unsigned i = 0; i < 2000; ++i) {
+    owned.push_back("key" + std::to_string(i) + "val");
+    owned.push_back("val" + std::to_string(i) + "key");
+    owned.push_back("\xC3\xA9t\xC3\xA9" + std::to_string(i));
+    owned.push_back(std::to_string(i) + "\xC3\xA9t\xC3\xA9");
+  }
+  for (const char *str : {"k", "ke", "va", "al", "\xC3\xA9", "t\xC3\xA9"}) {
+    owned.push_back(str);
+  }
+  std::vector<StringRef> strings(owned.begin(), owned.end());
+
+  hbc::ConsecutiveStringStorage storage(strings, true /* optimize */);
+  std::string utf8;
+  for (uint32_t i = 0; i < strings.size(); i++) {
+    EXPECT_EQ(strings[i], storage.getStringAtIndex(i, utf8)) << " idx " << i;
+  }
+  size_t naiveLength = 0;
+  for (const auto &entry : storage.getStringTableView()) {
+    naiveLength += entry.isUTF16() ? entry.getLength() * 2 : entry.getLength();
+  }
+  EXPECT_LT(storage.acquireStringStorage().size(), naiveLength);
+}
+
 /// \return The table resulting from adding the strings in \p strings into the
 /// accumulator \p accum (defaults to empty), and converting it into a table
 /// with optimizations enabled.
@@ -18,6 +18,7 @@ namespace hermes {
 
 struct TestCompileFlags {
   bool staticBuiltins{false};
+  bool compressBytecode{false};
 };
 
 /// Compile source code \p source into Hermes bytecode, asserting that it can be
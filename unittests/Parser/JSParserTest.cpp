@@ -11,6 +11,8 @@
 
 #include "gtest/gtest.h"
 
+#include <map>
+
 using llvh::cast;
 using llvh::dyn_cast;
 using llvh::isa;
@@ -298,4 +300,107 @@ TEST(JSParserTest, TestStoredTokens) {
 #endif
 }
 
+/// \return a bundle of \p numModules Metro style module definitions, each
+/// with a few functions, including strict and "show source" ones.
+std::string makeModuleBundle(llvh::StringRef prologue, unsigned numModules) {
+  std::string src = prologue;
+  src += "var __BUNDLE_START_TIME__ = 0;\n";
+  for (unsigned i = 0; i < numModules; ++i) {
+    std::string n = std::to_string(i);
+    src += "__d(function (global, require, module, exports) {\n";
+    src += "  function helper" + n + "(a, b) {\n";
+    src += "    'show source';\n";
+    src += "    return a.map(function (x) { return x * b + " + n + "; });\n";
+    src += "  }\n";
+    src += "  module.exports = {\n";
+    src += "    run: function () { 'use strict'; return helper" + n +
+        "([1, 2, 3], 2); },\n";
+    src += "    name: 'module" + n + "',\n";
+    src += "  };\n";
+    src += "}, " + n + ", [], \"module" + n + ".js\");\n";
+  }
+  return src;
+}
+
+/// Pre-parse \p src on up to \p threads threads. \return whether it
+/// succeeded, and put the function info in \p info.
+bool preParse(
+    llvh::StringRef src,
+    unsigned threads,
+    std::map<const char *, PreParsedFunctionInfo> &info) {
+  Context context;
+  context.setPreParseThreads(threads);
+  // Messages are only expected for broken sources.
+  SourceErrorManager::SaveAndSuppressMessages suppress(
+      &context.getSourceErrorManager());
+  uint32_t bufferId = context.getSourceErrorManager().addNewSourceBuffer(
+      llvh::MemoryBuffer::getMemBuffer(src, "bundle.js"));
+  bool useStaticBuiltin = false;
+  if (!JSParser::preParseBuffer(context, bufferId, useStaticBuiltin))
+    return false;
+  for (auto &entry : context.getPreParsedBufferInfo(bufferId)->functionInfo)
+    info[entry.first.getPointer()] = entry.second;
+  return true;
+}
+
+void expectSamePreParse(llvh::StringRef src) {
+  std::map<const char *, PreParsedFunctionInfo> serial, parallel;
+  ASSERT_TRUE(preParse(src, 1, serial));
+  ASSERT_TRUE(preParse(src, 4, parallel));
+  ASSERT_EQ(serial.size(), parallel.size());
+  for (auto &entry : serial) {
+    auto it = parallel.find(entry.first);
+    ASSERT_TRUE(it != parallel.end());
+    EXPECT_EQ(entry.second.end, it->second.end);
+    EXPECT_EQ(entry.second.strictMode, it->second.strictMode);
+    ASSERT_EQ(entry.second.directives.size(), it->second.directives.size());
+    for (size_t i = 0; i < entry.second.directives.size(); ++i) {
+      EXPECT_EQ(entry.second.directives[i], it->second.directives[i]);
+    }
+  }
+}
+
+TEST(JSParserTest, ParallelPreParse) {
+  // Large enough to be split into several chunks.
+  std::string src = makeModuleBundle("", 5000);
+  ASSERT_GT(src.size(), 1u << 20);
+  expectSamePreParse(src);
+  // A strict program can't be split, since the chunks would not know.
+  expectSamePreParse(makeModuleBundle("'use strict';\n", 5000));
+  // Neither can a bundle where a line continuation makes a string look like a
+  // module definition.
+  for (size_t pos = 0; (pos = src.find("'module", pos)) != std::string::npos;
+       ++pos) {
+    src.insert(pos + 1, "\\\n__d(not a module");
+  }
+  expectSamePreParse(src);
+}
+
+TEST(JSParserTest, ParallelPreParseError) {
+  std::string src = makeModuleBundle("", 5000);
+  // Break a module in the middle of the bundle.
+  src.insert(src.find("__d(", src.size() / 2) + 4, ")");
+  std::map<const char *, PreParsedFunctionInfo> info;
+  EXPECT_FALSE(preParse(src, 1, info));
+  EXPECT_FALSE(preParse(src, 4, info));
+}
+
+TEST(JSParserTest, ParallelPreParseLexerError) {
+  std::string src = makeModuleBundle("", 5000);
+  // A lexer error the parser recovers from, in a module after the first split
+  // point. Its chunk must not be merged, so the buffer is pre-parsed again as
+  // a whole, which reports the error exactly once.
+  size_t pos = src.find("'module", src.size() / 2);
+  ASSERT_NE(pos, std::string::npos);
+  src.insert(pos + 1, "\\u{110000}");
+  Context context;
+  context.setPreParseThreads(4);
+  DiagContext diag(context);
+  uint32_t bufferId = context.getSourceErrorManager().addNewSourceBuffer(
+      llvh::MemoryBuffer::getMemBuffer(src, "bundle.js"));
+  bool useStaticBuiltin = false;
+  EXPECT_FALSE(JSParser::preParseBuffer(context, bufferId, useStaticBuiltin));
+  EXPECT_EQ(1, diag.getErrCount());
+}
+
 }; // anonymous namespace
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/Support/ASCIIScan.h"
+
+#include "gtest/gtest.h"
+
+#include <string>
+
+using namespace hermes;
+
+namespace {
+
+/// \return true if \p c is in the set of characters trimmed by
+/// skipASCIISpace().
+template <typename T>
+bool naiveIsSpace(T c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' ||
+      c == '\r';
+}
+
+/// Check every function on every substring of \p text, so the interesting
+/// characters fall at every alignment and on both the vector and the scalar
+/// paths.
+template <typename T>
+void checkAll(const std::basic_string<T> &text) {
+  for (size_t b = 0; b <= text.size(); ++b) {
+    for (size_t e = b; e <= text.size(); ++e) {
+      const T *begin = text.data() + b;
+      const T *end = text.data() + e;
+
+      const T *p = begin;
+      while (p != end && static_cast<uint32_t>(*p) <= 0x7f)
+        ++p;
+      EXPECT_EQ(p, asciiscan::findNonASCII(begin, end));
+
+      p = begin;
+      while (p != end && !(*p >= 'A' && *p <= 'Z'))
+        ++p;
+      EXPECT_EQ(p, asciiscan::findInRange(begin, end, 'A', 'Z'));
+
+      p = begin;
+      while (p != end && naiveIsSpace(*p))
+        ++p;
+      EXPECT_EQ(p, asciiscan::skipASCIISpace(begin, end));
+
+      p = end;
+      while (p != begin && naiveIsSpace(p[-1]))
+        --p;
+      EXPECT_EQ(p, asciiscan::skipASCIISpaceBackward(begin, end));
+
+      std::basic_string<T> expected{begin, end};
+      for (T &c : expected) {
+        if (c >= 'a' && c <= 'z')
+          c -= 'a' - 'A';
+      }
+      std::basic_string<T> out(e - b, T('?'));
+      asciiscan::flipCaseInRange(begin, end, &out[0], 'a', 'z');
+      EXPECT_EQ(expected, out);
+    }
+  }
+}
+
+TEST(ASCIIScanTest, Char) {
+  checkAll(std::string("  \tHello, World!\r\n\v\f  Some MORE text here.  "));
+  checkAll(std::string("plain\x80\xff{}[]@`   \x85 end\x1f"));
+}
+
+TEST(ASCIIScanTest, Char16) {
+  checkAll(
+      std::u16string(u"  \tHello, World!\r\n\v\f  Some MORE text here.  "));
+  checkAll(
+      std::u16string(u"plain\u0080\u00ff{}[]@` \u2003 \u0130 end\u0141"));
+}
+
+TEST(ASCIIScanTest, FlipInPlace) {
+  std::u16string str(u"The Quick Brown Fox Jumps Over The Lazy Dog");
+  asciiscan::flipCaseInRange(
+      str.data(), str.data() + str.size(), &str[0], 'A', 'Z');
+  EXPECT_EQ(u"the quick brown fox jumps over the lazy dog", str);
+}
+
+} // namespace
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/Support/ByteScan.h"
+
+#include "gtest/gtest.h"
+
+#include <string>
+
+using namespace hermes;
+
+namespace {
+
+/// Call \p check with every placement of \p stop in a run of \p fill long
+/// enough to exercise both the vector and the scalar paths, at every
+/// alignment. \p check is passed the range and the expected result.
+template <typename F>
+void forEachPlacement(char fill, char stop, F check) {
+  for (size_t start = 0; start < 16; ++start) {
+    for (size_t len = 0; len < 50; ++len) {
+      for (size_t pos = 0; pos <= len; ++pos) {
+        std::string buf(start + len + 1, fill);
+        if (pos < len)
+          buf[start + pos] = stop;
+        // The byte past the end must never be looked at.
+        buf[start + len] = stop == fill ? '#' : fill;
+        const char *begin = buf.data() + start;
+        check(begin, begin + len, begin + pos);
+      }
+    }
+  }
+}
+
+TEST(ByteScanTest, SkipSpacesAndTabs) {
+  for (char fill : {' ', '\t'}) {
+    for (char stop : {'a', '\n', '\0', '\x80', '\xff'}) {
+      forEachPlacement(
+          fill, stop, [](const char *p, const char *end, const char *expected) {
+            EXPECT_EQ(bytescan::skipSpacesAndTabs(p, end), expected);
+          });
+    }
+  }
+  const char mixed[] = " \t  \t\t    \t       \t x";
+  EXPECT_EQ(
+      bytescan::skipSpacesAndTabs(mixed, mixed + sizeof(mixed) - 1),
+      mixed + sizeof(mixed) - 2);
+}
+
+TEST(ByteScanTest, SkipASCIIIdentifierParts) {
+  for (char fill : {'a', 'z', 'A', 'Z', '0', '9', '_', '$'}) {
+    for (char stop :
+         {' ', '-', '@', '`', '{', '[', '/', ':', '\0', '\x80', '\xc2'}) {
+      forEachPlacement(
+          fill, stop, [](const char *p, const char *end, const char *expected) {
+            EXPECT_EQ(bytescan::skipASCIIIdentifierParts(p, end), expected);
+          });
+    }
+  }
+  // The extra character is accepted, but only when one is given.
+  forEachPlacement(
+      '-', '-', [](const char *p, const char *end, const char *expected) {
+        EXPECT_EQ(bytescan::skipASCIIIdentifierParts(p, end, '-'), end);
+        EXPECT_EQ(bytescan::skipASCIIIdentifierParts(p, end), p);
+      });
+  forEachPlacement(
+      'x', '\0', [](const char *p, const char *end, const char *expected) {
+        EXPECT_EQ(bytescan::skipASCIIIdentifierParts(p, end, '@'), expected);
+      });
+}
+
+TEST(ByteScanTest, FindFirstOfOrNonASCII) {
+  for (char stop : {'*', '\n', '\0', '\x80', '\xe2', '\xff'}) {
+    forEachPlacement(
+        'a', stop, [](const char *p, const char *end, const char *expected) {
+          EXPECT_EQ(
+              (bytescan::findFirstOfOrNonASCII<'*', '\n', '\0'>(p, end)),
+              expected);
+        });
+  }
+  forEachPlacement(
+      'a', '/', [](const char *p, const char *end, const char *expected) {
+        EXPECT_EQ((bytescan::findFirstOfOrNonASCII<'*'>(p, end)), end);
+      });
+}
+
+} // namespace
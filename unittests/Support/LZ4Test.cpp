@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/Support/LZ4.h"
+
+#include "gtest/gtest.h"
+
+#include <random>
+
+using namespace hermes;
+
+namespace {
+
+/// Compress and decompress \p data, expecting the original back.
+/// \return the compressed size.
+size_t roundTrip(const std::vector<uint8_t> &data) {
+  std::vector<uint8_t> compressed;
+  lz4::compress(data, compressed);
+  std::vector<uint8_t> decompressed(data.size());
+  EXPECT_TRUE(lz4::decompress(compressed, decompressed));
+  EXPECT_EQ(data, decompressed);
+  return compressed.size();
+}
+
+TEST(LZ4Test, RoundTripSmall) {
+  roundTrip({});
+  roundTrip({1});
+  roundTrip({1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13});
+}
+
+TEST(LZ4Test, RoundTripRepetitive) {
+  std::vector<uint8_t> data;
+  for (int i = 0; i < 10000; ++i) {
+    data.push_back(i % 7);
+  }
+  // Long runs need extra length bytes for both literals and matches.
+  EXPECT_LT(roundTrip(data), data.size() / 20);
+
+  std::vector<uint8_t> zeros(100000, 0);
+  EXPECT_LT(roundTrip(zeros), 1000u);
+}
+
+TEST(LZ4Test, RoundTripRandom) {
+  std::minstd_rand rng{42};
+  std::vector<uint8_t> data;
+  for (int i = 0; i < 5000; ++i) {
+    data.push_back(rng());
+  }
+  // Incompressible data grows only slightly.
+  EXPECT_LT(roundTrip(data), data.size() + data.size() / 100 + 16);
+
+  // Mix random data with copies of it more than 64KB apart.
+  std::vector<uint8_t> mixed = data;
+  mixed.resize(70000, 3);
+  mixed.insert(mixed.end(), data.begin(), data.end());
+  roundTrip(mixed);
+}
+
+TEST(LZ4Test, DecompressMalformed) {
+  std::vector<uint8_t> data(1000, 'a');
+  std::vector<uint8_t> compressed;
+  lz4::compress(data, compressed);
+
+  // The output size must match exactly.
+  std::vector<uint8_t> small(data.size() - 1);
+  EXPECT_FALSE(lz4::decompress(compressed, small));
+  std::vector<uint8_t> large(data.size() + 1);
+  EXPECT_FALSE(lz4::decompress(compressed, large));
+
+  // Truncated input.
+  std::vector<uint8_t> out(data.size());
+  for (size_t len = 0; len < compressed.size(); ++len) {
+    EXPECT_FALSE(lz4::decompress(
+        llvh::makeArrayRef(compressed.data(), len), out));
+  }
+
+  // A match that reaches before the start of the output.
+  std::vector<uint8_t> badOffset{0x10, 'a', 0x05, 0x00, 0x00};
+  EXPECT_FALSE(lz4::decompress(badOffset, out));
+}
+
+} // namespace
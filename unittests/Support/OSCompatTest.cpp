@@ -51,6 +51,29 @@ TEST(OSCompatTest, CurrentRSS) {
   EXPECT_GE(oscompat::current_rss(), beginRSS);
 }
 
+TEST(OSCompatTest, ReserveAndCommit) {
+  const size_t PS = oscompat::page_size();
+  const size_t alignment = PS * 16;
+  auto result = oscompat::vm_reserve_aligned(PS * 64, alignment);
+  ASSERT_TRUE(result);
+  char *base = static_cast<char *>(result.get());
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(base) % alignment);
+
+  // Commit a range in the middle, and check that it can be written.
+  char *mid = base + PS * 8;
+  ASSERT_TRUE(oscompat::vm_commit(mid, PS * 2));
+  mid[0] = 1;
+  mid[PS * 2 - 1] = 1;
+
+  // Uncommitted memory can be committed again, and is zero.
+  oscompat::vm_uncommit(mid, PS * 2);
+  ASSERT_TRUE(oscompat::vm_commit(mid, PS * 2));
+  EXPECT_EQ(0, mid[0]);
+  EXPECT_EQ(0, mid[PS * 2 - 1]);
+
+  oscompat::vm_release_aligned(base, PS * 64);
+}
+
 #ifdef __linux__
 TEST(OSCompatTest, Scheduling) {
   // At least one CPU should be set.
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/Support/StringSearch.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <string>
+
+using namespace hermes;
+
+namespace {
+
+/// \return the first match of \p needle in \p hay, computed naively.
+template <typename T>
+const T *naiveFindFirst(const std::basic_string<T> &hay, const T *needle) {
+  std::basic_string<T> n{needle};
+  auto it = std::search(hay.begin(), hay.end(), n.begin(), n.end());
+  if (it == hay.end() && !n.empty())
+    return nullptr;
+  return hay.data() + (it - hay.begin());
+}
+
+/// \return the last match of \p needle in \p hay, computed naively.
+template <typename T>
+const T *naiveFindLast(const std::basic_string<T> &hay, const T *needle) {
+  std::basic_string<T> n{needle};
+  auto it = std::find_end(hay.begin(), hay.end(), n.begin(), n.end());
+  if (it == hay.end() && !n.empty())
+    return nullptr;
+  return hay.data() + (it - hay.begin());
+}
+
+/// Search for \p needle in every substring of \p text, so the matches fall
+/// at every alignment and on both the vector and the scalar paths.
+template <typename T>
+void checkAllSubstrings(const std::basic_string<T> &text, const T *needle) {
+  std::basic_string<T> n{needle};
+  for (size_t start = 0; start < text.size(); ++start) {
+    for (size_t len = 0; start + len <= text.size(); ++len) {
+      std::basic_string<T> hay = text.substr(start, len);
+      const T *begin = hay.data();
+      const T *end = begin + hay.size();
+      EXPECT_EQ(
+          stringsearch::findFirst(begin, end, n.data(), n.size()),
+          naiveFindFirst(hay, needle));
+      EXPECT_EQ(
+          stringsearch::findLast(begin, end, n.data(), n.size()),
+          naiveFindLast(hay, needle));
+    }
+  }
+}
+
+TEST(StringSearchTest, ASCII) {
+  std::string text =
+      "abracadabra, abracadabra! the quick brown fox jumps over the lazy "
+      "dog; aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaab";
+  for (const char *needle :
+       {"",
+        "a",
+        "b",
+        "!",
+        "z",
+        "ab",
+        "ra",
+        "abra",
+        "cadabra",
+        "the",
+        "aab",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaab",
+        "abracadabra, abracadabra! the qu",
+        "the quick brown fox jumps over the lazy dog",
+        "the quick brown fox jumps over the lazy cat"}) {
+    checkAllSubstrings(text, needle);
+  }
+}
+
+TEST(StringSearchTest, UTF16) {
+  std::u16string text =
+      u"ĀbcĀbcšĀbcabc ššššš"
+      u"ššššššššššš"
+      u"ššššššššššš"
+      u"ššššššxɡĀ end";
+  for (const char16_t *needle :
+       {u"",
+        u"Ā",
+        u"š",
+        u"\u0001",
+        u"a",
+        u"bc",
+        u"Ābc",
+        u"ɡ",
+        u"šx",
+        u"ššššššššššš"
+        u"ššššššššššš"
+        u"ššššššššššx",
+        // Differs from the text only in the high byte of a character.
+        u"ššššššššššš"
+        u"ššššššššššš"
+        u"ššššššššššxš",
+        u"xšĀ"}) {
+    checkAllSubstrings(text, needle);
+  }
+}
+
+} // namespace
@@ -10,7 +10,9 @@
 
 #include "gtest/gtest.h"
 
+#include <algorithm>
 #include <deque>
+#include <string>
 #include <vector>
 
 using namespace hermes;
@@ -206,6 +208,32 @@ TEST(UTF16StreamTest, UTF8InputTest) {
   }
 }
 
+TEST(UTF16StreamTest, AvailableTest) {
+  // ASCII with a non-ASCII character in the middle, long enough to span
+  // several chunks.
+  std::string str8(5000, 'a');
+  str8[3000] = '\xc3';
+  str8.insert(3001, 1, '\xa9');
+  UTF16Stream stream(llvh::ArrayRef<uint8_t>(
+      reinterpret_cast<const uint8_t *>(str8.data()), str8.size()));
+  std::u16string str16;
+  while (stream.hasChar()) {
+    llvh::ArrayRef<char16_t> avail = stream.available();
+    EXPECT_FALSE(avail.empty());
+    // Consume half of what is available in bulk, and the rest one by one.
+    size_t half = avail.size() / 2;
+    str16.append(avail.begin(), avail.begin() + half);
+    stream.skip(half);
+    for (size_t i = half; i < avail.size(); ++i) {
+      str16.push_back(*stream);
+      ++stream;
+    }
+  }
+  std::u16string expected(5000, u'a');
+  expected[3000] = u'\u00e9';
+  EXPECT_EQ(expected, str16);
+}
+
 size_t countRemainingCharsInStream(UTF16Stream &&str) {
   size_t size = 0;
   while (str.hasChar()) {
@@ -221,4 +249,52 @@ TEST(UTF16StreamTest, MoveTest) {
   EXPECT_EQ(3, countRemainingCharsInStream(std::move(stream)));
 }
 
+/// \return a reader that produces \p str8 in pieces of 1 to 7 bytes, so that
+/// characters are split across reads.
+UTF16Stream::Reader makePieceReader(const std::string &str8) {
+  size_t pos = 0;
+  size_t piece = 0;
+  return [str8, pos, piece](uint8_t *buffer, size_t size) mutable {
+    piece = piece % 7 + 1;
+    size_t count = std::min({piece, size, str8.size() - pos});
+    std::copy(str8.begin() + pos, str8.begin() + pos + count, buffer);
+    pos += count;
+    return count;
+  };
+}
+
+TEST(UTF16StreamTest, ReaderTest) {
+  {
+    UTF16Stream stream([](uint8_t *, size_t) { return size_t(0); });
+    EXPECT_FALSE(stream.hasChar());
+  }
+  {
+    // Characters of every UTF8 length, repeated over several chunks.
+    std::string str8;
+    std::u16string expected;
+    for (int i = 0; i < 2000; ++i) {
+      str8 += "a\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\xb9";
+      expected += u"aé€\U0001F639";
+    }
+    UTF16Stream stream(makePieceReader(str8));
+    std::u16string str16;
+    while (stream.hasChar()) {
+      str16.append(stream.available().begin(), stream.available().end());
+      stream.skip(stream.available().size());
+    }
+    EXPECT_EQ(expected, str16);
+  }
+  {
+    // The stream ends at the first malformed character, even if more input
+    // follows it.
+    UTF16Stream stream(makePieceReader("ab\xff" "cd"));
+    EXPECT_EQ(2, countRemainingCharsInStream(std::move(stream)));
+  }
+  {
+    // A truncated character at the end of the input is dropped.
+    UTF16Stream stream(makePieceReader("ab\xe2\x82"));
+    EXPECT_EQ(2, countRemainingCharsInStream(std::move(stream)));
+  }
+}
+
 } // end anonymous namespace
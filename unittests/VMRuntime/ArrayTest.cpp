@@ -178,4 +178,44 @@ TEST_F(ArrayTest, TestLength) {
   EXPECT_CALLRESULT_DOUBLE(
       5.0, JSObject::getNamed_RJS(array, runtime, lengthID));
 }
+
+TEST_F(ArrayTest, ElementsKind) {
+  auto arrayRes = JSArray::create(runtime, 4, 0);
+  ASSERT_FALSE(isException(arrayRes));
+  auto array = *arrayRes;
+  EXPECT_EQ(ElementsKind::Int32, array->getElementsKind());
+
+  JSArray::setElementAt(
+      array,
+      runtime,
+      0,
+      runtime->makeHandle(HermesValue::encodeDoubleValue(-5)));
+  JSArray::setElementAt(array, runtime, 1, runtime->makeHandle(7.0_hd));
+  EXPECT_EQ(ElementsKind::Int32, array->getElementsKind());
+
+  // -0 and numbers out of the int32 range are doubles.
+  JSArray::setElementAt(
+      array,
+      runtime,
+      2,
+      runtime->makeHandle(HermesValue::encodeDoubleValue(-0.0)));
+  EXPECT_EQ(ElementsKind::Double, array->getElementsKind());
+  // The kind doesn't go back when the double is overwritten.
+  JSArray::setElementAt(array, runtime, 2, runtime->makeHandle(1.0_hd));
+  EXPECT_EQ(ElementsKind::Double, array->getElementsKind());
+
+  JSArray::setElementAt(
+      array,
+      runtime,
+      3,
+      runtime->makeHandle(HermesValue::encodeUndefinedValue()));
+  EXPECT_EQ(ElementsKind::Generic, array->getElementsKind());
+
+  // Emptying the storage starts over.
+  ASSERT_FALSE(isException(JSArray::setStorageEndIndex(array, runtime, 0)));
+  EXPECT_EQ(ElementsKind::Int32, array->getElementsKind());
+  JSArray::setElementAt(
+      array, runtime, 0, runtime->makeHandle(2147483648.0_hd));
+  EXPECT_EQ(ElementsKind::Double, array->getElementsKind());
+}
 } // namespace
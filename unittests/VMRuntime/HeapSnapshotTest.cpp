@@ -1306,6 +1306,76 @@ B(4) @ test.js(2):7:15)#");
 
 #endif // HERMES_ENABLE_DEBUGGER
 
+class HeapSnapshotStreamingTest : public RuntimeTestFixtureBase {
+ protected:
+  HeapSnapshotStreamingTest()
+      : RuntimeTestFixtureBase(
+            RuntimeConfig::Builder()
+                .withGCConfig(GCConfig::Builder(kTestGCConfigBuilder)
+                                  .withStreamHeapSnapshots(true)
+                                  .build())
+                .build()) {}
+};
+
+TEST_F(HeapSnapshotStreamingTest, StringsAndEdges) {
+  JSONFactory::Allocator alloc;
+  JSONFactory jsonFactory{alloc};
+  hbc::CompileFlags flags;
+  // Create more distinct strings than fit in the deduplication cache.
+  std::string source = R"(
+var strs = [];
+for (var i = 0; i < 10000; i++) {
+  strs.push('str' + i);
+}
+({long: 'x'.repeat(1000), a: 'dup' + 1, b: 'dup' + 1, strs: strs});
+  )";
+  CallResult<HermesValue> res = runtime->run(source, "file:///fake.js", flags);
+  ASSERT_FALSE(isException(res));
+  Handle<JSObject> obj = runtime->makeHandle(vmcast<JSObject>(*res));
+  const auto objID = runtime->getHeap().getObjectID(obj.get());
+
+  JSONObject *root = TAKE_SNAPSHOT(runtime->getHeap(), jsonFactory);
+  ASSERT_NE(root, nullptr);
+  const JSONArray &nodes = *llvh::cast<JSONArray>(root->at("nodes"));
+  const JSONArray &edges = *llvh::cast<JSONArray>(root->at("edges"));
+  const JSONArray &strings = *llvh::cast<JSONArray>(root->at("strings"));
+
+  // Every string index must be valid.
+  for (size_t i = 0; i < nodes.size();
+       i += HeapSnapshot::V8_SNAPSHOT_NODE_FIELD_COUNT) {
+    ASSERT_LT(llvh::cast<JSONNumber>(nodes[i + 1])->getValue(), strings.size());
+  }
+
+  auto nodeAndEdges = FIND_NODE_AND_EDGES_FOR_ID(objID, nodes, edges, strings);
+  EXPECT_EQ(nodeAndEdges.first.name, "Object(long, a, b, strs)");
+  llvh::DenseMap<llvh::StringRef, HeapSnapshot::NodeID> propTargets;
+  for (const Edge &edge : nodeAndEdges.second) {
+    if (edge.type == HeapSnapshot::EdgeType::Property) {
+      propTargets[edge.name] = edge.toNode;
+    }
+  }
+  // The four properties, and __proto__.
+  ASSERT_EQ(propTargets.size(), 5u);
+  EXPECT_EQ(
+      FIND_NODE_FOR_ID(propTargets["long"], nodes, strings).name,
+      std::string(1000, 'x'));
+  EXPECT_EQ(FIND_NODE_FOR_ID(propTargets["a"], nodes, strings).name, "dup1");
+  EXPECT_EQ(FIND_NODE_FOR_ID(propTargets["b"], nodes, strings).name, "dup1");
+
+  // Check a string that was created early, and is likely to have been evicted
+  // from the cache.
+  auto strsNodeAndEdges =
+      FIND_NODE_AND_EDGES_FOR_ID(propTargets["strs"], nodes, edges, strings);
+  bool foundFirst = false;
+  for (const Edge &edge : strsNodeAndEdges.second) {
+    if (edge.type == HeapSnapshot::EdgeType::Element && edge.index == 0) {
+      EXPECT_EQ(FIND_NODE_FOR_ID(edge.toNode, nodes, strings).name, "str0");
+      foundFirst = true;
+    }
+  }
+  EXPECT_TRUE(foundFirst);
+}
+
 } // namespace heapsnapshottest
 } // namespace unittest
 } // namespace hermes
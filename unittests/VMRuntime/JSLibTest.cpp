@@ -1275,4 +1275,43 @@ TEST_F(JSLibMockedEnvironmentTest, MockedEnvironment) {
 #endif
 }
 
+class JSLibErrorStackConfigTest : public RuntimeTestFixtureBase {
+ public:
+  JSLibErrorStackConfigTest()
+      : RuntimeTestFixtureBase(RuntimeConfig::Builder()
+                                   .withGCConfig(kTestGCConfig)
+                                   .withErrorStackCaptureDepth(3)
+                                   .withLazyErrorStackNames(true)
+                                   .build()) {}
+};
+
+TEST_F(JSLibErrorStackConfigTest, CaptureDepthAndLazyNames) {
+  hermes::hbc::CompileFlags flags;
+  // Only the innermost frames are recorded, and names come from the bytecode
+  // even if the function's name property has been changed.
+  CallResult<HermesValue> res = runtime->run(
+      R"(
+function recurse(n) {
+  if (n === 0) throw new Error('bottom');
+  return recurse(n - 1);
+}
+Object.defineProperty(recurse, 'name', {value: 'renamed'});
+var stack;
+try {
+  recurse(10);
+} catch (e) {
+  stack = e.stack;
+}
+var lines = stack.split('\n');
+lines.length === 4 && lines[0] === 'Error: bottom' &&
+    lines.slice(1).every(function(l) {
+      return l.indexOf('    at recurse (') === 0;
+    });
+)",
+      "test.js",
+      flags);
+  ASSERT_FALSE(isException(res));
+  EXPECT_TRUE(res->getBool());
+}
+
 } // anonymous namespace
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/VM/Profiler/JSPerfMap.h"
+
+#include "gtest/gtest.h"
+
+#include "TestHelpers.h"
+
+#include "llvh/ADT/SmallString.h"
+#include "llvh/ADT/StringRef.h"
+#include "llvh/Support/FileSystem.h"
+#include "llvh/Support/MemoryBuffer.h"
+#include "llvh/Support/Path.h"
+
+using namespace hermes::vm;
+
+namespace hermes {
+namespace {
+
+class JSPerfMapTest : public RuntimeTestFixtureBase {
+ protected:
+  JSPerfMapTest() : JSPerfMapTest(createTestDir()) {}
+
+  ~JSPerfMapTest() override {
+    llvh::sys::fs::remove_directories(dir_);
+  }
+
+  /// A directory of its own for each test, removed afterwards.
+  const std::string dir_;
+
+  /// The map the runtime appends to, in dir_ instead of the real perf map of
+  /// the process in /tmp.
+  const std::string mapPath_;
+
+ private:
+  explicit JSPerfMapTest(const std::string &dir)
+      : RuntimeTestFixtureBase(
+            RuntimeConfig::Builder()
+                .withGCConfig(GCConfig::Builder(kTestGCConfigBuilder).build())
+                .withEnableJSPerfMap(true)
+                .withJSPerfMapPath(getMapPath(dir))
+                .build()),
+        dir_(dir),
+        mapPath_(getMapPath(dir)) {}
+
+  static std::string createTestDir() {
+    llvh::SmallString<128> dir;
+    EXPECT_FALSE(llvh::sys::fs::createUniqueDirectory("hermes-perf-map", dir));
+    return dir.str();
+  }
+
+  static std::string getMapPath(llvh::StringRef dir) {
+    llvh::SmallString<128> path{dir};
+    llvh::sys::path::append(path, "perf.map");
+    return path.str();
+  }
+};
+
+TEST_F(JSPerfMapTest, CallsAndExceptions) {
+  EXPECT_EQ(runtime->getJSPerfMap() != nullptr, JSPerfMap::isSupported());
+  EXPECT_EQ(runtime->hasNativeFramePerJSCall(), JSPerfMap::isSupported());
+
+  // Every JS call and return goes through a native frame, including ones
+  // that unwind several frames at once.
+  hbc::CompileFlags flags;
+  CallResult<HermesValue> res = runtime->run(
+      R"(
+function perfMapFib(n) {
+  return n < 2 ? n : perfMapFib(n - 1) + perfMapFib(n - 2);
+}
+function perfMapThrow(n) {
+  if (n === 0) throw new Error('bottom');
+  return perfMapThrow(n - 1);
+}
+var caught = 0;
+for (var i = 0; i < 3; i++) {
+  try {
+    perfMapThrow(5);
+  } catch (e) {
+    caught += e.message === 'bottom';
+  }
+}
+perfMapFib(15) + caught;
+)",
+      "file:///perfmap.js",
+      flags);
+  ASSERT_FALSE(isException(res));
+  EXPECT_EQ(res->getNumber(), 610 + 3);
+}
+
+// The symbols only exist where trampolines are generated. This gtest has no
+// GTEST_SKIP, so the test is reported as disabled elsewhere.
+#ifdef HERMESVM_JSPERFMAP_SUPPORTED
+#define MAYBE_SymbolsInMap SymbolsInMap
+#else
+#define MAYBE_SymbolsInMap DISABLED_SymbolsInMap
+#endif
+
+TEST_F(JSPerfMapTest, MAYBE_SymbolsInMap) {
+  // The function needs an instruction with a source location, or its symbol
+  // falls back to its bytecode offset.
+  hbc::CompileFlags flags;
+  CallResult<HermesValue> res = runtime->run(
+      "function perfMapSymbol(o) { return o.x; }\nperfMapSymbol({x: 1});",
+      "file:///symbols.js",
+      flags);
+  ASSERT_FALSE(isException(res));
+
+  auto buf = llvh::MemoryBuffer::getFile(mapPath_);
+  ASSERT_TRUE(static_cast<bool>(buf));
+  llvh::StringRef contents = (*buf)->getBuffer();
+  bool found = false;
+  while (!contents.empty()) {
+    llvh::StringRef line;
+    std::tie(line, contents) = contents.split('\n');
+    llvh::StringRef start, size, name;
+    std::tie(start, line) = line.split(' ');
+    std::tie(size, name) = line.split(' ');
+    if (!name.startswith("JS:perfMapSymbol(file:///symbols.js:1:")) {
+      continue;
+    }
+    found = true;
+    uint64_t startAddr, sizeBytes;
+    EXPECT_FALSE(start.getAsInteger(16, startAddr));
+    EXPECT_FALSE(size.getAsInteger(16, sizeBytes));
+    EXPECT_NE(startAddr, 0u);
+    EXPECT_NE(sizeBytes, 0u);
+  }
+  EXPECT_TRUE(found);
+}
+
+} // namespace
+} // namespace hermes
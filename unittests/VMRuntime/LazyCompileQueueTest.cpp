@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMESVM_LEAN
+
+#include "hermes/VM/LazyCompileQueue.h"
+
+#include "gtest/gtest.h"
+
+#include "TestHelpers.h"
+
+using namespace hermes::vm;
+
+namespace hermes {
+namespace {
+
+class LazyCompileQueueTest : public RuntimeTestFixtureBase {
+ protected:
+  LazyCompileQueueTest()
+      : RuntimeTestFixtureBase(
+            RuntimeConfig::Builder()
+                .withGCConfig(GCConfig::Builder(kTestGCConfigBuilder).build())
+                .withBackgroundLazyCompilation(true)
+                .build()) {
+    flags.lazy = true;
+    flags.preemptiveFileCompilationThreshold = 0;
+    flags.preemptiveFunctionCompilationThreshold = 0;
+  }
+
+  hbc::CompileFlags flags;
+};
+
+TEST_F(LazyCompileQueueTest, PrecompilesDeclaredFunctions) {
+  LazyCompileQueue *queue = runtime->getLazyCompileQueue();
+  ASSERT_NE(queue, nullptr);
+
+  // Running the global function creates closures for both functions, which
+  // queues them for compilation.
+  CallResult<HermesValue> res = runtime->run(
+      R"(
+function lazyAdd(a, b) {
+  return a + b;
+}
+function lazyOuter(n) {
+  function lazyInner(x) {
+    return x * 2;
+  }
+  return lazyInner(n) + 1;
+}
+[lazyAdd, lazyOuter];
+)",
+      "file:///lazy.js",
+      flags);
+  ASSERT_FALSE(isException(res));
+  queue->waitUntilIdle();
+  EXPECT_EQ(queue->getNumHits(), 0u);
+
+  res = runtime->run(
+      "lazyAdd(1, 2) * 100 + lazyOuter(10);", "file:///call.js", flags);
+  ASSERT_FALSE(isException(res));
+  EXPECT_EQ(res->getNumber(), 300 + 21);
+  // lazyAdd and lazyOuter were compiled ahead of their calls. lazyInner was
+  // only queued once lazyOuter ran, so it may or may not have been ready.
+  EXPECT_GE(queue->getNumHits(), 2u);
+}
+
+TEST_F(LazyCompileQueueTest, CompilesOnDemandWhenQueueIsFull) {
+  LazyCompileQueue *queue = runtime->getLazyCompileQueue();
+  ASSERT_NE(queue, nullptr);
+
+  // Create more closures than the queue holds, and call them right away, so
+  // that some are claimed while pending, some while being compiled, and some
+  // were never queued.
+  std::string source = "var sum = 0;\n";
+  const unsigned numFuncs = LazyCompileQueue::kMaxPending * 2;
+  for (unsigned i = 0; i < numFuncs; ++i) {
+    source += "sum += (function() { return " + std::to_string(i) + "; })();\n";
+  }
+  source += "sum;";
+  CallResult<HermesValue> res = runtime->run(source, "file:///many.js", flags);
+  ASSERT_FALSE(isException(res));
+  EXPECT_EQ(res->getNumber(), numFuncs * (numFuncs - 1) / 2);
+}
+
+} // namespace
+} // namespace hermes
+
+#endif // HERMESVM_LEAN
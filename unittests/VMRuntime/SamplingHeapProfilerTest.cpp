@@ -17,6 +17,7 @@
 #include "hermes/VM/HeapSnapshot.h"
 #include "hermes/VM/HermesValue.h"
 #include "hermes/VM/JSWeakMapImpl.h"
+#include "hermes/VM/Profiler/HeapSamplingProfiler.h"
 #include "hermes/VM/SymbolID.h"
 
 #include "llvh/ADT/StringRef.h"
@@ -28,9 +29,6 @@ using namespace hermes::parser;
 namespace hermes {
 namespace {
 
-// The sampling heap profiler only works with location traces enabled.
-#ifdef HERMES_ENABLE_ALLOCATION_LOCATION_TRACES
-
 static JSONObject *parseProfile(
     const std::string &json,
     JSONFactory &factory,
@@ -57,19 +55,6 @@ static JSONObject *parseProfile(
   return llvh::cast<JSONObject>(root);
 }
 
-static JSONObject *takeProfile(
-    Runtime *runtime,
-    JSONFactory &factory,
-    const char *file,
-    int line) {
-  std::string result("");
-  llvh::raw_string_ostream str(result);
-  runtime->collect("test");
-  runtime->disableSamplingHeapProfiler(str);
-  str.flush();
-  return parseProfile(result, factory, file, line);
-}
-
 class SamplingProfileTree final {
  public:
   struct Node final {
@@ -136,10 +121,27 @@ std::shared_ptr<SamplingProfileTree::Node> SamplingProfileTree::makeNode(
 }
 
 #define PARSE_PROFILE(...) parseProfile(__VA_ARGS__, __FILE__, __LINE__)
-#define TAKE_PROFILE(...) takeProfile(__VA_ARGS__, __FILE__, __LINE__)
 
 using SamplingHeapProfilerTest = RuntimeTestFixture;
 
+// The sampling heap profiler only works with location traces enabled.
+#ifdef HERMES_ENABLE_ALLOCATION_LOCATION_TRACES
+
+static JSONObject *takeProfile(
+    Runtime *runtime,
+    JSONFactory &factory,
+    const char *file,
+    int line) {
+  std::string result("");
+  llvh::raw_string_ostream str(result);
+  runtime->collect("test");
+  runtime->disableSamplingHeapProfiler(str);
+  str.flush();
+  return parseProfile(result, factory, file, line);
+}
+
+#define TAKE_PROFILE(...) takeProfile(__VA_ARGS__, __FILE__, __LINE__)
+
 TEST_F(SamplingHeapProfilerTest, Basic) {
   JSONFactory::Allocator alloc;
   JSONFactory jsonFactory{alloc};
@@ -203,5 +205,130 @@ foo();
 
 #endif
 
+static JSONObject *writeHeapSamplingProfile(
+    Runtime *runtime,
+    JSONFactory &factory,
+    const char *file,
+    int line) {
+  std::string result("");
+  llvh::raw_string_ostream str(result);
+  runtime->collect("test");
+  EXPECT_TRUE(runtime->writeHeapSamplingProfile(str));
+  str.flush();
+  return parseProfile(result, factory, file, line);
+}
+
+#define WRITE_HEAP_SAMPLING_PROFILE(...) \
+  writeHeapSamplingProfile(__VA_ARGS__, __FILE__, __LINE__)
+
+/// \return the number of samples in \p root that were taken in a function
+/// named \p functionName.
+static size_t countSamplesIn(const JSONObject &root, const char *functionName) {
+  SamplingProfileTree tree{*llvh::cast<JSONObject>(root.at("head"))};
+  const JSONArray &samples = *llvh::cast<JSONArray>(root.at("samples"));
+  size_t count = 0;
+  for (auto it = samples.begin(), end = samples.end(); it != end; ++it) {
+    const JSONObject &sample = *llvh::cast<JSONObject>(*it);
+    const int64_t id = llvh::cast<JSONNumber>(sample.at("nodeId"))->getValue();
+    if (tree.getNodeByID(id).callFrame.functionName == functionName) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+static const char *kAllocatorSource = R"(
+function allocator() {
+  return new Object(); // the allocation happens here, line 3 col 20.
+}
+function foo() {
+  var arr = [];
+  for (var i = 0; i < 500; i++) {
+    arr[i] = allocator();
+  }
+  return arr;
+}
+foo();
+  )";
+
+TEST_F(SamplingHeapProfilerTest, HeapSamplingProfilerBasic) {
+  JSONFactory::Allocator alloc;
+  JSONFactory jsonFactory{alloc};
+  EXPECT_FALSE(runtime->writeHeapSamplingProfile(llvh::nulls()));
+  // Use a fixed seed so the samples are deterministic.
+  runtime->enableHeapSamplingProfiler(
+      1 << 10,
+      HeapSamplingProfiler::kDefaultMaxStackDepth,
+      HeapSamplingProfiler::kDefaultMaxLiveSamples,
+      /*seed*/ 10);
+
+  GCScope scope{runtime};
+  hbc::CompileFlags flags;
+  CallResult<HermesValue> res =
+      runtime->run(kAllocatorSource, "file:///fake.js", flags);
+  ASSERT_FALSE(isException(res));
+  MutableHandle<JSArray> arrayToHold{runtime, vmcast<JSArray>(*res)};
+
+  JSONObject *root = WRITE_HEAP_SAMPLING_PROFILE(runtime, jsonFactory);
+  ASSERT_NE(root, nullptr);
+  SamplingProfileTree tree{*llvh::cast<JSONObject>(root->at("head"))};
+  EXPECT_EQ(tree.getRoot()->callFrame.functionName, "(root)");
+  const JSONArray &samples = *llvh::cast<JSONArray>(root->at("samples"));
+  EXPECT_NE(samples.size(), 0ul) << "Should be at least one sample";
+  for (auto it = samples.begin(), end = samples.end(); it != end; ++it) {
+    const JSONObject &sample = *llvh::cast<JSONObject>(*it);
+    EXPECT_NE(llvh::cast<JSONNumber>(sample.at("size"))->getValue(), 0);
+    const int64_t id = llvh::cast<JSONNumber>(sample.at("nodeId"))->getValue();
+    const auto &node = tree.getNodeByID(id);
+    if (node.callFrame.functionName != "allocator") {
+      continue;
+    }
+    EXPECT_EQ(node.callFrame.url, "file:///fake.js");
+    EXPECT_EQ(node.callFrame.lineNumber + 1, 3);
+    EXPECT_EQ(node.callFrame.columnNumber + 1, 20);
+    EXPECT_NE(node.selfSize, 0);
+    ASSERT_NE(node.parent, nullptr);
+    EXPECT_EQ(node.parent->callFrame.functionName, "foo");
+  }
+  EXPECT_NE(countSamplesIn(*root, "allocator"), 0u);
+  // Sampled objects are followed as weak roots, so the GC doesn't need to
+  // track the IDs of every object.
+  EXPECT_FALSE(runtime->getHeap().isTrackingIDs());
+
+  // The profiler keeps running, and forgets objects once they are freed.
+  arrayToHold = nullptr;
+  root = WRITE_HEAP_SAMPLING_PROFILE(runtime, jsonFactory);
+  ASSERT_NE(root, nullptr);
+  EXPECT_EQ(countSamplesIn(*root, "allocator"), 0u);
+
+  runtime->disableHeapSamplingProfiler();
+  EXPECT_FALSE(runtime->writeHeapSamplingProfile(llvh::nulls()));
+}
+
+TEST_F(SamplingHeapProfilerTest, HeapSamplingProfilerBounded) {
+  JSONFactory::Allocator alloc;
+  JSONFactory jsonFactory{alloc};
+  runtime->enableHeapSamplingProfiler(
+      1 << 6, /*maxStackDepth*/ 1, /*maxLiveSamples*/ 4, /*seed*/ 10);
+
+  GCScope scope{runtime};
+  hbc::CompileFlags flags;
+  CallResult<HermesValue> res =
+      runtime->run(kAllocatorSource, "file:///fake.js", flags);
+  ASSERT_FALSE(isException(res));
+  auto arrayToHold = runtime->makeHandle<JSArray>(*res);
+  ASSERT_EQ(JSArray::getLength(*arrayToHold, runtime), 500);
+
+  JSONObject *root = WRITE_HEAP_SAMPLING_PROFILE(runtime, jsonFactory);
+  ASSERT_NE(root, nullptr);
+  const JSONArray &samples = *llvh::cast<JSONArray>(root->at("samples"));
+  EXPECT_LE(samples.size(), 4u);
+  // With a depth of one, every captured stack is a direct child of the root.
+  SamplingProfileTree tree{*llvh::cast<JSONObject>(root->at("head"))};
+  for (const auto &child : tree.getRoot()->children) {
+    EXPECT_EQ(child->children.size(), 0u);
+  }
+}
+
 } // namespace
 } // namespace hermes
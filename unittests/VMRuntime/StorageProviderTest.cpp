@@ -11,9 +11,12 @@
 #include "hermes/Support/OSCompat.h"
 #include "hermes/VM/AlignedStorage.h"
 #include "hermes/VM/LimitedStorageProvider.h"
+#include "hermes/VM/SegmentPool.h"
 
 #include "llvh/ADT/STLExtras.h"
 
+#include <thread>
+
 using namespace hermes;
 using namespace hermes::vm;
 
@@ -181,6 +184,162 @@ TEST(StorageProviderTest, StorageProviderAllocsCount) {
   EXPECT_EQ(LIM, provider->numDeletedAllocs());
 }
 
+TEST(StorageProviderTest, ContiguousVAProviderAllocsFromRange) {
+  constexpr size_t LIM = 4;
+  auto provider =
+      StorageProvider::contiguousVAProvider(AlignedStorage::size() * LIM);
+
+  char *storages[LIM];
+  for (size_t i = 0; i < LIM; ++i) {
+    auto result = provider->newStorage("Test");
+    ASSERT_TRUE(result);
+    storages[i] = static_cast<char *>(result.get());
+    EXPECT_EQ(
+        0,
+        reinterpret_cast<uintptr_t>(storages[i]) % AlignedStorage::size());
+    // The storage is usable memory.
+    storages[i][0] = 1;
+    storages[i][AlignedStorage::size() - 1] = 1;
+  }
+  // Storages are handed out consecutively from the reserved range.
+  for (size_t i = 1; i < LIM; ++i) {
+    EXPECT_EQ(storages[i - 1] + AlignedStorage::size(), storages[i]);
+  }
+
+  const char *rangeStart = storages[0];
+  const char *rangeEnd = storages[LIM - 1] + AlignedStorage::size();
+  auto inRange = [rangeStart, rangeEnd](void *storage) {
+    return rangeStart <= storage && storage < rangeEnd;
+  };
+
+  // Exhausting the range falls back to separate, aligned allocations outside
+  // of it.
+  auto extra = provider->newStorage("Extra");
+  ASSERT_TRUE(extra);
+  EXPECT_FALSE(inRange(extra.get()));
+  EXPECT_EQ(
+      0, reinterpret_cast<uintptr_t>(extra.get()) % AlignedStorage::size());
+  static_cast<char *>(extra.get())[0] = 1;
+  EXPECT_EQ(LIM + 1, provider->numLiveAllocs());
+  EXPECT_EQ(0, provider->numFailedAllocs());
+
+  // Deleted storages in the range are uncommitted, and reused.
+  provider->deleteStorage(storages[1]);
+  auto reused = provider->newStorage("Reused");
+  ASSERT_TRUE(reused);
+  EXPECT_EQ(storages[1], reused.get());
+  storages[1] = static_cast<char *>(reused.get());
+  storages[1][0] = 1;
+
+  // Once the reused storage is taken, the range is exhausted again.
+  auto extra2 = provider->newStorage("Extra2");
+  ASSERT_TRUE(extra2);
+  EXPECT_FALSE(inRange(extra2.get()));
+  EXPECT_NE(extra.get(), extra2.get());
+
+  // Clean-up
+  provider->deleteStorage(extra.get());
+  provider->deleteStorage(extra2.get());
+  for (auto s : storages) {
+    provider->deleteStorage(s);
+  }
+  EXPECT_EQ(0, provider->numLiveAllocs());
+}
+
+TEST(StorageProviderTest, ContiguousVAProviderBindLocalNUMA) {
+  // Binding may be unsupported on this platform, but allocation must still
+  // succeed.
+  auto provider = StorageProvider::contiguousVAProvider(
+      AlignedStorage::size(), /* bindLocalNUMA */ true);
+  auto result = provider->newStorage("Test");
+  ASSERT_TRUE(result);
+  static_cast<char *>(result.get())[0] = 1;
+  provider->deleteStorage(result.get());
+}
+
+TEST(StorageProviderTest, SegmentPoolReusesStorage) {
+  SegmentPool pool;
+  pool.setLimits(2, 1, std::chrono::milliseconds::max());
+  void *first;
+  {
+    PooledStorageProvider provider{pool};
+    auto result = provider.newStorage("Test");
+    ASSERT_TRUE(result);
+    first = result.get();
+    static_cast<char *>(first)[0] = 1;
+    provider.deleteStorage(first);
+  }
+  EXPECT_EQ(1, pool.numPooled());
+  EXPECT_EQ(1, pool.numResident());
+
+  // A provider created later reuses the storage returned by the first one.
+  PooledStorageProvider provider{pool};
+  auto result = provider.newStorage("Test");
+  ASSERT_TRUE(result);
+  EXPECT_EQ(first, result.get());
+  EXPECT_EQ(0, pool.numPooled());
+  provider.deleteStorage(result.get());
+}
+
+TEST(StorageProviderTest, SegmentPoolBounds) {
+  constexpr size_t NUM = 4;
+  SegmentPool pool;
+  pool.setLimits(3, 1, std::chrono::milliseconds::max());
+  PooledStorageProvider provider{pool};
+
+  void *storages[NUM];
+  for (size_t i = 0; i < NUM; ++i) {
+    auto result = provider.newStorage("Test");
+    ASSERT_TRUE(result);
+    storages[i] = result.get();
+  }
+  for (auto s : storages) {
+    provider.deleteStorage(s);
+  }
+  // Only maxPooled storages are kept, and only maxResident of those keep
+  // their pages.
+  EXPECT_EQ(3, pool.numPooled());
+  EXPECT_EQ(1, pool.numResident());
+
+  pool.releaseIdle();
+  EXPECT_EQ(3, pool.numPooled());
+  EXPECT_EQ(0, pool.numResident());
+
+  pool.clear();
+  EXPECT_EQ(0, pool.numPooled());
+}
+
+TEST(StorageProviderTest, SegmentPoolIdleRelease) {
+  SegmentPool pool;
+  pool.setLimits(2, 2, std::chrono::milliseconds(0));
+  PooledStorageProvider provider{pool};
+  auto result = provider.newStorage("Test");
+  ASSERT_TRUE(result);
+  provider.deleteStorage(result.get());
+  // With a zero idle timeout, returned storage is released right away.
+  EXPECT_EQ(1, pool.numPooled());
+  EXPECT_EQ(0, pool.numResident());
+}
+
+TEST(StorageProviderTest, SegmentPoolIdleReleaseWithoutActivity) {
+  SegmentPool pool;
+  pool.setLimits(2, 2, std::chrono::milliseconds(20));
+  PooledStorageProvider provider{pool};
+  auto result = provider.newStorage("Test");
+  ASSERT_TRUE(result);
+  provider.deleteStorage(result.get());
+  EXPECT_EQ(1, pool.numResident());
+  // The storage is released once it times out, although nothing else goes
+  // through the pool.
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (pool.numResident() != 0 &&
+         std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  EXPECT_EQ(1, pool.numPooled());
+  EXPECT_EQ(0, pool.numResident());
+}
+
 /// StorageGuard will free storage on scope exit.
 class StorageGuard final {
  public:
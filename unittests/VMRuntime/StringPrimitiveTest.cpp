@@ -328,4 +328,74 @@ TEST_F(StringPrimTest, FastConcatTest) {
   EXPECT_TRUE(utf16Ref.size() == utfStr3.size());
   EXPECT_TRUE(std::equal(utfStr3.begin(), utfStr3.end(), utf16Ref.begin()));
 }
+
+TEST_F(StringPrimTest, SlicedStringTest) {
+  CallResult<HermesValue> cr{ExecutionStatus::EXCEPTION};
+  std::string bigStr;
+  for (unsigned i = 0; i < 1000; ++i)
+    bigStr.push_back('a' + i % 26);
+  auto big = StringPrimitive::createNoThrow(runtime, bigStr);
+
+  //=======================================
+  // A long slice references its parent.
+  cr = StringPrimitive::slice(runtime, big, 100, 800);
+  ASSERT_NE(ExecutionStatus::EXCEPTION, cr);
+  auto slice_1 = runtime->makeHandle<SlicedASCIIStringPrimitive>(*cr);
+  EXPECT_TRUE(slice_1->testGetParent() == *big);
+
+  auto asciiRef = slice_1->getStringRef<char>();
+  EXPECT_TRUE(asciiRef.size() == 800);
+  EXPECT_TRUE(std::equal(
+      bigStr.begin() + 100, bigStr.begin() + 900, asciiRef.begin()));
+
+  //=======================================
+  // A slice of a slice references the same parent.
+  cr = StringPrimitive::slice(runtime, slice_1, 50, 300);
+  ASSERT_NE(ExecutionStatus::EXCEPTION, cr);
+  auto slice_2 = runtime->makeHandle<SlicedASCIIStringPrimitive>(*cr);
+  EXPECT_TRUE(slice_2->testGetParent() == *big);
+
+  asciiRef = slice_2->getStringRef<char>();
+  EXPECT_TRUE(asciiRef.size() == 300);
+  EXPECT_TRUE(std::equal(
+      bigStr.begin() + 150, bigStr.begin() + 450, asciiRef.begin()));
+  auto copy = StringPrimitive::createNoThrow(runtime, bigStr.substr(150, 300));
+  EXPECT_TRUE(slice_2->equals(*copy));
+
+  //=======================================
+  // Short slices, and slices much shorter than their parent, are copied.
+  cr = StringPrimitive::slice(runtime, big, 10, 20);
+  ASSERT_NE(ExecutionStatus::EXCEPTION, cr);
+  EXPECT_FALSE(isSlicedStringPrimitive(cr->getString()));
+
+  std::string hugeStr(4 * 1000, 'x');
+  auto huge = StringPrimitive::createNoThrow(runtime, hugeStr);
+  cr = StringPrimitive::slice(runtime, huge, 0, 999);
+  ASSERT_NE(ExecutionStatus::EXCEPTION, cr);
+  EXPECT_FALSE(isSlicedStringPrimitive(cr->getString()));
+  cr = StringPrimitive::slice(runtime, huge, 0, 1000);
+  ASSERT_NE(ExecutionStatus::EXCEPTION, cr);
+  EXPECT_TRUE(isSlicedStringPrimitive(cr->getString()));
+
+  //=======================================
+  // UTF16
+  std::u16string utfStr(500, u'\u1234');
+  auto utf = StringPrimitive::createNoThrow(
+      runtime, UTF16Ref(utfStr.data(), utfStr.size()));
+  cr = StringPrimitive::slice(runtime, utf, 1, 400);
+  ASSERT_NE(ExecutionStatus::EXCEPTION, cr);
+  auto slice_3 = runtime->makeHandle<SlicedUTF16StringPrimitive>(*cr);
+  EXPECT_TRUE(slice_3->testGetParent() == *utf);
+  auto utf16Ref = slice_3->getStringRef<char16_t>();
+  EXPECT_TRUE(utf16Ref.size() == 400);
+  EXPECT_TRUE(std::equal(
+      utfStr.begin() + 1, utfStr.begin() + 401, utf16Ref.begin()));
+
+  //=======================================
+  // The characters are still reachable after the parent moves.
+  runtime->collect("test");
+  asciiRef = slice_2->getStringRef<char>();
+  EXPECT_TRUE(std::equal(
+      bigStr.begin() + 150, bigStr.begin() + 450, asciiRef.begin()));
+}
 } // namespace